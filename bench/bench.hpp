@@ -0,0 +1,162 @@
+/** @file
+ * Minimal benchmarking utilities: timing of (batch) callables, generation
+ * of realistic input coordinate sets and output of results in JSON format.
+ */
+
+#ifndef __DSO_GEODESY_BENCH_HPP__
+#define __DSO_GEODESY_BENCH_HPP__
+
+#include "transformations.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/** A single benchmark measurement. */
+struct Result {
+  /* name of the function benchmarked, e.g. "cartesian2geodetic" */
+  std::string name;
+  /* variant, e.g. "scalar", "batch", "CartesianCrd" */
+  std::string variant;
+  /* input distribution, e.g. "surface" */
+  std::string distribution;
+  /* number of points per call/loop */
+  std::size_t num_points;
+  /* (best) time per point [ns] */
+  double ns_per_point;
+  /* throughput [points/sec] */
+  double points_per_sec() const noexcept { return 1e9 / ns_per_point; }
+};
+
+/** @brief Time a callable that processes n points.
+ *
+ * The callable is invoked (repeats+1) times; the first (warm-up) run is
+ * discarded and the fastest of the remaining runs is reported, which is
+ * the most stable estimate on a (possibly) loaded machine.
+ *
+ * @return Time per point [ns]
+ */
+template <typename F>
+double ns_per_point(F &&f, std::size_t n, int repeats) noexcept {
+  f();
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < repeats; r++) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    best = std::min(
+        best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  return best / static_cast<double>(n);
+}
+
+/** Input distributions */
+enum class Distribution : char { Surface, Leo, Polar };
+
+inline const char *name_of(Distribution d) noexcept {
+  switch (d) {
+  case Distribution::Surface:
+    return "surface";
+  case Distribution::Leo:
+    return "leo";
+  case Distribution::Polar:
+    return "polar";
+  }
+  return "unknown";
+}
+
+/** A set of points, in geodetic, cartesian and spherical coordinates (SoA).
+ */
+struct Samples {
+  std::vector<double> lat, lon, hgt;
+  std::vector<double> x, y, z;
+  std::vector<double> r, glat, glon;
+};
+
+/** @brief Generate n random points following a given distribution.
+ *
+ * * Surface: points uniformly distributed on the ellipsoid (w.r.t. area),
+ *   with heights in the range [-500, 9000] m
+ * * Leo: as above, but with heights in the range [300, 2000] km (Low Earth
+ *   Orbit altitudes)
+ * * Polar: points with |latitude| > 89.9 deg, heights as in Surface
+ */
+template <dso::ellipsoid E = dso::ellipsoid::wgs84>
+Samples make_samples(Distribution d, std::size_t n, unsigned seed = 1) {
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<double> u(-1e0, 1e0);
+  std::uniform_real_distribution<double> ulon(-dso::DPI, dso::DPI);
+  std::uniform_real_distribution<double> usurf(-500e0, 9000e0);
+  std::uniform_real_distribution<double> uleo(300e3, 2000e3);
+  std::uniform_real_distribution<double> upol(89.9e0 * dso::DEG2RAD,
+                                              dso::DPI / 2e0);
+
+  Samples s;
+  for (auto *v : {&s.lat, &s.lon, &s.hgt, &s.x, &s.y, &s.z, &s.r, &s.glat,
+                  &s.glon})
+    v->resize(n);
+
+  for (std::size_t i = 0; i < n; i++) {
+    switch (d) {
+    case Distribution::Polar:
+      s.lat[i] = std::copysign(upol(gen), u(gen));
+      s.hgt[i] = usurf(gen);
+      break;
+    case Distribution::Leo:
+      s.lat[i] = std::asin(u(gen));
+      s.hgt[i] = uleo(gen);
+      break;
+    case Distribution::Surface:
+    default:
+      s.lat[i] = std::asin(u(gen));
+      s.hgt[i] = usurf(gen);
+      break;
+    }
+    s.lon[i] = ulon(gen);
+    dso::geodetic2cartesian<E>(s.lat[i], s.lon[i], s.hgt[i], s.x[i], s.y[i],
+                               s.z[i]);
+    dso::cartesian2spherical(s.x[i], s.y[i], s.z[i], s.r[i], s.glat[i],
+                             s.glon[i]);
+  }
+  return s;
+}
+
+/** @brief Write results in JSON format.
+ *
+ * @param[in] fp      Output stream
+ * @param[in] results Results to write
+ * @param[in] repeats Number of (timed) repetitions per benchmark
+ */
+inline void write_json(FILE *fp, const std::vector<Result> &results,
+                       int repeats) noexcept {
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"library\": \"geodesy\",\n");
+#ifdef GEODESY_VERSION
+  fprintf(fp, "  \"version\": \"%s\",\n", GEODESY_VERSION);
+#endif
+#ifdef __VERSION__
+  fprintf(fp, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+  fprintf(fp, "  \"repeats\": %d,\n", repeats);
+  fprintf(fp, "  \"results\": [\n");
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const auto &r = results[i];
+    fprintf(fp,
+            "    {\"name\": \"%s\", \"variant\": \"%s\", \"distribution\": "
+            "\"%s\", \"num_points\": %zu, \"ns_per_point\": %.4f, "
+            "\"points_per_sec\": %.1f}%s\n",
+            r.name.c_str(), r.variant.c_str(), r.distribution.c_str(),
+            r.num_points, r.ns_per_point, r.points_per_sec(),
+            (i + 1 < results.size()) ? "," : "");
+  }
+  fprintf(fp, "  ]\n}\n");
+}
+
+} /* namespace bench */
+
+#endif
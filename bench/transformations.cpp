@@ -0,0 +1,879 @@
+#include "angle_format.hpp"
+#include "bench.hpp"
+#include "cpu_dispatch.hpp"
+#include "distance_matrix.hpp"
+#include "geodesic.hpp"
+#include "helmert.hpp"
+#include "latitude_table.hpp"
+#include "parallel_transformations.hpp"
+#include "spatial_index.hpp"
+#include "station_reader.hpp"
+#include "topocentric_frame.hpp"
+#include "transverse_mercator.hpp"
+#include "units.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace dso;
+using bench::Distribution;
+using bench::Result;
+
+/* sink for results, so that computations are not optimized away */
+volatile double sink = 0e0;
+
+namespace {
+void consume(const std::vector<double> &v) noexcept {
+  sink = sink + v.front() + v.back();
+}
+
+template <ellipsoid E>
+void run(ThreadPool &pool, Distribution d, std::size_t n, int repeats,
+         std::vector<Result> &results) {
+  const bench::Samples s = bench::make_samples<E>(d, n);
+  const char *dist = bench::name_of(d);
+  std::vector<double> o1(n), o2(n), o3(n);
+
+  /* cartesian2geodetic */
+  results.push_back(
+      {"cartesian2geodetic", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               cartesian2geodetic<E>(s.x[i], s.y[i], s.z[i], o1[i], o2[i],
+                                     o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"cartesian2geodetic", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             cartesian2geodetic<E>(s.x.data(), s.y.data(), s.z.data(),
+                                   o1.data(), o2.data(), o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+  /* the same, reading interleaved (AoS) triplets through a span */
+  {
+    std::vector<double> xyz(3 * n);
+    for (std::size_t i = 0; i < n; i++) {
+      xyz[3 * i] = s.x[i];
+      xyz[3 * i + 1] = s.y[i];
+      xyz[3 * i + 2] = s.z[i];
+    }
+    const CartesianCrdConstSpan c = CartesianCrdConstSpan::aos(xyz.data(), n);
+    const GeodeticCrdSpan g(o1.data(), o2.data(), o3.data(), n);
+    results.push_back(
+        {"cartesian2geodetic", "aos-span", dist, n,
+         bench::ns_per_point([&]() { cartesian2geodetic<E>(c, g); }, n,
+                             repeats)});
+    consume(o1);
+  }
+  results.push_back(
+      {"cartesian2geodetic", "parallel", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             parallel::cartesian2geodetic<E>(pool, s.x.data(), s.y.data(),
+                                             s.z.data(), o1.data(), o2.data(),
+                                             o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+
+  results.push_back(
+      {"cartesian2geodetic", "scalar-mm", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               cartesian2geodetic<E, precision::mm>(s.x[i], s.y[i], s.z[i],
+                                                    o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"cartesian2geodetic", "scalar-cm", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               cartesian2geodetic<E, precision::cm>(s.x[i], s.y[i], s.z[i],
+                                                    o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* geodetic2cartesian */
+  results.push_back(
+      {"geodetic2cartesian", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               geodetic2cartesian<E>(s.lat[i], s.lon[i], s.hgt[i], o1[i],
+                                     o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"geodetic2cartesian", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             geodetic2cartesian<E>(s.lat.data(), s.lon.data(), s.hgt.data(),
+                                   o1.data(), o2.data(), o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"geodetic2cartesian", "parallel", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             parallel::geodetic2cartesian<E>(pool, s.lat.data(), s.lon.data(),
+                                             s.hgt.data(), o1.data(),
+                                             o2.data(), o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* batch kernels, for every instruction set level available */
+  const SimdLevel level = simd_level();
+  for (SimdLevel l :
+       {SimdLevel::baseline, SimdLevel::avx2, SimdLevel::avx512}) {
+    if (set_simd_level(l) != std::errc{})
+      continue;
+    const std::string variant = std::string("batch-") + simd_level_name(l);
+    results.push_back(
+        {"cartesian2geodetic", variant, dist, n,
+         bench::ns_per_point(
+             [&]() {
+               cartesian2geodetic<E>(s.x.data(), s.y.data(), s.z.data(),
+                                     o1.data(), o2.data(), o3.data(), n);
+             },
+             n, repeats)});
+    consume(o1);
+    results.push_back(
+        {"geodetic2cartesian", variant, dist, n,
+         bench::ns_per_point(
+             [&]() {
+               geodetic2cartesian<E>(s.lat.data(), s.lon.data(),
+                                     s.hgt.data(), o1.data(), o2.data(),
+                                     o3.data(), n);
+             },
+             n, repeats)});
+    consume(o1);
+  }
+  set_simd_level(level);
+
+  /* cartesian2spherical */
+  results.push_back(
+      {"cartesian2spherical", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               cartesian2spherical(s.x[i], s.y[i], s.z[i], o1[i], o2[i],
+                                   o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"cartesian2spherical", "scalar-mm", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               cartesian2spherical<precision::mm>(s.x[i], s.y[i], s.z[i],
+                                                  o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"cartesian2spherical", "scalar-cm", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               cartesian2spherical<precision::cm>(s.x[i], s.y[i], s.z[i],
+                                                  o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* spherical2cartesian */
+  results.push_back(
+      {"spherical2cartesian", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               spherical2cartesian(s.r[i], s.glat[i], s.glon[i], o1[i], o2[i],
+                                   o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"spherical2cartesian", "scalar-mm", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               spherical2cartesian<precision::mm>(s.r[i], s.glat[i], s.glon[i],
+                                                  o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"spherical2cartesian", "scalar-cm", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               spherical2cartesian<precision::cm>(s.r[i], s.glat[i], s.glon[i],
+                                                  o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* geodetic2lvlh */
+  results.push_back(
+      {"geodetic2lvlh", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               o1[i] = geodetic2lvlh(s.lat[i], s.lon[i]).trace();
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* normalization of (accumulated, i.e. a few turns) longitudes */
+  {
+    std::vector<double> a(n);
+    for (std::size_t i = 0; i < n; i++)
+      a[i] = s.lon[i] + 20e0 * s.lat[i];
+    results.push_back({"anpm", "scalar", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             for (std::size_t i = 0; i < n; i++)
+                               o1[i] = anpm(a[i]);
+                           },
+                           n, repeats)});
+    consume(o1);
+    results.push_back(
+        {"anpm", "batch", dist, n,
+         bench::ns_per_point([&]() { anpm(a.data(), o1.data(), n); }, n,
+                             repeats)});
+    consume(o1);
+  }
+
+  /* text I/O of geodetic coordinates, in decimal degrees */
+  {
+    std::vector<GeodeticCrd> crd(n);
+    for (std::size_t i = 0; i < n; i++) {
+      crd[i].lat() = s.lat[i];
+      crd[i].lon() = s.lon[i];
+      crd[i].hgt() = s.hgt[i];
+    }
+    std::vector<char> buf(64 * n + 1);
+    char *end = buf.data();
+    results.push_back(
+        {"format_geodetic", "snprintf", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               char *p = buf.data();
+               for (std::size_t i = 0; i < n; i++)
+                 p += std::snprintf(p, 64, "%.9f %.9f %.4f\n",
+                                    rad2deg(crd[i].lat()),
+                                    rad2deg(crd[i].lon()), crd[i].hgt());
+             },
+             n, repeats)});
+    results.push_back(
+        {"format_geodetic", "to_chars", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               end = format_geodetic(buf.data(), buf.data() + buf.size(),
+                                     crd.data(), n, angle_format::degrees, 9,
+                                     4)
+                         .ptr;
+             },
+             n, repeats)});
+    *end = '\0';
+    results.push_back(
+        {"parse_geodetic", "strtod", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               char *p = buf.data();
+               for (std::size_t i = 0; i < n; i++) {
+                 o1[i] = deg2rad(std::strtod(p, &p));
+                 o2[i] = deg2rad(std::strtod(p, &p));
+                 o3[i] = std::strtod(p, &p);
+               }
+             },
+             n, repeats)});
+    consume(o1);
+    results.push_back(
+        {"parse_geodetic", "from_chars", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               parse_geodetic(buf.data(), end, angle_format::degrees,
+                              crd.data(), n);
+             },
+             n, repeats)});
+    sink = sink + crd.back().lat();
+  }
+
+  /* reading station coordinates from SINEX and CSV text */
+  {
+    std::string snx("+SOLUTION/ESTIMATE\n");
+    std::string csv("site,x,y,z\n");
+    char line[128];
+    const double *v[] = {s.x.data(), s.y.data(), s.z.data()};
+    for (std::size_t i = 0; i < n; i++) {
+      for (int c = 0; c < 3; c++) {
+        std::snprintf(line, sizeof(line),
+                      " %5zu STA%c   S%03zu  A %4zu 21:001:00000 m    2 "
+                      "%21.14e %.5e\n",
+                      (3 * i + c) % 100000, 'X' + c, i % 1000, i / 1000 + 1,
+                      v[c][i], 1e-3);
+        snx += line;
+      }
+      std::snprintf(line, sizeof(line), "S%03zu,%.4f,%.4f,%.4f\n", i % 1000,
+                    s.x[i], s.y[i], s.z[i]);
+      csv += line;
+    }
+    snx += "-SOLUTION/ESTIMATE\n";
+    StationCoordinates sta;
+    const char *b = snx.data();
+    const char *e = b + snx.size();
+    results.push_back({"read_sinex", "serial", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             sta.clear();
+                             read_sinex(b, e, sta);
+                           },
+                           n, repeats)});
+    results.push_back({"read_sinex", "parallel", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             sta.clear();
+                             read_sinex(pool, b, e, sta);
+                           },
+                           n, repeats)});
+    b = csv.data();
+    e = b + csv.size();
+    results.push_back({"read_station_csv", "serial", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             sta.clear();
+                             read_station_csv(b, e, CsvColumns{}, sta);
+                           },
+                           n, repeats)});
+    results.push_back({"read_station_csv", "parallel", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             sta.clear();
+                             read_station_csv(pool, b, e, CsvColumns{}, sta);
+                           },
+                           n, repeats)});
+    sink = sink + sta.x.back();
+  }
+
+  /* meridian arc length */
+  results.push_back(
+      {"meridian_arc_length", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               o1[i] = meridian_arc_length<E>(s.lat[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"meridian_arc_length", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() { meridian_arc_length<E>(s.lat.data(), o1.data(), n); }, n,
+           repeats)});
+  consume(o1);
+  results.push_back(
+      {"meridian_arc_latitude", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() { meridian_arc_latitude<E>(o1.data(), o2.data(), n); }, n,
+           repeats)});
+  consume(o2);
+
+  /* Helmert transformation (ITRF-like parameters), alone and followed by
+   * cartesian2geodetic, either in two passes or fused */
+  {
+    const HelmertTransform h(
+        HelmertParameters::from_iers(1.6, 1.9, 2.4, -0.02, 0, 0, 0),
+        HelmertParameters::from_iers(0, 0, -0.1, 0.03, 0, 0, 0), 2010e0,
+        2024e0);
+    const Ellipsoid ell(E);
+    std::vector<double> hx(n), hy(n), hz(n);
+    results.push_back({"helmert", "batch", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             h.apply(s.x.data(), s.y.data(), s.z.data(),
+                                     hx.data(), hy.data(), hz.data(), n);
+                           },
+                           n, repeats)});
+    consume(hx);
+    results.push_back(
+        {"helmert_cartesian2geodetic", "two-pass", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               h.apply(s.x.data(), s.y.data(), s.z.data(), hx.data(),
+                       hy.data(), hz.data(), n);
+               ell.cartesian2geodetic(hx.data(), hy.data(), hz.data(),
+                                      o1.data(), o2.data(), o3.data(), n);
+             },
+             n, repeats)});
+    consume(o1);
+    results.push_back(
+        {"helmert_cartesian2geodetic", "fused", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               h.apply(ell, s.x.data(), s.y.data(), s.z.data(), o1.data(),
+                       o2.data(), o3.data(), n);
+             },
+             n, repeats)});
+    consume(o1);
+  }
+
+  /* covariance propagation, cartesian to geodetic: per point, with dynamic
+   * (heap-allocated) Eigen matrices, vs the batch (packed) version */
+  {
+    std::vector<double> cov(COV_SIZE * n), out(COV_SIZE * n);
+    for (std::size_t i = 0; i < n; i++) {
+      double *c = cov.data() + COV_SIZE * i;
+      c[0] = c[3] = c[5] = 1e-4;
+      c[1] = c[2] = c[4] = 1e-5;
+    }
+    results.push_back(
+        {"cartesian2geodetic_covariance", "per-point", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               for (std::size_t i = 0; i < n; i++) {
+                 const double *c = cov.data() + COV_SIZE * i;
+                 Eigen::MatrixXd S(3, 3);
+                 S << c[0], c[1], c[2], c[1], c[3], c[4], c[2], c[4], c[5];
+                 const Eigen::MatrixXd J =
+                     core::cartesian2geodetic_jacobian(
+                         ellipsoid_constants<E>, s.lat[i], s.lon[i],
+                         s.hgt[i]);
+                 const Eigen::MatrixXd P = J * S * J.transpose();
+                 double *o = out.data() + COV_SIZE * i;
+                 o[0] = P(0, 0);
+                 o[1] = P(0, 1);
+                 o[2] = P(0, 2);
+                 o[3] = P(1, 1);
+                 o[4] = P(1, 2);
+                 o[5] = P(2, 2);
+               }
+             },
+             n, repeats)});
+    consume(out);
+    results.push_back(
+        {"cartesian2geodetic_covariance", "batch", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               cartesian2geodetic_covariance<E>(s.lat.data(), s.lon.data(),
+                                                s.hgt.data(), cov.data(),
+                                                out.data(), n);
+             },
+             n, repeats)});
+    consume(out);
+  }
+
+  /* radii of curvature and auxiliary latitudes, direct vs interpolated from
+   * a table (0.1 deg step) */
+  {
+    const Ellipsoid ell(E);
+    const LatitudeTable tbl(ell, 0.1e0 * DPI / 180e0);
+    results.push_back({"N", "direct", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             for (std::size_t i = 0; i < n; i++)
+                               o1[i] = N<E>(s.lat[i]);
+                           },
+                           n, repeats)});
+    consume(o1);
+    results.push_back({"N", "table", dist, n,
+                       bench::ns_per_point(
+                           [&]() { tbl.N(s.lat.data(), o1.data(), n); }, n,
+                           repeats)});
+    consume(o1);
+    results.push_back({"geocentric_latitude", "direct", dist, n,
+                       bench::ns_per_point(
+                           [&]() {
+                             for (std::size_t i = 0; i < n; i++)
+                               o1[i] = geocentric_latitude<E>(s.lat[i]);
+                           },
+                           n, repeats)});
+    consume(o1);
+    results.push_back(
+        {"geocentric_latitude", "table", dist, n,
+         bench::ns_per_point(
+             [&]() { tbl.geocentric_latitude(s.lat.data(), o1.data(), n); },
+             n, repeats)});
+    consume(o1);
+  }
+
+  /* UTM projection; zones are selected per point */
+  std::vector<int> zone(n);
+  std::unique_ptr<bool[]> north(new bool[n]);
+  std::vector<double> ulon(n);
+  results.push_back(
+      {"geodetic2utm", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               geodetic2utm<E>(s.lat[i], s.lon[i], zone[i], north[i], o1[i],
+                               o2[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"geodetic2utm", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             geodetic2utm<E>(s.lat.data(), s.lon.data(), zone.data(),
+                             north.get(), o1.data(), o2.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"geodetic2utm", "parallel", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             parallel::geodetic2utm<E>(pool, s.lat.data(), s.lon.data(),
+                                       zone.data(), north.get(), o1.data(),
+                                       o2.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"utm2geodetic", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             utm2geodetic<E>(zone.data(), north.get(), o1.data(), o2.data(),
+                             o3.data(), ulon.data(), n);
+           },
+           n, repeats)});
+  consume(o3);
+  results.push_back(
+      {"utm2geodetic", "parallel", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             parallel::utm2geodetic<E>(pool, zone.data(), north.get(),
+                                       o1.data(), o2.data(), o3.data(),
+                                       ulon.data(), n);
+           },
+           n, repeats)});
+  consume(o3);
+
+  /* ECEF to ENU w.r.t a station; rotation per point vs cached frame */
+  GeodeticCrd sta;
+  sta.lat() = s.lat[0];
+  sta.lon() = s.lon[0];
+  sta.hgt() = s.hgt[0];
+  const TopocentricFrame frame(Ellipsoid{E}, sta);
+  results.push_back(
+      {"cartesian2enu", "geodetic2lvlh", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++) {
+               const detail::Vec3d enu =
+                   geodetic2lvlh(sta.lat(), sta.lon()).transpose() *
+                   (detail::Vec3d(s.x[i], s.y[i], s.z[i]) -
+                    frame.origin().mv);
+               o1[i] = enu(0);
+               o2[i] = enu(1);
+               o3[i] = enu(2);
+             }
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"cartesian2enu", "frame-batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             frame.cartesian2enu(s.x.data(), s.y.data(), s.z.data(),
+                                 o1.data(), o2.data(), o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"cartesian2aer", "frame-batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             frame.cartesian2aer(s.x.data(), s.y.data(), s.z.data(),
+                                 o1.data(), o2.data(), o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* geodesic problems; the i-th point is paired with the (n-1-i)-th one */
+  std::vector<double> lat2(s.lat.rbegin(), s.lat.rend());
+  std::vector<double> lon2(s.lon.rbegin(), s.lon.rend());
+  results.push_back(
+      {"geodesic_inverse", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               geodesic_inverse<E>(s.lat[i], s.lon[i], lat2[i], lon2[i],
+                                   o1[i], o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"geodesic_inverse", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             geodesic_inverse<E>(s.lat.data(), s.lon.data(), lat2.data(),
+                                 lon2.data(), o1.data(), o2.data(),
+                                 o3.data(), n);
+           },
+           n, repeats)});
+  consume(o1);
+  /* direct problems, using the distances and azimuths just computed */
+  const std::vector<double> s12(o1), azi1(o2);
+  results.push_back(
+      {"geodesic_direct", "scalar", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             for (std::size_t i = 0; i < n; i++)
+               geodesic_direct<E>(s.lat[i], s.lon[i], azi1[i], s12[i], o1[i],
+                                  o2[i], o3[i]);
+           },
+           n, repeats)});
+  consume(o1);
+  results.push_back(
+      {"geodesic_direct", "batch", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             geodesic_direct<E>(s.lat.data(), s.lon.data(), azi1.data(),
+                                s12.data(), o1.data(), o2.data(), o3.data(),
+                                n);
+           },
+           n, repeats)});
+  consume(o1);
+
+  /* spatial index over the (cartesian) samples; queries are the samples
+   * themselves, in reverse order */
+  results.push_back(
+      {"spatial_index_build", "serial", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             const SpatialIndex idx(s.x.data(), s.y.data(), s.z.data(), n);
+             sink = sink + static_cast<double>(idx.size());
+           },
+           n, repeats)});
+  results.push_back(
+      {"spatial_index_build", "parallel", dist, n,
+       bench::ns_per_point(
+           [&]() {
+             const SpatialIndex idx(pool, s.x.data(), s.y.data(), s.z.data(),
+                                    n);
+             sink = sink + static_cast<double>(idx.size());
+           },
+           n, repeats)});
+  {
+    const SpatialIndex idx(pool, s.x.data(), s.y.data(), s.z.data(), n);
+    const std::vector<double> qx(s.x.rbegin(), s.x.rend());
+    const std::vector<double> qy(s.y.rbegin(), s.y.rend());
+    const std::vector<double> qz(s.z.rbegin(), s.z.rend());
+    constexpr const std::size_t k = 8;
+    std::vector<std::size_t> ki(n * k);
+    std::vector<double> kd(n * k);
+    results.push_back(
+        {"spatial_index_knn8", "batch", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               idx.knn(qx.data(), qy.data(), qz.data(), n, k, ki.data(),
+                       kd.data());
+             },
+             n, repeats)});
+    consume(kd);
+    results.push_back(
+        {"spatial_index_knn8", "parallel", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               idx.knn(pool, qx.data(), qy.data(), qz.data(), n, k,
+                       ki.data(), kd.data());
+             },
+             n, repeats)});
+    consume(kd);
+  }
+
+  /* all-pairs distance matrix (packed upper triangle) over (at most) 2048
+   * of the samples; timings are per station pair */
+  {
+    const std::size_t ns = std::min<std::size_t>(n, 2048);
+    const Ellipsoid ell(E);
+    const StationNetwork net(ell, s.x.data(), s.y.data(), s.z.data(), ns);
+    const std::size_t np = matrix_size(ns, matrix_storage::upper);
+    std::vector<double> dm(np);
+    for (auto m : {distance_metric::chord, distance_metric::great_circle}) {
+      const char *name = (m == distance_metric::chord)
+                             ? "distance_matrix_chord"
+                             : "distance_matrix_great_circle";
+      results.push_back({name, "serial", dist, np,
+                         bench::ns_per_point(
+                             [&]() {
+                               net.distances(m, matrix_storage::upper,
+                                             dm.data());
+                             },
+                             np, repeats)});
+      consume(dm);
+      results.push_back({name, "parallel", dist, np,
+                         bench::ns_per_point(
+                             [&]() {
+                               net.distances(pool, m, matrix_storage::upper,
+                                             dm.data());
+                             },
+                             np, repeats)});
+      consume(dm);
+    }
+  }
+
+  /* cartesian2geodetic along a trajectory: a circular orbit (inclined at
+   * 98 deg, at the mean height of the samples), sampled every second in the
+   * earth-fixed frame; consecutive samples are close, but the batch
+   * conversion needs no state, hence is the one to use */
+  {
+    double h = 0e0;
+    for (std::size_t i = 0; i < n; i++)
+      h += s.hgt[i] / n;
+    const double r = Ellipsoid(E).semi_major() + h;
+    const double inc = 98e0 * DPI / 180e0;
+    const double wm = std::sqrt(3.986004418e14 / (r * r * r));
+    const double we = 7.292115e-5;
+    std::vector<double> tx(n), ty(n), tz(n);
+    for (std::size_t i = 0; i < n; i++) {
+      const double t = 1e0 * i;
+      const double u = wm * t, th = -we * t;
+      const double xo = r * std::cos(u);
+      const double yo = r * std::sin(u) * std::cos(inc);
+      tz[i] = r * std::sin(u) * std::sin(inc);
+      tx[i] = xo * std::cos(th) - yo * std::sin(th);
+      ty[i] = xo * std::sin(th) + yo * std::cos(th);
+    }
+    results.push_back(
+        {"cartesian2geodetic_trajectory", "scalar", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               for (std::size_t i = 0; i < n; i++)
+                 cartesian2geodetic<E>(tx[i], ty[i], tz[i], o1[i], o2[i],
+                                       o3[i]);
+             },
+             n, repeats)});
+    consume(o1);
+    results.push_back(
+        {"cartesian2geodetic_trajectory", "batch", dist, n,
+         bench::ns_per_point(
+             [&]() {
+               cartesian2geodetic<E>(tx.data(), ty.data(), tz.data(),
+                                     o1.data(), o2.data(), o3.data(), n);
+             },
+             n, repeats)});
+    consume(o1);
+  }
+
+  /* wrapper (coordinate type) overloads */
+  std::vector<CartesianCrd> crt(n);
+  std::vector<GeodeticCrd> geo(n);
+  std::vector<SphericalCrd> sph(n);
+  for (std::size_t i = 0; i < n; i++) {
+    crt[i] = CartesianCrd(s.x[i], s.y[i], s.z[i]);
+    geo[i].lat() = s.lat[i];
+    geo[i].lon() = s.lon[i];
+    geo[i].hgt() = s.hgt[i];
+    sph[i].r() = s.r[i];
+    sph[i].lat() = s.glat[i];
+    sph[i].lon() = s.glon[i];
+  }
+  std::vector<CartesianCrd> ocrt(n);
+  std::vector<GeodeticCrd> ogeo(n);
+  std::vector<SphericalCrd> osph(n);
+
+  results.push_back({"cartesian2geodetic", "CartesianCrd", dist, n,
+                     bench::ns_per_point(
+                         [&]() {
+                           for (std::size_t i = 0; i < n; i++)
+                             ogeo[i] = cartesian2geodetic<E>(crt[i]);
+                         },
+                         n, repeats)});
+  sink = sink + ogeo.back().lat();
+  results.push_back({"geodetic2cartesian", "GeodeticCrd", dist, n,
+                     bench::ns_per_point(
+                         [&]() {
+                           for (std::size_t i = 0; i < n; i++)
+                             ocrt[i] = geodetic2cartesian<E>(geo[i]);
+                         },
+                         n, repeats)});
+  sink = sink + ocrt.back().x();
+  results.push_back({"cartesian2spherical", "CartesianCrd", dist, n,
+                     bench::ns_per_point(
+                         [&]() {
+                           for (std::size_t i = 0; i < n; i++)
+                             osph[i] = cartesian2spherical(crt[i]);
+                         },
+                         n, repeats)});
+  sink = sink + osph.back().r();
+  results.push_back({"spherical2cartesian", "SphericalCrd", dist, n,
+                     bench::ns_per_point(
+                         [&]() {
+                           for (std::size_t i = 0; i < n; i++)
+                             ocrt[i] = spherical2cartesian(sph[i]);
+                         },
+                         n, repeats)});
+  sink = sink + ocrt.back().x();
+}
+} /* unnamed namespace */
+
+int main(int argc, char *argv[]) {
+  /* number of points; at least a pair, for the distance matrix */
+  constexpr const std::size_t MIN_POINTS = 2;
+  constexpr const std::size_t DEFAULT_POINTS = std::size_t(1) << 18;
+  std::size_t n = DEFAULT_POINTS;
+  bool valid_n = true;
+  if (argc > 2) {
+    const char *end = argv[2] + std::strlen(argv[2]);
+    const auto res = std::from_chars(argv[2], end, n);
+    valid_n = res.ec == std::errc{} && res.ptr == end && n >= MIN_POINTS;
+  }
+
+  if (argc > 3 || !valid_n || (argc > 1 && !std::strcmp(argv[1], "--help"))) {
+    fprintf(stderr, "Usage: %s [JSON_FILE [NUM_POINTS]]\n", argv[0]);
+    fprintf(stderr, "Results are written to JSON_FILE (default: stdout)\n");
+    fprintf(stderr, "NUM_POINTS is an integer >= %zu (default: %zu)\n",
+            MIN_POINTS, DEFAULT_POINTS);
+    return 1;
+  }
+
+  constexpr const int repeats = 5;
+
+  /* parallel variants use all available cores */
+  ThreadPool pool;
+
+  std::vector<Result> results;
+  for (auto d :
+       {Distribution::Surface, Distribution::Leo, Distribution::Polar})
+    run<ellipsoid::wgs84>(pool, d, n, repeats, results);
+
+  /* human-readable summary */
+  fprintf(stderr, "%-22s %-14s %-8s %12s %16s\n", "function", "variant",
+          "inputs", "[ns/point]", "[points/sec]");
+  for (const auto &r : results)
+    fprintf(stderr, "%-22s %-14s %-8s %12.3f %16.1f\n", r.name.c_str(),
+            r.variant.c_str(), r.distribution.c_str(), r.ns_per_point,
+            r.points_per_sec());
+
+  /* machine-readable output */
+  FILE *fp = (argc > 1) ? std::fopen(argv[1], "w") : stdout;
+  if (!fp) {
+    fprintf(stderr, "ERROR. Failed opening output file %s\n", argv[1]);
+    return 1;
+  }
+  bench::write_json(fp, results, repeats);
+  if (fp != stdout)
+    std::fclose(fp);
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/** @file
+ * Parsing and formatting of angles (sexagesimal or decimal degrees, or
+ * radians) and of records of geodetic coordinates, from/to text buffers.
+ *
+ * Built on std::from_chars/std::to_chars, i.e. locale-independent and
+ * allocation-free; errors are reported (as for std::from_chars) by a
+ * std::errc value and the position where parsing stopped.
+ */
+
+#ifndef __DSO_ANGLE_FORMAT_HPP__
+#define __DSO_ANGLE_FORMAT_HPP__
+
+#include "core/crdtype_warppers.hpp"
+#include <charconv>
+#include <cstddef>
+#include <system_error>
+
+namespace dso {
+
+/** Text representations of angles */
+enum class angle_format : char {
+  /** Decimal degrees, e.g. -23.7534293 */
+  degrees,
+  /** Radians, e.g. -0.4145780 */
+  radians,
+  /** Sexagesimal degrees, i.e. degrees, minutes and (fractional) seconds,
+   * separated by blanks or ':', e.g. 23 45 12.3456 */
+  dms
+};
+
+/** @brief Parse an angle.
+ *
+ * Leading blanks are skipped. The angle may be signed ('+' or '-') or, for
+ * degrees and dms, followed by a hemisphere letter (N, S, E or W, where S
+ * and W denote negative angles; not both a '-' sign and S/W), e.g.
+ * "-23 45 12.3456", "23:45:12.3456 S", "+23.5", "23.5 N" or "-0.41".
+ * The angle must be followed by a delimiter (i.e. a blank, ',', ';', the
+ * end of the line or the end of the buffer).
+ *
+ * @param[in]  first Start of the buffer
+ * @param[in]  last  End of the buffer
+ * @param[in]  f     The format of the angle
+ * @param[out] rad   The angle [rad]; not set on error
+ * @return On success, ptr points past the angle and ec is std::errc{}; on
+ *         error, ptr is first and ec is std::errc::invalid_argument
+ *         (malformed angle) or std::errc::result_out_of_range (minutes or
+ *         seconds not in [0, 60)).
+ */
+std::from_chars_result parse_angle(const char *first, const char *last,
+                                   angle_format f, double &rad) noexcept;
+
+/** @brief Format an angle.
+ *
+ * Degrees and radians are written in fixed notation; dms as degrees,
+ * minutes and seconds separated by blanks, with two-digit minutes and
+ * seconds, e.g. "23 05 02.3456" (seconds are rounded, carrying to minutes
+ * and degrees).
+ *
+ * @param[in] first     Start of the buffer
+ * @param[in] last      End of the buffer
+ * @param[in] rad       The angle [rad]
+ * @param[in] f         The format
+ * @param[in] precision Number of decimal digits (of the seconds, for dms;
+ *                      at most 9)
+ * @param[in] hemi      If not null, the two hemisphere letters for positive
+ *                      and negative angles (e.g. "NS" or "EW"); the
+ *                      absolute value is written, followed by a blank and
+ *                      the letter. Else, negative angles are signed.
+ * @return As for std::to_chars; ec is std::errc::value_too_large if the
+ *         buffer is too small.
+ */
+std::to_chars_result format_angle(char *first, char *last, double rad,
+                                  angle_format f, int precision,
+                                  const char *hemi = nullptr) noexcept;
+
+/** Result of dso::parse_geodetic */
+struct GeodeticParseResult {
+  /** Where parsing stopped; on error, the start of the offending line */
+  const char *ptr;
+  /** std::errc{} on success, else the error of the offending line */
+  std::errc ec;
+  /** Number of records parsed */
+  std::size_t count;
+};
+
+/** @brief Parse records of geodetic coordinates, one per line.
+ *
+ * Each line holds the latitude and the longitude (in format f, see
+ * dso::parse_angle) and the ellipsoidal height [m], separated by blanks or
+ * commas; further fields are ignored. Empty lines and lines starting with
+ * '#' are skipped. Parsing stops after n records, at the end of the buffer
+ * or at the first malformed record.
+ *
+ * @param[in]  first Start of the buffer
+ * @param[in]  last  End of the buffer
+ * @param[in]  f     The format of the latitudes and longitudes
+ * @param[out] crd   The coordinates [rad, rad, m]; size (at least) n
+ * @param[in]  n     Maximum number of records to parse
+ */
+GeodeticParseResult parse_geodetic(const char *first, const char *last,
+                                   angle_format f, GeodeticCrd *crd,
+                                   std::size_t n) noexcept;
+
+/** @brief Format records of geodetic coordinates, one per line.
+ *
+ * Writes the latitude and the longitude (in format f, see
+ * dso::format_angle, with hemisphere letters for dms) and the ellipsoidal
+ * height [m], separated by blanks, i.e. records readable by
+ * dso::parse_geodetic.
+ *
+ * @param[in] first         Start of the buffer
+ * @param[in] last          End of the buffer
+ * @param[in] crd           The coordinates [rad, rad, m]
+ * @param[in] n             Number of records
+ * @param[in] f             The format of the latitudes and longitudes
+ * @param[in] precision     Number of decimal digits of the angles
+ * @param[in] hgt_precision Number of decimal digits of the heights
+ * @return As for std::to_chars; on error (buffer too small), ptr is the
+ *         end of the last complete record.
+ */
+std::to_chars_result format_geodetic(char *first, char *last,
+                                     const GeodeticCrd *crd, std::size_t n,
+                                     angle_format f, int precision,
+                                     int hgt_precision) noexcept;
+
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,80 @@
+/** @file
+ * Tables of the batch (array) kernels, one per instruction set level they
+ * are compiled for (see cpu_dispatch.hpp). Used internally, by the batch
+ * transformations and covariance propagation functions, which forward to
+ * the kernels of the level selected at run time.
+ */
+
+#ifndef __DSO_BATCH_KERNELS_CORE_HPP__
+#define __DSO_BATCH_KERNELS_CORE_HPP__
+
+#include "ellipsoid_core.hpp"
+#include <cstddef>
+
+namespace dso {
+
+namespace core {
+
+namespace kernels {
+
+/** Batch kernels compiled for an instruction set level; see the respective
+ * functions in crd_transformations.hpp and crd_jacobians.hpp for arguments.
+ */
+struct KernelTable {
+  /** dso::core::cartesian2geodetic; returns the number of points on the
+   * polar axis if instrumentation is enabled, else 0 */
+  std::size_t (*cartesian2geodetic)(const EllipsoidConstants &ell,
+                                    const double *x, const double *y,
+                                    const double *z, double *lat, double *lon,
+                                    double *hgt, std::size_t n) noexcept;
+  /** dso::core::geodetic2cartesian */
+  void (*geodetic2cartesian)(const EllipsoidConstants &ell, const double *lat,
+                             const double *lon, const double *hgt, double *x,
+                             double *y, double *z, std::size_t n) noexcept;
+  /** dso::core::geodetic2cartesian_covariance */
+  void (*geodetic2cartesian_covariance)(const EllipsoidConstants &ell,
+                                        const double *lat, const double *lon,
+                                        const double *hgt, const double *cov,
+                                        double *out, std::size_t n) noexcept;
+  /** dso::core::cartesian2geodetic_covariance */
+  void (*cartesian2geodetic_covariance)(const EllipsoidConstants &ell,
+                                        const double *lat, const double *lon,
+                                        const double *hgt, const double *cov,
+                                        double *out, std::size_t n) noexcept;
+  /** dso::cartesian2enu_covariance */
+  void (*cartesian2enu_covariance)(const double *lat, const double *lon,
+                                   const double *cov, double *out,
+                                   std::size_t n) noexcept;
+  /** dso::enu2cartesian_covariance */
+  void (*enu2cartesian_covariance)(const double *lat, const double *lon,
+                                   const double *cov, double *out,
+                                   std::size_t n) noexcept;
+}; /* struct KernelTable */
+
+/** Kernels compiled for the baseline of the target */
+namespace baseline {
+extern const KernelTable table;
+}
+
+#ifdef DSO_GEODESY_X86_KERNELS
+/** Kernels compiled for AVX2 + FMA */
+namespace avx2 {
+extern const KernelTable table;
+}
+
+/** Kernels compiled for AVX-512 */
+namespace avx512 {
+extern const KernelTable table;
+}
+#endif
+
+/** @brief The kernels of the instruction set level currently selected */
+const KernelTable &active() noexcept;
+
+} /* namespace kernels */
+
+} /* namespace core */
+
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,204 @@
+/** @file
+ * Jacobians of the coordinate transformations (in closed form), and
+ * propagation of (3x3) covariance matrices between cartesian, geodetic and
+ * topocentric (ENU) coordinates.
+ *
+ * Covariance matrices are symmetric; they are stored packed, as the 6
+ * elements of their upper triangle, row-major, i.e.
+ * (σxx, σxy, σxz, σyy, σyz, σzz). Batch versions take n such matrices, in
+ * consecutive blocks of 6 doubles.
+ */
+
+#ifndef __DSO_COORDINATE_JACOBIANS_CORE_HPP__
+#define __DSO_COORDINATE_JACOBIANS_CORE_HPP__
+
+#include "crd_transformations.hpp"
+#include <cmath>
+#include <cstddef>
+
+namespace dso {
+
+/** Number of elements of a packed (symmetric) 3x3 covariance matrix */
+constexpr const std::size_t COV_SIZE = 6;
+
+/** @brief Jacobian of dso::spherical2cartesian, i.e. ∂(x,y,z)/∂(r,φ,λ).
+ *
+ * @param[in] r    Radius [m]
+ * @param[in] glat Geocentric latitude [rad]
+ * @param[in] lon  Longitude [rad]
+ */
+inline Eigen::Matrix<double, 3, 3>
+spherical2cartesian_jacobian(double r, double glat, double lon) noexcept {
+  const double sf = std::sin(glat), cf = std::cos(glat);
+  const double sl = std::sin(lon), cl = std::cos(lon);
+  Eigen::Matrix<double, 3, 3> J;
+  J << cf * cl, -r * sf * cl, -r * cf * sl, cf * sl, -r * sf * sl,
+      r * cf * cl, sf, r * cf, 0e0;
+  return J;
+}
+
+/** @brief Jacobian of dso::cartesian2spherical, i.e. ∂(r,φ,λ)/∂(x,y,z),
+ *         given the spherical coordinates of the point.
+ *
+ * The derivatives of the longitude are infinite on the polar axis.
+ *
+ * @param[in] r    Radius [m]
+ * @param[in] glat Geocentric latitude [rad]
+ * @param[in] lon  Longitude [rad]
+ */
+inline Eigen::Matrix<double, 3, 3>
+cartesian2spherical_jacobian(double r, double glat, double lon) noexcept {
+  const double sf = std::sin(glat), cf = std::cos(glat);
+  const double sl = std::sin(lon), cl = std::cos(lon);
+  Eigen::Matrix<double, 3, 3> J;
+  J << cf * cl, cf * sl, sf, -sf * cl / r, -sf * sl / r, cf / r,
+      -sl / (r * cf), cl / (r * cf), 0e0;
+  return J;
+}
+
+/** @brief Jacobian of the transformation from cartesian (ECEF) to
+ *         topocentric (ENU) coordinates, i.e. ∂(e,n,u)/∂(x,y,z) = R^T.
+ * @see dso::geodetic2lvlh
+ */
+inline Eigen::Matrix<double, 3, 3>
+cartesian2enu_jacobian(double lat, double lon) noexcept {
+  return geodetic2lvlh(lat, lon).transpose();
+}
+
+namespace core {
+
+/** @brief Jacobian of dso::geodetic2cartesian, i.e. ∂(x,y,z)/∂(φ,λ,h).
+ *
+ * The columns are the north, east and up unit vectors, scaled by (M + h),
+ * (N + h) cos(φ) and 1, where M and N are the meridional and normal radii
+ * of curvature.
+ *
+ * @param[in] ell Constants of the reference ellipsoid
+ * @param[in] lat Geodetic latitude [rad]
+ * @param[in] lon Geodetic longitude [rad]
+ * @param[in] hgt Ellipsoidal height [m]
+ */
+inline Eigen::Matrix<double, 3, 3>
+geodetic2cartesian_jacobian(const EllipsoidConstants &ell, double lat,
+                            double lon, double hgt) noexcept {
+  const double sf = std::sin(lat), cf = std::cos(lat);
+  const double sl = std::sin(lon), cl = std::cos(lon);
+  const double w2 = 1e0 - ell.e2 * sf * sf;
+  const double Rn = ell.a / std::sqrt(w2);
+  const double Rm = Rn * ell.ep2 / w2;
+  const double m = Rm + hgt, p = (Rn + hgt) * cf;
+  Eigen::Matrix<double, 3, 3> J;
+  J << -m * sf * cl, -p * sl, cf * cl, -m * sf * sl, p * cl, cf * sl, m * cf,
+      0e0, sf;
+  return J;
+}
+
+/** @brief Jacobian of dso::cartesian2geodetic, i.e. ∂(φ,λ,h)/∂(x,y,z),
+ *         given the geodetic coordinates of the point.
+ *
+ * This is the inverse of dso::core::geodetic2cartesian_jacobian; its rows
+ * are the north, east and up unit vectors, divided by (M + h),
+ * (N + h) cos(φ) and 1. The derivatives of the longitude are infinite on
+ * the polar axis.
+ *
+ * @param[in] ell Constants of the reference ellipsoid
+ * @param[in] lat Geodetic latitude [rad]
+ * @param[in] lon Geodetic longitude [rad]
+ * @param[in] hgt Ellipsoidal height [m]
+ */
+inline Eigen::Matrix<double, 3, 3>
+cartesian2geodetic_jacobian(const EllipsoidConstants &ell, double lat,
+                            double lon, double hgt) noexcept {
+  const double sf = std::sin(lat), cf = std::cos(lat);
+  const double sl = std::sin(lon), cl = std::cos(lon);
+  const double w2 = 1e0 - ell.e2 * sf * sf;
+  const double Rn = ell.a / std::sqrt(w2);
+  const double Rm = Rn * ell.ep2 / w2;
+  const double im = 1e0 / (Rm + hgt), ip = 1e0 / ((Rn + hgt) * cf);
+  Eigen::Matrix<double, 3, 3> J;
+  J << -sf * cl * im, -sf * sl * im, cf * im, -sl * ip, cl * ip, 0e0,
+      cf * cl, cf * sl, sf;
+  return J;
+}
+
+/** @brief Propagate a (packed) covariance matrix, i.e. compute J Σ J^T.
+ *
+ * @param[in]  J   The Jacobian of the transformation
+ * @param[in]  cov The covariance matrix Σ, packed (6 elements)
+ * @param[out] out The covariance matrix J Σ J^T, packed (6 elements); may
+ *                 be the same as cov
+ */
+inline void propagate_covariance(const Eigen::Matrix<double, 3, 3> &J,
+                                 const double *cov, double *out) noexcept {
+  Eigen::Matrix<double, 3, 3> S;
+  S << cov[0], cov[1], cov[2], cov[1], cov[3], cov[4], cov[2], cov[4], cov[5];
+  const Eigen::Matrix<double, 3, 3> P = J * S * J.transpose();
+  out[0] = P(0, 0);
+  out[1] = P(0, 1);
+  out[2] = P(0, 2);
+  out[3] = P(1, 1);
+  out[4] = P(1, 2);
+  out[5] = P(2, 2);
+}
+
+/** @brief Propagate covariance matrices from geodetic (φ, λ, h) to
+ *         cartesian (ECEF) coordinates, for a batch of n points.
+ *
+ * Uses fixed-size (closed form) Jacobians and does not allocate.
+ *
+ * @param[in]  ell Constants of the reference ellipsoid
+ * @param[in]  lat Geodetic latitudes of the points [rad]
+ * @param[in]  lon Geodetic longitudes of the points [rad]
+ * @param[in]  hgt Ellipsoidal heights of the points [m]
+ * @param[in]  cov Covariance matrices of (φ, λ, h) [rad², rad m, m²],
+ *                 packed, size 6n
+ * @param[out] out Covariance matrices of (x, y, z) [m²], packed, size 6n;
+ *                 may be the same as cov
+ * @param[in]  n   Number of points
+ */
+void geodetic2cartesian_covariance(const EllipsoidConstants &ell,
+                                   const double *lat, const double *lon,
+                                   const double *hgt, const double *cov,
+                                   double *out, std::size_t n) noexcept;
+
+/** @brief Propagate covariance matrices from cartesian (ECEF) to geodetic
+ *         (φ, λ, h) coordinates, for a batch of n points, given their
+ *         geodetic coordinates (e.g. as computed by the batch
+ *         dso::core::cartesian2geodetic).
+ * @see dso::core::geodetic2cartesian_covariance
+ */
+void cartesian2geodetic_covariance(const EllipsoidConstants &ell,
+                                   const double *lat, const double *lon,
+                                   const double *hgt, const double *cov,
+                                   double *out, std::size_t n) noexcept;
+
+} /* namespace core */
+
+/** @brief Propagate covariance matrices from cartesian (ECEF) to the
+ *         topocentric (ENU) frame at each point, for a batch of n points.
+ *
+ * @param[in]  lat Latitudes of the points (i.e. of the frames' origins)
+ *                 [rad]
+ * @param[in]  lon Longitudes of the points [rad]
+ * @param[in]  cov Covariance matrices of (x, y, z) [m²], packed, size 6n
+ * @param[out] out Covariance matrices of (e, n, u) [m²], packed, size 6n;
+ *                 may be the same as cov
+ * @param[in]  n   Number of points
+ * @see dso::geodetic2lvlh
+ */
+void cartesian2enu_covariance(const double *lat, const double *lon,
+                              const double *cov, double *out,
+                              std::size_t n) noexcept;
+
+/** @brief Propagate covariance matrices from the topocentric (ENU) frame at
+ *         each point to cartesian (ECEF) coordinates, for a batch of n
+ *         points.
+ * @see dso::cartesian2enu_covariance
+ */
+void enu2cartesian_covariance(const double *lat, const double *lon,
+                              const double *cov, double *out,
+                              std::size_t n) noexcept;
+
+} /* namespace dso */
+
+#endif
@@ -6,7 +6,12 @@
 #define __DSO_COORDINATE_TRANSFORMATIONS_CORE_HPP__
 
 #include "eigen3/Eigen/Eigen"
+#include "ellipsoid_core.hpp"
+#include "fastmath.hpp"
 #include "geoconst.hpp"
+#include "instrumentation.hpp"
+#include <cstddef>
+#include <type_traits>
 
 namespace dso {
 
@@ -36,6 +41,89 @@ void cartesian2spherical(double x, double y, double z, double &r, double &glat,
 void spherical2cartesian(double r, double glat, double lon, double &x,
                          double &y, double &z) noexcept;
 
+/** @brief Cartesian to spherical (geographic) coordinates, at a given
+ *         precision tier and/or for a given scalar type.
+ *
+ * @see dso::cartesian2spherical and dso::precision
+ * @tparam P The precision tier; for precision::full, this is the same as
+ *           dso::cartesian2spherical. Tiers other than precision::full are
+ *           only available for double.
+ * @tparam T The scalar type, e.g. double, float or a SIMD pack type (see
+ *           scalar_traits.hpp). For types other than double, the latitude
+ *           is computed as atan2(z, p) rather than asin(z/r), which is
+ *           accurate close to the poles also in single precision.
+ */
+template <precision P = precision::full, typename T>
+inline void cartesian2spherical(core::identity_t<T> x, core::identity_t<T> y,
+                                core::identity_t<T> z, T &r, T &glat,
+                                T &lon) noexcept {
+  static_assert(P == precision::full || std::is_same_v<T, double>,
+                "Precision tiers are only available for double");
+  /* else, counted by the non-template version */
+  if constexpr (P != precision::full || !std::is_same_v<T, double>)
+    instrument::detail::count(instrument::entry::cartesian2spherical,
+                              instrument::detail::lanes<T>);
+  if constexpr (P == precision::full && std::is_same_v<T, double>) {
+    cartesian2spherical(x, y, z, r, glat, lon);
+  } else if constexpr (P == precision::full) {
+    using std::atan2;
+    using std::sqrt;
+    const T p2 = x * x + y * y;
+    r = sqrt(p2 + z * z);
+    lon = atan2(y, x);
+    /* asin(z/r) is ill-conditioned close to the poles, which matters for
+     * single precision */
+    glat = atan2(z, sqrt(p2));
+  } else {
+    r = std::sqrt(x * x + y * y + z * z);
+    lon = core::fastmath::atan2<P>(y, x);
+    glat = core::fastmath::asin<P>(z / r);
+  }
+}
+
+/** @brief Spherical (geographic) to Cartesian coordinates, at a given
+ *         precision tier and/or for a given scalar type.
+ *
+ * @see dso::spherical2cartesian and dso::precision
+ * @tparam P The precision tier; for precision::full, this is the same as
+ *           dso::spherical2cartesian. Tiers other than precision::full are
+ *           only available for double.
+ * @tparam T The scalar type, e.g. double, float or a SIMD pack type (see
+ *           scalar_traits.hpp)
+ */
+template <precision P = precision::full, typename T>
+inline void spherical2cartesian(core::identity_t<T> r,
+                                core::identity_t<T> glat,
+                                core::identity_t<T> lon, T &x, T &y,
+                                T &z) noexcept {
+  static_assert(P == precision::full || std::is_same_v<T, double>,
+                "Precision tiers are only available for double");
+  /* else, counted by the non-template version */
+  if constexpr (P != precision::full || !std::is_same_v<T, double>)
+    instrument::detail::count(instrument::entry::spherical2cartesian,
+                              instrument::detail::lanes<T>);
+  if constexpr (P == precision::full && std::is_same_v<T, double>) {
+    spherical2cartesian(r, glat, lon, x, y, z);
+  } else if constexpr (P == precision::full) {
+    using std::cos;
+    using std::sin;
+    const T sf = sin(glat);
+    const T cf = cos(glat);
+    const T sl = sin(lon);
+    const T cl = cos(lon);
+    x = r * cf * cl;
+    y = r * cf * sl;
+    z = r * sf;
+  } else {
+    double sf, cf, sl, cl;
+    core::fastmath::sincos<P>(glat, sf, cf);
+    core::fastmath::sincos<P>(lon, sl, cl);
+    x = r * cf * cl;
+    y = r * cf * sl;
+    z = r * sf;
+  }
+}
+
 /** Given a point on the ellipsoid/spheroid with (φ,λ), compute topocentric
  *  rotation matrix.
  *
@@ -70,6 +158,211 @@ void spherical2cartesian(double r, double glat, double lon, double &x,
  */
 Eigen::Matrix<double, 3, 3> geodetic2lvlh(double lat, double lon) noexcept;
 
+namespace core {
+
+/** @brief Geodetic (ellipsoidal) to cartesian coordinates.
+ *
+ * @tparam      T    The scalar type, e.g. double, float or a SIMD pack type
+ *                   (see scalar_traits.hpp)
+ * @param[in]   ell  Constants of the reference ellipsoid.
+ * @param[in]   lat  Geodetic latitude (-π/2, π/2) [rad]
+ * @param[in]   lon  Geodetic longtitude in rage (-π, π) [rad]
+ * @param[in]   h    Ellipsoidal height [m]
+ * @param[out]  x    Cartesian x-component [m]
+ * @param[out]  y    Cartesian y-component [m]
+ * @param[out]  z    Cartesian z-component [m]
+ */
+template <typename T>
+inline void geodetic2cartesian(const EllipsoidConstants &ell,
+                               identity_t<T> lat, identity_t<T> lon,
+                               identity_t<T> h, T &x, T &y, T &z) noexcept {
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
+  instrument::detail::count(instrument::entry::geodetic2cartesian,
+                            instrument::detail::lanes<T>);
+
+  /* Trigonometric numbers. */
+  const T sf = sin(lat);
+  const T cf = cos(lat);
+  const T sl = sin(lon);
+  const T cl = cos(lon);
+
+  /* Radius of curvature in the prime vertical (using the cached e^2). */
+  const T Rn = broadcast<T>(ell.a) /
+               sqrt(broadcast<T>(1e0) - broadcast<T>(ell.e2) * sf * sf);
+
+  /* Compute geocentric rectangular coordinates. */
+  x = (Rn + h) * cf * cl;
+  y = (Rn + h) * cf * sl;
+  z = (broadcast<T>(ell.ep2) * Rn + h) * sf;
+
+  /* Finished. */
+  return;
+}
+
+/** @brief Cartesian to geodetic/ellipsoidal.
+ *
+ * Transform cartesian, geocentric coordinates (x, y, z) to ellipsoidal (i.e.
+ * latitude, longtitude, ellispoidal height). All units are meters and
+ * radians.
+ * Fukushima, T., "Transformation from Cartesian to geodetic coordinates
+ * accelerated by Halley's method", J. Geodesy (2006), 79(12): 689-693
+ *
+ * Both the general case and the special case of points on the polar axis
+ * are computed, and the results are selected (per element, for SIMD pack
+ * types).
+ *
+ * @tparam     P    The precision tier (see dso::precision); for tiers
+ *                  other than precision::full, the arc tangents are
+ *                  computed via fast polynomial approximations. Heights are
+ *                  not affected. Tiers other than precision::full are only
+ *                  available for double.
+ * @tparam     T    The scalar type, e.g. double, float or a SIMD pack type
+ *                  (see scalar_traits.hpp)
+ * @param[in]  ell  Constants of the reference ellipsoid.
+ * @param[in]  x    Cartesian x-component (meters)
+ * @param[in]  y    Cartesian y-component (meters)
+ * @param[in]  z    Cartesian z-component (meters)
+ * @param[out] lat  Geodetic latitude (radians)
+ * @param[out] lon  Geodetic longtitude (radians)
+ * @param[out] hgt  Ellipsoidal height (meters)
+ */
+template <precision P = precision::full, typename T>
+inline void cartesian2geodetic(const EllipsoidConstants &ell, identity_t<T> x,
+                               identity_t<T> y, identity_t<T> z, T &lat,
+                               T &lon, T &hgt) noexcept {
+  static_assert(P == precision::full || std::is_same_v<T, double>,
+                "Precision tiers are only available for double");
+  using std::abs;
+  using std::atan;
+  using std::atan2;
+  using std::sqrt;
+  instrument::detail::count(instrument::entry::cartesian2geodetic,
+                            instrument::detail::lanes<T>);
+
+  /* Functions of ellipsoid parameters. */
+  const T a = broadcast<T>(ell.a);
+  const T e2 = broadcast<T>(ell.e2);
+  const T ep = broadcast<T>(ell.ep);
+  const T zero = broadcast<T>(0e0);
+
+  /* Compute distance from polar axis squared. */
+  const T p2 = x * x + y * y;
+
+  /* Compute longitude. */
+  if constexpr (P == precision::full)
+    lon = select(p2 != zero, atan2(y, x), zero);
+  else
+    lon = (p2) ? fastmath::atan2<P>(y, x) : 0e0;
+
+  /* Ensure that Z-coordinate is unsigned. */
+  const T absz = abs(z);
+
+  /* Compute distance from polar axis. */
+  const T p = sqrt(p2);
+  /* Normalize. */
+  const T s0 = absz / a;
+  const T pn = p / a;
+  const T zp = ep * s0;
+  /* Prepare Newton correction factors. */
+  const T c0 = ep * pn;
+  const T c02 = c0 * c0;
+  const T c03 = c02 * c0;
+  const T s02 = s0 * s0;
+  const T s03 = s02 * s0;
+  const T a02 = c02 + s02;
+  const T a0 = sqrt(a02);
+  const T a03 = a02 * a0;
+  const T d0 = zp * a03 + e2 * s03;
+  const T f0 = pn * a03 - e2 * c03;
+  /* Prepare Halley correction factor. */
+  const T b0 = broadcast<T>(ell.e4t) * s02 * c02 * pn * (a0 - ep);
+  const T s1 = d0 * f0 - b0 * s0;
+  const T cp = ep * (f0 * f0 - b0 * c0);
+  /* Evaluate latitude and height. */
+  T phi;
+  if constexpr (P == precision::full)
+    phi = atan(s1 / cp);
+  else
+    phi = fastmath::atan<P>(s1 / cp);
+  const T s12 = s1 * s1;
+  const T cp2 = cp * cp;
+  const T h =
+      (p * cp + absz * s1 - a * sqrt(broadcast<T>(ell.ep2) * s12 + cp2)) /
+      sqrt(s12 + cp2);
+
+  /* Special case: pole (the above yields NaNs on the polar axis). */
+  const auto offaxis = p2 > broadcast<T>(ell.aeps2);
+  if constexpr (instrument::enabled && std::is_arithmetic_v<T>) {
+    if (!offaxis)
+      instrument::detail::count_poles(1);
+  }
+  phi = select(offaxis, phi, broadcast<T>(dso::DPI / 2e0));
+  hgt = select(offaxis, h, absz - broadcast<T>(ell.aep));
+
+  /* Restore sign of latitude. */
+  lat = select(z < zero, -phi, phi);
+
+  /* Finished. */
+  return;
+}
+
+/** @brief Cartesian to geodetic/ellipsoidal coordinates, for a batch of
+ *         points given in structure-of-arrays layout.
+ *
+ * This is the batch version of dso::cartesian2geodetic; the same algorithm
+ * (Fukushima, 2006) is used, but the loop body is branch-free: the special
+ * case of points on (or very close to) the polar axis is handled via
+ * selection rather than branching, and the trigonometric functions are
+ * computed via dso::core::vmath. Hence, the loop can be vectorized; it is
+ * compiled for several instruction sets, selected at run time (see
+ * cpu_dispatch.hpp).
+ * Results agree with the ones of the scalar version to within a couple of
+ * ulp.
+ *
+ * Input and output arrays must not overlap; each must hold (at least) n
+ * elements.
+ *
+ * @param[in]  ell  Constants of the reference ellipsoid.
+ * @param[in]  x    Cartesian x-components [m]
+ * @param[in]  y    Cartesian y-components [m]
+ * @param[in]  z    Cartesian z-components [m]
+ * @param[out] lat  Geodetic latitudes [rad]
+ * @param[out] lon  Geodetic longtitudes [rad]
+ * @param[out] hgt  Ellipsoidal heights [m]
+ * @param[in]  n    Number of points
+ */
+void cartesian2geodetic(const EllipsoidConstants &ell, const double *x,
+                        const double *y, const double *z, double *lat,
+                        double *lon, double *hgt, std::size_t n) noexcept;
+
+/** @brief Geodetic (ellipsoidal) to cartesian coordinates, for a batch of
+ *         points given in structure-of-arrays layout.
+ *
+ * This is the batch version of dso::geodetic2cartesian. The sine and cosine
+ * of each angle are computed once (and at once) via dso::core::vmath::sincos,
+ * hence the loop can be vectorized (for the instruction set selected at run
+ * time, see cpu_dispatch.hpp).
+ *
+ * Input and output arrays must not overlap; each must hold (at least) n
+ * elements.
+ *
+ * @param[in]  ell  Constants of the reference ellipsoid.
+ * @param[in]  lat  Geodetic latitudes [rad]
+ * @param[in]  lon  Geodetic longtitudes [rad]
+ * @param[in]  hgt  Ellipsoidal heights [m]
+ * @param[out] x    Cartesian x-components [m]
+ * @param[out] y    Cartesian y-components [m]
+ * @param[out] z    Cartesian z-components [m]
+ * @param[in]  n    Number of points
+ */
+void geodetic2cartesian(const EllipsoidConstants &ell, const double *lat,
+                        const double *lon, const double *hgt, double *x,
+                        double *y, double *z, std::size_t n) noexcept;
+
+} /* namespace core */
+
 } /* namespace dso */
 
 #endif
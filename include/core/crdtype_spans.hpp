@@ -0,0 +1,391 @@
+/** @file
+ * Span types, i.e. (non-owning) views of N coordinates of a given type,
+ * stored in external buffers.
+ *
+ * Each component (e.g. x, y and z for cartesian coordinates) is described by
+ * a pointer to its first element and a stride, in bytes, i.e. component i of
+ * a span is at (char*)ptr + i * stride. This covers structure-of-arrays
+ * (SoA) layouts (one contiguous column per component, stride = sizeof(T)),
+ * array-of-structures (AoS) layouts (e.g. interleaved x,y,z triplets, stride
+ * = 3 * sizeof(T)) and records holding extra fields (stride = size of the
+ * record), as well as strided columns (e.g. HDF5 hyperslabs).
+ *
+ * Element i of a span is a reference type (e.g. CartesianCrdRefT), which can
+ * be passed to the (scalar) transformations taking coordinate types;
+ * spans themselves can be passed to the batch transformations (see
+ * transformations.hpp), which read and write the spanned memory in place.
+ */
+
+#ifndef __DSO_COORDINATE_TYPE_SPANS_CORE_HPP__
+#define __DSO_COORDINATE_TYPE_SPANS_CORE_HPP__
+
+#include "crdtype_warppers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+namespace dso {
+
+namespace detail {
+
+/** @brief A strided pointer; element i is at (char*)p + i * stride. T may
+ *         be const-qualified.
+ */
+template <typename T> struct StridedPtr {
+  T *p;
+  /* stride in [bytes] */
+  std::ptrdiff_t stride;
+
+  T &operator[](std::size_t i) const noexcept {
+    using B = std::conditional_t<std::is_const_v<T>, const char, char>;
+    return *reinterpret_cast<T *>(reinterpret_cast<B *>(p) +
+                                  static_cast<std::ptrdiff_t>(i) * stride);
+  }
+
+  /** @brief Is the spanned memory contiguous (i.e. an array of T)? */
+  bool contiguous() const noexcept {
+    return stride == static_cast<std::ptrdiff_t>(sizeof(T));
+  }
+
+  /** @brief Do the first n elements of this and of q share any memory? */
+  template <typename S>
+  bool overlaps(const StridedPtr<S> &q, std::size_t n) const noexcept {
+    if (!n)
+      return false;
+    const auto first = [n](auto *ptr, std::ptrdiff_t s) {
+      const char *b = reinterpret_cast<const char *>(ptr);
+      return (s < 0) ? b + static_cast<std::ptrdiff_t>(n - 1) * s : b;
+    };
+    const auto last = [n](auto *ptr, std::ptrdiff_t s, std::size_t sz) {
+      const char *b = reinterpret_cast<const char *>(ptr);
+      return ((s > 0) ? b + static_cast<std::ptrdiff_t>(n - 1) * s : b) + sz;
+    };
+    const std::less<const char *> lt;
+    return lt(first(p, stride), last(q.p, q.stride, sizeof(S))) &&
+           lt(first(q.p, q.stride), last(p, stride, sizeof(T)));
+  }
+};
+
+/** @brief Can a span of T's refer to an array of C's (i.e. coordinate types
+ *         Crd, possibly const-qualified)?
+ */
+template <typename C, typename Crd, typename T>
+constexpr bool spans_array_v =
+    std::is_same_v<std::remove_const_t<C>, Crd> &&
+    (std::is_const_v<T> || !std::is_const_v<C>);
+
+/** @brief The (common) data of all 3-component coordinate spans */
+template <typename T> struct CrdSpan3 {
+  /* The components */
+  StridedPtr<T> c[3];
+  /* Number of coordinates */
+  std::size_t n;
+
+  CrdSpan3(T *p0, std::ptrdiff_t s0, T *p1, std::ptrdiff_t s1, T *p2,
+           std::ptrdiff_t s2, std::size_t size) noexcept
+      : c{{p0, s0}, {p1, s1}, {p2, s2}}, n(size) {}
+
+  /** @brief Is the span given in (contiguous) SoA layout? */
+  bool is_soa() const noexcept {
+    return c[0].contiguous() && c[1].contiguous() && c[2].contiguous();
+  }
+
+  /** @brief Does any component share memory with any component of s? */
+  template <typename S>
+  bool overlaps(const CrdSpan3<S> &s) const noexcept {
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        if (c[i].overlaps(s.c[j], std::min(n, s.n)))
+          return true;
+    return false;
+  }
+};
+
+} /* namespace detail */
+
+/** @brief Reference to the cartesian coordinates of a span element.
+ *         T may be const-qualified.
+ */
+template <typename T> struct CartesianCrdRefT {
+  T &mx, &my, &mz;
+
+  T &x() const noexcept { return mx; }
+  T &y() const noexcept { return my; }
+  T &z() const noexcept { return mz; }
+
+  /** @brief Assign (i.e. write to the spanned memory) */
+  template <typename S>
+  const CartesianCrdRefT &operator=(const CartesianCrdT<S> &v) const noexcept {
+    mx = v.x();
+    my = v.y();
+    mz = v.z();
+    return *this;
+  }
+};
+
+/** @brief Reference to the geodetic coordinates of a span element.
+ *         T may be const-qualified.
+ */
+template <typename T> struct GeodeticCrdRefT {
+  T &mlat, &mlon, &mhgt;
+
+  T &lat() const noexcept { return mlat; }
+  T &lon() const noexcept { return mlon; }
+  T &hgt() const noexcept { return mhgt; }
+
+  /** @brief Assign (i.e. write to the spanned memory) */
+  template <typename S>
+  const GeodeticCrdRefT &operator=(const GeodeticCrdT<S> &v) const noexcept {
+    mlat = v.lat();
+    mlon = v.lon();
+    mhgt = v.hgt();
+    return *this;
+  }
+};
+
+/** @brief Reference to the spherical coordinates of a span element.
+ *         T may be const-qualified.
+ */
+template <typename T> struct SphericalCrdRefT {
+  T &mr, &mlat, &mlon;
+
+  T &r() const noexcept { return mr; }
+  T &lat() const noexcept { return mlat; }
+  T &lon() const noexcept { return mlon; }
+
+  /** @brief Assign (i.e. write to the spanned memory) */
+  template <typename S>
+  const SphericalCrdRefT &operator=(const SphericalCrdT<S> &v) const noexcept {
+    mr = v.r();
+    mlat = v.lat();
+    mlon = v.lon();
+    return *this;
+  }
+};
+
+/** @brief A span of N cartesian coordinates (x, y, z) [m], over external
+ *         memory; T may be const-qualified (i.e. a read-only span).
+ */
+template <typename T> struct CartesianCrdSpanT : detail::CrdSpan3<T> {
+  using reference = CartesianCrdRefT<T>;
+
+  /** @brief Span with a (byte) stride per component */
+  CartesianCrdSpanT(T *x, std::ptrdiff_t sx, T *y, std::ptrdiff_t sy, T *z,
+                    std::ptrdiff_t sz, std::size_t size) noexcept
+      : detail::CrdSpan3<T>(x, sx, y, sy, z, sz, size) {}
+
+  /** @brief Span over (contiguous) arrays, i.e. SoA layout */
+  CartesianCrdSpanT(T *x, T *y, T *z, std::size_t size) noexcept
+      : CartesianCrdSpanT(x, sizeof(T), y, sizeof(T), z, sizeof(T), size) {}
+
+  /** @brief A read-only span, from a writable one */
+  template <typename S, typename = std::enable_if_t<
+                            std::is_same_v<T, const S> && std::is_const_v<T>>>
+  CartesianCrdSpanT(const CartesianCrdSpanT<S> &s) noexcept
+      : detail::CrdSpan3<T>(s.c[0].p, s.c[0].stride, s.c[1].p, s.c[1].stride,
+                            s.c[2].p, s.c[2].stride, s.n) {}
+
+  /** @brief Span over AoS records, i.e. n triplets (x, y, z), the first of
+   *         which starts at xyz, separated by stride bytes (by default,
+   *         consecutive).
+   */
+  static CartesianCrdSpanT aos(T *xyz, std::size_t n,
+                               std::ptrdiff_t stride = 3 * sizeof(T)) noexcept {
+    return CartesianCrdSpanT(xyz, stride, xyz + 1, stride, xyz + 2, stride, n);
+  }
+
+  /** @brief Span over an array of CartesianCrdT's */
+  template <typename C,
+            typename = std::enable_if_t<detail::spans_array_v<
+                C, CartesianCrdT<std::remove_const_t<T>>, T>>>
+  static CartesianCrdSpanT aos(C *p, std::size_t n) noexcept {
+    return aos(&p[0].mv(0), n, sizeof(C));
+  }
+
+  std::size_t size() const noexcept { return this->n; }
+
+  reference operator[](std::size_t i) const noexcept {
+    return {this->c[0][i], this->c[1][i], this->c[2][i]};
+  }
+};
+
+/** @brief A span of N geodetic coordinates (φ, λ, h) [rad, rad, m], over
+ *         external memory; T may be const-qualified.
+ * @see CartesianCrdSpanT
+ */
+template <typename T> struct GeodeticCrdSpanT : detail::CrdSpan3<T> {
+  using reference = GeodeticCrdRefT<T>;
+
+  GeodeticCrdSpanT(T *lat, std::ptrdiff_t slat, T *lon, std::ptrdiff_t slon,
+                   T *hgt, std::ptrdiff_t shgt, std::size_t size) noexcept
+      : detail::CrdSpan3<T>(lat, slat, lon, slon, hgt, shgt, size) {}
+
+  GeodeticCrdSpanT(T *lat, T *lon, T *hgt, std::size_t size) noexcept
+      : GeodeticCrdSpanT(lat, sizeof(T), lon, sizeof(T), hgt, sizeof(T),
+                         size) {}
+
+  template <typename S, typename = std::enable_if_t<
+                            std::is_same_v<T, const S> && std::is_const_v<T>>>
+  GeodeticCrdSpanT(const GeodeticCrdSpanT<S> &s) noexcept
+      : detail::CrdSpan3<T>(s.c[0].p, s.c[0].stride, s.c[1].p, s.c[1].stride,
+                            s.c[2].p, s.c[2].stride, s.n) {}
+
+  static GeodeticCrdSpanT aos(T *llh, std::size_t n,
+                              std::ptrdiff_t stride = 3 * sizeof(T)) noexcept {
+    return GeodeticCrdSpanT(llh, stride, llh + 1, stride, llh + 2, stride, n);
+  }
+
+  template <typename C,
+            typename = std::enable_if_t<detail::spans_array_v<
+                C, GeodeticCrdT<std::remove_const_t<T>>, T>>>
+  static GeodeticCrdSpanT aos(C *p, std::size_t n) noexcept {
+    return aos(&p[0].mv(0), n, sizeof(C));
+  }
+
+  std::size_t size() const noexcept { return this->n; }
+
+  reference operator[](std::size_t i) const noexcept {
+    return {this->c[0][i], this->c[1][i], this->c[2][i]};
+  }
+};
+
+/** @brief A span of N spherical coordinates (r, φ, λ) [m, rad, rad], over
+ *         external memory; T may be const-qualified.
+ * @see CartesianCrdSpanT
+ */
+template <typename T> struct SphericalCrdSpanT : detail::CrdSpan3<T> {
+  using reference = SphericalCrdRefT<T>;
+
+  SphericalCrdSpanT(T *r, std::ptrdiff_t sr, T *lat, std::ptrdiff_t slat,
+                    T *lon, std::ptrdiff_t slon, std::size_t size) noexcept
+      : detail::CrdSpan3<T>(r, sr, lat, slat, lon, slon, size) {}
+
+  SphericalCrdSpanT(T *r, T *lat, T *lon, std::size_t size) noexcept
+      : SphericalCrdSpanT(r, sizeof(T), lat, sizeof(T), lon, sizeof(T), size) {}
+
+  template <typename S, typename = std::enable_if_t<
+                            std::is_same_v<T, const S> && std::is_const_v<T>>>
+  SphericalCrdSpanT(const SphericalCrdSpanT<S> &s) noexcept
+      : detail::CrdSpan3<T>(s.c[0].p, s.c[0].stride, s.c[1].p, s.c[1].stride,
+                            s.c[2].p, s.c[2].stride, s.n) {}
+
+  static SphericalCrdSpanT aos(T *rll, std::size_t n,
+                               std::ptrdiff_t stride = 3 * sizeof(T)) noexcept {
+    return SphericalCrdSpanT(rll, stride, rll + 1, stride, rll + 2, stride, n);
+  }
+
+  template <typename C,
+            typename = std::enable_if_t<detail::spans_array_v<
+                C, SphericalCrdT<std::remove_const_t<T>>, T>>>
+  static SphericalCrdSpanT aos(C *p, std::size_t n) noexcept {
+    return aos(&p[0].mv(0), n, sizeof(C));
+  }
+
+  std::size_t size() const noexcept { return this->n; }
+
+  reference operator[](std::size_t i) const noexcept {
+    return {this->c[0][i], this->c[1][i], this->c[2][i]};
+  }
+};
+
+/* Traits of references and spans; spans are marked by isSpan */
+template <typename T> struct CoordinateTypeTraits<CartesianCrdRefT<T>> {
+  using scalar_type = std::remove_const_t<T>;
+  static constexpr const int isCartesian = true;
+  static constexpr const int isConst = std::is_const_v<T>;
+};
+template <typename T> struct CoordinateTypeTraits<GeodeticCrdRefT<T>> {
+  using scalar_type = std::remove_const_t<T>;
+  static constexpr const int isGeodetic = true;
+  static constexpr const int isConst = std::is_const_v<T>;
+};
+template <typename T> struct CoordinateTypeTraits<SphericalCrdRefT<T>> {
+  using scalar_type = std::remove_const_t<T>;
+  static constexpr const int isSpherical = true;
+  static constexpr const int isConst = std::is_const_v<T>;
+};
+template <typename T> struct CoordinateTypeTraits<CartesianCrdSpanT<T>> {
+  using scalar_type = std::remove_const_t<T>;
+  static constexpr const int isCartesian = true;
+  static constexpr const int isConst = std::is_const_v<T>;
+  static constexpr const int isSpan = true;
+};
+template <typename T> struct CoordinateTypeTraits<GeodeticCrdSpanT<T>> {
+  using scalar_type = std::remove_const_t<T>;
+  static constexpr const int isGeodetic = true;
+  static constexpr const int isConst = std::is_const_v<T>;
+  static constexpr const int isSpan = true;
+};
+template <typename T> struct CoordinateTypeTraits<SphericalCrdSpanT<T>> {
+  using scalar_type = std::remove_const_t<T>;
+  static constexpr const int isSpherical = true;
+  static constexpr const int isConst = std::is_const_v<T>;
+  static constexpr const int isSpan = true;
+};
+
+namespace core {
+
+/** Number of coordinates per block, for batch kernels applied to spans
+ * that are not in (contiguous) SoA layout */
+constexpr const std::size_t SPAN_BLOCK = 256;
+
+/** @brief Apply a batch (SoA) kernel to spans of coordinates.
+ *
+ * If both spans are in SoA layout and do not overlap, the kernel is applied
+ * directly to the spanned memory; else, coordinates are gathered into
+ * (stack) blocks of SPAN_BLOCK coordinates, transformed and scattered to
+ * the output span, so that the kernel still runs on contiguous (and
+ * cache-resident) arrays. Kernels need not support aliased input and
+ * output arrays; spans that overlap (e.g. a transformation in place) always
+ * take the block path.
+ *
+ * @param[in] in  The input span, n coordinates
+ * @param[in] out The output span, (at least) n coordinates; element i of
+ *                out may share memory only with element i of in
+ * @param[in] f   The kernel, with signature f(const double *in0, const
+ *                double *in1, const double *in2, double *out0, double *out1,
+ *                double *out2, std::size_t n)
+ */
+template <typename SI, typename SO, typename F>
+void apply_batch(const SI &in, const SO &out, F &&f) noexcept {
+  const std::size_t n = in.n;
+  if (in.is_soa() && out.is_soa() && !out.overlaps(in)) {
+    f(in.c[0].p, in.c[1].p, in.c[2].p, out.c[0].p, out.c[1].p, out.c[2].p,
+      n);
+    return;
+  }
+  double bi[3][SPAN_BLOCK], bo[3][SPAN_BLOCK];
+  for (std::size_t b = 0; b < n; b += SPAN_BLOCK) {
+    const std::size_t m = std::min(SPAN_BLOCK, n - b);
+    for (int k = 0; k < 3; k++)
+      for (std::size_t i = 0; i < m; i++)
+        bi[k][i] = in.c[k][b + i];
+    f(bi[0], bi[1], bi[2], bo[0], bo[1], bo[2], m);
+    for (int k = 0; k < 3; k++)
+      for (std::size_t i = 0; i < m; i++)
+        out.c[k][b + i] = bo[k][i];
+  }
+}
+
+} /* namespace core */
+
+/* double precision span types */
+using CartesianCrdSpan = CartesianCrdSpanT<double>;
+using CartesianCrdConstSpan = CartesianCrdSpanT<const double>;
+using GeodeticCrdSpan = GeodeticCrdSpanT<double>;
+using GeodeticCrdConstSpan = GeodeticCrdSpanT<const double>;
+using SphericalCrdSpan = SphericalCrdSpanT<double>;
+using SphericalCrdConstSpan = SphericalCrdSpanT<const double>;
+
+/* single precision span types */
+using CartesianCrdSpanf = CartesianCrdSpanT<float>;
+using CartesianCrdConstSpanf = CartesianCrdSpanT<const float>;
+using GeodeticCrdSpanf = GeodeticCrdSpanT<float>;
+using GeodeticCrdConstSpanf = GeodeticCrdSpanT<const float>;
+using SphericalCrdSpanf = SphericalCrdSpanT<float>;
+using SphericalCrdConstSpanf = SphericalCrdSpanT<const float>;
+
+} /* namespace dso */
+
+#endif
@@ -11,206 +11,255 @@
 namespace dso {
 
 namespace detail {
-using Vec3d = Eigen::Matrix<double, 3, 1>;
+template <typename T> using Vec3 = Eigen::Matrix<T, 3, 1>;
+using Vec3d = Vec3<double>;
 } /* namespace detail */
 
-struct CartesianCrd {
+/* Each coordinate type is templated on its scalar type T (i.e. double or
+ * float); the double instantiations are aliased below, as CartesianCrd,
+ * GeodeticCrd, etc., and the float ones as CartesianCrdf, GeodeticCrdf, etc.
+ */
+
+template <typename T> struct CartesianCrdT {
   /* mv = (X,Y,Z) in [m] */
-  detail::Vec3d mv;
+  detail::Vec3<T> mv;
 
-  double x() const noexcept { return mv(0); }
-  double y() const noexcept { return mv(1); }
-  double z() const noexcept { return mv(2); }
-  double &x() noexcept { return mv(0); }
-  double &y() noexcept { return mv(1); }
-  double &z() noexcept { return mv(2); }
+  T x() const noexcept { return mv(0); }
+  T y() const noexcept { return mv(1); }
+  T z() const noexcept { return mv(2); }
+  T &x() noexcept { return mv(0); }
+  T &y() noexcept { return mv(1); }
+  T &z() noexcept { return mv(2); }
 
-  CartesianCrd() noexcept : mv{} {};
+  CartesianCrdT() noexcept : mv{} {};
 
-  explicit CartesianCrd(const detail::Vec3d &vec) noexcept : mv(vec) {};
-  CartesianCrd(double x, double y, double z) noexcept { mv << x, y, z; }
+  explicit CartesianCrdT(const detail::Vec3<T> &vec) noexcept : mv(vec) {};
+  CartesianCrdT(T x, T y, T z) noexcept { mv << x, y, z; }
 };
 
-struct CartesianCrdView {
+template <typename T> struct CartesianCrdViewT {
   /* mv = (X,Y,Z) in [m] */
-  detail::Vec3d &mv;
+  detail::Vec3<T> &mv;
 
-  explicit CartesianCrdView(detail::Vec3d &v) noexcept : mv(v) {};
-  explicit CartesianCrdView(CartesianCrd &v) noexcept : mv(v.mv) {};
+  explicit CartesianCrdViewT(detail::Vec3<T> &v) noexcept : mv(v) {};
+  explicit CartesianCrdViewT(CartesianCrdT<T> &v) noexcept : mv(v.mv) {};
 
-  double x() const noexcept { return mv(0); }
-  double y() const noexcept { return mv(1); }
-  double z() const noexcept { return mv(2); }
-  double &x() noexcept { return mv(0); }
-  double &y() noexcept { return mv(1); }
-  double &z() noexcept { return mv(2); }
+  T x() const noexcept { return mv(0); }
+  T y() const noexcept { return mv(1); }
+  T z() const noexcept { return mv(2); }
+  T &x() noexcept { return mv(0); }
+  T &y() noexcept { return mv(1); }
+  T &z() noexcept { return mv(2); }
 };
 
-struct CartesianCrdConstView {
+template <typename T> struct CartesianCrdConstViewT {
   /* mv = (X,Y,Z) in [m] */
-  const detail::Vec3d &mv;
+  const detail::Vec3<T> &mv;
 
-  explicit CartesianCrdConstView(const detail::Vec3d &v) noexcept : mv(v) {};
-  explicit CartesianCrdConstView(const CartesianCrd &v) noexcept : mv(v.mv) {};
-  explicit CartesianCrdConstView(const CartesianCrdView &v) noexcept
+  explicit CartesianCrdConstViewT(const detail::Vec3<T> &v) noexcept : mv(v) {};
+  explicit CartesianCrdConstViewT(const CartesianCrdT<T> &v) noexcept
+      : mv(v.mv) {};
+  explicit CartesianCrdConstViewT(const CartesianCrdViewT<T> &v) noexcept
       : mv(v.mv) {};
 
-  double x() const noexcept { return mv(0); }
-  double y() const noexcept { return mv(1); }
-  double z() const noexcept { return mv(2); }
+  T x() const noexcept { return mv(0); }
+  T y() const noexcept { return mv(1); }
+  T z() const noexcept { return mv(2); }
 };
 
-struct GeodeticCrd {
+template <typename T> struct GeodeticCrdT {
   /* mv = (φ,λ,h) with φ geodetic lattide and h ellipsoidal height. Units
    * in ([rad], [rad], [m]) and ranges:
    * -π/2 <= φ < π/2
    * -π <= λ < π
    * h Real number
    */
-  detail::Vec3d mv;
-
-  double lat() const noexcept { return mv(0); }
-  double lon() const noexcept { return mv(1); }
-  double hgt() const noexcept { return mv(2); }
-  double &lat() noexcept { return mv(0); }
-  double &lon() noexcept { return mv(1); }
-  double &hgt() noexcept { return mv(2); }
+  detail::Vec3<T> mv;
+
+  T lat() const noexcept { return mv(0); }
+  T lon() const noexcept { return mv(1); }
+  T hgt() const noexcept { return mv(2); }
+  T &lat() noexcept { return mv(0); }
+  T &lon() noexcept { return mv(1); }
+  T &hgt() noexcept { return mv(2); }
 };
 
-struct GeodeticCrdView {
+template <typename T> struct GeodeticCrdViewT {
   /* mv = (φ,λ,h) with φ geodetic lattide and h ellipsoidal height. Units
    * in ([rad], [rad], [m]) and ranges:
    * -π/2 <= φ < π/2
    * -π <= λ < π
    * h Real number
    */
-  detail::Vec3d &mv;
+  detail::Vec3<T> &mv;
 
-  explicit GeodeticCrdView(detail::Vec3d &v) noexcept : mv(v) {};
-  explicit GeodeticCrdView(GeodeticCrd &v) noexcept : mv(v.mv) {};
+  explicit GeodeticCrdViewT(detail::Vec3<T> &v) noexcept : mv(v) {};
+  explicit GeodeticCrdViewT(GeodeticCrdT<T> &v) noexcept : mv(v.mv) {};
 
-  double lat() const noexcept { return mv(0); }
-  double lon() const noexcept { return mv(1); }
-  double hgt() const noexcept { return mv(2); }
-  double &lat() noexcept { return mv(0); }
-  double &lon() noexcept { return mv(1); }
-  double &hgt() noexcept { return mv(2); }
+  T lat() const noexcept { return mv(0); }
+  T lon() const noexcept { return mv(1); }
+  T hgt() const noexcept { return mv(2); }
+  T &lat() noexcept { return mv(0); }
+  T &lon() noexcept { return mv(1); }
+  T &hgt() noexcept { return mv(2); }
 };
 
-struct GeodeticCrdConstView {
+template <typename T> struct GeodeticCrdConstViewT {
   /* mv = (φ,λ,h) with φ geodetic lattide and h ellipsoidal height. Units
    * in ([rad], [rad], [m]) and ranges:
    * -π/2 <= φ < π/2
    * -π <= λ < π
    * h Real number
    */
-  const detail::Vec3d &mv;
+  const detail::Vec3<T> &mv;
 
-  explicit GeodeticCrdConstView(const detail::Vec3d &v) noexcept : mv(v) {};
-  explicit GeodeticCrdConstView(const GeodeticCrd &v) noexcept : mv(v.mv) {};
-  explicit GeodeticCrdConstView(const GeodeticCrdView &v) noexcept
+  explicit GeodeticCrdConstViewT(const detail::Vec3<T> &v) noexcept : mv(v) {};
+  explicit GeodeticCrdConstViewT(const GeodeticCrdT<T> &v) noexcept
+      : mv(v.mv) {};
+  explicit GeodeticCrdConstViewT(const GeodeticCrdViewT<T> &v) noexcept
       : mv(v.mv) {};
 
-  double lat() const noexcept { return mv(0); }
-  double lon() const noexcept { return mv(1); }
-  double hgt() const noexcept { return mv(2); }
+  T lat() const noexcept { return mv(0); }
+  T lon() const noexcept { return mv(1); }
+  T hgt() const noexcept { return mv(2); }
 };
 
-struct SphericalCrd {
+template <typename T> struct SphericalCrdT {
   /* mv = (r,φ,λ) with φ geocentric lattide and r radius. Units
    * in ([rad], [rad], [m]) and ranges:
    * -π/2 <= φ < π/2
    * -π <= λ < π
    * r >= 0
    */
-  detail::Vec3d mv;
-
-  double r() const noexcept { return mv(0); }
-  double lat() const noexcept { return mv(1); }
-  double lon() const noexcept { return mv(2); }
-  double &r() noexcept { return mv(0); }
-  double &lat() noexcept { return mv(1); }
-  double &lon() noexcept { return mv(2); }
+  detail::Vec3<T> mv;
+
+  T r() const noexcept { return mv(0); }
+  T lat() const noexcept { return mv(1); }
+  T lon() const noexcept { return mv(2); }
+  T &r() noexcept { return mv(0); }
+  T &lat() noexcept { return mv(1); }
+  T &lon() noexcept { return mv(2); }
 };
 
-struct SphericalCrdView {
+template <typename T> struct SphericalCrdViewT {
   /* mv = (r,φ,λ) with φ geocentric lattide and r radius. Units
    * in ([rad], [rad], [m]) and ranges:
    * -π/2 <= φ < π/2
    * -π <= λ < π
    * r >= 0
    */
-  detail::Vec3d &mv;
+  detail::Vec3<T> &mv;
 
-  explicit SphericalCrdView(detail::Vec3d &v) noexcept : mv(v) {};
-  explicit SphericalCrdView(SphericalCrd &v) noexcept : mv(v.mv) {};
+  explicit SphericalCrdViewT(detail::Vec3<T> &v) noexcept : mv(v) {};
+  explicit SphericalCrdViewT(SphericalCrdT<T> &v) noexcept : mv(v.mv) {};
 
-  double r() const noexcept { return mv(0); }
-  double lat() const noexcept { return mv(1); }
-  double lon() const noexcept { return mv(2); }
-  double &r() noexcept { return mv(0); }
-  double &lat() noexcept { return mv(1); }
-  double &lon() noexcept { return mv(2); }
+  T r() const noexcept { return mv(0); }
+  T lat() const noexcept { return mv(1); }
+  T lon() const noexcept { return mv(2); }
+  T &r() noexcept { return mv(0); }
+  T &lat() noexcept { return mv(1); }
+  T &lon() noexcept { return mv(2); }
 };
 
-struct SphericalCrdConstView {
+template <typename T> struct SphericalCrdConstViewT {
   /* mv = (r,φ,λ) with φ geocentric lattide and r radius. Units
    * in ([rad], [rad], [m]) and ranges:
    * -π/2 <= φ < π/2
    * -π <= λ < π
    * r >= 0
    */
-  const detail::Vec3d &mv;
+  const detail::Vec3<T> &mv;
 
-  explicit SphericalCrdConstView(const detail::Vec3d &v) noexcept : mv(v) {};
-  explicit SphericalCrdConstView(const SphericalCrd &v) noexcept : mv(v.mv) {};
-  explicit SphericalCrdConstView(const SphericalCrdView &v) noexcept
+  explicit SphericalCrdConstViewT(const detail::Vec3<T> &v) noexcept : mv(v) {};
+  explicit SphericalCrdConstViewT(const SphericalCrdT<T> &v) noexcept
+      : mv(v.mv) {};
+  explicit SphericalCrdConstViewT(const SphericalCrdViewT<T> &v) noexcept
       : mv(v.mv) {};
 
-  double r() const noexcept { return mv(0); }
-  double lat() const noexcept { return mv(1); }
-  double lon() const noexcept { return mv(2); }
+  T r() const noexcept { return mv(0); }
+  T lat() const noexcept { return mv(1); }
+  T lon() const noexcept { return mv(2); }
 };
 
-template <typename T> struct CoordinateTypeTraits {};
+/** @brief Traits of coordinate types.
+ *
+ * Specializations define the kind of coordinates (e.g. isCartesian), whether
+ * the type is a const view (isConst) and the scalar type (scalar_type).
+ */
+template <typename C> struct CoordinateTypeTraits {};
 
-template <> struct CoordinateTypeTraits<CartesianCrd> {
+template <typename T> struct CoordinateTypeTraits<CartesianCrdT<T>> {
+  using scalar_type = T;
   static constexpr const int isCartesian = true;
   static constexpr const int isConst = false;
 };
-template <> struct CoordinateTypeTraits<CartesianCrdView> {
+template <typename T> struct CoordinateTypeTraits<CartesianCrdViewT<T>> {
+  using scalar_type = T;
   static constexpr const int isCartesian = true;
   static constexpr const int isConst = false;
 };
-template <> struct CoordinateTypeTraits<CartesianCrdConstView> {
+template <typename T> struct CoordinateTypeTraits<CartesianCrdConstViewT<T>> {
+  using scalar_type = T;
   static constexpr const int isCartesian = true;
   static constexpr const int isConst = true;
 };
-template <> struct CoordinateTypeTraits<GeodeticCrd> {
+template <typename T> struct CoordinateTypeTraits<GeodeticCrdT<T>> {
+  using scalar_type = T;
   static constexpr const int isGeodetic = true;
   static constexpr const int isConst = false;
 };
-template <> struct CoordinateTypeTraits<GeodeticCrdView> {
+template <typename T> struct CoordinateTypeTraits<GeodeticCrdViewT<T>> {
+  using scalar_type = T;
   static constexpr const int isGeodetic = true;
   static constexpr const int isConst = false;
 };
-template <> struct CoordinateTypeTraits<GeodeticCrdConstView> {
+template <typename T> struct CoordinateTypeTraits<GeodeticCrdConstViewT<T>> {
+  using scalar_type = T;
   static constexpr const int isGeodetic = true;
   static constexpr const int isConst = true;
 };
-template <> struct CoordinateTypeTraits<SphericalCrd> {
+template <typename T> struct CoordinateTypeTraits<SphericalCrdT<T>> {
+  using scalar_type = T;
   static constexpr const int isSpherical = true;
   static constexpr const int isConst = false;
 };
-template <> struct CoordinateTypeTraits<SphericalCrdView> {
+template <typename T> struct CoordinateTypeTraits<SphericalCrdViewT<T>> {
+  using scalar_type = T;
   static constexpr const int isSpherical = true;
   static constexpr const int isConst = false;
 };
-template <> struct CoordinateTypeTraits<SphericalCrdConstView> {
+template <typename T> struct CoordinateTypeTraits<SphericalCrdConstViewT<T>> {
+  using scalar_type = T;
   static constexpr const int isSpherical = true;
   static constexpr const int isConst = true;
 };
 
+/** @brief Scalar type of a coordinate type */
+template <typename C>
+using crd_scalar_t = typename CoordinateTypeTraits<C>::scalar_type;
+
+/* double precision coordinate types */
+using CartesianCrd = CartesianCrdT<double>;
+using CartesianCrdView = CartesianCrdViewT<double>;
+using CartesianCrdConstView = CartesianCrdConstViewT<double>;
+using GeodeticCrd = GeodeticCrdT<double>;
+using GeodeticCrdView = GeodeticCrdViewT<double>;
+using GeodeticCrdConstView = GeodeticCrdConstViewT<double>;
+using SphericalCrd = SphericalCrdT<double>;
+using SphericalCrdView = SphericalCrdViewT<double>;
+using SphericalCrdConstView = SphericalCrdConstViewT<double>;
+
+/* single precision coordinate types */
+using CartesianCrdf = CartesianCrdT<float>;
+using CartesianCrdViewf = CartesianCrdViewT<float>;
+using CartesianCrdConstViewf = CartesianCrdConstViewT<float>;
+using GeodeticCrdf = GeodeticCrdT<float>;
+using GeodeticCrdViewf = GeodeticCrdViewT<float>;
+using GeodeticCrdConstViewf = GeodeticCrdConstViewT<float>;
+using SphericalCrdf = SphericalCrdT<float>;
+using SphericalCrdViewf = SphericalCrdViewT<float>;
+using SphericalCrdConstViewf = SphericalCrdConstViewT<float>;
+
 } /* namespace dso */
 
 #endif
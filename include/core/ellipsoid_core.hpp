@@ -8,6 +8,7 @@
 #ifndef __DSO_ELLIPSOID_GEOMETRY_CORE_HPP__
 #define __DSO_ELLIPSOID_GEOMETRY_CORE_HPP__
 
+#include "scalar_traits.hpp"
 #include <cmath>
 
 namespace dso {
@@ -15,6 +16,40 @@ namespace dso {
 /** @brief core namespace holds the core of ellipsoid-related functions */
 namespace core {
 
+/** @brief Square root, usable in constant expressions.
+ *
+ * std::sqrt is not constexpr (although gcc treats it as such), hence this
+ * function can be used to compute derived ellipsoid constants at compile
+ * time on every compiler. A Newton-Raphson iteration is followed by a
+ * correction step based on the exact residual (Dekker's product), so that
+ * the result is the correctly rounded square root, i.e. it is identical to
+ * the one of std::sqrt.
+ *
+ * @param[in] x A finite, non-negative number
+ * @return \f$ \sqrt{x} \f$
+ */
+inline constexpr double constexpr_sqrt(double x) noexcept {
+  if (!(x > 0e0))
+    return x;
+  /* Newton-Raphson iterations, starting from above; iterates decrease
+   * monotonically until convergence */
+  double r = (x > 1e0) ? x : 1e0;
+  for (;;) {
+    const double rn = 0.5e0 * (r + x / r);
+    if (!(rn < r))
+      break;
+    r = rn;
+  }
+  /* correction via the exact residual x - r*r (Veltkamp splitting) */
+  constexpr const double SPLIT = 134217729e0; /* 2^27 + 1 */
+  const double cr = SPLIT * r;
+  const double rhi = cr - (cr - r);
+  const double rlo = r - rhi;
+  const double p = r * r;
+  const double pe = ((rhi * rhi - p) + 2e0 * rhi * rlo) + rlo * rlo;
+  return r + ((x - p) - pe) / (2e0 * r);
+}
+
 /** @brief Compute the squared eccentricity.
  *
  * Compute the squared (first) eccentricity (i.e. \f$e^2\f$) given the
@@ -63,9 +98,9 @@ inline constexpr double semi_minor(double a, double f) noexcept {
  * @param[in] a Semi-major axis [me]
  * @return Linear eccentricity \f$E\f$
  */
-inline double linear_eccentricity(double a, double f) noexcept {
+inline constexpr double linear_eccentricity(double a, double f) noexcept {
   const double b = semi_minor(a, f);
-  return std::sqrt(a * a - b * b);
+  return constexpr_sqrt(a * a - b * b);
 }
 
 /** @brief Polar radius of curvature
@@ -84,14 +119,25 @@ inline constexpr double polar_radius_of_curvature(double a, double f) noexcept {
 
 /** @brief Compute the normal radius of curvature at a given latitude.
  *
+ * @tparam    T   The scalar type (e.g. double, float or a SIMD pack type)
  * @param[in] a   The ellipsoid's semi-major axis [m]
  * @param[in] f   Flattening
  * @param[in] lat The latitude [rad]
  * @return Normal radius of curvature at lat [m]
  */
+template <typename T>
+inline generic_scalar_t<T> N(double a, double f, T lat) noexcept {
+  using std::sin;
+  using std::sqrt;
+  const T sf = sin(lat);
+  return broadcast<T>(a) /
+         sqrt(broadcast<T>(1e0) -
+              broadcast<T>(eccentricity_squared(f)) * sf * sf);
+}
+
+/** @brief Normal radius of curvature, for a double (or integer) latitude */
 inline double N(double a, double f, double lat) noexcept {
-  const double sf = std::sin(lat);
-  return a / std::sqrt(1e0 - eccentricity_squared(f) * sf * sf);
+  return N<double>(a, f, lat);
 }
 
 namespace detail {
@@ -104,24 +150,38 @@ namespace detail {
  *                we are computing it here, we might as well return it!
  * @return Normal radius of curvature at lat [m]
  */
-inline double N(double a, double f, double lat, double &sinlat) noexcept {
-  sinlat = std::sin(lat);
-  return a / std::sqrt(1e0 - eccentricity_squared(f) * sinlat * sinlat);
+template <typename T>
+inline T N(double a, double f, T lat, T &sinlat) noexcept {
+  using std::sin;
+  using std::sqrt;
+  sinlat = sin(lat);
+  return broadcast<T>(a) /
+         sqrt(broadcast<T>(1e0) -
+              broadcast<T>(eccentricity_squared(f)) * sinlat * sinlat);
 }
 } // namespace detail
 
 /** @brief Compute the meridional radii of curvature at a given latitude.
  *
+ * @tparam    T   The scalar type (e.g. double, float or a SIMD pack type)
  * @param[in] a   The ellipsoid's semi-major axis [m]
  * @param[in] f   Flattening
  * @param[in] lat The latitude in [rad]
  * @return The meridional radius of curvature [m]
  */
+template <typename T>
+inline generic_scalar_t<T> M(double a, double f, T lat) noexcept {
+  T slat;
+  const T Rn = detail::N(a, f, lat, slat);
+  const T e2 = broadcast<T>(eccentricity_squared(f));
+  return Rn *
+         ((broadcast<T>(1e0) - e2) / (broadcast<T>(1e0) - e2 * slat * slat));
+}
+
+/** @brief Meridional radius of curvature, for a double (or integer)
+ *         latitude */
 inline double M(double a, double f, double lat) noexcept {
-  double slat;
-  const double Rn = detail::N(a, f, lat, slat);
-  return Rn * ((1e0 - eccentricity_squared(f)) /
-               (1e0 - eccentricity_squared(f) * slat * slat));
+  return M<double>(a, f, lat);
 }
 
 /** @brief Compute the geocentric latitude, given a geodetic one for a point
@@ -135,12 +195,21 @@ inline double M(double a, double f, double lat) noexcept {
  * poles but at other latitudes they differ by a few minutes of arc.
  * Reference Torge, 2001, Eq. 4.11
  *
+ * @tparam    T   The scalar type (e.g. double, float or a SIMD pack type)
  * @param[in] f   The ellipsoid's flattening [-]
  * @param[in] lat The (geodetic) latitude in [rad]
  * @return The geocentric latitude [rad]
  */
+template <typename T>
+inline generic_scalar_t<T> geocentric_latitude(double f, T lat) noexcept {
+  using std::atan;
+  using std::tan;
+  return atan(broadcast<T>((1e0 - f) * (1e0 - f)) * tan(lat));
+}
+
+/** @brief Geocentric latitude, for a double (or integer) latitude */
 inline double geocentric_latitude(double f, double lat) noexcept {
-  return std::atan((1e0 - f) * (1e0 - f) * std::tan(lat));
+  return geocentric_latitude<double>(f, lat);
 }
 
 /** @brief Compute the parametric or reduced latitude
@@ -151,14 +220,77 @@ inline double geocentric_latitude(double f, double lat) noexcept {
  * of a point P on the ellipsoid at latitude \f$ \phi \f$
  * Reference Torge, 2001, Eq. 4.11
  *
+ * @tparam    T   The scalar type (e.g. double, float or a SIMD pack type)
  * @param[in] f   The ellipsoid's flattening
  * @param[in] lat The (geodetic) latitude in radians
  * @return The parametric or reduced latitude at lat in radians
  */
+template <typename T>
+inline generic_scalar_t<T> reduced_latitude(double f, T lat) noexcept {
+  using std::atan;
+  using std::tan;
+  return atan(broadcast<T>(1e0 - f) * tan(lat));
+}
+
+/** @brief Reduced latitude, for a double (or integer) latitude */
 inline double reduced_latitude(double f, double lat) noexcept {
-  return std::atan((1e0 - f) * std::tan(lat));
+  return reduced_latitude<double>(f, lat);
 }
 
+/** @brief Fundamental and derived geometric constants of an ellipsoid.
+ *
+ * Coordinate transformations (e.g. cartesian to geodetic) need a number of
+ * quantities derived from the semi-major axis and the flattening. This
+ * class computes them once (at construction, which can happen at compile
+ * time on every compiler, see constexpr_sqrt), so that they need not be
+ * recomputed on every call. For the enumerated ellipsoids, see
+ * dso::ellipsoid_constants.
+ */
+struct EllipsoidConstants {
+  /** Semi-major axis [m] */
+  double a;
+  /** Flattening [-] */
+  double f;
+  /** Squared eccentricity \f$ e^2 \f$ */
+  double e2;
+  /** \f$ 1 - e^2 \f$ (not the second eccentricity squared \f$ e'^2 \f$, which
+   * is second_ecc2) */
+  double ep2;
+  /** \f$ \sqrt{1 - e^2} \f$, aka b/a */
+  double ep;
+  /** \f$ a \sqrt{1 - e^2} \f$, aka the semi-minor axis b [m] */
+  double aep;
+  /** \f$ 1.5 e^4 \f$ */
+  double e4t;
+  /** Threshold for the squared distance from the polar axis, below which a
+   * point is considered to lie on the polar axis [m^2] */
+  double aeps2;
+  /** Second eccentricity squared, \f$ e'^2 = e^2 / (1 - e^2) \f$ */
+  double second_ecc2;
+  /** Third flattening \f$ n = f / (2 - f) \f$ */
+  double n;
+  /** Polar radius of curvature \f$ c = a^2 / b \f$ [m] */
+  double c;
+  /** Linear eccentricity \f$ \sqrt{a^2 - b^2} \f$ [m] */
+  double le;
+
+  /** @brief Constructor from the defining parameters.
+   * @param[in] sa Semi-major axis [m]
+   * @param[in] sf Flattening [-]
+   */
+  constexpr EllipsoidConstants(double sa, double sf) noexcept
+      : a(sa), f(sf), e2(eccentricity_squared(sf)),
+        ep2(1e0 - eccentricity_squared(sf)),
+        ep(constexpr_sqrt(1e0 - eccentricity_squared(sf))),
+        aep(sa * constexpr_sqrt(1e0 - eccentricity_squared(sf))),
+        e4t(eccentricity_squared(sf) * eccentricity_squared(sf) * 1.5e0),
+        aeps2(sa * sa * 1e-32),
+        second_ecc2(eccentricity_squared(sf) /
+                    (1e0 - eccentricity_squared(sf))),
+        n(third_flattening(sf)), c(polar_radius_of_curvature(sa, sf)),
+        le(linear_eccentricity(sa, sf)) {}
+}; /* EllipsoidConstants */
+
 } /* namespace core */
 } /* namespace dso */
 
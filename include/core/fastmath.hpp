@@ -0,0 +1,238 @@
+/** @file
+ * Precision tiers for coordinate transformations and the (fast) polynomial
+ * approximations of elementary functions used for each tier.
+ *
+ * Many applications (e.g. visualization, geofencing, screening) only need
+ * coordinates at the millimeter or centimeter level. For these, the
+ * (relatively expensive) libm calls within the transformations can be
+ * replaced by low-degree minimax polynomials, selected at compile time via
+ * the dso::precision template parameter of the transformations.
+ *
+ * Polynomial coefficients were computed via the Remez exchange algorithm,
+ * minimizing the absolute error on the reduced argument range of each
+ * function. Maximum errors (listed in dso::precision_traits) are tested in
+ * the unit tests. The kernels are branch-free, hence also usable within
+ * vectorized loops.
+ */
+
+#ifndef __DSO_FAST_MATH_CORE_HPP__
+#define __DSO_FAST_MATH_CORE_HPP__
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace dso {
+
+/** @brief Precision tiers for coordinate transformations.
+ *
+ * full: Results are computed using libm (i.e. correctly rounded or within
+ *       an ulp) elementary functions.
+ * mm  : Angles are accurate to 1e-10 [rad], i.e. better than 1 [mm] on the
+ *       surface of the Earth.
+ * cm  : Angles are accurate to 2e-9 [rad], i.e. about 1 [cm] on the
+ *       surface of the Earth.
+ */
+enum class precision : char { full, mm, cm };
+
+/** @brief Traits for each precision tier */
+template <precision P> struct precision_traits {
+  /** Maximum error of angles (e.g. latitude, longitude) [rad] */
+  static constexpr const double max_angle_error = 0e0;
+};
+
+template <> struct precision_traits<precision::mm> {
+  /** Maximum error of angles (e.g. latitude, longitude) [rad] */
+  static constexpr const double max_angle_error = 1e-10;
+};
+
+template <> struct precision_traits<precision::cm> {
+  /** Maximum error of angles (e.g. latitude, longitude) [rad] */
+  static constexpr const double max_angle_error = 2e-9;
+};
+
+namespace core {
+
+/** @brief fastmath holds elementary functions for each precision tier.
+ *
+ * For precision::full, the respective libm (i.e. std::) function is called.
+ */
+namespace fastmath {
+
+namespace detail {
+/** @brief The bit pattern of a double, as an integer */
+inline std::int64_t bits(double x) noexcept {
+  std::int64_t i;
+  std::memcpy(&i, &x, sizeof(double));
+  return i;
+}
+
+/** @brief A double from its bit pattern */
+inline double from_bits(std::int64_t i) noexcept {
+  double x;
+  std::memcpy(&x, &i, sizeof(double));
+  return x;
+}
+
+/** @brief Arc tangent of u, for |u| <= tan(π/8).
+ *
+ * Maximum absolute error is 5.2e-12 for precision::mm and 1.6e-10 for
+ * precision::cm.
+ */
+template <precision P> inline double atan_kernel(double u) noexcept {
+  const double z = u * u;
+  if constexpr (P == precision::cm) {
+    return u + u * z *
+                   (-3.3333302982249585e-01 +
+                    z * (1.9997895429214166e-01 +
+                         z * (-1.4234509234807155e-01 +
+                              z * (1.0536120349442290e-01 +
+                                   z * -5.9483631598486644e-02))));
+  } else {
+    return u +
+           u * z *
+               (-3.3333331792256880e-01 +
+                z * (1.9999856201517130e-01 +
+                     z * (-1.4280886053843828e-01 +
+                          z * (1.1032733519850696e-01 +
+                               z * (-8.4170323839231480e-02 +
+                                    z * 4.6331857333243985e-02)))));
+  }
+}
+
+/** @brief Sine and cosine of r, for |r| <= π/4.
+ *
+ * Maximum absolute error is 2.3e-12 (sine) and 5.4e-11 (cosine) for
+ * precision::mm and 1.8e-9 (sine) and 5.4e-11 (cosine) for precision::cm.
+ */
+template <precision P>
+inline void sincos_kernel(double r, double &s, double &c) noexcept {
+  const double z = r * r;
+  if constexpr (P == precision::cm) {
+    s = r + r * z *
+                (-1.6666650669294308e-01 +
+                 z * (8.3319786631604000e-03 + z * -1.9495636237865990e-04));
+  } else {
+    s = r + r * z *
+                (-1.6666666627998986e-01 +
+                 z * (8.3333282387081600e-03 +
+                      z * (-1.9839043768566083e-04 +
+                           z * 2.7160140019528550e-06)));
+  }
+  c = 1e0 + z * (-4.9999999725108374e-01 +
+                 z * (4.1666623324358760e-02 +
+                      z * (-1.3886763794754883e-03 +
+                           z * 2.4390450734098007e-05)));
+}
+} /* namespace detail */
+
+/** @brief Arc tangent of y/x, in range [-π, π], using the signs of the
+ *         arguments to determine the quadrant of the result.
+ *
+ * The arguments are reduced to the first octant, and then to
+ * |u| <= tan(π/8) via atan(t) = π/4 + atan((t-1)/(t+1)); a single division
+ * is performed. Octant selections are expressed as (exact) arithmetic on
+ * 0/1 flags; the flags are computed by comparing the bit patterns of
+ * non-negative doubles (which are ordered as integers). This way the
+ * compiler emits conditional moves instead of branches, which for random
+ * inputs would be mispredicted. Results for zero arguments (including
+ * signed zeros) match the ones of std::atan2.
+ */
+template <precision P> inline double atan2(double y, double x) noexcept {
+  if constexpr (P == precision::full) {
+    return std::atan2(y, x);
+  } else {
+    constexpr const double PIO4 = 7.85398163397448309616e-1;
+    /* tan(π/8) */
+    constexpr const double TPI8 = 4.14213562373095048802e-01;
+    const double ax = std::abs(x);
+    const double ay = std::abs(y);
+    const std::int64_t bx = detail::bits(ax);
+    const std::int64_t by = detail::bits(ay);
+    /* first octant: t = num / den, 0 <= t <= 1 */
+    const std::int64_t swap = by > bx;
+    const double num = detail::from_bits(swap ? bx : by);
+    const double den = detail::from_bits(swap ? by : bx);
+    const std::int64_t mid = detail::bits(num) > detail::bits(TPI8 * den);
+    /* flags (0 or 1) */
+    const double fs = static_cast<double>(swap);
+    const double fm = static_cast<double>(mid);
+    const double fx = static_cast<double>(std::signbit(x));
+    /* reduce to |u| <= tan(π/8); if x = y = 0, then u = 0 */
+    const double fz = static_cast<double>((bx | by) == 0);
+    const double u = (num - fm * den) / (den + fm * num + fz);
+    /* result = m*π/4 + s*atan(u), with m an integer in [0,4] */
+    const double m1 = fm + fs * (2e0 - 2e0 * fm);
+    const double m2 = m1 + fx * (4e0 - 2e0 * m1);
+    const double s2 = (1e0 - 2e0 * fs) * (1e0 - 2e0 * fx);
+    return std::copysign(m2 * PIO4 + s2 * detail::atan_kernel<P>(u), y);
+  }
+}
+
+/** @brief Arc tangent of x, in range [-π/2, π/2]. */
+template <precision P> inline double atan(double x) noexcept {
+  if constexpr (P == precision::full) {
+    return std::atan(x);
+  } else {
+    /* atan(x) = atan2(x, 1) */
+    return atan2<P>(x, 1e0);
+  }
+}
+
+/** @brief Arc sine of x, for x in [-1, 1]; result in range [-π/2, π/2]. */
+template <precision P> inline double asin(double x) noexcept {
+  if constexpr (P == precision::full) {
+    return std::asin(x);
+  } else {
+    /* asin(x) = atan2(x, sqrt(1-x^2)), well-conditioned everywhere */
+    return atan2<P>(x, std::sqrt((1e0 - x) * (1e0 + x)));
+  }
+}
+
+/** @brief Compute the sine and cosine of an angle, at once.
+ *
+ * The argument is reduced to r in [-π/4, π/4] via x = r + q*π/2 (two-part
+ * Cody-Waite reduction); accurate for |x| < 1e5. The quadrant q mod 4 is
+ * read off the bit pattern of the rounded argument, and the results are
+ * mapped to the quadrant via integer selections and sign-bit flips (i.e.
+ * without branches).
+ */
+template <precision P>
+inline void sincos(double x, double &s, double &c) noexcept {
+  if constexpr (P == precision::full) {
+    s = std::sin(x);
+    c = std::cos(x);
+  } else {
+    constexpr const double TWOOPI = 6.36619772367581343076e-01;
+    /* π/2 = PIO2_1 + PIO2_2; the first one holds 33 bits */
+    constexpr const double PIO2_1 = 1.57079632673412561417e+00;
+    constexpr const double PIO2_2 = 6.07710050650619224932e-11;
+    /* 1.5 * 2^52; x + ROUND - ROUND rounds x to the nearest integer */
+    constexpr const double ROUND = 6755399441055744e0;
+    /* x = r + q * π/2; the low bits of t hold q (two's complement) */
+    const double t = x * TWOOPI + ROUND;
+    const double q = t - ROUND;
+    const double r = (x - q * PIO2_1) - q * PIO2_2;
+    const std::int64_t k = detail::bits(t) & 3;
+    double sr, cr;
+    detail::sincos_kernel<P>(r, sr, cr);
+    /* map to quadrant */
+    const std::int64_t sb = detail::bits(sr);
+    const std::int64_t cb = detail::bits(cr);
+    /* all ones if the quadrant is odd, i.e. sine and cosine swap */
+    const std::int64_t odd = -(k & 1);
+    const std::uint64_t sneg = static_cast<std::uint64_t>(k >> 1) << 63;
+    const std::uint64_t cneg = static_cast<std::uint64_t>((k + 1) >> 1) << 63;
+    s = detail::from_bits(((cb & odd) | (sb & ~odd)) ^
+                          static_cast<std::int64_t>(sneg));
+    c = detail::from_bits(((sb & odd) | (cb & ~odd)) ^
+                          static_cast<std::int64_t>(cneg));
+  }
+}
+
+} /* namespace fastmath */
+
+} /* namespace core */
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,252 @@
+/** @file
+ * Core of the geodesic (inverse and direct) problems on the ellipsoid,
+ * following Karney's algorithms.
+ *
+ * Charles F. F. Karney, Algorithms for geodesics, J Geod (2013) 87:43–55
+ *
+ * Series expansions are carried out to order 6 in the third flattening n
+ * (resp. the parameter ε), which yields results accurate to round-off for
+ * |f| < 1/50. The ellipsoid-dependent series coefficients are collected in
+ * dso::core::GeodesicConstants, which can be constructed at compile time.
+ *
+ * This file is derived from geodesic.c, of the C library of GeographicLib,
+ * version 1.52, which is distributed under the following license:
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2012-2021, Charles Karney <charles@karney.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit
+ * persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+ * NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __DSO_GEODESIC_CORE_HPP__
+#define __DSO_GEODESIC_CORE_HPP__
+
+#include "ellipsoid_core.hpp"
+#include "series.hpp"
+#include <cstddef>
+#include <limits>
+
+namespace dso {
+
+namespace core {
+
+namespace detail {
+/** Coefficients of A3 (Karney, 2013, Eq. 24); for each power of ε (from the
+ * highest to the lowest) the coefficients of a polynomial in n, followed by
+ * the denominator */
+inline constexpr const double A3_COEFFS[] = {
+    /* ε^5, polynomial in n of order 0 */
+    -3, 128,
+    /* ε^4, polynomial in n of order 1 */
+    -2, -3, 64,
+    /* ε^3, polynomial in n of order 2 */
+    -1, -3, -1, 16,
+    /* ε^2, polynomial in n of order 2 */
+    3, -1, -2, 8,
+    /* ε^1, polynomial in n of order 1 */
+    1, -1, 2,
+    /* ε^0, polynomial in n of order 0 */
+    1, 1};
+
+/** Coefficients of C3[l] (Karney, 2013, Eq. 25), for l = 1, ..., 5; layout
+ * as for A3_COEFFS */
+inline constexpr const double C3_COEFFS[] = {
+    /* C3[1], ε^5, polynomial in n of order 0 */
+    3, 128,
+    /* C3[1], ε^4, polynomial in n of order 1 */
+    2, 5, 128,
+    /* C3[1], ε^3, polynomial in n of order 2 */
+    -1, 3, 3, 64,
+    /* C3[1], ε^2, polynomial in n of order 2 */
+    -1, 0, 1, 8,
+    /* C3[1], ε^1, polynomial in n of order 1 */
+    -1, 1, 4,
+    /* C3[2], ε^5, polynomial in n of order 0 */
+    5, 256,
+    /* C3[2], ε^4, polynomial in n of order 1 */
+    1, 3, 128,
+    /* C3[2], ε^3, polynomial in n of order 2 */
+    -3, -2, 3, 64,
+    /* C3[2], ε^2, polynomial in n of order 2 */
+    1, -3, 2, 32,
+    /* C3[3], ε^5, polynomial in n of order 0 */
+    7, 512,
+    /* C3[3], ε^4, polynomial in n of order 1 */
+    -10, 9, 384,
+    /* C3[3], ε^3, polynomial in n of order 2 */
+    5, -9, 5, 192,
+    /* C3[4], ε^5, polynomial in n of order 0 */
+    7, 512,
+    /* C3[4], ε^4, polynomial in n of order 1 */
+    -14, 7, 512,
+    /* C3[5], ε^5, polynomial in n of order 0 */
+    21, 2560};
+} /* namespace detail */
+
+/** @brief Constants of an ellipsoid needed to solve geodesic problems.
+ *
+ * Besides derived geometric constants, this holds the coefficients of the
+ * series A3 and C3 (which are polynomials in ε, with coefficients depending
+ * on the third flattening n). These are computed once, at construction,
+ * which can happen at compile time.
+ */
+struct GeodesicConstants {
+  /** Order of the series expansions */
+  static constexpr const int ORDER = 6;
+  /** Number of coefficients of the C3 series */
+  static constexpr const int NC3X = (ORDER * (ORDER - 1)) / 2;
+
+  /** Semi-major axis [m] */
+  double a;
+  /** Flattening [-] */
+  double f;
+  /** \f$ 1 - f \f$ */
+  double f1;
+  /** Squared eccentricity \f$ e^2 \f$ */
+  double e2;
+  /** Second eccentricity squared \f$ e'^2 = e^2 / (1-f)^2 \f$ */
+  double ep2;
+  /** Third flattening \f$ n = f / (2 - f) \f$ */
+  double n;
+  /** Semi-minor axis [m] */
+  double b;
+  /** Threshold on the spherical arc, below which lines are treated as
+   * (really) short in the inverse problem */
+  double etol2;
+  /** Coefficients of A3, as a polynomial in ε (highest power first) */
+  double A3x[ORDER];
+  /** Coefficients of C3[l], l = 1, ..., 5, as polynomials in ε */
+  double C3x[NC3X];
+
+  /** @brief Constructor from the defining parameters.
+   * @param[in] sa Semi-major axis [m]
+   * @param[in] sf Flattening [-]
+   */
+  constexpr GeodesicConstants(double sa, double sf) noexcept
+      : a(sa), f(sf), f1(1e0 - sf), e2(eccentricity_squared(sf)),
+        ep2(eccentricity_squared(sf) / ((1e0 - sf) * (1e0 - sf))),
+        n(third_flattening(sf)), b(semi_minor(sa, sf)), etol2(0e0), A3x{},
+        C3x{} {
+    const double af = (f < 0e0) ? -f : f;
+    etol2 = 0.1e0 * constexpr_sqrt(std::numeric_limits<double>::epsilon()) /
+            constexpr_sqrt((af > 1e-3 ? af : 1e-3) *
+                           (f < 0e0 ? 1e0 : 1e0 - f / 2e0) / 2e0);
+    int o = 0, k = 0;
+    for (int j = ORDER - 1; j >= 0; --j) {
+      const int m = (ORDER - j - 1 < j) ? ORDER - j - 1 : j;
+      A3x[k++] = detail::polyval(m, detail::A3_COEFFS + o, n) /
+                 detail::A3_COEFFS[o + m + 1];
+      o += m + 2;
+    }
+    o = k = 0;
+    for (int l = 1; l < ORDER; ++l) {
+      for (int j = ORDER - 1; j >= l; --j) {
+        const int m = (ORDER - j - 1 < j) ? ORDER - j - 1 : j;
+        C3x[k++] = detail::polyval(m, detail::C3_COEFFS + o, n) /
+                   detail::C3_COEFFS[o + m + 1];
+        o += m + 2;
+      }
+    }
+  }
+}; /* GeodesicConstants */
+
+/** @brief Solve the inverse geodesic problem, i.e. given two points on the
+ *         ellipsoid, compute the length of the geodesic between them and
+ *         the azimuths at its end points.
+ *
+ * The (shortest) geodesic is found via Newton's method on the azimuth at
+ * the first point (Karney, 2013, Sec. 5); the method converges for all
+ * pairs of points, including nearly antipodal ones.
+ *
+ * @param[in]  g    Geodesic constants of the reference ellipsoid
+ * @param[in]  lat1 Geodetic latitude of the first point [rad]
+ * @param[in]  lon1 Longitude of the first point [rad]
+ * @param[in]  lat2 Geodetic latitude of the second point [rad]
+ * @param[in]  lon2 Longitude of the second point [rad]
+ * @param[out] s12  Length of the geodesic [m]
+ * @param[out] azi1 Azimuth (forward) at the first point, in range [-π, π]
+ *                  [rad]
+ * @param[out] azi2 Azimuth (forward) at the second point, in range [-π, π]
+ *                  [rad]
+ */
+void geodesic_inverse(const GeodesicConstants &g, double lat1, double lon1,
+                      double lat2, double lon2, double &s12, double &azi1,
+                      double &azi2) noexcept;
+
+/** @brief Solve the direct geodesic problem, i.e. given a point, an azimuth
+ *         and a distance, compute the end point of the geodesic.
+ *
+ * @param[in]  g    Geodesic constants of the reference ellipsoid
+ * @param[in]  lat1 Geodetic latitude of the first point [rad]
+ * @param[in]  lon1 Longitude of the first point [rad]
+ * @param[in]  azi1 Azimuth at the first point [rad]
+ * @param[in]  s12  Length of the geodesic [m]; can be negative
+ * @param[out] lat2 Geodetic latitude of the end point [rad]
+ * @param[out] lon2 Longitude of the end point, in range [-π, π] [rad]
+ * @param[out] azi2 Azimuth (forward) at the end point, in range [-π, π]
+ *                  [rad]
+ */
+void geodesic_direct(const GeodesicConstants &g, double lat1, double lon1,
+                     double azi1, double s12, double &lat2, double &lon2,
+                     double &azi2) noexcept;
+
+/** @brief Solve the inverse geodesic problem for a batch of point pairs,
+ *         given in structure-of-arrays layout.
+ *
+ * The number of Newton iterations needed differs among pairs, hence each
+ * pair is solved in turn (i.e. the loop is not vectorized); the set up of
+ * the series coefficients is shared by all pairs. Results are identical to
+ * the ones of the single-pair version.
+ *
+ * Input and output arrays must not overlap; each must hold (at least) n
+ * elements.
+ *
+ * @see dso::core::geodesic_inverse
+ */
+void geodesic_inverse(const GeodesicConstants &g, const double *lat1,
+                      const double *lon1, const double *lat2,
+                      const double *lon2, double *s12, double *azi1,
+                      double *azi2, std::size_t n) noexcept;
+
+/** @brief Solve the direct geodesic problem for a batch of points, given in
+ *         structure-of-arrays layout.
+ *
+ * The direct problem needs no iteration; the loop body is branch-free and
+ * trigonometric functions are computed via dso::core::vmath, hence the loop
+ * is vectorized for the instruction set the library is compiled for.
+ * Results agree with the ones of the single-point version to within a
+ * couple of ulp.
+ *
+ * Input and output arrays must not overlap; each must hold (at least) n
+ * elements.
+ *
+ * @see dso::core::geodesic_direct
+ */
+void geodesic_direct(const GeodesicConstants &g, const double *lat1,
+                     const double *lon1, const double *azi1,
+                     const double *s12, double *lat2, double *lon2,
+                     double *azi2, std::size_t n) noexcept;
+
+} /* namespace core */
+
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,205 @@
+/** @file
+ * Optional instrumentation of the coordinate transformations, i.e. per-thread
+ * call counts, number of points processed, timings of batch calls and pole
+ * (special case) hits of cartesian to geodetic transformations.
+ *
+ * Instrumentation is enabled at compile time, by defining
+ * DSO_GEODESY_INSTRUMENT (CMake option GEODESY_INSTRUMENT); else, all hooks
+ * are empty inline functions, i.e. they cost nothing.
+ * When enabled, each thread updates its own counters (no locks or atomic
+ * read-modify-write operations on the hot path); dso::instrument::snapshot
+ * aggregates the counters of all threads.
+ */
+
+#ifndef __DSO_INSTRUMENTATION_HPP__
+#define __DSO_INSTRUMENTATION_HPP__
+
+#include "scalar_traits.hpp"
+#include <cstddef>
+#include <cstdint>
+#ifdef DSO_GEODESY_INSTRUMENT
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace dso {
+
+namespace instrument {
+
+/** Is instrumentation compiled in? */
+#ifdef DSO_GEODESY_INSTRUMENT
+constexpr const bool enabled = true;
+#else
+constexpr const bool enabled = false;
+#endif
+
+/** Instrumented functions */
+enum class entry : unsigned char {
+  /** geodetic2cartesian, for a point (or a SIMD pack of points) */
+  geodetic2cartesian,
+  /** cartesian2geodetic, for a point (or a SIMD pack of points) */
+  cartesian2geodetic,
+  /** cartesian2spherical, for a point (or a SIMD pack of points) */
+  cartesian2spherical,
+  /** spherical2cartesian, for a point (or a SIMD pack of points) */
+  spherical2cartesian,
+  /** geodetic2cartesian, for a batch of points */
+  geodetic2cartesian_batch,
+  /** cartesian2geodetic, for a batch of points */
+  cartesian2geodetic_batch,
+  /** geodetic2cartesian_covariance, for a batch of points */
+  geodetic2cartesian_covariance,
+  /** cartesian2geodetic_covariance, for a batch of points */
+  cartesian2geodetic_covariance,
+  /** cartesian2enu_covariance, for a batch of points */
+  cartesian2enu_covariance,
+  /** enu2cartesian_covariance, for a batch of points */
+  enu2cartesian_covariance
+};
+
+/** Number of instrumented functions */
+constexpr const std::size_t NUM_ENTRIES = 10;
+
+/** @brief Name of an instrumented function */
+const char *name(entry e) noexcept;
+
+/** Statistics of an instrumented function */
+struct EntryStats {
+  /** Number of calls */
+  std::uint64_t calls{0};
+  /** Number of points processed */
+  std::uint64_t points{0};
+  /** Time spent, in ticks (CPU timestamp counter cycles, where available);
+   * only recorded for batch functions */
+  std::uint64_t ticks{0};
+};
+
+/** Aggregated statistics of all threads (including threads that have
+ * exited), since the start of the program.
+ */
+struct Snapshot {
+  EntryStats entries[NUM_ENTRIES];
+  /** Points handled by the pole branch of cartesian2geodetic (scalar and
+   * batch versions) */
+  std::uint64_t pole_hits{0};
+  /** Number of threads that recorded statistics (alive or not) */
+  std::size_t threads{0};
+  /** Ticks per second, i.e. to convert EntryStats::ticks to seconds */
+  double ticks_per_second{0e0};
+
+  const EntryStats &operator[](entry e) const noexcept {
+    return entries[static_cast<std::size_t>(e)];
+  }
+};
+
+/** @brief Aggregate the statistics of all threads.
+ *
+ * Takes a lock, but never blocks the instrumented functions; counters of
+ * threads running concurrently are read as they are at the time of the
+ * call. If instrumentation is not enabled, all statistics are zero.
+ */
+Snapshot snapshot();
+
+/** @brief Statistics between two snapshots, i.e. a - b (except for threads
+ *         and ticks_per_second, which are the ones of a).
+ */
+Snapshot operator-(const Snapshot &a, const Snapshot &b) noexcept;
+
+namespace detail {
+
+/** Number of points in a value of scalar (or SIMD pack) type T */
+template <typename T>
+constexpr const std::uint64_t lanes =
+    sizeof(T) / sizeof(core::value_type_t<T>);
+
+#ifdef DSO_GEODESY_INSTRUMENT
+/** Counters of a thread; written only by the owning thread */
+struct alignas(64) ThreadCounters {
+  std::atomic<std::uint64_t> calls[NUM_ENTRIES];
+  std::atomic<std::uint64_t> points[NUM_ENTRIES];
+  std::atomic<std::uint64_t> ticks[NUM_ENTRIES];
+  std::atomic<std::uint64_t> pole_hits;
+};
+
+/** Allocate and register the counters of the calling thread */
+ThreadCounters *register_thread();
+
+/** Counters of the calling thread (null until its first record) */
+inline thread_local ThreadCounters *tls_counters = nullptr;
+
+inline ThreadCounters &counters() noexcept {
+  ThreadCounters *c = tls_counters;
+  return c ? *c : *register_thread();
+}
+
+/** Add to a counter; single writer, hence no read-modify-write */
+inline void add(std::atomic<std::uint64_t> &c, std::uint64_t v) noexcept {
+  c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+/** Current time, in ticks */
+inline std::uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/** @brief Record a call of e, for n points */
+inline void count(entry e, std::uint64_t n) noexcept {
+  ThreadCounters &c = counters();
+  const std::size_t i = static_cast<std::size_t>(e);
+  add(c.calls[i], 1);
+  add(c.points[i], n);
+}
+
+/** @brief Record n pole hits */
+inline void count_poles(std::uint64_t n) noexcept {
+  add(counters().pole_hits, n);
+}
+
+/** @brief Records a call of a batch function, timed over its lifetime */
+class BatchTimer {
+  entry __e;
+  std::uint64_t __n;
+  std::uint64_t __t0;
+
+public:
+  BatchTimer(const BatchTimer &) = delete;
+  BatchTimer &operator=(const BatchTimer &) = delete;
+  BatchTimer(entry e, std::uint64_t n) noexcept
+      : __e(e), __n(n), __t0(ticks()) {}
+  ~BatchTimer() noexcept {
+    const std::uint64_t t = ticks() - __t0;
+    ThreadCounters &c = counters();
+    const std::size_t i = static_cast<std::size_t>(__e);
+    add(c.calls[i], 1);
+    add(c.points[i], __n);
+    add(c.ticks[i], t);
+  }
+}; /* class BatchTimer */
+#else
+inline void count(entry, std::uint64_t) noexcept {}
+inline void count_poles(std::uint64_t) noexcept {}
+class BatchTimer {
+public:
+  BatchTimer(const BatchTimer &) = delete;
+  BatchTimer &operator=(const BatchTimer &) = delete;
+  BatchTimer(entry, std::uint64_t) noexcept {}
+}; /* class BatchTimer */
+#endif
+
+} /* namespace detail */
+
+} /* namespace instrument */
+
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,96 @@
+/** @file
+ * Helpers to write computations that are generic over the scalar type, i.e.
+ * that can be instantiated with double, float, or SIMD pack types (e.g.
+ * std::experimental::simd).
+ *
+ * Generic code should:
+ * * call math functions unqualified, after a using-declaration for the
+ *   std:: version (e.g. `using std::sqrt; sqrt(x);`), so that the
+ *   functions for pack types are found via argument-dependent lookup,
+ * * create constants via dso::core::broadcast, and
+ * * use dso::core::select instead of branches or the ternary operator, since
+ *   comparisons of pack types yield masks rather than bools.
+ * For the built-in floating point types, all of these compile to the same
+ * code as their plain (non-generic) counterparts.
+ */
+
+#ifndef __DSO_SCALAR_TRAITS_CORE_HPP__
+#define __DSO_SCALAR_TRAITS_CORE_HPP__
+
+#include <type_traits>
+
+namespace dso {
+
+namespace core {
+
+/** @brief Traits of a scalar (or pack) type T.
+ *
+ * value_type is the type of each element, i.e. T itself for built-in types,
+ * or T::value_type for pack types.
+ */
+template <typename T, typename = void> struct scalar_traits {
+  using value_type = T;
+};
+
+template <typename T>
+struct scalar_traits<T, std::void_t<typename T::value_type>> {
+  using value_type = typename T::value_type;
+};
+
+/** @brief Element type of a scalar (or pack) type */
+template <typename T>
+using value_type_t = typename scalar_traits<T>::value_type;
+
+/** @brief T, if it is a floating point type or a pack of floating point
+ *         elements; else, substitution fails.
+ *
+ * Generic functions of an angle (or length) restrict their scalar type with
+ * it, and come with a double overload, so that e.g. integer arguments are
+ * converted to double rather than computed in integer arithmetic.
+ */
+template <typename T>
+using generic_scalar_t =
+    std::enable_if_t<std::is_floating_point_v<value_type_t<T>>, T>;
+
+/** @brief T, in a non-deduced context.
+ *
+ * Used for the input parameters of functions whose scalar type is deduced
+ * from their output (reference) parameters, so that inputs of a different
+ * type (e.g. literals) are converted as for plain double parameters.
+ */
+template <typename T> struct type_identity {
+  using type = T;
+};
+template <typename T> using identity_t = typename type_identity<T>::type;
+
+/** @brief Create a (constant) value of type T from a double.
+ *
+ * For pack types, all elements are set to c (converted to the element
+ * type).
+ */
+template <typename T> constexpr T broadcast(double c) noexcept {
+  return T(static_cast<value_type_t<T>>(c));
+}
+
+/** @brief Select a if m is true, else b. */
+template <typename T>
+inline T select(bool m, const T &a, const T &b) noexcept {
+  return m ? a : b;
+}
+
+/** @brief Select, elementwise, a where the mask m is set, else b.
+ *
+ * Overload for pack types; `where` is found via argument-dependent lookup.
+ */
+template <typename M, typename T>
+inline T select(const M &m, const T &a, const T &b) noexcept {
+  T r(b);
+  where(m, r) = a;
+  return r;
+}
+
+} /* namespace core */
+
+} /* namespace dso */
+
+#endif
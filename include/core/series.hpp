@@ -0,0 +1,88 @@
+/** @file
+ * Evaluation of (truncated) series, shared by the series expansions of
+ * geodesics, meridian arcs and map projections.
+ *
+ * Coefficient tables of such expansions are given as polynomials in some
+ * small (ellipsoid-dependent) parameter, e.g. the third flattening n. These
+ * are evaluated once per ellipsoid (via dso::core::detail::polyval, which is
+ * constexpr), while the resulting trigonometric series are evaluated per
+ * point via Clenshaw summation (dso::core::detail::sin_series), for real or
+ * complex arguments.
+ */
+
+#ifndef __DSO_SERIES_CORE_HPP__
+#define __DSO_SERIES_CORE_HPP__
+
+namespace dso {
+
+namespace core {
+
+namespace detail {
+/** @brief Evaluate the polynomial p[0]*x^N + p[1]*x^(N-1) + ... + p[N], via
+ *         Horner's method; for N < 0, 0 is returned.
+ */
+inline constexpr double polyval(int N, const double *p, double x) noexcept {
+  double y = (N < 0) ? 0e0 : *p++;
+#pragma GCC unroll 8
+  while (--N >= 0)
+    y = y * x + *p++;
+  return y;
+}
+
+/** @brief Evaluate the series sum(c[l] * sin(2 * l * x), l = 1, ..., n) via
+ *         Clenshaw summation, given sin(x) and cos(x); c[0] is unused.
+ *
+ * Only one sine and one cosine evaluation are needed, independent of n. For
+ * a compile-time n the loop is unrolled, hence the function can be used
+ * within vectorized loops.
+ */
+inline double sin_series(double sinx, double cosx, const double *c,
+                         int n) noexcept {
+  c += (n + 1);
+  const double ar = 2e0 * (cosx - sinx) * (cosx + sinx);
+  double y0 = (n & 1) ? *--c : 0e0, y1 = 0e0;
+  n /= 2;
+#pragma GCC unroll 8
+  while (n--) {
+    y1 = ar * y0 - y1 + *--c;
+    y0 = ar * y1 - y0 + *--c;
+  }
+  return 2e0 * sinx * cosx * y0;
+}
+
+/** @brief Evaluate the series sum(c[l] * sin(2 * l * z), l = 1, ..., n) for
+ *         a complex argument z = x + iy, via Clenshaw summation; c[0] is
+ *         unused.
+ *
+ * The argument is given via sin(2x), cos(2x), sinh(2y) and cosh(2y); the
+ * real and imaginary parts of the sum are returned in re and im. As for
+ * sin_series, the function can be used within vectorized loops.
+ */
+inline void sin_series(double sin2x, double cos2x, double sinh2y,
+                       double cosh2y, const double *c, int n, double &re,
+                       double &im) noexcept {
+  /* a = 2 cos(2z) */
+  const double ar = 2e0 * cos2x * cosh2y;
+  const double ai = -2e0 * sin2x * sinh2y;
+  double y0r = 0e0, y0i = 0e0, y1r = 0e0, y1i = 0e0;
+#pragma GCC unroll 8
+  for (int l = n; l > 0; --l) {
+    const double yr = ar * y0r - ai * y0i - y1r + c[l];
+    const double yi = ar * y0i + ai * y0r - y1i;
+    y1r = y0r;
+    y1i = y0i;
+    y0r = yr;
+    y0i = yi;
+  }
+  /* sum = sin(2z) * y0 */
+  const double sr = sin2x * cosh2y, si = cos2x * sinh2y;
+  re = sr * y0r - si * y0i;
+  im = sr * y0i + si * y0r;
+}
+} /* namespace detail */
+
+} /* namespace core */
+
+} /* namespace dso */
+
+#endif
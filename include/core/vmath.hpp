@@ -0,0 +1,371 @@
+/** @file
+ * Branch-free implementations of elementary (trigonometric) functions, meant
+ * to be used within batch (i.e. array) loops.
+ *
+ * Calls to libm functions (e.g. std::atan, std::atan2) inside a loop prevent
+ * the compiler from vectorizing it. The functions defined here are built only
+ * out of arithmetic operations, std::sqrt, std::abs, std::copysign and
+ * (ternary) selections, so that a loop calling them can be auto-vectorized
+ * for the target instruction set (SSE2, AVX2, AVX-512, ...).
+ *
+ * Implementations follow the Cephes Math Library (S. L. Moshier); accuracy
+ * is that of the respective Cephes function, i.e. within a couple of ulp of
+ * the libm result.
+ *
+ * @warning These functions rely on strict IEEE-754 semantics; do not compile
+ *          with -ffast-math (or equivalent), else the rounding tricks used
+ *          here will be optimized away.
+ */
+
+#ifndef __DSO_VECTORIZABLE_MATH_CORE_HPP__
+#define __DSO_VECTORIZABLE_MATH_CORE_HPP__
+
+#include "fastmath.hpp"
+#include <cmath>
+#include <cstdint>
+
+namespace dso {
+
+namespace core {
+
+/** @brief vmath holds branch-free (vectorizable) elementary functions */
+namespace vmath {
+
+/** @brief Arc tangent of x, in range [-π/2, π/2].
+ *
+ * The argument is reduced to |x| <= 0.66 via the identities
+ * atan(x) = π/2 - atan(1/x) and atan(x) = π/4 + atan((x-1)/(x+1)); all
+ * reductions are computed and the correct one is selected (no branches).
+ * A rational approximation of degree 4/5 is then used.
+ *
+ * @param[in] x Argument
+ * @return The arc tangent of x [rad]
+ */
+inline double atan(double x) noexcept {
+  /* tan(3π/8) */
+  constexpr const double T3P8 = 2.41421356237309504880e0;
+  constexpr const double PIO2 = 1.57079632679489661923e0;
+  constexpr const double PIO4 = 7.85398163397448309616e-1;
+  /* π/2 = PIO2 + MOREBITS (to higher precision) */
+  constexpr const double MOREBITS = 6.123233995736765886130e-17;
+
+  const double ax = std::abs(x);
+  const bool big = ax > T3P8;
+  const bool mid = ax > 0.66e0;
+
+  /* reduced argument and offset */
+  const double xb = -1e0 / ax;
+  const double xm = (ax - 1e0) / (ax + 1e0);
+  const double xr = big ? xb : (mid ? xm : ax);
+  const double y0 = big ? PIO2 : (mid ? PIO4 : 0e0);
+  const double mb = big ? MOREBITS : (mid ? 0.5e0 * MOREBITS : 0e0);
+
+  /* rational approximation */
+  const double z = xr * xr;
+  const double p = (((-8.750608600031904122785e-1 * z -
+                      1.615753718733365076637e1) *
+                         z -
+                     7.500855792314704667340e1) *
+                        z -
+                    1.228866684490136173410e2) *
+                       z -
+                   6.485021904942025371773e1;
+  const double q = ((((z + 2.485846490142306297962e1) * z +
+                      1.650270098316988542046e2) *
+                         z +
+                     4.328810604912902668951e2) *
+                        z +
+                    4.853903996359136964868e2) *
+                       z +
+                   1.945506571482613964425e2;
+
+  const double r = y0 + ((xr * (z * p / q) + xr) + mb);
+  return std::copysign(r, x);
+}
+
+namespace detail {
+/** @brief Error-free transformation of a sum, i.e. a + b = s + e exactly.
+ *  Knuth, TAOCP Vol. 2
+ */
+inline void two_sum(double a, double b, double &s, double &e) noexcept {
+  s = a + b;
+  const double bb = s - a;
+  e = (a - (s - bb)) + (b - bb);
+}
+
+/** @brief Error-free transformation of a product, i.e. a * b = p + e
+ *  exactly. If the target supports FMA instructions, these are used; else,
+ *  Veltkamp splitting is used.
+ *  Dekker, T.J., A floating-point technique for extending the available
+ *  precision, Numer. Math. (1971), 18: 224-242
+ */
+inline void two_prod(double a, double b, double &p, double &e) noexcept {
+  p = a * b;
+#if defined(__FMA__)
+  e = std::fma(a, b, -p);
+#else
+  constexpr const double SPLIT = 134217729e0; /* 2^27 + 1 */
+  const double ca = SPLIT * a;
+  const double ahi = ca - (ca - a);
+  const double alo = a - ahi;
+  const double cb = SPLIT * b;
+  const double bhi = cb - (cb - b);
+  const double blo = b - bhi;
+  e = ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo;
+#endif
+}
+} /* namespace detail */
+
+/** @brief Arc tangent of y/x, using the signs of the arguments to determine
+ *         the quadrant of the result.
+ *
+ * The arguments are reduced to the first octant via symmetries, and then to
+ * |u| <= tan(π/8) via atan(t) = π/4 + atan((t-1)/(t+1)). The reduced argument
+ * and the final summation are carried out in double-double arithmetic, so
+ * that the result is (nearly) correctly rounded, i.e. it is of the same
+ * quality as std::atan2. This is important for longitudes close to ±π.
+ * Results (including signed zeros and the case x=y=0) match the ones of
+ * std::atan2; result is in range [-π, π].
+ *
+ * @warning Infinite arguments and arguments with magnitude > 1e300 are not
+ *          supported (a NaN is returned).
+ *
+ * @param[in] y Numerator
+ * @param[in] x Denominator
+ * @return The arc tangent of y/x [rad]
+ */
+inline double atan2(double y, double x) noexcept {
+  constexpr const double PI = 3.14159265358979323846e0;
+  /* π/4 = PIO4_HI + PIO4_LO; PIO4_HI has (at least) three trailing zero
+   * bits, hence m*PIO4_HI is exact for m = 0,...,4 */
+  constexpr const double PIO4_HI = 7.85398163397448279e-01;
+  constexpr const double PIO4_LO = 3.061616997868383e-17;
+  /* tan(π/8) */
+  constexpr const double TPI8 = 4.14213562373095048802e-01;
+
+  const double ax = std::abs(x);
+  const double ay = std::abs(y);
+
+  /* first octant: t = num / den, 0 <= t <= 1 */
+  const bool swap = ay > ax;
+  const double num = swap ? ax : ay;
+  const double den = swap ? ay : ax;
+
+  /* reduce to |u| <= tan(π/8), keeping track of rounding errors */
+  const bool mid = num > TPI8 * den;
+  double sh, sl, dh, dl;
+  detail::two_sum(num, den, dh, dl);
+  detail::two_sum(num, -den, sh, sl);
+  const double nh = mid ? sh : num;
+  const double nl = mid ? sl : 0e0;
+  const double dh_ = mid ? dh : den;
+  const double dl_ = mid ? dl : 0e0;
+
+  /* u + ulo = (nh + nl) / (dh_ + dl_) */
+  const double u = nh / dh_;
+  double ph, pl;
+  detail::two_prod(u, dh_, ph, pl);
+  const double ulo = ((((nh - ph) - pl) + nl) - u * dl_) / dh_;
+
+  /* atan(u + ulo) = u + corr + ulo / (1 + u^2) */
+  const double z = u * u;
+  const double p = (((-8.750608600031904122785e-1 * z -
+                      1.615753718733365076637e1) *
+                         z -
+                     7.500855792314704667340e1) *
+                        z -
+                    1.228866684490136173410e2) *
+                       z -
+                   6.485021904942025371773e1;
+  const double q = ((((z + 2.485846490142306297962e1) * z +
+                      1.650270098316988542046e2) *
+                         z +
+                     4.328810604912902668951e2) *
+                        z +
+                    4.853903996359136964868e2) *
+                       z +
+                   1.945506571482613964425e2;
+  const double corr = u * (z * p / q) + (ulo - ulo * z);
+
+  /* result = m*π/4 + s*atan(u+ulo), with m an integer in [0,4] */
+  const double m0 = mid ? 1e0 : 0e0;
+  const double m1 = swap ? 2e0 - m0 : m0;
+  const double m2 = (x < 0e0) ? 4e0 - m1 : m1;
+  const double s1 = swap ? -1e0 : 1e0;
+  const double s2 = (x < 0e0) ? -s1 : s1;
+
+  double th, tl;
+  detail::two_sum(m2 * PIO4_HI, s2 * u, th, tl);
+  const double theta = th + (tl + (m2 * PIO4_LO + s2 * corr));
+  const double r = std::copysign(theta, y);
+
+  /* both arguments are zero */
+  const double rz = (std::copysign(1e0, x) < 0e0) ? std::copysign(PI, y)
+                                                  : std::copysign(0e0, y);
+  return (x == 0e0 && y == 0e0) ? rz : r;
+}
+
+/** @brief Compute the sine and cosine of an angle, at once.
+ *
+ * The argument is reduced to r in [-π/4, π/4] via x = r + q*π/2, using a
+ * three-part (Cody-Waite) representation of π/2; the integer q is computed
+ * via rounding (no integer conversions), hence the function is vectorizable
+ * for any target. sin(r) and cos(r) are then computed via the polynomial
+ * kernels of fdlibm (Sun Microsystems).
+ *
+ * @warning The argument reduction is accurate for |x| < 1e5; for larger
+ *          arguments accuracy degrades.
+ *
+ * @param[in]  x Angle [rad]
+ * @param[out] s The sine of x
+ * @param[out] c The cosine of x
+ */
+inline void sincos(double x, double &s, double &c) noexcept {
+  constexpr const double TWOOPI = 6.36619772367581343076e-01;
+  /* π/2 = PIO2_1 + PIO2_2 + PIO2_3; the first two hold 33 bits */
+  constexpr const double PIO2_1 = 1.57079632673412561417e+00;
+  constexpr const double PIO2_2 = 6.07710050630396597660e-11;
+  constexpr const double PIO2_3 = 2.02226624871116645580e-21;
+  /* 1.5 * 2^52; x + ROUND - ROUND rounds x to the nearest integer */
+  constexpr const double ROUND = 6755399441055744e0;
+
+  /* x = r + q * π/2 */
+  const double q = (x * TWOOPI + ROUND) - ROUND;
+  const double r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+
+  /* quadrant, i.e. q mod 4 (as floating point number) */
+  const double q4 = ((q * 0.25e0 - 0.375e0) + ROUND) - ROUND;
+  const double k = q - 4e0 * q4;
+
+  /* sine and cosine of r */
+  const double z = r * r;
+  const double sr =
+      r + r * z *
+              (-1.66666666666666324348e-01 +
+               z * (8.33333333332248946124e-03 +
+                    z * (-1.98412698298579493134e-04 +
+                         z * (2.75573137070700676789e-06 +
+                              z * (-2.50507602534068634195e-08 +
+                                   z * 1.58969099521155010221e-10)))));
+  const double pc =
+      z * z *
+      (4.16666666666666019037e-02 +
+       z * (-1.38888888888741095749e-03 +
+            z * (2.48015872894767294178e-05 +
+                 z * (-2.75573143513906633035e-07 +
+                      z * (2.08757232129817482790e-09 +
+                           z * -1.13596475577881948265e-11)))));
+  const double hz = 0.5e0 * z;
+  const double w = 1e0 - hz;
+  const double cr = w + (((1e0 - w) - hz) + pc);
+
+  /* map to quadrant */
+  const bool odd = (k == 1e0) || (k == 3e0);
+  const double s0 = odd ? cr : sr;
+  const double c0 = odd ? sr : cr;
+  s = (k >= 2e0) ? -s0 : s0;
+  c = (k == 1e0 || k == 2e0) ? -c0 : c0;
+}
+
+/** @brief Exponential function, for |x| < 708.
+ *
+ * The argument is reduced to r in [-ln2/2, ln2/2] via x = r + k*ln2 (two-part
+ * Cody-Waite reduction); exp(r) is computed via the rational approximation
+ * of fdlibm (Sun Microsystems), and scaled by 2^k, which is assembled
+ * directly in the exponent bits. The integer k is read off the bit pattern
+ * of the rounded argument (no conversions), hence the function is
+ * vectorizable for any target.
+ *
+ * @param[in] x Argument, |x| < 708
+ * @return $ e^x $
+ */
+inline double exp(double x) noexcept {
+  constexpr const double LOG2E = 1.44269504088896338700e+00;
+  /* ln2 = LN2_HI + LN2_LO; LN2_HI holds 32 bits, hence k*LN2_HI is exact */
+  constexpr const double LN2_HI = 6.93147180369123816490e-01;
+  constexpr const double LN2_LO = 1.90821492927058770002e-10;
+  /* 1.5 * 2^52; x + ROUND - ROUND rounds x to the nearest integer */
+  constexpr const double ROUND = 6755399441055744e0;
+
+  /* x = r + k * ln2; the low bits of t hold k (two's complement) */
+  const double t = x * LOG2E + ROUND;
+  const double k = t - ROUND;
+  const double r = (x - k * LN2_HI) - k * LN2_LO;
+
+  /* exp(r) */
+  const double z = r * r;
+  const double c =
+      r - z * (1.66666666666666019037e-01 +
+               z * (-2.77777777770155933842e-03 +
+                    z * (6.61375632143793436117e-05 +
+                         z * (-1.65339022054652515390e-06 +
+                              z * 4.13813679705723846039e-08))));
+  const double er = 1e0 - ((r * c) / (c - 2e0) - r);
+
+  /* 2^k */
+  const std::uint64_t kb = static_cast<std::uint64_t>(
+      fastmath::detail::bits(t) - fastmath::detail::bits(ROUND));
+  return er * fastmath::detail::from_bits(
+                  static_cast<std::int64_t>((kb + 1023) << 52));
+}
+
+/** @brief Natural logarithm of 1 + x, for x > -1 (and 1 + x a finite,
+ *         normal number).
+ *
+ * u = 1 + x is split as u = m * 2^k, with m in [sqrt(1/2), sqrt(2)), via
+ * integer arithmetic on the bit pattern of u (logical shifts only); log(m)
+ * is computed via the polynomial of fdlibm (Sun Microsystems). The rounding
+ * error of 1 + x is corrected for, so that results are accurate (within a
+ * couple of ulp) also for tiny x.
+ *
+ * @param[in] x Argument, x > -1
+ * @return $ \ln(1+x) $
+ */
+inline double log1p(double x) noexcept {
+  constexpr const double LN2_HI = 6.93147180369123816490e-01;
+  constexpr const double LN2_LO = 1.90821492927058770002e-10;
+  constexpr const double ROUND = 6755399441055744e0;
+  /* bit pattern of sqrt(1/2) */
+  constexpr const std::uint64_t SQRTH = 0x3fe6a09e667f3bcdULL;
+  constexpr const std::uint64_t ONE = 0x3ff0000000000000ULL;
+
+  const double u = 1e0 + x;
+  /* rounding error of u, i.e. u = 1 + x + cu */
+  const double cu = (u - 1e0) - x;
+
+  /* u = m * 2^k; kb = k + 1023 (non-negative) */
+  const std::uint64_t ib =
+      static_cast<std::uint64_t>(fastmath::detail::bits(u));
+  const std::uint64_t kb = (ib - SQRTH + ONE) >> 52;
+  const double m = fastmath::detail::from_bits(
+      static_cast<std::int64_t>(ib - (kb << 52) + ONE));
+  const double k =
+      (fastmath::detail::from_bits(static_cast<std::int64_t>(
+           static_cast<std::uint64_t>(fastmath::detail::bits(ROUND)) + kb)) -
+       ROUND) -
+      1023e0;
+
+  /* log(m) = f - hfsq + s * (hfsq + R) */
+  const double f = m - 1e0;
+  const double hfsq = 0.5e0 * f * f;
+  const double s = f / (2e0 + f);
+  const double z = s * s;
+  const double R =
+      z * (6.666666666666735130e-01 +
+           z * (3.999999999940941908e-01 +
+                z * (2.857142874366239149e-01 +
+                     z * (2.222219843214978396e-01 +
+                          z * (1.818357216161805012e-01 +
+                               z * (1.531383769920937332e-01 +
+                                    z * 1.479819860511658591e-01))))));
+  const double logu =
+      k * LN2_HI - ((hfsq - (s * (hfsq + R) + k * LN2_LO)) - f);
+  return logu - cu / u;
+}
+
+} /* namespace vmath */
+
+} /* namespace core */
+} /* namespace dso */
+
+#endif
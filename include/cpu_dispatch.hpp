@@ -0,0 +1,60 @@
+/** @file
+ * Run-time selection of the instruction set used by the batch (array)
+ * kernels, i.e. the batch coordinate transformations and covariance
+ * propagation.
+ *
+ * The kernels are compiled for several instruction set levels; the best one
+ * supported by the CPU is selected once, when the library is loaded. The
+ * selection can be overridden via the environment variable DSO_GEODESY_SIMD
+ * (one of "baseline", "sse2", "avx2", "avx512"; read at load time) or via
+ * dso::set_simd_level.
+ *
+ * All levels give bitwise identical results (floating point contraction is
+ * disabled for all of them), hence results do not depend on the machine the
+ * program runs on.
+ */
+
+#ifndef __DSO_GEODESY_CPU_DISPATCH_HPP__
+#define __DSO_GEODESY_CPU_DISPATCH_HPP__
+
+#include <system_error>
+
+namespace dso {
+
+/** Instruction set levels the batch kernels are compiled for */
+enum class SimdLevel : unsigned char {
+  /** The baseline of the target (SSE2 on x86-64); always available */
+  baseline,
+  /** AVX2 and FMA (x86-64 only) */
+  avx2,
+  /** AVX-512 F/DQ/VL, with 512-bit vectors (x86-64 only) */
+  avx512
+};
+
+/** @brief Name of an instruction set level, e.g. "avx2" */
+const char *simd_level_name(SimdLevel l) noexcept;
+
+/** @brief Can the batch kernels use level l on this machine? I.e. is l
+ *         compiled in and supported by the CPU (and operating system)?
+ */
+bool simd_level_available(SimdLevel l) noexcept;
+
+/** @brief The best instruction set level available on this machine */
+SimdLevel max_simd_level() noexcept;
+
+/** @brief The instruction set level currently used by the batch kernels */
+SimdLevel simd_level() noexcept;
+
+/** @brief Set the instruction set level used by the batch kernels.
+ *
+ * Takes effect for batch calls that start after this function returns;
+ * calls running concurrently complete with the previous level.
+ *
+ * @return std::errc{} on success, or std::errc::not_supported if level l is
+ *         not available (in which case the current level is kept).
+ */
+std::errc set_simd_level(SimdLevel l) noexcept;
+
+} /* namespace dso */
+
+#endif
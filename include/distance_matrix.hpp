@@ -0,0 +1,176 @@
+/** @file
+ * All-pairs distance matrices for networks of stations.
+ *
+ * Stations are converted once (at construction of a dso::StationNetwork) to
+ * cartesian (ECEF) coordinates, unit vectors and geodetic coordinates, in
+ * structure-of-arrays layout; the matrix is then computed in square tiles
+ * (so that the data of a tile stays in cache), with vectorized inner loops
+ * and, optionally, tiles processed in parallel.
+ *
+ * Since distances are symmetric, only the pairs i < j are computed; the
+ * matrix is stored either in full (both triangles and the zero diagonal) or
+ * as its packed upper triangle (see dso::matrix_storage).
+ */
+
+#ifndef __DSO_DISTANCE_MATRIX_HPP__
+#define __DSO_DISTANCE_MATRIX_HPP__
+
+#include "core/crdtype_warppers.hpp"
+#include "core/geodesic_core.hpp"
+#include "ellipsoid.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace dso {
+
+/** Distance between two stations */
+enum class distance_metric : char {
+  /** Euclidean (straight line) distance between the ECEF positions */
+  chord,
+  /** Great circle distance on a sphere of radius StationNetwork::radius(),
+   * between the geocentric directions of the stations */
+  great_circle,
+  /** Geodesic distance on the ellipsoid, between the stations' footpoints
+   * (i.e. heights are ignored) */
+  geodesic
+};
+
+/** Storage of an n x n (symmetric) distance matrix */
+enum class matrix_storage : char {
+  /** All n*n elements, row-major */
+  full,
+  /** The n*(n-1)/2 elements above the diagonal, packed row-major, i.e.
+   * (0,1), (0,2), ..., (0,n-1), (1,2), ...; see dso::upper_index */
+  upper
+};
+
+/** @brief Number of elements of an n x n distance matrix, for the given
+ *         storage.
+ */
+inline std::size_t matrix_size(std::size_t n, matrix_storage s) noexcept {
+  return (s == matrix_storage::full) ? n * n : n * (n - (n > 0)) / 2;
+}
+
+/** @brief Position of element (i, j), i < j, in the packed upper triangle of
+ *         an n x n matrix (i.e. matrix_storage::upper).
+ */
+inline std::size_t upper_index(std::size_t n, std::size_t i,
+                               std::size_t j) noexcept {
+  return i * n - i * (i + 1) / 2 + (j - i - 1);
+}
+
+namespace detail {
+/** The (read-only) data of a StationNetwork, as seen by the distance kernels
+ * (defined in the implementation) */
+struct NetworkView;
+} /* namespace detail */
+
+/** @class StationNetwork
+ *
+ * A network of stations, prepared for the computation of (all-pairs)
+ * distances. Stations are identified by their index in the input.
+ *
+ * Distance matrices are computed in tiles of TILE x TILE station pairs.
+ * Chord and great circle distances are computed with vectorized loops; the
+ * geodesic distance requires an (iterative) solution of the inverse
+ * geodesic problem per pair, and is hence much slower.
+ */
+class StationNetwork {
+public:
+  /** Size (rows and columns) of a tile of the distance matrix */
+  static constexpr const std::size_t TILE = 64;
+
+  /** @brief Constructor from cartesian (ECEF) coordinates, given in
+   *         structure-of-arrays layout.
+   * @param[in] e The reference ellipsoid
+   * @param[in] x Cartesian x-components, size n [m]
+   * @param[in] y Cartesian y-components, size n [m]
+   * @param[in] z Cartesian z-components, size n [m]
+   * @param[in] n Number of stations
+   */
+  StationNetwork(const Ellipsoid &e, const double *x, const double *y,
+                 const double *z, std::size_t n);
+
+  /** @brief Constructor from cartesian (ECEF) coordinates. */
+  StationNetwork(const Ellipsoid &e, const std::vector<CartesianCrd> &sta);
+
+  /** @brief Constructor from geodetic coordinates. */
+  StationNetwork(const Ellipsoid &e, const std::vector<GeodeticCrd> &sta);
+
+  /** @brief Number of stations */
+  std::size_t size() const noexcept { return __x.size(); }
+
+  /** @brief Radius of the sphere used for great circle distances; defaults
+   *         to the mean earth radius of the ellipsoid, (2a + b) / 3 [m]
+   */
+  double radius() const noexcept { return __R; }
+
+  /** @brief Set the radius of the sphere used for great circle distances.
+   * @param[in] R Radius [m]
+   */
+  void set_radius(double R) noexcept { __R = R; }
+
+  /** @brief Distance between stations i and j.
+   * @param[in] i Index of the first station
+   * @param[in] j Index of the second station
+   * @param[in] m The metric to use
+   * @return Distance [m]
+   */
+  double distance(std::size_t i, std::size_t j,
+                  distance_metric m) const noexcept;
+
+  /** @brief Distance matrix of the network.
+   *
+   * @param[in]  m   The metric to use
+   * @param[in]  s   Storage of the matrix
+   * @param[out] out The distance matrix [m], of size matrix_size(size(), s)
+   */
+  void distances(distance_metric m, matrix_storage s,
+                 double *out) const noexcept;
+
+  /** @brief Distance matrix of the network, in single precision (to halve
+   *         memory for large networks); distances are computed in double
+   *         precision and rounded on storage.
+   * @see StationNetwork::distances
+   */
+  void distances(distance_metric m, matrix_storage s,
+                 float *out) const noexcept;
+
+  /** @brief Distance matrix of the network, with tiles computed in
+   *         parallel; results are identical to the serial version.
+   * @see StationNetwork::distances
+   */
+  void distances(ThreadPool &pool, distance_metric m, matrix_storage s,
+                 double *out) const noexcept;
+
+  /** @brief Distance matrix of the network, in single precision and in
+   *         parallel.
+   * @see StationNetwork::distances
+   */
+  void distances(ThreadPool &pool, distance_metric m, matrix_storage s,
+                 float *out) const noexcept;
+
+private:
+  /** Compute the derived quantities (unit vectors, geodetic coordinates),
+   * once __x, __y, __z are set */
+  void prepare(const Ellipsoid &e);
+
+  /** The data of the network, as seen by the distance kernels */
+  detail::NetworkView view() const noexcept;
+
+  /** Cartesian (ECEF) coordinates [m] */
+  std::vector<double> __x, __y, __z;
+  /** Unit vectors (geocentric directions) */
+  std::vector<double> __ux, __uy, __uz;
+  /** Geodetic latitude and longitude [rad] */
+  std::vector<double> __lat, __lon;
+  /** Constants for the inverse geodesic problem */
+  core::GeodesicConstants __g;
+  /** Radius of the sphere for great circle distances [m] */
+  double __R;
+}; /* class StationNetwork */
+
+} /* namespace dso */
+
+#endif
@@ -34,7 +34,10 @@
 #ifndef __DSO_REFERENCE_ELLIPSOID_HPP__
 #define __DSO_REFERENCE_ELLIPSOID_HPP__
 
+#include "core/crd_jacobians.hpp"
+#include "core/crd_transformations.hpp"
 #include "core/ellipsoid_core.hpp"
+#include "core/meridian_arc_core.hpp"
 #include <type_traits>
 
 namespace dso {
@@ -100,13 +103,27 @@ template <> struct ellipsoid_traits<ellipsoid::pz90> {
   static constexpr const char *n{"PZ90"};
 };
 
+/** @brief Derived geometric constants of a reference ellipsoid, computed at
+ *         compile time (on every compiler; see dso::core::constexpr_sqrt).
+ *
+ * Functions templated on the ellipsoid read their constants from here, so
+ * that nothing is computed at runtime. The series coefficients of the
+ * ellipsoid are likewise available as dso::meridian_arc_constants,
+ * dso::geodesic_constants and dso::transverse_mercator_constants.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ */
+template <ellipsoid E>
+inline constexpr core::EllipsoidConstants ellipsoid_constants{
+    ellipsoid_traits<E>::a, ellipsoid_traits<E>::f};
+
 /** @brief Compute the squared eccentricity.
  *
  * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
  * @return Eccentricity squared.
  */
 template <ellipsoid E> constexpr double eccentricity_squared() noexcept {
-  return core::eccentricity_squared(ellipsoid_traits<E>::f);
+  return ellipsoid_constants<E>.e2;
 }
 
 /** @brief Compute the linear eccentricity.
@@ -114,9 +131,8 @@ template <ellipsoid E> constexpr double eccentricity_squared() noexcept {
  * @tparam E  The reference ellipsoid (i.e. one of dso::ellipsoid).
  * @return linear eccentricity
  */
-template <ellipsoid E> double linear_eccentricity() noexcept {
-  return core::linear_eccentricity(ellipsoid_traits<E>::a,
-                                   ellipsoid_traits<E>::f);
+template <ellipsoid E> constexpr double linear_eccentricity() noexcept {
+  return ellipsoid_constants<E>.le;
 }
 
 /** @brief Compute the semi-minor axis (b).
@@ -134,8 +150,7 @@ template <ellipsoid E> constexpr double semi_minor() noexcept {
  * @return Polar radius of curvature of the reference ellipsoid in [m].
  */
 template <ellipsoid E> constexpr double polar_radius_of_curvature() noexcept {
-  return core::polar_radius_of_curvature(ellipsoid_traits<E>::a,
-                                         ellipsoid_traits<E>::f);
+  return ellipsoid_constants<E>.c;
 }
 
 /** @brief Compute the third flattening
@@ -144,15 +159,32 @@ template <ellipsoid E> constexpr double polar_radius_of_curvature() noexcept {
  * @return Third flattening
  */
 template <ellipsoid E> constexpr double third_flattening() noexcept {
-  return core::third_flattening(ellipsoid_traits<E>::f);
+  return ellipsoid_constants<E>.n;
+}
+
+/** @brief Compute the second eccentricity squared, \f$ e'^2 \f$
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @return Second eccentricity squared
+ */
+template <ellipsoid E>
+constexpr double second_eccentricity_squared() noexcept {
+  return ellipsoid_constants<E>.second_ecc2;
 }
 
 /** @brief Compute the normal radius of curvature at a given latitude.
  *
  * @tparam E  The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @tparam T  The scalar type (e.g. double, float or a SIMD pack type).
  * @param[in] lat The latitude in [rad].
  * @return    The normal radius of curvature in [m].
  */
+template <ellipsoid E, typename T>
+core::generic_scalar_t<T> N(T lat) noexcept {
+  return core::N(ellipsoid_traits<E>::a, ellipsoid_traits<E>::f, lat);
+}
+
+/** @brief Normal radius of curvature, for a double (or integer) latitude */
 template <ellipsoid E> double N(double lat) noexcept {
   return core::N(ellipsoid_traits<E>::a, ellipsoid_traits<E>::f, lat);
 }
@@ -167,6 +199,12 @@ template <ellipsoid E> double N(double lat) noexcept {
  * @note If the point has height != 0 (aka, is not ON the ellipsoid), the use
  *  the version whilch also takes height as input.
  */
+template <ellipsoid E, typename T>
+core::generic_scalar_t<T> geocentric_latitude(T lat) noexcept {
+  return core::geocentric_latitude(ellipsoid_traits<E>::f, lat);
+}
+
+/** @brief Geocentric latitude, for a double (or integer) latitude */
 template <ellipsoid E> double geocentric_latitude(double lat) noexcept {
   return core::geocentric_latitude(ellipsoid_traits<E>::f, lat);
 }
@@ -205,6 +243,12 @@ double geocentric_latitude(double lat, double h) noexcept {
  * @param[in] lat The geodetic latitude in [rad]
  * @return    The parametric or reduced latitude in [rad]
  */
+template <ellipsoid E, typename T>
+core::generic_scalar_t<T> reduced_latitude(T lat) noexcept {
+  return core::reduced_latitude(ellipsoid_traits<E>::f, lat);
+}
+
+/** @brief Reduced latitude, for a double (or integer) latitude */
 template <ellipsoid E> double reduced_latitude(double lat) noexcept {
   return core::reduced_latitude(ellipsoid_traits<E>::f, lat);
 }
@@ -215,6 +259,13 @@ template <ellipsoid E> double reduced_latitude(double lat) noexcept {
  * @param[in] lat The latitude in [rad].
  * @return The meridional radius of curvature in [m].
  */
+template <ellipsoid E, typename T>
+core::generic_scalar_t<T> M(T lat) noexcept {
+  return core::M(ellipsoid_traits<E>::a, ellipsoid_traits<E>::f, lat);
+}
+
+/** @brief Meridional radius of curvature, for a double (or integer)
+ *         latitude */
 template <ellipsoid E> double M(double lat) noexcept {
   return core::M(ellipsoid_traits<E>::a, ellipsoid_traits<E>::f, lat);
 }
@@ -248,6 +299,67 @@ double infinitesimal_meridian_arc(double lat, double dlat) noexcept {
   return Rm * dlat;
 }
 
+/** @brief Meridian arc constants (i.e. rectifying radius and series
+ *         coefficients) of a reference ellipsoid, computed at compile time.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ */
+template <ellipsoid E>
+inline constexpr core::MeridianArcConstants meridian_arc_constants{
+    ellipsoid_traits<E>::a, ellipsoid_traits<E>::f};
+
+/** @brief Rectifying latitude at a given geodetic latitude.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in] lat Geodetic latitude [rad]
+ * @return Rectifying latitude [rad]
+ * @see dso::core::rectifying_latitude
+ */
+template <ellipsoid E> double rectifying_latitude(double lat) noexcept {
+  return core::rectifying_latitude(meridian_arc_constants<E>, lat);
+}
+
+/** @brief Meridian arc length, from the equator to a given latitude.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in] lat Geodetic latitude [rad]
+ * @return Arc length (on the meridian) [m]; negative for southern latitudes
+ * @see dso::core::meridian_arc_length
+ */
+template <ellipsoid E> double meridian_arc_length(double lat) noexcept {
+  return core::meridian_arc_length(meridian_arc_constants<E>, lat);
+}
+
+/** @brief Geodetic (footpoint) latitude at a given meridian arc length from
+ *         the equator, i.e. the inverse of dso::meridian_arc_length.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in] s Arc length (on the meridian) [m]
+ * @return Geodetic latitude [rad]
+ * @see dso::core::meridian_arc_latitude
+ */
+template <ellipsoid E> double meridian_arc_latitude(double s) noexcept {
+  return core::meridian_arc_latitude(meridian_arc_constants<E>, s);
+}
+
+/** @brief Meridian arc length for a batch of n latitudes.
+ * @see dso::core::meridian_arc_length
+ */
+template <ellipsoid E>
+void meridian_arc_length(const double *lat, double *s, std::size_t n) noexcept {
+  core::meridian_arc_length(meridian_arc_constants<E>, lat, s, n);
+}
+
+/** @brief Geodetic (footpoint) latitude for a batch of n meridian arc
+ *         lengths.
+ * @see dso::core::meridian_arc_latitude
+ */
+template <ellipsoid E>
+void meridian_arc_latitude(const double *s, double *lat,
+                           std::size_t n) noexcept {
+  core::meridian_arc_latitude(meridian_arc_constants<E>, s, lat, n);
+}
+
 /** @brief Arc length on parallel
  *
  * @param[in] lat  Latitude of the parallel [rad]
@@ -278,68 +390,180 @@ public:
    * @param[in] e An dso::ellipsoid; fundamental geometric constants are
    *   automatically assigned via the dso::ellipsoid_traits class.
    */
-  explicit constexpr Ellipsoid(ellipsoid e) noexcept : __a(0e0), __f(0e0) {
-    switch (e) {
-    case ellipsoid::grs80:
-      __a = ellipsoid_traits<ellipsoid::grs80>::a;
-      __f = ellipsoid_traits<ellipsoid::grs80>::f;
-      break;
-    case ellipsoid::wgs84:
-      __a = ellipsoid_traits<ellipsoid::wgs84>::a;
-      __f = ellipsoid_traits<ellipsoid::wgs84>::f;
-      break;
-    case ellipsoid::pz90:
-      __a = ellipsoid_traits<ellipsoid::pz90>::a;
-      __f = ellipsoid_traits<ellipsoid::pz90>::f;
-      break;
-    }
-  }
+  explicit constexpr Ellipsoid(ellipsoid e) noexcept : __c(constants_of(e)) {}
 
   /** @brief  User-defined instance.
    * @param[in] a The semi-major axis [m]
    * @param[in] f The flattening
    */
-  constexpr Ellipsoid(double a, double f) noexcept : __a(a), __f(f) {};
+  constexpr Ellipsoid(double a, double f) noexcept : __c(a, f) {};
 
   /** @brief et the semi-major axis \f$ \alpha \f$ */
-  constexpr double semi_major() const noexcept { return __a; }
+  constexpr double semi_major() const noexcept { return __c.a; }
 
   /** @brief  Get the flatteninga */
-  constexpr double flattening() const noexcept { return __f; }
+  constexpr double flattening() const noexcept { return __c.f; }
 
   /** @brief  Get the squared eccentricity \f$ e^2 \f$ */
-  constexpr double eccentricity_squared() const noexcept {
-    return core::eccentricity_squared(__f);
-  }
+  constexpr double eccentricity_squared() const noexcept { return __c.e2; }
 
   /** @brief  Get the semi-minor axis \f$ \beta \f$ */
   constexpr double semi_minor() const noexcept {
-    return core::semi_minor(__a, __f);
+    return core::semi_minor(__c.a, __c.f);
   }
 
   /** @brief Get the third flattening \f$ n \f$ */
-  constexpr double third_flattening() const noexcept {
-    return core::third_flattening(__f);
+  constexpr double third_flattening() const noexcept { return __c.n; }
+
+  /** @brief Get the second eccentricity squared \f$ e'^2 \f$ */
+  constexpr double second_eccentricity_squared() const noexcept {
+    return __c.second_ecc2;
+  }
+
+  /** @brief Get the linear eccentricity [m] */
+  constexpr double linear_eccentricity() const noexcept { return __c.le; }
+
+  /** @brief Get the polar radius of curvature \f$ c \f$ [m] */
+  constexpr double polar_radius_of_curvature() const noexcept {
+    return __c.c;
+  }
+
+  /** @brief Get the (cached) derived constants of the ellipsoid */
+  constexpr const core::EllipsoidConstants &constants() const noexcept {
+    return __c;
+  }
+
+  /** @brief Compute the meridian arc constants of the ellipsoid; to be used
+   *         (and cached) with the dso::core::meridian_arc_length family of
+   *         functions.
+   */
+  constexpr core::MeridianArcConstants meridian_arc_constants() const noexcept {
+    return core::MeridianArcConstants(__c.a, __c.f);
   }
 
   /** @brief Compute the geocentric latitude at some (geodetic) latitude */
   double geocentric_latitude(double lat) const noexcept {
-    return core::geocentric_latitude(__f, lat);
+    return core::geocentric_latitude(__c.f, lat);
   }
 
   /** @brief Compute the reduced latitude at some (geodetic) latitude */
   double reduced_latitude(double lat) const noexcept {
-    return core::reduced_latitude(__f, lat);
+    return core::reduced_latitude(__c.f, lat);
   }
 
   /** @brief  Compute the normal radius of curvature at a given latitude */
-  double N(double lat) const noexcept { return core::N(__a, __f, lat); }
+  double N(double lat) const noexcept {
+    const double sf = std::sin(lat);
+    return __c.a / std::sqrt(1e0 - __c.e2 * sf * sf);
+  }
 
   /** @brief  Compute the meridional radii of curvature at a given latitude */
-  double M(double lat) const noexcept { return core::M(__a, __f, lat); }
+  double M(double lat) const noexcept {
+    const double sf = std::sin(lat);
+    const double d = 1e0 - __c.e2 * sf * sf;
+    return (__c.a / std::sqrt(d)) * (__c.ep2 / d);
+  }
+
+  /** @brief Geodetic (ellipsoidal) to cartesian coordinates.
+   * @see dso::geodetic2cartesian
+   * @tparam T The scalar type (e.g. double, float or a SIMD pack type).
+   */
+  template <typename T = double>
+  void geodetic2cartesian(core::identity_t<T> lat, core::identity_t<T> lon,
+                          core::identity_t<T> h, T &x, T &y,
+                          T &z) const noexcept {
+    core::geodetic2cartesian(__c, lat, lon, h, x, y, z);
+  }
+
+  /** @brief Cartesian to geodetic/ellipsoidal coordinates.
+   * @see dso::cartesian2geodetic
+   * @tparam P The precision tier (see dso::precision).
+   * @tparam T The scalar type (e.g. double, float or a SIMD pack type).
+   */
+  template <precision P = precision::full, typename T = double>
+  void cartesian2geodetic(core::identity_t<T> x, core::identity_t<T> y,
+                          core::identity_t<T> z, T &lat, T &lon,
+                          T &hgt) const noexcept {
+    core::cartesian2geodetic<P>(__c, x, y, z, lat, lon, hgt);
+  }
+
+  /** @brief Geodetic (ellipsoidal) to cartesian coordinates, for a batch of
+   *         n points, given in structure-of-arrays layout.
+   * @see dso::core::geodetic2cartesian
+   */
+  void geodetic2cartesian(const double *lat, const double *lon,
+                          const double *hgt, double *x, double *y, double *z,
+                          std::size_t n) const noexcept {
+    core::geodetic2cartesian(__c, lat, lon, hgt, x, y, z, n);
+  }
+
+  /** @brief Cartesian to geodetic/ellipsoidal coordinates, for a batch of n
+   *         points, given in structure-of-arrays layout.
+   * @see dso::core::cartesian2geodetic
+   */
+  void cartesian2geodetic(const double *x, const double *y, const double *z,
+                          double *lat, double *lon, double *hgt,
+                          std::size_t n) const noexcept {
+    core::cartesian2geodetic(__c, x, y, z, lat, lon, hgt, n);
+  }
+
+  /** @brief Jacobian of the geodetic to cartesian transformation.
+   * @see dso::core::geodetic2cartesian_jacobian
+   */
+  Eigen::Matrix<double, 3, 3>
+  geodetic2cartesian_jacobian(double lat, double lon,
+                              double hgt) const noexcept {
+    return core::geodetic2cartesian_jacobian(__c, lat, lon, hgt);
+  }
+
+  /** @brief Jacobian of the cartesian to geodetic transformation.
+   * @see dso::core::cartesian2geodetic_jacobian
+   */
+  Eigen::Matrix<double, 3, 3>
+  cartesian2geodetic_jacobian(double lat, double lon,
+                              double hgt) const noexcept {
+    return core::cartesian2geodetic_jacobian(__c, lat, lon, hgt);
+  }
+
+  /** @brief Propagate (packed) covariance matrices from geodetic to
+   *         cartesian coordinates, for a batch of n points.
+   * @see dso::core::geodetic2cartesian_covariance
+   */
+  void geodetic2cartesian_covariance(const double *lat, const double *lon,
+                                     const double *hgt, const double *cov,
+                                     double *out,
+                                     std::size_t n) const noexcept {
+    core::geodetic2cartesian_covariance(__c, lat, lon, hgt, cov, out, n);
+  }
+
+  /** @brief Propagate (packed) covariance matrices from cartesian to
+   *         geodetic coordinates, for a batch of n points.
+   * @see dso::core::cartesian2geodetic_covariance
+   */
+  void cartesian2geodetic_covariance(const double *lat, const double *lon,
+                                     const double *hgt, const double *cov,
+                                     double *out,
+                                     std::size_t n) const noexcept {
+    core::cartesian2geodetic_covariance(__c, lat, lon, hgt, cov, out, n);
+  }
 
 private:
-  double __a, __f;
+  /** @brief Constants of the ellipsoids in the dso::ellipsoid enum */
+  static constexpr core::EllipsoidConstants
+  constants_of(ellipsoid e) noexcept {
+    switch (e) {
+    case ellipsoid::wgs84:
+      return ellipsoid_constants<ellipsoid::wgs84>;
+    case ellipsoid::pz90:
+      return ellipsoid_constants<ellipsoid::pz90>;
+    case ellipsoid::grs80:
+    default:
+      return ellipsoid_constants<ellipsoid::grs80>;
+    }
+  }
+
+  /** Fundamental and (cached) derived constants */
+  core::EllipsoidConstants __c;
 }; /* class Ellipsoid */
 
 } /* namespace dso */
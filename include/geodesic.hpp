@@ -0,0 +1,162 @@
+/** @file
+ * Geodesic (inverse and direct) problems on a reference ellipsoid.
+ *
+ * As for the ellipsoid itself, there are two ways to use the solvers:
+ * * 1. If the ellipsoid of choice is known at compile time, use the template
+ *      functions, e.g.
+ *      geodesic_inverse<ellipsoid::grs80>(lat1, lon1, lat2, lon2, s12, a1, a2);
+ *      The series coefficients of the ellipsoid (dso::geodesic_constants)
+ *      are then computed at compile time.
+ * * 2. If the ellipsoid of choice is only known at runtime, construct a
+ *      dso::Geodesic instance, which computes the coefficients once, e.g.
+ *      Geodesic geod(Ellipsoid(a, f));
+ *      geod.inverse(lat1, lon1, lat2, lon2, s12, a1, a2);
+ *
+ * All angles are in [rad], distances in [m].
+ *
+ * [1] Charles F. F. Karney, Algorithms for geodesics, J Geod (2013) 87:43–55
+ */
+
+#ifndef __DSO_GEODESIC_HPP__
+#define __DSO_GEODESIC_HPP__
+
+#include "core/geodesic_core.hpp"
+#include "ellipsoid.hpp"
+#include <cstddef>
+
+namespace dso {
+
+/** @brief Geodesic constants (including the series coefficients) of a
+ *         reference ellipsoid, computed at compile time.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ */
+template <ellipsoid E>
+inline constexpr core::GeodesicConstants geodesic_constants{
+    ellipsoid_traits<E>::a, ellipsoid_traits<E>::f};
+
+/** @brief Solve the inverse geodesic problem, i.e. compute the length of
+ *         the (shortest) geodesic between two points and the azimuths at its
+ *         end points.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodesic_inverse
+ */
+template <ellipsoid E>
+void geodesic_inverse(double lat1, double lon1, double lat2, double lon2,
+                      double &s12, double &azi1, double &azi2) noexcept {
+  core::geodesic_inverse(geodesic_constants<E>, lat1, lon1, lat2, lon2, s12,
+                         azi1, azi2);
+}
+
+/** @brief Solve the direct geodesic problem, i.e. compute the end point of a
+ *         geodesic given its starting point, azimuth and length.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodesic_direct
+ */
+template <ellipsoid E>
+void geodesic_direct(double lat1, double lon1, double azi1, double s12,
+                     double &lat2, double &lon2, double &azi2) noexcept {
+  core::geodesic_direct(geodesic_constants<E>, lat1, lon1, azi1, s12, lat2,
+                        lon2, azi2);
+}
+
+/** @brief Solve the inverse geodesic problem for a batch of n point pairs,
+ *         given in structure-of-arrays layout.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodesic_inverse
+ */
+template <ellipsoid E>
+void geodesic_inverse(const double *lat1, const double *lon1,
+                      const double *lat2, const double *lon2, double *s12,
+                      double *azi1, double *azi2, std::size_t n) noexcept {
+  core::geodesic_inverse(geodesic_constants<E>, lat1, lon1, lat2, lon2, s12,
+                         azi1, azi2, n);
+}
+
+/** @brief Solve the direct geodesic problem for a batch of n points, given
+ *         in structure-of-arrays layout.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodesic_direct
+ */
+template <ellipsoid E>
+void geodesic_direct(const double *lat1, const double *lon1,
+                     const double *azi1, const double *s12, double *lat2,
+                     double *lon2, double *azi2, std::size_t n) noexcept {
+  core::geodesic_direct(geodesic_constants<E>, lat1, lon1, azi1, s12, lat2,
+                        lon2, azi2, n);
+}
+
+/** @class Geodesic
+ *
+ * Solver for geodesic problems on a reference ellipsoid known only at
+ * runtime. The series coefficients of the ellipsoid are computed once, at
+ * construction, and shared by all subsequent solutions.
+ */
+class Geodesic {
+public:
+  /** @brief Constructor from a reference ellipsoid */
+  explicit constexpr Geodesic(const Ellipsoid &e) noexcept
+      : __g(e.semi_major(), e.flattening()) {}
+
+  /** @brief Constructor from one of the enumerated reference ellipsoids */
+  explicit constexpr Geodesic(ellipsoid e) noexcept : Geodesic(Ellipsoid(e)) {}
+
+  /** @brief Constructor from the defining parameters of the ellipsoid.
+   * @param[in] a Semi-major axis [m]
+   * @param[in] f Flattening [-]
+   */
+  constexpr Geodesic(double a, double f) noexcept : __g(a, f) {}
+
+  /** @brief Get the (cached) geodesic constants */
+  constexpr const core::GeodesicConstants &constants() const noexcept {
+    return __g;
+  }
+
+  /** @brief Solve the inverse geodesic problem.
+   * @see dso::core::geodesic_inverse
+   */
+  void inverse(double lat1, double lon1, double lat2, double lon2,
+               double &s12, double &azi1, double &azi2) const noexcept {
+    core::geodesic_inverse(__g, lat1, lon1, lat2, lon2, s12, azi1, azi2);
+  }
+
+  /** @brief Solve the direct geodesic problem.
+   * @see dso::core::geodesic_direct
+   */
+  void direct(double lat1, double lon1, double azi1, double s12, double &lat2,
+              double &lon2, double &azi2) const noexcept {
+    core::geodesic_direct(__g, lat1, lon1, azi1, s12, lat2, lon2, azi2);
+  }
+
+  /** @brief Solve the inverse geodesic problem for a batch of n point
+   *         pairs, given in structure-of-arrays layout.
+   * @see dso::core::geodesic_inverse
+   */
+  void inverse(const double *lat1, const double *lon1, const double *lat2,
+               const double *lon2, double *s12, double *azi1, double *azi2,
+               std::size_t n) const noexcept {
+    core::geodesic_inverse(__g, lat1, lon1, lat2, lon2, s12, azi1, azi2, n);
+  }
+
+  /** @brief Solve the direct geodesic problem for a batch of n points, given
+   *         in structure-of-arrays layout.
+   * @see dso::core::geodesic_direct
+   */
+  void direct(const double *lat1, const double *lon1, const double *azi1,
+              const double *s12, double *lat2, double *lon2, double *azi2,
+              std::size_t n) const noexcept {
+    core::geodesic_direct(__g, lat1, lon1, azi1, s12, lat2, lon2, azi2, n);
+  }
+
+private:
+  /** Constants and series coefficients of the ellipsoid */
+  core::GeodesicConstants __g;
+}; /* class Geodesic */
+
+} /* namespace dso */
+
+#endif
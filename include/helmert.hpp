@@ -0,0 +1,172 @@
+/** @file
+ * Helmert (7- or 14-parameter similarity) transformation between terrestrial
+ * reference frames, e.g. between ITRF realizations or from ITRF to a
+ * regional frame.
+ */
+
+#ifndef __DSO_HELMERT_HPP__
+#define __DSO_HELMERT_HPP__
+
+#include "core/crdtype_warppers.hpp"
+#include "ellipsoid.hpp"
+#include <cstddef>
+
+namespace dso {
+
+/** @brief The (7) parameters of a Helmert transformation, or their rates.
+ *
+ * Units are SI: translations in [m], scale (i.e. the scale difference, not
+ * the scale factor) in [-] and rotations in [rad]; rates are per year. IERS
+ * tables usually list translations in [mm], scale in [ppb] and rotations in
+ * [mas]; see HelmertParameters::from_iers.
+ */
+struct HelmertParameters {
+  /** Translation [m] */
+  double tx{0e0}, ty{0e0}, tz{0e0};
+  /** Scale difference [-] */
+  double d{0e0};
+  /** Rotation angles [rad] */
+  double rx{0e0}, ry{0e0}, rz{0e0};
+
+  /** @brief Parameters given in the units of the IERS tables.
+   * @param[in] tx_mm  Translation, x-component [mm]
+   * @param[in] ty_mm  Translation, y-component [mm]
+   * @param[in] tz_mm  Translation, z-component [mm]
+   * @param[in] d_ppb  Scale difference [ppb]
+   * @param[in] rx_mas Rotation about the x-axis [mas]
+   * @param[in] ry_mas Rotation about the y-axis [mas]
+   * @param[in] rz_mas Rotation about the z-axis [mas]
+   */
+  static HelmertParameters from_iers(double tx_mm, double ty_mm,
+                                     double tz_mm, double d_ppb,
+                                     double rx_mas, double ry_mas,
+                                     double rz_mas) noexcept;
+};
+
+/** @class HelmertTransform
+ *
+ * A Helmert transformation, in the (linearized) form of the IERS
+ * Conventions (2010), Eq. 4.13:
+ * \f$ X' = X + T + D X + R X \f$, with
+ * \f$ R = [[0, -r_z, r_y], [r_z, 0, -r_x], [-r_y, r_x, 0]] \f$.
+ *
+ * The parameters (for 14-parameter transformations, propagated to the epoch
+ * of the coordinates) are folded into a single affine transformation
+ * \f$ X' = A X + T \f$ at construction, so that each point costs a 3x3
+ * matrix-vector product. Batch versions are vectorized; fused versions
+ * also convert the results to geodetic coordinates, in cache-sized blocks,
+ * so that no intermediate (cartesian) arrays are written to memory.
+ */
+class HelmertTransform {
+public:
+  /** Number of points transformed per block, by the fused (Helmert and
+   * cartesian to geodetic) batch transformations */
+  static constexpr const std::size_t BLOCK = 256;
+
+  /** @brief Constructor from 7 parameters.
+   * @param[in] p The transformation parameters
+   */
+  explicit HelmertTransform(const HelmertParameters &p) noexcept;
+
+  /** @brief Constructor from 14 parameters (i.e. parameters and rates),
+   *         for coordinates at a given epoch.
+   * @param[in] p     The transformation parameters, at epoch t0
+   * @param[in] rates The rates of the parameters [(units)/year]
+   * @param[in] t0    The reference epoch of the parameters, e.g. 2010.0
+   *                  [year]
+   * @param[in] t     The epoch of the coordinates to be transformed [year]
+   */
+  HelmertTransform(const HelmertParameters &p, const HelmertParameters &rates,
+                   double t0, double t) noexcept;
+
+  /** @brief The inverse transformation (exact, i.e. the inverse of the
+   *         affine transformation, not the one with negated parameters).
+   */
+  HelmertTransform inverse() const noexcept;
+
+  /** @brief The matrix A of the affine transformation X' = A X + T */
+  const Eigen::Matrix<double, 3, 3> &matrix() const noexcept { return __A; }
+
+  /** @brief The translation T of the affine transformation X' = A X + T */
+  const CartesianCrd &translation() const noexcept { return __T; }
+
+  /** @brief Transform a point.
+   *
+   * @param[in]  x  Cartesian x-component, in the source frame [m]
+   * @param[in]  y  Cartesian y-component, in the source frame [m]
+   * @param[in]  z  Cartesian z-component, in the source frame [m]
+   * @param[out] xt Cartesian x-component, in the target frame [m]
+   * @param[out] yt Cartesian y-component, in the target frame [m]
+   * @param[out] zt Cartesian z-component, in the target frame [m]
+   */
+  void apply(double x, double y, double z, double &xt, double &yt,
+             double &zt) const noexcept {
+    xt = __T.x() + (__A(0, 0) * x + __A(0, 1) * y + __A(0, 2) * z);
+    yt = __T.y() + (__A(1, 0) * x + __A(1, 1) * y + __A(1, 2) * z);
+    zt = __T.z() + (__A(2, 0) * x + __A(2, 1) * y + __A(2, 2) * z);
+  }
+
+  /** @brief Transform a point.
+   * @see HelmertTransform::apply
+   */
+  CartesianCrd apply(const CartesianCrd &p) const noexcept {
+    CartesianCrd t;
+    apply(p.x(), p.y(), p.z(), t.x(), t.y(), t.z());
+    return t;
+  }
+
+  /** @brief Transform a batch of n points, given in structure-of-arrays
+   *         layout; the output may be the input (i.e. in-place).
+   * @see HelmertTransform::apply
+   */
+  void apply(const double *x, const double *y, const double *z, double *xt,
+             double *yt, double *zt, std::size_t n) const noexcept;
+
+  /** @brief Transform a batch of n points; the output may be the input
+   *         (i.e. in-place).
+   * @see HelmertTransform::apply
+   */
+  void apply(const CartesianCrd *p, CartesianCrd *t,
+             std::size_t n) const noexcept;
+
+  /** @brief Transform a batch of n points, and convert the results to
+   *         geodetic coordinates (fused, see the class documentation).
+   *
+   * Results are identical to the ones of HelmertTransform::apply, followed
+   * by the batch dso::Ellipsoid::cartesian2geodetic.
+   *
+   * @param[in]  e   The reference ellipsoid (of the target frame)
+   * @param[in]  x   Cartesian x-components, in the source frame [m]
+   * @param[in]  y   Cartesian y-components, in the source frame [m]
+   * @param[in]  z   Cartesian z-components, in the source frame [m]
+   * @param[out] lat Geodetic latitudes, in the target frame [rad]
+   * @param[out] lon Geodetic longitudes, in the target frame [rad]
+   * @param[out] hgt Ellipsoidal heights, in the target frame [m]
+   * @param[in]  n   Number of points
+   */
+  void apply(const Ellipsoid &e, const double *x, const double *y,
+             const double *z, double *lat, double *lon, double *hgt,
+             std::size_t n) const noexcept;
+
+  /** @brief Transform a batch of n points, and convert the results to
+   *         geodetic coordinates (fused).
+   * @see HelmertTransform::apply
+   */
+  void apply(const Ellipsoid &e, const CartesianCrd *p, GeodeticCrd *g,
+             std::size_t n) const noexcept;
+
+private:
+  /** @brief Constructor from the affine transformation */
+  HelmertTransform(const Eigen::Matrix<double, 3, 3> &A,
+                   const CartesianCrd &T) noexcept
+      : __A(A), __T(T) {}
+
+  /** Matrix of the affine transformation, i.e. (1 + D) I + R */
+  Eigen::Matrix<double, 3, 3> __A;
+  /** Translation */
+  CartesianCrd __T;
+}; /* class HelmertTransform */
+
+} /* namespace dso */
+
+#endif
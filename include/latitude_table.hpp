@@ -0,0 +1,163 @@
+/** @file
+ * Lookup tables for latitude-dependent quantities of an ellipsoid (radii of
+ * curvature and auxiliary latitudes), interpolated over a latitude grid.
+ */
+
+#ifndef __DSO_LATITUDE_TABLE_HPP__
+#define __DSO_LATITUDE_TABLE_HPP__
+
+#include "ellipsoid.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace dso {
+
+/** Latitude-dependent quantities tabulated by dso::LatitudeTable */
+enum class latitude_quantity : char {
+  /** Normal radius of curvature [m], see dso::core::N */
+  N,
+  /** Meridional radius of curvature [m], see dso::core::M */
+  M,
+  /** Geocentric latitude [rad], see dso::core::geocentric_latitude */
+  geocentric,
+  /** Reduced (parametric) latitude [rad], see dso::core::reduced_latitude */
+  reduced
+};
+
+/** @class LatitudeTable
+ *
+ * Tabulated values of dso::latitude_quantity's over a uniform grid of
+ * (geodetic) latitudes, replacing the evaluation of trigonometric functions
+ * by a table lookup and a cubic polynomial.
+ *
+ * Each quantity is interpolated by cubic Hermite segments, i.e. matching
+ * the value and the (analytic) derivative at the grid nodes. The
+ * interpolation error is bounded by \f$ h^4/384 \max|f^{(4)}| \f$, for a
+ * grid step h; it is hence reduced 16-fold when halving the step. With a
+ * step of 0.1 deg, radii of curvature are within ~2e-8 m and auxiliary
+ * latitudes within ~2e-15 rad (see max_error for the actual errors of a
+ * table); a step of 1 deg gives ~1e-4 m and ~1e-11 rad.
+ *
+ * Latitudes outside the grid range are extrapolated from the first or last
+ * segment, and are hence only accurate if close to the range.
+ */
+class LatitudeTable {
+public:
+  /** @brief Constructor; tabulate the quantities of an ellipsoid.
+   * @param[in] e       The reference ellipsoid
+   * @param[in] step    The (maximum) grid step [rad]; the actual step is
+   *                    the one dividing [lat_min, lat_max] in an integer
+   *                    number of segments
+   * @param[in] lat_min Lowest latitude of the grid [rad]
+   * @param[in] lat_max Highest latitude of the grid [rad]
+   * @throw std::invalid_argument if step is not positive (or not finite),
+   *        or lat_max is not greater than lat_min
+   */
+  LatitudeTable(const Ellipsoid &e, double step, double lat_min = -DPI / 2e0,
+                double lat_max = DPI / 2e0);
+
+  /** @brief Number of segments of the grid */
+  std::size_t size() const noexcept { return __n; }
+
+  /** @brief Step of the grid [rad] */
+  double step() const noexcept { return __h; }
+
+  /** @brief Lowest latitude of the grid [rad] */
+  double lat_min() const noexcept { return __lat0; }
+
+  /** @brief Highest latitude of the grid [rad] */
+  double lat_max() const noexcept { return __lat0 + __n * __h; }
+
+  /** @brief Maximum interpolation error of a quantity (in its units),
+   *         w.r.t. the direct computation; evaluated at construction, at
+   *         the midpoint (where the error of cubic Hermite interpolation
+   *         peaks) and the quartiles of each segment.
+   */
+  double max_error(latitude_quantity q) const noexcept {
+    return __err[static_cast<int>(q)];
+  }
+
+  /** @brief Interpolated value of a quantity at a given latitude.
+   * @param[in] q   The quantity
+   * @param[in] lat The (geodetic) latitude [rad]
+   */
+  double value(latitude_quantity q, double lat) const noexcept;
+
+  /** @brief Interpolated values of a quantity, for a batch of n latitudes.
+   * @param[in]  q   The quantity
+   * @param[in]  lat The (geodetic) latitudes [rad], size n
+   * @param[out] out The values of the quantity, size n
+   * @param[in]  n   Number of latitudes
+   */
+  void value(latitude_quantity q, const double *lat, double *out,
+             std::size_t n) const noexcept;
+
+  /** @brief Normal radius of curvature [m] at a given latitude [rad] */
+  double N(double lat) const noexcept {
+    return value(latitude_quantity::N, lat);
+  }
+
+  /** @brief Meridional radius of curvature [m] at a given latitude [rad] */
+  double M(double lat) const noexcept {
+    return value(latitude_quantity::M, lat);
+  }
+
+  /** @brief Geocentric latitude [rad] at a given latitude [rad] */
+  double geocentric_latitude(double lat) const noexcept {
+    return value(latitude_quantity::geocentric, lat);
+  }
+
+  /** @brief Reduced latitude [rad] at a given latitude [rad] */
+  double reduced_latitude(double lat) const noexcept {
+    return value(latitude_quantity::reduced, lat);
+  }
+
+  /** @brief Normal radius of curvature, for a batch of n latitudes.
+   * @see LatitudeTable::value
+   */
+  void N(const double *lat, double *out, std::size_t n) const noexcept {
+    value(latitude_quantity::N, lat, out, n);
+  }
+
+  /** @brief Meridional radius of curvature, for a batch of n latitudes.
+   * @see LatitudeTable::value
+   */
+  void M(const double *lat, double *out, std::size_t n) const noexcept {
+    value(latitude_quantity::M, lat, out, n);
+  }
+
+  /** @brief Geocentric latitude, for a batch of n latitudes.
+   * @see LatitudeTable::value
+   */
+  void geocentric_latitude(const double *lat, double *out,
+                           std::size_t n) const noexcept {
+    value(latitude_quantity::geocentric, lat, out, n);
+  }
+
+  /** @brief Reduced latitude, for a batch of n latitudes.
+   * @see LatitudeTable::value
+   */
+  void reduced_latitude(const double *lat, double *out,
+                        std::size_t n) const noexcept {
+    value(latitude_quantity::reduced, lat, out, n);
+  }
+
+private:
+  /** Number of tabulated quantities */
+  static constexpr const int NQ = 4;
+
+  /** Lowest latitude [rad], step [rad] and its inverse */
+  double __lat0, __h, __ih;
+  /** Number of segments */
+  std::size_t __n;
+  /** Per quantity, the coefficients of the cubic polynomial (in the
+   * normalized coordinate within the segment) of each segment, 4 per
+   * segment, lowest order first */
+  std::vector<double> __c[NQ];
+  /** Per quantity, the maximum interpolation error */
+  double __err[NQ];
+}; /* class LatitudeTable */
+
+} /* namespace dso */
+
+#endif
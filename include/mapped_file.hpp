@@ -0,0 +1,66 @@
+/** @file
+ * A read-only memory mapping of a (whole) file, e.g. for streaming large
+ * coordinate files through the batch transformations without copying them.
+ */
+
+#ifndef __DSO_MAPPED_FILE_HPP__
+#define __DSO_MAPPED_FILE_HPP__
+
+#include <cstddef>
+#include <system_error>
+
+namespace dso {
+
+/** @class MappedFile
+ *
+ * Maps a file (read-only) in memory; the mapping is released on
+ * destruction. Hence, pointers into the file (e.g. names of stations read
+ * by dso::read_sinex) are valid for the lifetime of the instance.
+ */
+class MappedFile {
+  int __fd{-1};
+  void *__data{nullptr};
+  std::size_t __size{0};
+
+public:
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile() noexcept = default;
+
+  /** @brief Destructor; unmaps and closes the file */
+  ~MappedFile() noexcept { close(); }
+
+  /** @brief Unmap and close the file (if any); the instance is empty */
+  void close() noexcept;
+
+  /** @brief Map the given file; a file mapped before is released first.
+   * @param[in] fn The name of the file
+   * @return std::errc{} on success; else, the cause of the error (and the
+   *         instance is empty)
+   */
+  std::errc open(const char *fn) noexcept;
+
+  /** @brief Start of the mapped file (null if empty) */
+  const char *data() const noexcept {
+    return static_cast<const char *>(__data);
+  }
+
+  /** @brief Start of the mapped file */
+  const char *begin() const noexcept { return data(); }
+
+  /** @brief End of the mapped file */
+  const char *end() const noexcept { return data() + __size; }
+
+  /** @brief Size of the file in bytes */
+  std::size_t size() const noexcept { return __size; }
+
+  /** @brief Tell the kernel that bytes [0, bytes) will not be used again;
+   *         they are re-read from the file if accessed.
+   */
+  void release(std::size_t bytes) noexcept;
+}; /* class MappedFile */
+
+} /* namespace dso */
+
+#endif
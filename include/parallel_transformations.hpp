@@ -0,0 +1,249 @@
+/** @file
+ * Multi-threaded versions of the (batch) coordinate transformations, for
+ * large arrays of points.
+ *
+ * Arrays are split into chunks (of a size that fits in cache) which are
+ * scheduled on a dso::ThreadPool. Each chunk is processed by the respective
+ * (vectorized) batch transformation, so that the work is spread over all
+ * threads and lanes of each core.
+ * Results do not depend on the number of threads used.
+ */
+
+#ifndef __DSO_PARALLEL_COORDINATE_TRANSFORMATIONS_HPP__
+#define __DSO_PARALLEL_COORDINATE_TRANSFORMATIONS_HPP__
+
+#include "thread_pool.hpp"
+#include "transformations.hpp"
+#include "transverse_mercator.hpp"
+
+namespace dso {
+
+namespace parallel {
+
+/** @brief Default number of points per chunk.
+ *
+ * Transformations read and write 6 arrays of doubles, hence a chunk of 4096
+ * points touches 192 kB, i.e. fits in the L2 cache of most CPUs.
+ */
+constexpr const std::size_t DEFAULT_CHUNK_SIZE = 4096;
+
+/** @brief Cartesian to geodetic coordinates, for large arrays, in parallel.
+ *
+ * @see dso::cartesian2geodetic (batch version)
+ *
+ * @tparam     E     The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  pool  The thread pool to use.
+ * @param[in]  x     Cartesian x-components, size n [m]
+ * @param[in]  y     Cartesian y-components, size n [m]
+ * @param[in]  z     Cartesian z-components, size n [m]
+ * @param[out] lat   Geodetic latitudes, size n [rad]
+ * @param[out] lon   Geodetic longtitudes, size n [rad]
+ * @param[out] hgt   Ellipsoidal heights, size n [m]
+ * @param[in]  n     Number of points
+ * @param[in]  chunk Number of points per chunk
+ */
+template <ellipsoid E>
+void cartesian2geodetic(ThreadPool &pool, const double *x, const double *y,
+                        const double *z, double *lat, double *lon,
+                        double *hgt, std::size_t n,
+                        std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [=](std::size_t b, std::size_t e) noexcept {
+    dso::cartesian2geodetic<E>(x + b, y + b, z + b, lat + b, lon + b, hgt + b,
+                               e - b);
+  });
+}
+
+/** @brief Cartesian to geodetic coordinates, for large arrays, in parallel,
+ *         using an ellipsoid known at runtime.
+ * @see dso::parallel::cartesian2geodetic
+ */
+inline void
+cartesian2geodetic(ThreadPool &pool, const Ellipsoid &ell, const double *x,
+                   const double *y, const double *z, double *lat, double *lon,
+                   double *hgt, std::size_t n,
+                   std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [&, x, y, z, lat, lon, hgt](
+                                  std::size_t b, std::size_t e) noexcept {
+    ell.cartesian2geodetic(x + b, y + b, z + b, lat + b, lon + b, hgt + b,
+                           e - b);
+  });
+}
+
+/** @brief Geodetic to cartesian coordinates, for large arrays, in parallel.
+ *
+ * @see dso::geodetic2cartesian (batch version)
+ *
+ * @tparam     E     The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  pool  The thread pool to use.
+ * @param[in]  lat   Geodetic latitudes, size n [rad]
+ * @param[in]  lon   Geodetic longtitudes, size n [rad]
+ * @param[in]  hgt   Ellipsoidal heights, size n [m]
+ * @param[out] x     Cartesian x-components, size n [m]
+ * @param[out] y     Cartesian y-components, size n [m]
+ * @param[out] z     Cartesian z-components, size n [m]
+ * @param[in]  n     Number of points
+ * @param[in]  chunk Number of points per chunk
+ */
+template <ellipsoid E>
+void geodetic2cartesian(ThreadPool &pool, const double *lat, const double *lon,
+                        const double *hgt, double *x, double *y, double *z,
+                        std::size_t n,
+                        std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [=](std::size_t b, std::size_t e) noexcept {
+    dso::geodetic2cartesian<E>(lat + b, lon + b, hgt + b, x + b, y + b, z + b,
+                               e - b);
+  });
+}
+
+/** @brief Geodetic to cartesian coordinates, for large arrays, in parallel,
+ *         using an ellipsoid known at runtime.
+ * @see dso::parallel::geodetic2cartesian
+ */
+inline void
+geodetic2cartesian(ThreadPool &pool, const Ellipsoid &ell, const double *lat,
+                   const double *lon, const double *hgt, double *x, double *y,
+                   double *z, std::size_t n,
+                   std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [&, lat, lon, hgt, x, y, z](
+                                  std::size_t b, std::size_t e) noexcept {
+    ell.geodetic2cartesian(lat + b, lon + b, hgt + b, x + b, y + b, z + b,
+                           e - b);
+  });
+}
+
+/** @brief Cartesian to spherical coordinates, for large arrays, in parallel.
+ *
+ * @see dso::cartesian2spherical
+ *
+ * @param[in]  pool  The thread pool to use.
+ * @param[in]  x     Cartesian x-components, size n [m]
+ * @param[in]  y     Cartesian y-components, size n [m]
+ * @param[in]  z     Cartesian z-components, size n [m]
+ * @param[out] r     Radii, size n [m]
+ * @param[out] glat  Geocentric latitudes, size n [rad]
+ * @param[out] lon   Longitudes, size n [rad]
+ * @param[in]  n     Number of points
+ * @param[in]  chunk Number of points per chunk
+ */
+inline void
+cartesian2spherical(ThreadPool &pool, const double *x, const double *y,
+                    const double *z, double *r, double *glat, double *lon,
+                    std::size_t n,
+                    std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [=](std::size_t b, std::size_t e) noexcept {
+    for (std::size_t i = b; i < e; i++)
+      dso::cartesian2spherical(x[i], y[i], z[i], r[i], glat[i], lon[i]);
+  });
+}
+
+/** @brief Spherical to cartesian coordinates, for large arrays, in parallel.
+ *
+ * @see dso::spherical2cartesian
+ *
+ * @param[in]  pool  The thread pool to use.
+ * @param[in]  r     Radii, size n [m]
+ * @param[in]  glat  Geocentric latitudes, size n [rad]
+ * @param[in]  lon   Longitudes, size n [rad]
+ * @param[out] x     Cartesian x-components, size n [m]
+ * @param[out] y     Cartesian y-components, size n [m]
+ * @param[out] z     Cartesian z-components, size n [m]
+ * @param[in]  n     Number of points
+ * @param[in]  chunk Number of points per chunk
+ */
+inline void
+spherical2cartesian(ThreadPool &pool, const double *r, const double *glat,
+                    const double *lon, double *x, double *y, double *z,
+                    std::size_t n,
+                    std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [=](std::size_t b, std::size_t e) noexcept {
+    for (std::size_t i = b; i < e; i++)
+      dso::spherical2cartesian(r[i], glat[i], lon[i], x[i], y[i], z[i]);
+  });
+}
+
+/** @brief Geodetic to UTM coordinates, for large arrays, in parallel; zones
+ *         are selected per point.
+ *
+ * @see dso::geodetic2utm (batch version)
+ *
+ * @tparam     E        The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  pool     The thread pool to use.
+ * @param[in]  lat      Geodetic latitudes, size n [rad]
+ * @param[in]  lon      Geodetic longtitudes, size n [rad]
+ * @param[out] zone     UTM zones, size n
+ * @param[out] north    Hemispheres (true for north), size n
+ * @param[out] easting  Eastings, size n [m]
+ * @param[out] northing Northings, size n [m]
+ * @param[in]  n        Number of points
+ * @param[in]  chunk    Number of points per chunk
+ */
+template <ellipsoid E>
+void geodetic2utm(ThreadPool &pool, const double *lat, const double *lon,
+                  int *zone, bool *north, double *easting, double *northing,
+                  std::size_t n,
+                  std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [=](std::size_t b, std::size_t e) noexcept {
+    dso::geodetic2utm<E>(lat + b, lon + b, zone + b, north + b, easting + b,
+                         northing + b, e - b);
+  });
+}
+
+/** @brief UTM to geodetic coordinates, for large arrays, in parallel.
+ *
+ * @see dso::utm2geodetic (batch version)
+ *
+ * @tparam     E        The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  pool     The thread pool to use.
+ * @param[in]  zone     UTM zones, size n
+ * @param[in]  north    Hemispheres (true for north), size n
+ * @param[in]  easting  Eastings, size n [m]
+ * @param[in]  northing Northings, size n [m]
+ * @param[out] lat      Geodetic latitudes, size n [rad]
+ * @param[out] lon      Geodetic longtitudes, size n [rad]
+ * @param[in]  n        Number of points
+ * @param[in]  chunk    Number of points per chunk
+ */
+template <ellipsoid E>
+void utm2geodetic(ThreadPool &pool, const int *zone, const bool *north,
+                  const double *easting, const double *northing, double *lat,
+                  double *lon, std::size_t n,
+                  std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [=](std::size_t b, std::size_t e) noexcept {
+    dso::utm2geodetic<E>(zone + b, north + b, easting + b, northing + b,
+                         lat + b, lon + b, e - b);
+  });
+}
+
+/** @brief Geodetic to Transverse Mercator grid coordinates, for large
+ *         arrays, in parallel.
+ * @see dso::TransverseMercator::forward (batch version)
+ */
+inline void geodetic2tm(ThreadPool &pool, const TransverseMercator &tm,
+                        const double *lat, const double *lon,
+                        double *easting, double *northing, std::size_t n,
+                        std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [&, lat, lon, easting, northing](
+                                  std::size_t b, std::size_t e) noexcept {
+    tm.forward(lat + b, lon + b, easting + b, northing + b, e - b);
+  });
+}
+
+/** @brief Transverse Mercator grid to geodetic coordinates, for large
+ *         arrays, in parallel.
+ * @see dso::TransverseMercator::inverse (batch version)
+ */
+inline void tm2geodetic(ThreadPool &pool, const TransverseMercator &tm,
+                        const double *easting, const double *northing,
+                        double *lat, double *lon, std::size_t n,
+                        std::size_t chunk = DEFAULT_CHUNK_SIZE) noexcept {
+  pool.parallel_for(n, chunk, [&, easting, northing, lat, lon](
+                                  std::size_t b, std::size_t e) noexcept {
+    tm.inverse(easting + b, northing + b, lat + b, lon + b, e - b);
+  });
+}
+
+} /* namespace parallel */
+
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,260 @@
+/** @file
+ * A static spatial index (k-d tree) over cartesian (ECEF) points, for
+ * nearest-neighbour and radius queries.
+ */
+
+#ifndef __DSO_SPATIAL_INDEX_HPP__
+#define __DSO_SPATIAL_INDEX_HPP__
+
+#include "core/crdtype_warppers.hpp"
+#include "geodesic.hpp"
+#include "thread_pool.hpp"
+#include "transformations.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace dso {
+
+namespace detail {
+/** A point of a dso::SpatialIndex; key holds the point's index in the input
+ * array (lower 62 bits) and, for internal nodes, the split axis (upper 2
+ * bits). Nodes are 32 bytes, i.e. two per cache line. */
+struct KdNode {
+  double c[3];
+  std::uint64_t key;
+};
+} /* namespace detail */
+
+/** @brief Chord length between two points on a sphere, given the (great
+ *         circle) arc length between them.
+ *
+ * @param[in] s Arc length [m], in the range [0, πR]
+ * @param[in] R Radius of the sphere [m]
+ * @return Chord length [m]
+ */
+inline double arc2chord(double s, double R) noexcept {
+  return 2e0 * R * std::sin(s / (2e0 * R));
+}
+
+/** @brief Arc (great circle) length between two points on a sphere, given
+ *         the chord length between them; inverse of dso::arc2chord.
+ *
+ * @param[in] c Chord length [m], in the range [0, 2R]
+ * @param[in] R Radius of the sphere [m]
+ * @return Arc length [m]
+ */
+inline double chord2arc(double c, double R) noexcept {
+  return 2e0 * R * std::asin(c / (2e0 * R));
+}
+
+/** @class SpatialIndex
+ *
+ * A static (i.e. built once, not updated) k-d tree over a set of cartesian
+ * (ECEF) points, answering k-nearest-neighbour and radius queries w.r.t the
+ * euclidean (chord) distance.
+ *
+ * The tree is balanced and stored in an implicit layout: the points are
+ * permuted so that the root of any subtree spanning the range [b, e) is the
+ * point at the middle, m = b + (e - b) / 2, with the left (resp. right)
+ * subtree spanning [b, m) (resp. [m + 1, e)). Hence, no child pointers are
+ * stored and subtrees are contiguous in memory; ranges of at most LEAF_SIZE
+ * points are not split further, but scanned linearly. Each node splits
+ * along the axis of largest extent of its points.
+ *
+ * Points are identified by their index in the input array; query results
+ * are given in terms of these indexes. Distances are in [m].
+ *
+ * For radius queries w.r.t the (geodesic) distance on the ellipsoid, see
+ * SpatialIndex::geodesic_radius. On a sphere, arc lengths convert to chord
+ * lengths exactly, see dso::arc2chord.
+ */
+class SpatialIndex {
+public:
+  /** Maximum number of points in a leaf (i.e. range not split further) */
+  static constexpr const std::size_t LEAF_SIZE = 16;
+  /** Index returned for missing results (e.g. k > size()) */
+  static constexpr const std::size_t npos =
+      std::numeric_limits<std::size_t>::max();
+
+  /** @brief Build the index from n points given in structure-of-arrays
+   *         layout.
+   * @param[in] x Cartesian x-components, size n [m]
+   * @param[in] y Cartesian y-components, size n [m]
+   * @param[in] z Cartesian z-components, size n [m]
+   * @param[in] n Number of points
+   */
+  SpatialIndex(const double *x, const double *y, const double *z,
+               std::size_t n);
+
+  /** @brief Build the index from n points given in structure-of-arrays
+   *         layout, in parallel.
+   *
+   * The tree is identical to the one built serially.
+   *
+   * @see SpatialIndex::SpatialIndex
+   */
+  SpatialIndex(ThreadPool &pool, const double *x, const double *y,
+               const double *z, std::size_t n);
+
+  /** @brief Build the index from a vector of cartesian points. */
+  explicit SpatialIndex(const std::vector<CartesianCrd> &pts);
+
+  /** @brief Build the index from a vector of cartesian points, in parallel.
+   */
+  SpatialIndex(ThreadPool &pool, const std::vector<CartesianCrd> &pts);
+
+  /** @brief Number of points in the index */
+  std::size_t size() const noexcept { return __nodes.size(); }
+
+  /** @brief Nearest point to a query point.
+   *
+   * @param[in]  x    Cartesian x-component of the query point [m]
+   * @param[in]  y    Cartesian y-component of the query point [m]
+   * @param[in]  z    Cartesian z-component of the query point [m]
+   * @param[out] dist Distance to the nearest point [m]
+   * @return Index of the nearest point; npos if the index is empty
+   */
+  std::size_t nearest(double x, double y, double z,
+                      double &dist) const noexcept {
+    std::size_t idx;
+    knn(x, y, z, 1, &idx, &dist);
+    return idx;
+  }
+
+  /** @brief Nearest point to a query point. @see SpatialIndex::nearest */
+  std::size_t nearest(const CartesianCrd &p, double &dist) const noexcept {
+    return nearest(p.x(), p.y(), p.z(), dist);
+  }
+
+  /** @brief The k nearest points to a query point.
+   *
+   * @param[in]  x    Cartesian x-component of the query point [m]
+   * @param[in]  y    Cartesian y-component of the query point [m]
+   * @param[in]  z    Cartesian z-component of the query point [m]
+   * @param[in]  k    Number of points to search for
+   * @param[out] idx  Indexes of the k nearest points, by increasing
+   *                  distance, size k; if k > size(), trailing entries are
+   *                  set to npos
+   * @param[out] dist Distances to the k nearest points, size k [m]; entries
+   *                  with no point are set to +infinity
+   * @return Number of points found, i.e. min(k, size())
+   */
+  std::size_t knn(double x, double y, double z, std::size_t k,
+                  std::size_t *idx, double *dist) const noexcept;
+
+  /** @brief The k nearest points, for a batch of nq query points given in
+   *         structure-of-arrays layout.
+   *
+   * Results are stored row-wise, i.e. the results of the i-th query at
+   * idx[i*k], ..., idx[i*k+k-1] (and likewise for dist).
+   *
+   * @see SpatialIndex::knn
+   */
+  void knn(const double *x, const double *y, const double *z, std::size_t nq,
+           std::size_t k, std::size_t *idx, double *dist) const noexcept;
+
+  /** @brief The k nearest points, for a batch of query points, in parallel.
+   * @see SpatialIndex::knn
+   */
+  void knn(ThreadPool &pool, const double *x, const double *y, const double *z,
+           std::size_t nq, std::size_t k, std::size_t *idx,
+           double *dist) const noexcept;
+
+  /** @brief All points within a given (chord) distance from a query point.
+   *
+   * @param[in]  x    Cartesian x-component of the query point [m]
+   * @param[in]  y    Cartesian y-component of the query point [m]
+   * @param[in]  z    Cartesian z-component of the query point [m]
+   * @param[in]  r    Search radius [m]
+   * @param[out] idx  Indexes of the points within r, in no particular order
+   *                  (results are appended)
+   * @param[out] dist Distances of the points within r [m] (results are
+   *                  appended)
+   */
+  void radius(double x, double y, double z, double r,
+              std::vector<std::size_t> &idx, std::vector<double> &dist) const;
+
+  /** @brief All points within a given distance, for a batch of nq query
+   *         points given in structure-of-arrays layout.
+   *
+   * Results are stored in compressed-row layout: the results of the i-th
+   * query are idx[offsets[i]], ..., idx[offsets[i+1]-1] (and likewise for
+   * dist); offsets has size nq + 1. Output vectors are overwritten.
+   *
+   * @see SpatialIndex::radius
+   */
+  void radius(const double *x, const double *y, const double *z,
+              std::size_t nq, double r, std::vector<std::size_t> &offsets,
+              std::vector<std::size_t> &idx, std::vector<double> &dist) const;
+
+  /** @brief All points within a given distance, for a batch of query
+   *         points, in parallel.
+   *
+   * Results are identical to the ones of the serial version; so are
+   * exceptions (i.e. std::bad_alloc), which are thrown to the caller.
+   *
+   * @see SpatialIndex::radius
+   */
+  void radius(ThreadPool &pool, const double *x, const double *y,
+              const double *z, std::size_t nq, double r,
+              std::vector<std::size_t> &offsets, std::vector<std::size_t> &idx,
+              std::vector<double> &dist) const;
+
+  /** @brief All points within a given geodesic distance (on the ellipsoid)
+   *         from a point on the ellipsoid.
+   *
+   * Distances are measured between the points' projections (footpoints) on
+   * the ellipsoid. Since a chord never exceeds the length of a curve
+   * joining its end points, candidates are searched for within the chord
+   * distance s + hmax (hmax accounting for the points' heights), and then
+   * filtered by their exact geodesic distance from the query point; results
+   * are hence exact, for points with |height| <= hmax.
+   *
+   * @tparam     E    The reference ellipsoid (i.e. one of dso::ellipsoid).
+   * @param[in]  lat  Geodetic latitude of the query point [rad]
+   * @param[in]  lon  Geodetic longitude of the query point [rad]
+   * @param[in]  s    Search radius, as a geodesic distance [m]
+   * @param[out] idx  Indexes of the points within s, in no particular order
+   *                  (results are appended)
+   * @param[out] dist Geodesic distances of the points within s [m] (results
+   *                  are appended)
+   * @param[in]  hmax Maximum (absolute) ellipsoidal height of the indexed
+   *                  points [m]
+   */
+  template <ellipsoid E>
+  void geodesic_radius(double lat, double lon, double s,
+                       std::vector<std::size_t> &idx,
+                       std::vector<double> &dist, double hmax = 1e4) const {
+    double x, y, z;
+    geodetic2cartesian<E>(lat, lon, 0e0, x, y, z);
+    std::vector<std::size_t> cidx;
+    std::vector<double> cdist;
+    radius(x, y, z, s + hmax, cidx, cdist);
+    for (std::size_t i : cidx) {
+      const detail::KdNode &p = __nodes[__pos[i]];
+      double plat, plon, phgt, s12, azi1, azi2;
+      cartesian2geodetic<E>(p.c[0], p.c[1], p.c[2], plat, plon, phgt);
+      geodesic_inverse<E>(lat, lon, plat, plon, s12, azi1, azi2);
+      if (s12 <= s) {
+        idx.push_back(i);
+        dist.push_back(s12);
+      }
+    }
+  }
+
+private:
+  /** Build the tree; see the constructors */
+  void build(ThreadPool *pool);
+
+  /** Nodes, in tree order */
+  std::vector<detail::KdNode> __nodes;
+  /** Position (in __nodes) of each input point */
+  std::vector<std::size_t> __pos;
+}; /* class SpatialIndex */
+
+} /* namespace dso */
+
+#endif
@@ -0,0 +1,132 @@
+/** @file
+ * Readers for station coordinate solutions, i.e. the SOLUTION/ESTIMATE
+ * block of SINEX files and CSV exports of station coordinates.
+ *
+ * Readers work on (read-only) character buffers, typically a
+ * dso::MappedFile, and fill structure-of-arrays buffers of cartesian
+ * coordinates, which can be passed directly to the batch transformations,
+ * e.g. dso::cartesian2geodetic<E>(sta.x.data(), sta.y.data(), sta.z.data(),
+ * lat, lon, hgt, sta.size()).
+ * Numbers are parsed via std::from_chars and station names are not copied
+ * (they point into the buffer). Large buffers can be split in chunks (at
+ * line boundaries) and parsed in parallel on a dso::ThreadPool; results do
+ * not depend on the number of threads used.
+ */
+
+#ifndef __DSO_STATION_READER_HPP__
+#define __DSO_STATION_READER_HPP__
+
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace dso {
+
+/** Station coordinates, in structure-of-arrays layout; all arrays have
+ * the same size.
+ *
+ * Names point into the buffer the coordinates were read from, hence they
+ * are only valid as long as the buffer is.
+ */
+struct StationCoordinates {
+  /** Station names; the 4-char site code, for SINEX */
+  std::vector<std::string_view> site;
+  /** Solution numbers (SINEX), or empty */
+  std::vector<std::string_view> soln;
+  /** Cartesian components [m] */
+  std::vector<double> x, y, z;
+  /** Standard deviations of the cartesian components [m]; 0 if unknown */
+  std::vector<double> sx, sy, sz;
+
+  /** @brief Number of stations */
+  std::size_t size() const noexcept { return x.size(); }
+
+  /** @brief Remove all stations */
+  void clear() noexcept;
+
+  /** @brief Reserve space for n stations */
+  void reserve(std::size_t n);
+
+  /** @brief Append all stations of another instance */
+  void append(const StationCoordinates &other);
+}; /* struct StationCoordinates */
+
+/** Result of the station readers */
+struct StationReadResult {
+  /** Where parsing stopped; on error, the start of the offending line */
+  const char *ptr;
+  /** std::errc{} on success, else the error */
+  std::errc ec;
+  /** Number of stations read (stations before an error are kept) */
+  std::size_t count;
+};
+
+/** Columns (0-based) of a CSV file of station coordinates; negative
+ * indexes denote missing columns.
+ */
+struct CsvColumns {
+  int site{0};
+  int x{1}, y{2}, z{3};
+  int sx{-1}, sy{-1}, sz{-1};
+  /** Field separator */
+  char sep{','};
+  /** Skip the first (non-comment) line, i.e. a header */
+  bool header{true};
+};
+
+/** @brief Read the station coordinates of the SOLUTION/ESTIMATE block of a
+ *         SINEX file.
+ *
+ * Parameters of type STAX, STAY and STAZ are read (all others are
+ * skipped); the three components of each station (i.e. site code, point
+ * code and solution number) are expected on consecutive lines, as written
+ * by all analysis centres. Fields are read by column, as defined by the
+ * SINEX format.
+ *
+ * @param[in]  first Start of the buffer, i.e. of the SINEX file
+ * @param[in]  last  End of the buffer
+ * @param[out] sta   Stations are appended to this instance
+ * @return ec is std::errc::invalid_argument if the block is missing or a
+ *         line is malformed, std::errc::result_out_of_range if a number is
+ *         not representable.
+ */
+StationReadResult read_sinex(const char *first, const char *last,
+                             StationCoordinates &sta);
+
+/** @brief Read the station coordinates of the SOLUTION/ESTIMATE block of a
+ *         SINEX file, in parallel.
+ * @see dso::read_sinex
+ */
+StationReadResult read_sinex(ThreadPool &pool, const char *first,
+                             const char *last, StationCoordinates &sta);
+
+/** @brief Read station coordinates from a CSV file.
+ *
+ * Each line holds one station; fields are separated by cols.sep (quoting
+ * is not supported) and leading/trailing blanks are trimmed. Empty lines
+ * and lines starting with '#' are skipped.
+ *
+ * @param[in]  first Start of the buffer, i.e. of the CSV file
+ * @param[in]  last  End of the buffer
+ * @param[in]  cols  The layout of the file
+ * @param[out] sta   Stations are appended to this instance
+ * @return ec is std::errc::invalid_argument if a line is malformed (e.g.
+ *         a column is missing), std::errc::result_out_of_range if a number
+ *         is not representable.
+ */
+StationReadResult read_station_csv(const char *first, const char *last,
+                                   const CsvColumns &cols,
+                                   StationCoordinates &sta);
+
+/** @brief Read station coordinates from a CSV file, in parallel.
+ * @see dso::read_station_csv
+ */
+StationReadResult read_station_csv(ThreadPool &pool, const char *first,
+                                   const char *last, const CsvColumns &cols,
+                                   StationCoordinates &sta);
+
+} /* namespace dso */
+
+#endif
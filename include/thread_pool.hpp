@@ -0,0 +1,143 @@
+/** @file
+ * A (reusable) thread pool with work stealing, used to spread batch
+ * computations over large arrays across all available cores.
+ */
+
+#ifndef __DSO_GEODESY_THREAD_POOL_HPP__
+#define __DSO_GEODESY_THREAD_POOL_HPP__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dso {
+
+/** @class ThreadPool
+ *
+ * A pool of worker threads, which execute index ranges (chunks) of parallel
+ * loops. Each thread owns a queue of chunks; when a thread runs out of work,
+ * it steals chunks from the other queues, so that the load is balanced even
+ * if chunks take different times to process.
+ *
+ * The thread calling ThreadPool::parallel_for also takes part in the
+ * computation, hence a pool of num_threads threads spawns num_threads-1
+ * workers; a pool of a single thread runs everything on the calling thread.
+ *
+ * Chunk boundaries depend only on the size of the loop and the chunk size
+ * (never on the number of threads or on scheduling), hence for elementwise
+ * computations results are identical irrespective of the number of threads
+ * used.
+ *
+ * The pool is created once and can be reused for any number of parallel
+ * loops; it can also be used concurrently by multiple threads.
+ */
+class ThreadPool {
+public:
+  /** @brief Constructor.
+   * @param[in] num_threads Number of threads to use (including the calling
+   *            thread). If 0, std::thread::hardware_concurrency() is used.
+   */
+  explicit ThreadPool(unsigned num_threads = 0);
+
+  /** @brief Destructor; joins all worker threads. */
+  ~ThreadPool() noexcept;
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+
+  /** @brief Number of threads (including the calling thread) */
+  unsigned num_threads() const noexcept {
+    return static_cast<unsigned>(__workers.size()) + 1;
+  }
+
+  /** @brief Execute f over the range [0, n) in chunks, in parallel.
+   *
+   * The range [0, n) is split in chunks of (at most) chunk indexes, i.e.
+   * [0, chunk), [chunk, 2*chunk), ...; f(begin, end) is called once for each
+   * chunk, from any of the pool's threads. The function returns when all
+   * chunks have been processed.
+   *
+   * @param[in] n     Size of the range
+   * @param[in] chunk Chunk size; if 0, the whole range is one chunk
+   * @param[in] f     A callable with signature void(std::size_t begin,
+   *                  std::size_t end); it should not throw.
+   */
+  template <typename F>
+  void parallel_for(std::size_t n, std::size_t chunk, F &&f) noexcept {
+    if (!n)
+      return;
+    if (!chunk || chunk > n)
+      chunk = n;
+    /* serial execution, if only one chunk or no workers */
+    if (chunk == n || __workers.empty()) {
+      for (std::size_t b = 0; b < n; b += chunk)
+        f(b, (n - b > chunk) ? b + chunk : n);
+      return;
+    }
+    using Fn = std::remove_reference_t<F>;
+    Job job(
+        [](void *ctx, std::size_t b, std::size_t e) noexcept {
+          (*static_cast<Fn *>(ctx))(b, e);
+        },
+        const_cast<void *>(static_cast<const void *>(&f)));
+    run(job, n, chunk);
+  }
+
+private:
+  /** A parallel loop; the callable is type-erased. */
+  struct Job {
+    void (*fn)(void *, std::size_t, std::size_t) noexcept;
+    void *ctx;
+    std::size_t pending{0};
+    std::mutex m;
+    std::condition_variable cv;
+    Job(void (*f)(void *, std::size_t, std::size_t) noexcept,
+        void *c) noexcept
+        : fn(f), ctx(c) {}
+  };
+
+  /** A chunk of a parallel loop, i.e. the range [begin, end) */
+  struct Task {
+    Job *job;
+    std::size_t begin, end;
+  };
+
+  /** A per-thread queue of tasks. The owner pops from the back, thieves
+   * steal from the front. */
+  struct Queue {
+    std::mutex m;
+    std::deque<Task> tasks;
+  };
+
+  /** Split [0,n) in chunks, distribute them and wait for completion */
+  void run(Job &job, std::size_t n, std::size_t chunk) noexcept;
+
+  /** Get a task, either from queue `own` or (else) steal one */
+  bool acquire(std::size_t own, Task &task) noexcept;
+
+  /** Execute a task and signal its job */
+  static void execute(const Task &task) noexcept;
+
+  /** Main loop of worker threads */
+  void work(std::size_t id) noexcept;
+
+  /* one queue per thread; queue 0 belongs to the calling thread(s) */
+  std::vector<std::unique_ptr<Queue>> __queues;
+  std::vector<std::thread> __workers;
+  /* used to wake up sleeping workers when new tasks are pushed */
+  std::mutex __wake_m;
+  std::condition_variable __wake_cv;
+  std::size_t __epoch{0};
+  bool __stop{false};
+}; /* class ThreadPool */
+
+} /* namespace dso */
+
+#endif
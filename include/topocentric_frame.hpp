@@ -0,0 +1,174 @@
+/** @file
+ * A topocentric (local, East/North/Up) reference frame, anchored at some
+ * station.
+ */
+
+#ifndef __DSO_TOPOCENTRIC_FRAME_HPP__
+#define __DSO_TOPOCENTRIC_FRAME_HPP__
+
+#include "core/crd_transformations.hpp"
+#include "core/crdtype_warppers.hpp"
+#include "ellipsoid.hpp"
+#include <cmath>
+#include <cstddef>
+
+namespace dso {
+
+/** @class TopocentricFrame
+ *
+ * A topocentric (East/North/Up) frame, with origin at some station. The
+ * origin (in ECEF) and the rotation matrix R = [e, n, u] (as computed by
+ * dso::geodetic2lvlh at the station's geodetic coordinates) are computed
+ * once, at construction. Transformations between ECEF coordinates and
+ * topocentric coordinates (either cartesian ENU or azimuth/elevation/range)
+ * then only need a 3x3 matrix-vector product per point; the rotation is
+ * never recomputed.
+ *
+ * Batch (structure-of-arrays) versions of all transformations are provided,
+ * which are vectorized.
+ */
+class TopocentricFrame {
+public:
+  /** @brief Constructor given the geodetic coordinates of the station.
+   * @param[in] ell The reference ellipsoid
+   * @param[in] sta Geodetic coordinates of the station (origin)
+   */
+  TopocentricFrame(const Ellipsoid &ell, const GeodeticCrd &sta) noexcept;
+
+  /** @brief Constructor given the (ECEF) cartesian coordinates of the
+   *         station.
+   * @param[in] ell The reference ellipsoid
+   * @param[in] sta Cartesian coordinates of the station (origin)
+   */
+  TopocentricFrame(const Ellipsoid &ell, const CartesianCrd &sta) noexcept;
+
+  /** @brief Cartesian (ECEF) coordinates of the origin */
+  const CartesianCrd &origin() const noexcept { return __x0; }
+
+  /** @brief Geodetic coordinates of the origin */
+  const GeodeticCrd &origin_geodetic() const noexcept { return __g0; }
+
+  /** @brief The rotation matrix R = [e, n, u], i.e. ΔX = R * ENU
+   *  @see dso::geodetic2lvlh
+   */
+  const Eigen::Matrix<double, 3, 3> &rotation() const noexcept { return __R; }
+
+  /** @brief Cartesian (ECEF) coordinates of a point to topocentric (ENU)
+   *         coordinates, w.r.t the frame's origin.
+   *
+   * @param[in]  x  Cartesian x-component [m]
+   * @param[in]  y  Cartesian y-component [m]
+   * @param[in]  z  Cartesian z-component [m]
+   * @param[out] e  East component [m]
+   * @param[out] n  North component [m]
+   * @param[out] u  Up component [m]
+   */
+  void cartesian2enu(double x, double y, double z, double &e, double &n,
+                     double &u) const noexcept {
+    const double dx = x - __x0.x();
+    const double dy = y - __x0.y();
+    const double dz = z - __x0.z();
+    e = __R(0, 0) * dx + __R(1, 0) * dy + __R(2, 0) * dz;
+    n = __R(0, 1) * dx + __R(1, 1) * dy + __R(2, 1) * dz;
+    u = __R(0, 2) * dx + __R(1, 2) * dy + __R(2, 2) * dz;
+  }
+
+  /** @brief Topocentric (ENU) coordinates to cartesian (ECEF) coordinates.
+   *
+   * @param[in]  e  East component [m]
+   * @param[in]  n  North component [m]
+   * @param[in]  u  Up component [m]
+   * @param[out] x  Cartesian x-component [m]
+   * @param[out] y  Cartesian y-component [m]
+   * @param[out] z  Cartesian z-component [m]
+   */
+  void enu2cartesian(double e, double n, double u, double &x, double &y,
+                     double &z) const noexcept {
+    x = __x0.x() + (__R(0, 0) * e + __R(0, 1) * n + __R(0, 2) * u);
+    y = __x0.y() + (__R(1, 0) * e + __R(1, 1) * n + __R(1, 2) * u);
+    z = __x0.z() + (__R(2, 0) * e + __R(2, 1) * n + __R(2, 2) * u);
+  }
+
+  /** @brief Cartesian (ECEF) coordinates of a point to azimuth, elevation
+   *         and range, w.r.t the frame's origin.
+   *
+   * @param[in]  x   Cartesian x-component [m]
+   * @param[in]  y   Cartesian y-component [m]
+   * @param[in]  z   Cartesian z-component [m]
+   * @param[out] az  Azimuth (from North, clockwise) in range [0, 2π) [rad]
+   * @param[out] el  Elevation in range [-π/2, π/2] [rad]
+   * @param[out] rng Range, i.e. distance from the origin [m]
+   */
+  void cartesian2aer(double x, double y, double z, double &az, double &el,
+                     double &rng) const noexcept {
+    double e, n, u;
+    cartesian2enu(x, y, z, e, n, u);
+    const double a = std::atan2(e, n);
+    az = (a < 0e0) ? a + 2e0 * DPI : a;
+    /* a tiny negative angle rounds to 2π */
+    if (az >= 2e0 * DPI)
+      az -= 2e0 * DPI;
+    el = std::atan2(u, std::sqrt(e * e + n * n));
+    rng = std::sqrt(e * e + n * n + u * u);
+  }
+
+  /** @brief Azimuth, elevation and range w.r.t the frame's origin, to
+   *         cartesian (ECEF) coordinates.
+   *
+   * @param[in]  az  Azimuth (from North, clockwise) [rad]
+   * @param[in]  el  Elevation [rad]
+   * @param[in]  rng Range, i.e. distance from the origin [m]
+   * @param[out] x   Cartesian x-component [m]
+   * @param[out] y   Cartesian y-component [m]
+   * @param[out] z   Cartesian z-component [m]
+   */
+  void aer2cartesian(double az, double el, double rng, double &x, double &y,
+                     double &z) const noexcept {
+    const double hr = rng * std::cos(el);
+    enu2cartesian(hr * std::sin(az), hr * std::cos(az), rng * std::sin(el), x,
+                  y, z);
+  }
+
+  /** @brief Cartesian (ECEF) to topocentric (ENU) coordinates, for a batch
+   *         of n points, given in structure-of-arrays layout.
+   * @see TopocentricFrame::cartesian2enu
+   */
+  void cartesian2enu(const double *x, const double *y, const double *z,
+                     double *e, double *n, double *u,
+                     std::size_t num_pts) const noexcept;
+
+  /** @brief Topocentric (ENU) to cartesian (ECEF) coordinates, for a batch
+   *         of n points, given in structure-of-arrays layout.
+   * @see TopocentricFrame::enu2cartesian
+   */
+  void enu2cartesian(const double *e, const double *n, const double *u,
+                     double *x, double *y, double *z,
+                     std::size_t num_pts) const noexcept;
+
+  /** @brief Cartesian (ECEF) coordinates to azimuth, elevation and range,
+   *         for a batch of n points, given in structure-of-arrays layout.
+   * @see TopocentricFrame::cartesian2aer
+   */
+  void cartesian2aer(const double *x, const double *y, const double *z,
+                     double *az, double *el, double *rng,
+                     std::size_t num_pts) const noexcept;
+
+  /** @brief Azimuth, elevation and range to cartesian (ECEF) coordinates,
+   *         for a batch of n points, given in structure-of-arrays layout.
+   * @see TopocentricFrame::aer2cartesian
+   */
+  void aer2cartesian(const double *az, const double *el, const double *rng,
+                     double *x, double *y, double *z,
+                     std::size_t num_pts) const noexcept;
+
+private:
+  /** Origin, in cartesian (ECEF) and geodetic coordinates */
+  CartesianCrd __x0;
+  GeodeticCrd __g0;
+  /** Rotation matrix R = [e, n, u] */
+  Eigen::Matrix<double, 3, 3> __R;
+}; /* class TopocentricFrame */
+
+} /* namespace dso */
+
+#endif
@@ -6,6 +6,7 @@
 #define __DSO_COORDINATE_TRANSFORMATIONS_HPP__
 
 #include "core/crd_transformations.hpp"
+#include "core/crdtype_spans.hpp"
 #include "core/crdtype_warppers.hpp"
 #include "ellipsoid.hpp"
 
@@ -14,6 +15,9 @@ namespace dso {
 /* @brief Geodetic (ellipsoidal) to cartesian coordinates.
  *
  * @tparam      E    The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @tparam      T    The scalar type, e.g. double, float or a SIMD pack type
+ *                   (see core/scalar_traits.hpp); deduced from the output
+ *                   arguments only, the inputs are converted to T
  * @param[in]   lat  Geodetic latitude (-π/2, π/2) [rad]
  * @param[in]   lon  Geodetic longtitude in rage (-π, π) [rad]
  * @param[in]   h    Ellipsoidal height [m]
@@ -21,28 +25,35 @@ namespace dso {
  * @param[out]  y    Cartesian y-component [m]
  * @param[out]  z    Cartesian z-component [m]
  */
-template <ellipsoid E>
-void geodetic2cartesian(double lat, double lon, double h, double &x, double &y,
-                        double &z) noexcept {
-  /* Eccentricity squared. */
-  constexpr const double e2 = dso::eccentricity_squared<E>();
-
-  /* Radius of curvature in the prime vertical. */
-  const double Rn = dso::N<E>(lat);
-
-  /* Trigonometric numbers. */
-  const double sf = std::sin(lat);
-  const double cf = std::cos(lat);
-  const double sl = std::sin(lon);
-  const double cl = std::cos(lon);
-
-  /* Compute geocentric rectangular coordinates. */
-  x = (Rn + h) * cf * cl;
-  y = (Rn + h) * cf * sl;
-  z = ((1e0 - e2) * Rn + h) * sf;
+template <ellipsoid E, typename T = double>
+void geodetic2cartesian(core::identity_t<T> lat, core::identity_t<T> lon,
+                        core::identity_t<T> h, T &x, T &y, T &z) noexcept {
+  core::geodetic2cartesian(ellipsoid_constants<E>, lat, lon, h, x, y, z);
+}
 
-  /* Finished. */
-  return;
+/** @brief Geodetic (ellipsoidal) to cartesian coordinates, for a batch of
+ *         points.
+ *
+ * Batch version of dso::geodetic2cartesian; coordinates are given and
+ * returned in structure-of-arrays layout, i.e. as seperate (contiguous)
+ * arrays for each component. The sine and cosine of each angle are only
+ * computed once and the loop over the points is vectorized; see
+ * dso::core::geodetic2cartesian for details.
+ *
+ * @tparam      E    The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]   lat  Geodetic latitudes, size n [rad]
+ * @param[in]   lon  Geodetic longtitudes, size n [rad]
+ * @param[in]   hgt  Ellipsoidal heights, size n [m]
+ * @param[out]  x    Cartesian x-components, size n [m]
+ * @param[out]  y    Cartesian y-components, size n [m]
+ * @param[out]  z    Cartesian z-components, size n [m]
+ * @param[in]   n    Number of points
+ */
+template <ellipsoid E>
+void geodetic2cartesian(const double *lat, const double *lon,
+                        const double *hgt, double *x, double *y, double *z,
+                        std::size_t n) noexcept {
+  core::geodetic2cartesian(ellipsoid_constants<E>, lat, lon, hgt, x, y, z, n);
 }
 
 /** @brief Cartesian to geodetic/ellipsoidal.
@@ -54,113 +65,273 @@ void geodetic2cartesian(double lat, double lon, double h, double &x, double &y,
  * accelerated by Halley's method", J. Geodesy (2006), 79(12): 689-693
  *
  * @tparam     E    The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @tparam     P    The precision tier (see dso::precision); tiers other
+ *                  than precision::full are only available for double.
+ * @tparam     T    The scalar type, e.g. double, float or a SIMD pack type
+ *                  (see core/scalar_traits.hpp); deduced from the output
+ *                  arguments only, the inputs are converted to T
  * @param[in]  x    Cartesian x-component (meters)
  * @param[in]  y    Cartesian y-component (meters)
  * @param[out] lat  Geodetic latitude (radians)
  * @param[out] lon  Geodetic longtitude (radians)
  * @param[out] h    Ellipsoidal height (meters)
  */
+template <ellipsoid E, precision P = precision::full, typename T = double>
+void cartesian2geodetic(core::identity_t<T> x, core::identity_t<T> y,
+                        core::identity_t<T> z, T &lat, T &lon,
+                        T &hgt) noexcept {
+  core::cartesian2geodetic<P>(ellipsoid_constants<E>, x, y, z, lat, lon, hgt);
+}
+
+/** @brief Cartesian to geodetic/ellipsoidal, for a batch of points.
+ *
+ * Batch version of dso::cartesian2geodetic; coordinates are given and
+ * returned in structure-of-arrays layout, i.e. as seperate (contiguous)
+ * arrays for each component. The loop over the points is branch-free and
+ * vectorized; see dso::core::cartesian2geodetic for details.
+ *
+ * @tparam     E    The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  x    Cartesian x-components, size n (meters)
+ * @param[in]  y    Cartesian y-components, size n (meters)
+ * @param[in]  z    Cartesian z-components, size n (meters)
+ * @param[out] lat  Geodetic latitudes, size n (radians)
+ * @param[out] lon  Geodetic longtitudes, size n (radians)
+ * @param[out] hgt  Ellipsoidal heights, size n (meters)
+ * @param[in]  n    Number of points
+ */
 template <ellipsoid E>
-void cartesian2geodetic(double x, double y, double z, double &lat, double &lon,
-                        double &hgt) noexcept {
-  /* Functions of ellipsoid parameters. */
-  constexpr double a = ellipsoid_traits<E>::a;
-  constexpr double aeps2 = a * a * 1e-32;
-  constexpr double e2 = eccentricity_squared<E>();
-  constexpr double e4t = e2 * e2 * 1.5e0;
-  constexpr double ep2 = 1.0e0 - e2;
-#if defined(__clang__)
-  /* clang goes pedantic on this! std::sqrt is not constexpr */
-  const double ep = std::sqrt(ep2);
-  const double aep = a * ep;
-#else
-  constexpr double ep = std::sqrt(ep2);
-  constexpr double aep = a * ep;
-#endif
+void cartesian2geodetic(const double *x, const double *y, const double *z,
+                        double *lat, double *lon, double *hgt,
+                        std::size_t n) noexcept {
+  core::cartesian2geodetic(ellipsoid_constants<E>, x, y, z, lat, lon, hgt, n);
+}
 
-  /* Compute distance from polar axis squared. */
-  const double p2 = x * x + y * y;
-
-  /* Compute longitude. */
-  lon = (p2) ? std::atan2(y, x) : 0e0;
-
-  /* Ensure that Z-coordinate is unsigned. */
-  const double absz = std::abs(z);
-
-  if (p2 > aeps2) {
-    /* Continue unless at the poles */
-    /* Compute distance from polar axis. */
-    const double p = std::sqrt(p2);
-    /* Normalize. */
-    const double s0 = absz / a;
-    const double pn = p / a;
-    const double zp = ep * s0;
-    /* Prepare Newton correction factors. */
-    const double c0 = ep * pn;
-    const double c02 = c0 * c0;
-    const double c03 = c02 * c0;
-    const double s02 = s0 * s0;
-    const double s03 = s02 * s0;
-    const double a02 = c02 + s02;
-    const double a0 = std::sqrt(a02);
-    const double a03 = a02 * a0;
-    const double d0 = zp * a03 + e2 * s03;
-    const double f0 = pn * a03 - e2 * c03;
-    /* Prepare Halley correction factor. */
-    const double b0 = e4t * s02 * c02 * pn * (a0 - ep);
-    const double s1 = d0 * f0 - b0 * s0;
-    const double cp = ep * (f0 * f0 - b0 * c0);
-    /* Evaluate latitude and height. */
-    lat = std::atan(s1 / cp);
-    const double s12 = s1 * s1;
-    const double cp2 = cp * cp;
-    hgt = (p * cp + absz * s1 - a * std::sqrt(ep2 * s12 + cp2)) /
-          std::sqrt(s12 + cp2);
-  } else {
-    /* Special case: pole. */
-    lat = dso::DPI / 2e0;
-    hgt = absz - aep;
-  }
-
-  /* Restore sign of latitude. */
-  if (z < 0.e0)
-    lat = -lat;
-
-  /* Finished. */
-  return;
+/** @brief Propagate covariance matrices from geodetic to cartesian
+ *         coordinates, for a batch of points.
+ *
+ * Covariance matrices are packed, i.e. 6 elements per point; see
+ * core/crd_jacobians.hpp and dso::core::geodetic2cartesian_covariance.
+ *
+ * @tparam     E    The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  lat  Geodetic latitudes, size n [rad]
+ * @param[in]  lon  Geodetic longtitudes, size n [rad]
+ * @param[in]  hgt  Ellipsoidal heights, size n [m]
+ * @param[in]  cov  Covariance matrices of (φ, λ, h), size 6n
+ * @param[out] out  Covariance matrices of (x, y, z), size 6n; may be cov
+ * @param[in]  n    Number of points
+ */
+template <ellipsoid E>
+void geodetic2cartesian_covariance(const double *lat, const double *lon,
+                                   const double *hgt, const double *cov,
+                                   double *out, std::size_t n) noexcept {
+  core::geodetic2cartesian_covariance(ellipsoid_constants<E>, lat, lon, hgt,
+                                      cov, out, n);
+}
+
+/** @brief Propagate covariance matrices from cartesian to geodetic
+ *         coordinates, for a batch of points, given their geodetic
+ *         coordinates.
+ * @see dso::geodetic2cartesian_covariance
+ */
+template <ellipsoid E>
+void cartesian2geodetic_covariance(const double *lat, const double *lon,
+                                   const double *hgt, const double *cov,
+                                   double *out, std::size_t n) noexcept {
+  core::cartesian2geodetic_covariance(ellipsoid_constants<E>, lat, lon, hgt,
+                                      cov, out, n);
 }
 
 template <typename C = CartesianCrd>
-inline SphericalCrd cartesian2spherical(const /*CartesianCrd*/ C &v) noexcept {
+inline SphericalCrdT<crd_scalar_t<C>>
+cartesian2spherical(const /*CartesianCrd*/ C &v) noexcept {
   static_assert(dso::CoordinateTypeTraits<C>::isCartesian);
-  SphericalCrd s;
+  SphericalCrdT<crd_scalar_t<C>> s;
   cartesian2spherical(v.x(), v.y(), v.z(), s.r(), s.lat(), s.lon());
   return s;
 }
 
 template <typename S = SphericalCrd>
-inline CartesianCrd spherical2cartesian(const /*SphericalCrd*/ S &v) noexcept {
+inline CartesianCrdT<crd_scalar_t<S>>
+spherical2cartesian(const /*SphericalCrd*/ S &v) noexcept {
   static_assert(dso::CoordinateTypeTraits<S>::isSpherical);
-  CartesianCrd s;
+  CartesianCrdT<crd_scalar_t<S>> s;
   spherical2cartesian(v.r(), v.lat(), v.lon(), s.x(), s.y(), s.z());
   return s;
 }
 
 template <ellipsoid E, typename G = GeodeticCrd>
-CartesianCrd geodetic2cartesian(const /*GeodeticCrd*/ G &v) noexcept {
+CartesianCrdT<crd_scalar_t<G>>
+geodetic2cartesian(const /*GeodeticCrd*/ G &v) noexcept {
   static_assert(dso::CoordinateTypeTraits<G>::isGeodetic);
-  CartesianCrd s;
+  CartesianCrdT<crd_scalar_t<G>> s;
   geodetic2cartesian<E>(v.lat(), v.lon(), v.hgt(), s.x(), s.y(), s.z());
   return s;
 }
 
 template <ellipsoid E, typename C = CartesianCrd>
-GeodeticCrd cartesian2geodetic(const /*CartesianCrd*/ C &v) noexcept {
+GeodeticCrdT<crd_scalar_t<C>>
+cartesian2geodetic(const /*CartesianCrd*/ C &v) noexcept {
   static_assert(dso::CoordinateTypeTraits<C>::isCartesian);
-  GeodeticCrd s;
+  GeodeticCrdT<crd_scalar_t<C>> s;
   cartesian2geodetic<E>(v.x(), v.y(), v.z(), s.lat(), s.lon(), s.hgt());
   return s;
 }
+
+/** @brief Geodetic (ellipsoidal) to cartesian coordinates, using an
+ *         ellipsoid known at runtime.
+ *
+ * @param[in] v   Geodetic coordinates (any type with isGeodetic trait).
+ * @param[in] ell The reference ellipsoid.
+ * @return Cartesian coordinates.
+ */
+template <typename G = GeodeticCrd>
+CartesianCrdT<crd_scalar_t<G>>
+geodetic2cartesian(const /*GeodeticCrd*/ G &v, const Ellipsoid &ell) noexcept {
+  static_assert(dso::CoordinateTypeTraits<G>::isGeodetic);
+  CartesianCrdT<crd_scalar_t<G>> s;
+  ell.geodetic2cartesian(v.lat(), v.lon(), v.hgt(), s.x(), s.y(), s.z());
+  return s;
+}
+
+/** @brief Cartesian to geodetic/ellipsoidal coordinates, using an
+ *         ellipsoid known at runtime.
+ *
+ * @param[in] v   Cartesian coordinates (any type with isCartesian trait).
+ * @param[in] ell The reference ellipsoid.
+ * @return Geodetic coordinates.
+ */
+template <typename C = CartesianCrd>
+GeodeticCrdT<crd_scalar_t<C>>
+cartesian2geodetic(const /*CartesianCrd*/ C &v, const Ellipsoid &ell) noexcept {
+  static_assert(dso::CoordinateTypeTraits<C>::isCartesian);
+  GeodeticCrdT<crd_scalar_t<C>> s;
+  ell.cartesian2geodetic(v.x(), v.y(), v.z(), s.lat(), s.lon(), s.hgt());
+  return s;
+}
+
+/** @brief Geodetic (ellipsoidal) to cartesian coordinates, for spans of
+ *         coordinates (see core/crdtype_spans.hpp).
+ *
+ * Spans in SoA layout are transformed directly by the batch
+ * dso::geodetic2cartesian; other layouts (AoS, records, strided columns),
+ * as well as spans sharing memory, are transformed in cache-sized blocks
+ * (see dso::core::apply_batch), i.e. no copies of the input or output are
+ * allocated.
+ *
+ * @tparam     E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @param[in]  g Span of geodetic coordinates (double precision)
+ * @param[out] c Span of cartesian coordinates (double precision), of (at
+ *               least) the size of g; may refer to the memory of g,
+ *               i.e. the transformation may be performed in place
+ */
+template <ellipsoid E, typename G, typename C>
+void geodetic2cartesian(const G &g, const C &c) noexcept {
+  static_assert(CoordinateTypeTraits<G>::isSpan &&
+                CoordinateTypeTraits<G>::isGeodetic);
+  static_assert(CoordinateTypeTraits<C>::isSpan &&
+                CoordinateTypeTraits<C>::isCartesian &&
+                !CoordinateTypeTraits<C>::isConst);
+  static_assert(std::is_same_v<crd_scalar_t<G>, double> &&
+                std::is_same_v<crd_scalar_t<C>, double>);
+  core::apply_batch(g, c,
+                    [](const double *lat, const double *lon,
+                       const double *hgt, double *x, double *y, double *z,
+                       std::size_t n) {
+                      core::geodetic2cartesian(ellipsoid_constants<E>, lat,
+                                               lon, hgt, x, y, z, n);
+                    });
+}
+
+/** @brief Cartesian to geodetic/ellipsoidal coordinates, for spans of
+ *         coordinates.
+ * @see dso::geodetic2cartesian(const G &g, const C &c)
+ */
+template <ellipsoid E, typename C, typename G>
+void cartesian2geodetic(const C &c, const G &g) noexcept {
+  static_assert(CoordinateTypeTraits<C>::isSpan &&
+                CoordinateTypeTraits<C>::isCartesian);
+  static_assert(CoordinateTypeTraits<G>::isSpan &&
+                CoordinateTypeTraits<G>::isGeodetic &&
+                !CoordinateTypeTraits<G>::isConst);
+  static_assert(std::is_same_v<crd_scalar_t<C>, double> &&
+                std::is_same_v<crd_scalar_t<G>, double>);
+  core::apply_batch(c, g,
+                    [](const double *x, const double *y, const double *z,
+                       double *lat, double *lon, double *hgt, std::size_t n) {
+                      core::cartesian2geodetic(ellipsoid_constants<E>, x, y,
+                                               z, lat, lon, hgt, n);
+                    });
+}
+
+/** @brief Geodetic (ellipsoidal) to cartesian coordinates, for spans of
+ *         coordinates, using an ellipsoid known at runtime.
+ * @see dso::geodetic2cartesian(const G &g, const C &c)
+ */
+template <typename G, typename C>
+void geodetic2cartesian(const G &g, const C &c, const Ellipsoid &ell) noexcept {
+  static_assert(CoordinateTypeTraits<G>::isSpan &&
+                CoordinateTypeTraits<G>::isGeodetic);
+  static_assert(CoordinateTypeTraits<C>::isSpan &&
+                CoordinateTypeTraits<C>::isCartesian &&
+                !CoordinateTypeTraits<C>::isConst);
+  static_assert(std::is_same_v<crd_scalar_t<G>, double> &&
+                std::is_same_v<crd_scalar_t<C>, double>);
+  core::apply_batch(g, c,
+                    [&ell](const double *lat, const double *lon,
+                           const double *hgt, double *x, double *y,
+                           double *z, std::size_t n) {
+                      ell.geodetic2cartesian(lat, lon, hgt, x, y, z, n);
+                    });
+}
+
+/** @brief Cartesian to geodetic/ellipsoidal coordinates, for spans of
+ *         coordinates, using an ellipsoid known at runtime.
+ * @see dso::geodetic2cartesian(const G &g, const C &c)
+ */
+template <typename C, typename G>
+void cartesian2geodetic(const C &c, const G &g, const Ellipsoid &ell) noexcept {
+  static_assert(CoordinateTypeTraits<C>::isSpan &&
+                CoordinateTypeTraits<C>::isCartesian);
+  static_assert(CoordinateTypeTraits<G>::isSpan &&
+                CoordinateTypeTraits<G>::isGeodetic &&
+                !CoordinateTypeTraits<G>::isConst);
+  static_assert(std::is_same_v<crd_scalar_t<C>, double> &&
+                std::is_same_v<crd_scalar_t<G>, double>);
+  core::apply_batch(c, g,
+                    [&ell](const double *x, const double *y, const double *z,
+                           double *lat, double *lon, double *hgt,
+                           std::size_t n) {
+                      ell.cartesian2geodetic(x, y, z, lat, lon, hgt, n);
+                    });
+}
+
+/** @brief Cartesian to spherical coordinates, for spans of coordinates (of
+ *         any scalar type); the output may refer to the memory of the input.
+ */
+template <typename C, typename S>
+void cartesian2spherical(const C &c, const S &s) noexcept {
+  static_assert(CoordinateTypeTraits<C>::isSpan &&
+                CoordinateTypeTraits<C>::isCartesian);
+  static_assert(CoordinateTypeTraits<S>::isSpan &&
+                CoordinateTypeTraits<S>::isSpherical &&
+                !CoordinateTypeTraits<S>::isConst);
+  for (std::size_t i = 0; i < c.size(); i++)
+    s[i] = cartesian2spherical(c[i]);
+}
+
+/** @brief Spherical to cartesian coordinates, for spans of coordinates (of
+ *         any scalar type); the output may refer to the memory of the input.
+ */
+template <typename S, typename C>
+void spherical2cartesian(const S &s, const C &c) noexcept {
+  static_assert(CoordinateTypeTraits<S>::isSpan &&
+                CoordinateTypeTraits<S>::isSpherical);
+  static_assert(CoordinateTypeTraits<C>::isSpan &&
+                CoordinateTypeTraits<C>::isCartesian &&
+                !CoordinateTypeTraits<C>::isConst);
+  for (std::size_t i = 0; i < s.size(); i++)
+    c[i] = spherical2cartesian(s[i]);
+}
 } /* namespace dso */
 
 #endif
@@ -0,0 +1,234 @@
+/** @file
+ * Transverse Mercator (TM) projection and the UTM grid system.
+ *
+ * As for the ellipsoid itself, there are two ways to use the projection:
+ * * 1. If the ellipsoid of choice is known at compile time, use the template
+ *      functions, e.g.
+ *      geodetic2utm<ellipsoid::wgs84>(lat, lon, zone, hemisphere, E, N);
+ *      The series coefficients of the ellipsoid
+ *      (dso::transverse_mercator_constants) are then computed at compile
+ *      time.
+ * * 2. If the ellipsoid of choice is only known at runtime, construct a
+ *      dso::TransverseMercator instance, which computes the coefficients
+ *      once, e.g.
+ *      TransverseMercator tm(Ellipsoid(a, f), lon0, k0, fe, fn);
+ *      tm.forward(lat, lon, E, N);
+ *
+ * All angles are in [rad], distances in [m].
+ *
+ * [1] C. F. F. Karney, Transverse Mercator with an accuracy of a few
+ *     nanometers, J Geod (2011) 85:475–485
+ */
+
+#ifndef __DSO_TRANSVERSE_MERCATOR_HPP__
+#define __DSO_TRANSVERSE_MERCATOR_HPP__
+
+#include "core/transverse_mercator_core.hpp"
+#include "ellipsoid.hpp"
+#include <cstddef>
+
+namespace dso {
+
+/** @brief Transverse Mercator constants (i.e. the Krüger series
+ *         coefficients) of a reference ellipsoid, computed at compile time.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ */
+template <ellipsoid E>
+inline constexpr core::TransverseMercatorConstants
+    transverse_mercator_constants{ellipsoid_traits<E>::a,
+                                  ellipsoid_traits<E>::f};
+
+/** @brief Geodetic to Transverse Mercator grid coordinates.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodetic2tm
+ */
+template <ellipsoid E>
+void geodetic2tm(const core::TransverseMercatorGrid &g, double lat,
+                 double lon, double &easting, double &northing) noexcept {
+  core::geodetic2tm(transverse_mercator_constants<E>, g, lat, lon, easting,
+                    northing);
+}
+
+/** @brief Transverse Mercator grid to geodetic coordinates.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::tm2geodetic
+ */
+template <ellipsoid E>
+void tm2geodetic(const core::TransverseMercatorGrid &g, double easting,
+                 double northing, double &lat, double &lon) noexcept {
+  core::tm2geodetic(transverse_mercator_constants<E>, g, easting, northing, lat,
+                    lon);
+}
+
+/** @brief Geodetic to UTM coordinates; the zone is selected automatically.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodetic2utm
+ */
+template <ellipsoid E>
+void geodetic2utm(double lat, double lon, int &zone, bool &north,
+                  double &easting, double &northing) noexcept {
+  core::geodetic2utm(transverse_mercator_constants<E>, lat, lon, zone, north,
+                     easting, northing);
+}
+
+/** @brief UTM to geodetic coordinates.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::utm2geodetic
+ */
+template <ellipsoid E>
+void utm2geodetic(int zone, bool north, double easting, double northing,
+                  double &lat, double &lon) noexcept {
+  core::utm2geodetic(transverse_mercator_constants<E>, zone, north, easting,
+                     northing, lat, lon);
+}
+
+/** @brief Geodetic to Transverse Mercator grid coordinates, for a batch of
+ *         n points.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodetic2tm
+ */
+template <ellipsoid E>
+void geodetic2tm(const core::TransverseMercatorGrid &g, const double *lat,
+                 const double *lon, double *easting, double *northing,
+                 std::size_t n) noexcept {
+  core::geodetic2tm(transverse_mercator_constants<E>, g, lat, lon, easting,
+                    northing, n);
+}
+
+/** @brief Transverse Mercator grid to geodetic coordinates, for a batch of
+ *         n points.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::tm2geodetic
+ */
+template <ellipsoid E>
+void tm2geodetic(const core::TransverseMercatorGrid &g, const double *easting,
+                 const double *northing, double *lat, double *lon,
+                 std::size_t n) noexcept {
+  core::tm2geodetic(transverse_mercator_constants<E>, g, easting, northing, lat,
+                    lon, n);
+}
+
+/** @brief Geodetic to UTM coordinates, for a batch of n points; zones are
+ *         selected per point.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::geodetic2utm
+ */
+template <ellipsoid E>
+void geodetic2utm(const double *lat, const double *lon, int *zone,
+                  bool *north, double *easting, double *northing,
+                  std::size_t n) noexcept {
+  core::geodetic2utm(transverse_mercator_constants<E>, lat, lon, zone, north,
+                     easting, northing, n);
+}
+
+/** @brief UTM to geodetic coordinates, for a batch of n points.
+ *
+ * @tparam E The reference ellipsoid (i.e. one of dso::ellipsoid).
+ * @see dso::core::utm2geodetic
+ */
+template <ellipsoid E>
+void utm2geodetic(const int *zone, const bool *north, const double *easting,
+                  const double *northing, double *lat, double *lon,
+                  std::size_t n) noexcept {
+  core::utm2geodetic(transverse_mercator_constants<E>, zone, north, easting,
+                     northing, lat, lon, n);
+}
+
+/** @class TransverseMercator
+ *
+ * A Transverse Mercator grid on a reference ellipsoid known only at runtime.
+ * The series coefficients of the ellipsoid are computed once, at
+ * construction, and shared by all subsequent projections.
+ *
+ * Grids with a latitude of origin other than the equator are supported by
+ * absorbing the meridian arc to the origin into the false northing.
+ */
+class TransverseMercator {
+public:
+  /** @brief Constructor from a reference ellipsoid and the grid parameters.
+   * @param[in] e    The reference ellipsoid
+   * @param[in] lon0 Longitude of the central meridian [rad]
+   * @param[in] k0   Scale factor on the central meridian [-]
+   * @param[in] fe   False easting [m]
+   * @param[in] fn   False northing [m]
+   * @param[in] lat0 Latitude of origin [rad]
+   */
+  TransverseMercator(const Ellipsoid &e, double lon0, double k0,
+                     double fe = 0e0, double fn = 0e0,
+                     double lat0 = 0e0) noexcept
+      : __c(e.semi_major(), e.flattening()), __g{lon0, k0, fe, fn} {
+    if (lat0 != 0e0) {
+      double E0, N0;
+      core::geodetic2tm(__c, __g, lat0, lon0, E0, N0);
+      __g.fn -= (N0 - fn);
+    }
+  }
+
+  /** @brief Constructor for a UTM zone.
+   * @param[in] e     The reference ellipsoid
+   * @param[in] zone  The UTM zone, in the range [1, 60]
+   * @param[in] north True for the northern hemisphere
+   */
+  static TransverseMercator utm(const Ellipsoid &e, int zone,
+                                bool north) noexcept {
+    return TransverseMercator(e, core::utm_central_meridian(zone),
+                              core::UTM_K0, core::UTM_FALSE_EASTING,
+                              north ? 0e0 : core::UTM_FALSE_NORTHING_SOUTH);
+  }
+
+  /** @brief Get the (cached) Transverse Mercator constants */
+  const core::TransverseMercatorConstants &constants() const noexcept {
+    return __c;
+  }
+
+  /** @brief Get the parameters of the grid */
+  const core::TransverseMercatorGrid &grid() const noexcept { return __g; }
+
+  /** @brief Geodetic to grid coordinates.
+   * @see dso::core::geodetic2tm
+   */
+  void forward(double lat, double lon, double &E, double &N) const noexcept {
+    core::geodetic2tm(__c, __g, lat, lon, E, N);
+  }
+
+  /** @brief Grid to geodetic coordinates.
+   * @see dso::core::tm2geodetic
+   */
+  void inverse(double E, double N, double &lat, double &lon) const noexcept {
+    core::tm2geodetic(__c, __g, E, N, lat, lon);
+  }
+
+  /** @brief Geodetic to grid coordinates, for a batch of n points.
+   * @see dso::core::geodetic2tm
+   */
+  void forward(const double *lat, const double *lon, double *E, double *N,
+               std::size_t n) const noexcept {
+    core::geodetic2tm(__c, __g, lat, lon, E, N, n);
+  }
+
+  /** @brief Grid to geodetic coordinates, for a batch of n points.
+   * @see dso::core::tm2geodetic
+   */
+  void inverse(const double *E, const double *N, double *lat, double *lon,
+               std::size_t n) const noexcept {
+    core::tm2geodetic(__c, __g, E, N, lat, lon, n);
+  }
+
+private:
+  /** Series coefficients of the ellipsoid */
+  core::TransverseMercatorConstants __c;
+  /** Parameters of the grid */
+  core::TransverseMercatorGrid __g;
+}; /* class TransverseMercator */
+
+} /* namespace dso */
+
+#endif
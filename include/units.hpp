@@ -8,6 +8,7 @@
 
 #include "core/geoconst.hpp"
 #include <cmath>
+#include <cstddef>
 
 namespace dso {
 
@@ -98,6 +99,50 @@ inline double anpm(double a) noexcept {
   return r[std::abs(a) >= halfCircle];
 }
 
+/** @brief Largest magnitude of angles (in units U) normalized by the range
+ *         reduction of the batch dso::norm_angle and dso::anpm, i.e. 2^25
+ *         full circles (e.g. ~2.1e8 rad or ~1.2e10 deg); larger angles are
+ *         normalized by (the scalar versions, i.e.) std::fmod.
+ */
+template <detail::AngleUnit U = detail::AngleUnit::Radians>
+inline constexpr double angle_reduction_limit() noexcept {
+  return 33554432e0 * detail::AngleUnitTraits<U>::full_circle();
+}
+
+/** @brief Normalize a batch of n angles in the range [0, 2π]/[0,360].
+ *
+ * The range reduction a - k * circle is computed exactly, by multiplying,
+ * rounding and subtracting (the circle split in two parts, so that the
+ * products are exact) instead of calling std::fmod, and the loop over the
+ * angles is branch-free and vectorized. Results are identical to the ones
+ * of the scalar dso::norm_angle, for angles smaller than
+ * dso::angle_reduction_limit (in absolute value); larger ones (and
+ * non-finite ones) fall back to the scalar version.
+ *
+ * @tparam     U   Units of the angles, i.e. one of detail::AngleUnit
+ * @param[in]  a   Angles in units of U, size n
+ * @param[out] out Normalized angles in units of U, size n; may be a
+ * @param[in]  n   Number of angles
+ */
+template <detail::AngleUnit U = detail::AngleUnit::Radians>
+void norm_angle(const double *a, double *out, std::size_t n) noexcept;
+
+/** @brief Normalize a batch of n angles in the range [0, 2π]/[0,360].
+ * @see dso::norm_angle(const double *, double *, std::size_t)
+ */
+template <detail::AngleUnit U = detail::AngleUnit::Radians>
+inline void anp(const double *a, double *out, std::size_t n) noexcept {
+  norm_angle<U>(a, out, n);
+}
+
+/** @brief Normalize a batch of n angles in the range [-1/2 to 1/2) of
+ *         circle; results are identical to the ones of the scalar
+ *         dso::anpm.
+ * @see dso::norm_angle(const double *, double *, std::size_t)
+ */
+template <detail::AngleUnit U = detail::AngleUnit::Radians>
+void anpm(const double *a, double *out, std::size_t n) noexcept;
+
 /** @brief Decimal to hexicondal degrees.
  *
  * @param[in]  decimal_deg The decimal degrees.
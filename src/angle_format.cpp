@@ -0,0 +1,261 @@
+#include "angle_format.hpp"
+#include "units.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+inline bool is_blank(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+/* Does p point to a delimiter, i.e. the end of a field? */
+inline bool is_delim(const char *p, const char *last) noexcept {
+  return p == last || is_blank(*p) || *p == '\n' || *p == ',' || *p == ';';
+}
+
+inline const char *skip_blanks(const char *p, const char *last) noexcept {
+  while (p != last && is_blank(*p))
+    ++p;
+  return p;
+}
+
+/* Skip the separator between fields of a record: blanks, and at most one
+ * comma */
+inline const char *skip_field_sep(const char *p, const char *last) noexcept {
+  p = skip_blanks(p, last);
+  if (p != last && *p == ',')
+    p = skip_blanks(p + 1, last);
+  return p;
+}
+
+/* Skip the separator between the fields of a dms angle, i.e. blanks or a
+ * ':'; returns null if there is none */
+inline const char *skip_dms_sep(const char *p, const char *last) noexcept {
+  if (p != last && *p == ':')
+    return p + 1;
+  const char *q = skip_blanks(p, last);
+  return (q == p) ? nullptr : q;
+}
+
+/* An optional sign, followed by (the start of) an unsigned number */
+inline const char *parse_sign(const char *p, const char *last,
+                              bool &neg) noexcept {
+  neg = false;
+  if (p != last && (*p == '+' || *p == '-')) {
+    neg = (*p == '-');
+    ++p;
+  }
+  return (p != last && (is_digit(*p) || *p == '.')) ? p : nullptr;
+}
+
+/* A floating point number, optionally signed (std::from_chars does not
+ * accept a leading '+') */
+inline std::from_chars_result parse_real(const char *p, const char *last,
+                                         double &v) noexcept {
+  bool neg;
+  const char *q = parse_sign(p, last, neg);
+  if (!q)
+    return {p, std::errc::invalid_argument};
+  auto r = std::from_chars(q, last, v);
+  if (r.ec == std::errc{} && neg)
+    v = -v;
+  return r;
+}
+
+/* Append a character */
+inline bool put(char *&p, char *last, char c) noexcept {
+  if (p == last)
+    return false;
+  *p++ = c;
+  return true;
+}
+
+/* Append an unsigned integer, zero-padded to (at least) w digits */
+inline bool put_uint(char *&p, char *last, std::uint64_t v, int w) noexcept {
+  char buf[24];
+  const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+  const int len = static_cast<int>(r.ptr - buf);
+  if (last - p < std::max(len, w))
+    return false;
+  for (int i = len; i < w; i++)
+    *p++ = '0';
+  std::memcpy(p, buf, len);
+  p += len;
+  return true;
+}
+
+constexpr const std::uint64_t POW10[] = {
+    1ULL,       10ULL,       100ULL,       1000ULL,       10000ULL,
+    100000ULL,  1000000ULL,  10000000ULL,  100000000ULL,  1000000000ULL};
+} /* unnamed namespace */
+
+std::from_chars_result dso::parse_angle(const char *first, const char *last,
+                                        angle_format f,
+                                        double &rad) noexcept {
+  const std::from_chars_result error{first, std::errc::invalid_argument};
+  bool neg;
+  const char *p = parse_sign(skip_blanks(first, last), last, neg);
+  if (!p)
+    return error;
+
+  double v;
+  if (f == angle_format::dms) {
+    /* integer degrees and minutes, fractional seconds */
+    long d;
+    int m;
+    double s;
+    auto r = std::from_chars(p, last, d);
+    if (r.ec != std::errc{} || !(p = skip_dms_sep(r.ptr, last)))
+      return error;
+    r = std::from_chars(p, last, m);
+    if (r.ec != std::errc{} || !(p = skip_dms_sep(r.ptr, last)))
+      return error;
+    if (p == last || !is_digit(*p))
+      return error;
+    r = std::from_chars(p, last, s);
+    if (r.ec != std::errc{})
+      return error;
+    if (m < 0 || m >= 60 || !(s < 60e0))
+      return {first, std::errc::result_out_of_range};
+    p = r.ptr;
+    v = hexd2decd(static_cast<int>(d), m, s);
+  } else {
+    const auto r = std::from_chars(p, last, v);
+    if (r.ec != std::errc{})
+      return error;
+    p = r.ptr;
+  }
+
+  /* hemisphere letter, for degrees */
+  if (f != angle_format::radians) {
+    const char *q = skip_blanks(p, last);
+    if (q != last && *q && std::strchr("NSEWnsew", *q) &&
+        is_delim(q + 1, last)) {
+      const bool south = std::strchr("SWsw", *q);
+      if (south && neg)
+        return error;
+      neg = neg || south;
+      p = q + 1;
+    }
+  }
+
+  if (!is_delim(p, last))
+    return error;
+  v = neg ? -v : v;
+  rad = (f == angle_format::radians) ? v : deg2rad(v);
+  return {p, std::errc{}};
+}
+
+std::to_chars_result dso::format_angle(char *first, char *last, double rad,
+                                       angle_format f, int precision,
+                                       const char *hemi) noexcept {
+  const std::to_chars_result error{last, std::errc::value_too_large};
+  char *p = first;
+  const bool neg = std::signbit(rad);
+  const double a = std::abs(rad);
+
+  if (f == angle_format::dms) {
+    /* total, in units of the last digit of the seconds, i.e. rounded once */
+    const int pr = std::min(std::max(precision, 0), 9);
+    const std::uint64_t scale = POW10[pr];
+    const std::uint64_t units =
+        static_cast<std::uint64_t>(std::llround(rad2deg(a) * 3600e0 * scale));
+    const std::uint64_t d = units / (3600 * scale);
+    const std::uint64_t m = (units / (60 * scale)) % 60;
+    const std::uint64_t s = units % (60 * scale);
+    if (neg && !hemi && units && !put(p, last, '-'))
+      return error;
+    if (!put_uint(p, last, d, 1) || !put(p, last, ' ') ||
+        !put_uint(p, last, m, 2) || !put(p, last, ' ') ||
+        !put_uint(p, last, s / scale, 2))
+      return error;
+    if (pr && (!put(p, last, '.') || !put_uint(p, last, s % scale, pr)))
+      return error;
+  } else {
+    const double v = (f == angle_format::radians) ? a : rad2deg(a);
+    if (neg && !hemi && !put(p, last, '-'))
+      return error;
+    const auto r = std::to_chars(p, last, v, std::chars_format::fixed,
+                                 std::max(precision, 0));
+    if (r.ec != std::errc{})
+      return error;
+    p = r.ptr;
+  }
+
+  if (hemi && (!put(p, last, ' ') || !put(p, last, hemi[neg])))
+    return error;
+  return {p, std::errc{}};
+}
+
+dso::GeodeticParseResult dso::parse_geodetic(const char *first,
+                                             const char *last, angle_format f,
+                                             GeodeticCrd *crd,
+                                             std::size_t n) noexcept {
+  std::size_t count = 0;
+  const char *p = first;
+  while (count < n && p != last) {
+    const char *line = p;
+    const char *eol =
+        static_cast<const char *>(std::memchr(p, '\n', last - p));
+    if (!eol)
+      eol = last;
+    const char *next = (eol == last) ? last : eol + 1;
+
+    /* empty line or comment */
+    const char *q = skip_blanks(p, eol);
+    if (q == eol || *q == '#') {
+      p = next;
+      continue;
+    }
+
+    double lat, lon, hgt;
+    auto r = parse_angle(q, eol, f, lat);
+    if (r.ec != std::errc{})
+      return {line, r.ec, count};
+    r = parse_angle(skip_field_sep(r.ptr, eol), eol, f, lon);
+    if (r.ec != std::errc{})
+      return {line, r.ec, count};
+    r = parse_real(skip_field_sep(r.ptr, eol), eol, hgt);
+    if (r.ec != std::errc{} || !is_delim(r.ptr, eol))
+      return {line, std::errc::invalid_argument, count};
+
+    crd[count].lat() = lat;
+    crd[count].lon() = lon;
+    crd[count].hgt() = hgt;
+    ++count;
+    p = next;
+  }
+  return {p, std::errc{}, count};
+}
+
+std::to_chars_result dso::format_geodetic(char *first, char *last,
+                                          const GeodeticCrd *crd,
+                                          std::size_t n, angle_format f,
+                                          int precision,
+                                          int hgt_precision) noexcept {
+  const bool dms = (f == angle_format::dms);
+  char *p = first;
+  for (std::size_t i = 0; i < n; i++) {
+    auto r = format_angle(p, last, crd[i].lat(), f, precision,
+                          dms ? "NS" : nullptr);
+    if (r.ec == std::errc{} && r.ptr != last) {
+      *r.ptr = ' ';
+      r = format_angle(r.ptr + 1, last, crd[i].lon(), f, precision,
+                       dms ? "EW" : nullptr);
+    }
+    if (r.ec == std::errc{} && r.ptr != last) {
+      *r.ptr = ' ';
+      r = std::to_chars(r.ptr + 1, last, crd[i].hgt(),
+                        std::chars_format::fixed, std::max(hgt_precision, 0));
+    }
+    if (r.ec != std::errc{} || r.ptr == last)
+      return {p, std::errc::value_too_large};
+    *r.ptr = '\n';
+    p = r.ptr + 1;
+  }
+  return {p, std::errc{}};
+}
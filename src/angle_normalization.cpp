@@ -0,0 +1,110 @@
+#include "units.hpp"
+
+namespace {
+using dso::detail::AngleUnit;
+using dso::detail::AngleUnitTraits;
+
+/* Constants for the range reduction of angles in units U, i.e. for
+ * a - k * C, where C is the full circle */
+template <AngleUnit U> struct Reduction {
+  static constexpr double C = AngleUnitTraits<U>::full_circle();
+  static constexpr double IC = 1e0 / C;
+  /* C = C_HI + C_LO, each with (at most) 26 significant bits (Veltkamp
+   * split), so that k * C_HI and k * C_LO are exact for |k| < 2^26 */
+  static constexpr double SPLIT = 134217729e0; /* 2^27 + 1 */
+  static constexpr double C_HI = C * SPLIT - (C * SPLIT - C);
+  static constexpr double C_LO = C - C_HI;
+};
+
+/* 1.5 * 2^52; x + ROUND - ROUND rounds x to the nearest integer */
+constexpr const double ROUND = 6755399441055744e0;
+
+/* std::fmod(a, C), exactly, for |a| < dso::angle_reduction_limit<U>() */
+template <AngleUnit U> inline double fmod_circle(double a) noexcept {
+  using R = Reduction<U>;
+  /* k = trunc(a / C), give or take one, in the vicinity of integers */
+  const double q = a * R::IC;
+  double k = (q + ROUND) - ROUND;
+  k = (std::abs(k) > std::abs(q)) ? k - std::copysign(1e0, q) : k;
+  /* a - k * C; exact, since both products are and a - k * C_HI cancels */
+  double r = (a - k * R::C_HI) - k * R::C_LO;
+  /* if k was off by one, add/subtract a circle (exact, since the result
+   * is the one of fmod, which is representable) */
+  const double sa = std::copysign(1e0, a);
+  r = (sa * r < 0e0) ? r + sa * R::C : r;
+  r = (std::abs(r) >= R::C) ? r - sa * R::C : r;
+  /* zeros take the sign of a, as for fmod */
+  return std::copysign(r, a);
+}
+} /* unnamed namespace */
+
+template <AngleUnit U>
+void dso::norm_angle(const double *a, double *out, std::size_t n) noexcept {
+  constexpr const double C = Reduction<U>::C;
+  constexpr const double LIMIT = angle_reduction_limit<U>();
+  double large = 0e0;
+#pragma omp simd reduction(+ : large)
+  for (std::size_t i = 0; i < n; i++) {
+    const double ai = a[i];
+    const double r = fmod_circle<U>(ai);
+    /* as in the scalar version */
+    const double v = (r < 0e0) ? r + C : r;
+    /* out of the range of the reduction (or NaN); left as is */
+    const bool big = !(std::abs(ai) < LIMIT);
+    out[i] = big ? ai : v;
+    large += big ? 1e0 : 0e0;
+  }
+
+  /* fallback; results are < C, hence values beyond the limit are inputs */
+  if (large > 0e0) {
+    for (std::size_t i = 0; i < n; i++)
+      if (!(std::abs(out[i]) < LIMIT))
+        out[i] = norm_angle<U>(out[i]);
+  }
+}
+
+template <AngleUnit U>
+void dso::anpm(const double *a, double *out, std::size_t n) noexcept {
+  constexpr const double C = Reduction<U>::C;
+  constexpr const double H = AngleUnitTraits<U>::full_circle() / 2e0;
+  constexpr const double LIMIT = angle_reduction_limit<U>();
+  double large = 0e0;
+#pragma omp simd reduction(+ : large)
+  for (std::size_t i = 0; i < n; i++) {
+    const double ai = a[i];
+    const double r = fmod_circle<U>(ai);
+    const double v = (std::abs(r) >= H) ? r - std::copysign(C, r) : r;
+    const bool big = !(std::abs(ai) < LIMIT);
+    out[i] = big ? ai : v;
+    large += big ? 1e0 : 0e0;
+  }
+
+  if (large > 0e0) {
+    for (std::size_t i = 0; i < n; i++)
+      if (!(std::abs(out[i]) < LIMIT))
+        out[i] = anpm<U>(out[i]);
+  }
+}
+
+/* instantiations, for all angular units */
+template void dso::norm_angle<AngleUnit::Radians>(const double *, double *,
+                                                  std::size_t) noexcept;
+template void dso::norm_angle<AngleUnit::Degrees>(const double *, double *,
+                                                  std::size_t) noexcept;
+template void dso::norm_angle<AngleUnit::Seconds>(const double *, double *,
+                                                  std::size_t) noexcept;
+template void dso::norm_angle<AngleUnit::Hours>(const double *, double *,
+                                                std::size_t) noexcept;
+template void
+dso::norm_angle<AngleUnit::SecondsOfHour>(const double *, double *,
+                                          std::size_t) noexcept;
+template void dso::anpm<AngleUnit::Radians>(const double *, double *,
+                                            std::size_t) noexcept;
+template void dso::anpm<AngleUnit::Degrees>(const double *, double *,
+                                            std::size_t) noexcept;
+template void dso::anpm<AngleUnit::Seconds>(const double *, double *,
+                                            std::size_t) noexcept;
+template void dso::anpm<AngleUnit::Hours>(const double *, double *,
+                                          std::size_t) noexcept;
+template void dso::anpm<AngleUnit::SecondsOfHour>(const double *, double *,
+                                                  std::size_t) noexcept;
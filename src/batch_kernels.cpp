@@ -0,0 +1,246 @@
+/* Batch (array) kernels. This file is compiled once for every instruction
+ * set level (see batch_kernels_avx2.cpp and batch_kernels_avx512.cpp), with
+ * DSO_KERNEL_ISA naming the level (i.e. the namespace of the kernels).
+ *
+ * Kernels are [[gnu::flatten]], so that every (inline) function they call is
+ * inlined; else, an out-of-line copy of a header function compiled for e.g.
+ * AVX-512 could be picked by the linker for the whole library.
+ */
+#include "core/batch_kernels.hpp"
+#include "core/geoconst.hpp"
+#include "core/vmath.hpp"
+#include <cmath>
+
+#ifndef DSO_KERNEL_ISA
+#define DSO_KERNEL_ISA baseline
+#endif
+
+namespace {
+using dso::core::EllipsoidConstants;
+namespace vmath = dso::core::vmath;
+
+/* elements of a packed covariance matrix, i.e. dso::COV_SIZE */
+constexpr const std::size_t COV_SIZE = 6;
+
+/* A 3x3 matrix, row-major */
+struct M3 {
+  double a00, a01, a02, a10, a11, a12, a20, a21, a22;
+};
+
+/* o = J S J^T, with S and o packed; S is read completely before o is
+ * written, hence o may be S */
+inline void sandwich(const M3 &J, const double *s, double *o) noexcept {
+  const double s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3], s4 = s[4],
+               s5 = s[5];
+  /* T = J S */
+  const double t00 = J.a00 * s0 + J.a01 * s1 + J.a02 * s2;
+  const double t01 = J.a00 * s1 + J.a01 * s3 + J.a02 * s4;
+  const double t02 = J.a00 * s2 + J.a01 * s4 + J.a02 * s5;
+  const double t10 = J.a10 * s0 + J.a11 * s1 + J.a12 * s2;
+  const double t11 = J.a10 * s1 + J.a11 * s3 + J.a12 * s4;
+  const double t12 = J.a10 * s2 + J.a11 * s4 + J.a12 * s5;
+  const double t20 = J.a20 * s0 + J.a21 * s1 + J.a22 * s2;
+  const double t21 = J.a20 * s1 + J.a21 * s3 + J.a22 * s4;
+  const double t22 = J.a20 * s2 + J.a21 * s4 + J.a22 * s5;
+  /* o = T J^T, upper triangle */
+  o[0] = t00 * J.a00 + t01 * J.a01 + t02 * J.a02;
+  o[1] = t00 * J.a10 + t01 * J.a11 + t02 * J.a12;
+  o[2] = t00 * J.a20 + t01 * J.a21 + t02 * J.a22;
+  o[3] = t10 * J.a10 + t11 * J.a11 + t12 * J.a12;
+  o[4] = t10 * J.a20 + t11 * J.a21 + t12 * J.a22;
+  o[5] = t20 * J.a20 + t21 * J.a21 + t22 * J.a22;
+}
+
+/* The rotation R^T = [e, n, u]^T, i.e. ∂(e,n,u)/∂(x,y,z), at (lat, lon) */
+inline M3 enu_rows(double lat, double lon) noexcept {
+  double sf, cf, sl, cl;
+  vmath::sincos(lat, sf, cf);
+  vmath::sincos(lon, sl, cl);
+  return {-sl, cl, 0e0, -sf * cl, -sf * sl, cf, cf * cl, cf * sl, sf};
+}
+
+/* The north, east and up unit vectors at (lat, lon), as rows, and the radii
+ * (M + h) and (N + h) cos(lat) */
+inline M3 neu_rows(const EllipsoidConstants &ell, double lat, double lon,
+                   double hgt, double &m, double &p) noexcept {
+  double sf, cf, sl, cl;
+  vmath::sincos(lat, sf, cf);
+  vmath::sincos(lon, sl, cl);
+  const double w2 = 1e0 - ell.e2 * sf * sf;
+  const double Rn = ell.a / std::sqrt(w2);
+  m = Rn * ell.ep2 / w2 + hgt;
+  p = (Rn + hgt) * cf;
+  return {-sf * cl, -sf * sl, cf, -sl, cl, 0e0, cf * cl, cf * sl, sf};
+}
+
+[[gnu::flatten]] std::size_t
+cartesian2geodetic(const EllipsoidConstants &ell, const double *x,
+                   const double *y, const double *z, double *lat, double *lon,
+                   double *hgt, std::size_t n) noexcept {
+  /* Functions of ellipsoid parameters. */
+  const double a = ell.a;
+  const double aeps2 = ell.aeps2;
+  const double e2 = ell.e2;
+  const double e4t = ell.e4t;
+  const double ep2 = ell.ep2;
+  const double ep = ell.ep;
+  const double aep = ell.aep;
+
+  /* number of points on the polar axis, if instrumented */
+  double poles = 0e0;
+#ifdef DSO_GEODESY_INSTRUMENT
+#pragma omp simd reduction(+ : poles)
+#else
+#pragma omp simd
+#endif
+  for (std::size_t i = 0; i < n; i++) {
+    /* Compute distance from polar axis squared. */
+    const double p2 = x[i] * x[i] + y[i] * y[i];
+
+    /* Compute longitude. */
+    const double lambda = vmath::atan2(y[i], x[i]);
+    lon[i] = (p2 != 0e0) ? lambda : 0e0;
+
+    /* Ensure that Z-coordinate is unsigned. */
+    const double absz = std::abs(z[i]);
+
+    /* The (general) solution is computed for every point; at the poles it
+     * yields non-finite values, which are replaced below.
+     */
+    const bool pole = !(p2 > aeps2);
+#ifdef DSO_GEODESY_INSTRUMENT
+    poles += pole ? 1e0 : 0e0;
+#endif
+
+    /* Compute distance from polar axis. */
+    const double p = std::sqrt(p2);
+    /* Normalize. */
+    const double s0 = absz / a;
+    const double pn = p / a;
+    const double zp = ep * s0;
+    /* Prepare Newton correction factors. */
+    const double c0 = ep * pn;
+    const double c02 = c0 * c0;
+    const double c03 = c02 * c0;
+    const double s02 = s0 * s0;
+    const double s03 = s02 * s0;
+    const double a02 = c02 + s02;
+    const double a0 = std::sqrt(a02);
+    const double a03 = a02 * a0;
+    const double d0 = zp * a03 + e2 * s03;
+    const double f0 = pn * a03 - e2 * c03;
+    /* Prepare Halley correction factor. */
+    const double b0 = e4t * s02 * c02 * pn * (a0 - ep);
+    const double s1 = d0 * f0 - b0 * s0;
+    const double cp = ep * (f0 * f0 - b0 * c0);
+    /* Evaluate latitude and height. */
+    const double phi = vmath::atan(s1 / cp);
+    const double s12 = s1 * s1;
+    const double cp2 = cp * cp;
+    const double h = (p * cp + absz * s1 - a * std::sqrt(ep2 * s12 + cp2)) /
+                     std::sqrt(s12 + cp2);
+
+    /* Special case: pole. */
+    const double phi1 = pole ? dso::DPI / 2e0 : phi;
+    hgt[i] = pole ? absz - aep : h;
+
+    /* Restore sign of latitude. */
+    lat[i] = (z[i] < 0e0) ? -phi1 : phi1;
+  }
+
+  return static_cast<std::size_t>(poles);
+}
+
+[[gnu::flatten]] void geodetic2cartesian(const EllipsoidConstants &ell,
+                                         const double *lat, const double *lon,
+                                         const double *hgt, double *x,
+                                         double *y, double *z,
+                                         std::size_t n) noexcept {
+  /* Functions of ellipsoid parameters. */
+  const double a = ell.a;
+  const double e2 = ell.e2;
+  const double ep2 = ell.ep2;
+
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    /* Trigonometric numbers. */
+    double sf, cf, sl, cl;
+    vmath::sincos(lat[i], sf, cf);
+    vmath::sincos(lon[i], sl, cl);
+
+    /* Radius of curvature in the prime vertical. */
+    const double Rn = a / std::sqrt(1e0 - e2 * sf * sf);
+
+    /* Compute geocentric rectangular coordinates. */
+    x[i] = (Rn + hgt[i]) * cf * cl;
+    y[i] = (Rn + hgt[i]) * cf * sl;
+    z[i] = (ep2 * Rn + hgt[i]) * sf;
+  }
+}
+
+[[gnu::flatten]] void
+geodetic2cartesian_covariance(const EllipsoidConstants &ell, const double *lat,
+                              const double *lon, const double *hgt,
+                              const double *cov, double *out,
+                              std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    double m, p;
+    const M3 R = neu_rows(ell, lat[i], lon[i], hgt[i], m, p);
+    /* J = [n (M + h), e (N + h) cos(φ), u], as columns */
+    const M3 J{R.a00 * m, R.a10 * p, R.a20, R.a01 * m, R.a11 * p,
+               R.a21,     R.a02 * m, R.a12 * p, R.a22};
+    sandwich(J, cov + COV_SIZE * i, out + COV_SIZE * i);
+  }
+}
+
+[[gnu::flatten]] void
+cartesian2geodetic_covariance(const EllipsoidConstants &ell, const double *lat,
+                              const double *lon, const double *hgt,
+                              const double *cov, double *out,
+                              std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    double m, p;
+    const M3 R = neu_rows(ell, lat[i], lon[i], hgt[i], m, p);
+    /* rows n / (M + h), e / ((N + h) cos(φ)), u */
+    const double im = 1e0 / m, ip = 1e0 / p;
+    const M3 J{R.a00 * im, R.a01 * im, R.a02 * im, R.a10 * ip, R.a11 * ip,
+               R.a12 * ip, R.a20,      R.a21,      R.a22};
+    sandwich(J, cov + COV_SIZE * i, out + COV_SIZE * i);
+  }
+}
+
+[[gnu::flatten]] void cartesian2enu_covariance(const double *lat,
+                                               const double *lon,
+                                               const double *cov, double *out,
+                                               std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++)
+    sandwich(enu_rows(lat[i], lon[i]), cov + COV_SIZE * i,
+             out + COV_SIZE * i);
+}
+
+[[gnu::flatten]] void enu2cartesian_covariance(const double *lat,
+                                               const double *lon,
+                                               const double *cov, double *out,
+                                               std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    const M3 R = enu_rows(lat[i], lon[i]);
+    /* J = R, i.e. the transpose */
+    const M3 J{R.a00, R.a10, R.a20, R.a01, R.a11,
+               R.a21, R.a02, R.a12, R.a22};
+    sandwich(J, cov + COV_SIZE * i, out + COV_SIZE * i);
+  }
+}
+} /* unnamed namespace */
+
+const dso::core::kernels::KernelTable
+    dso::core::kernels::DSO_KERNEL_ISA::table = {
+        cartesian2geodetic,
+        geodetic2cartesian,
+        geodetic2cartesian_covariance,
+        cartesian2geodetic_covariance,
+        cartesian2enu_covariance,
+        enu2cartesian_covariance};
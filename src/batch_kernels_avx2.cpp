@@ -0,0 +1,3 @@
+/* The batch kernels, compiled for AVX2 + FMA (see src/CMakeLists.txt) */
+#define DSO_KERNEL_ISA avx2
+#include "batch_kernels.cpp"
@@ -0,0 +1,3 @@
+/* The batch kernels, compiled for AVX-512 (see src/CMakeLists.txt) */
+#define DSO_KERNEL_ISA avx512
+#include "batch_kernels.cpp"
@@ -0,0 +1,18 @@
+#include "core/batch_kernels.hpp"
+#include "core/crd_transformations.hpp"
+
+void dso::core::cartesian2geodetic(const EllipsoidConstants &ell,
+                                   const double *x, const double *y,
+                                   const double *z, double *lat, double *lon,
+                                   double *hgt, std::size_t n) noexcept {
+  const instrument::detail::BatchTimer timer(
+      instrument::entry::cartesian2geodetic_batch, n);
+
+  /* the loop lives in src/batch_kernels.cpp */
+  const std::size_t poles =
+      kernels::active().cartesian2geodetic(ell, x, y, z, lat, lon, hgt, n);
+  instrument::detail::count_poles(poles);
+
+  /* Finished. */
+  return;
+}
@@ -3,6 +3,8 @@
 
 void dso::cartesian2spherical(double x, double y, double z, double &r,
                               double &glat, double &lon) noexcept {
+  instrument::detail::count(instrument::entry::cartesian2spherical, 1);
+
   /* radius */
   r = std::sqrt(x * x + y * y + z * z);
 
@@ -0,0 +1,40 @@
+#include "core/batch_kernels.hpp"
+#include "core/crd_jacobians.hpp"
+
+/* the loops live in src/batch_kernels.cpp */
+
+void dso::core::geodetic2cartesian_covariance(
+    const EllipsoidConstants &ell, const double *lat, const double *lon,
+    const double *hgt, const double *cov, double *out,
+    std::size_t n) noexcept {
+  const instrument::detail::BatchTimer timer(
+      instrument::entry::geodetic2cartesian_covariance, n);
+  kernels::active().geodetic2cartesian_covariance(ell, lat, lon, hgt, cov,
+                                                  out, n);
+}
+
+void dso::core::cartesian2geodetic_covariance(
+    const EllipsoidConstants &ell, const double *lat, const double *lon,
+    const double *hgt, const double *cov, double *out,
+    std::size_t n) noexcept {
+  const instrument::detail::BatchTimer timer(
+      instrument::entry::cartesian2geodetic_covariance, n);
+  kernels::active().cartesian2geodetic_covariance(ell, lat, lon, hgt, cov,
+                                                  out, n);
+}
+
+void dso::cartesian2enu_covariance(const double *lat, const double *lon,
+                                   const double *cov, double *out,
+                                   std::size_t n) noexcept {
+  const instrument::detail::BatchTimer timer(
+      instrument::entry::cartesian2enu_covariance, n);
+  core::kernels::active().cartesian2enu_covariance(lat, lon, cov, out, n);
+}
+
+void dso::enu2cartesian_covariance(const double *lat, const double *lon,
+                                   const double *cov, double *out,
+                                   std::size_t n) noexcept {
+  const instrument::detail::BatchTimer timer(
+      instrument::entry::enu2cartesian_covariance, n);
+  core::kernels::active().enu2cartesian_covariance(lat, lon, cov, out, n);
+}
@@ -0,0 +1,110 @@
+#include "cpu_dispatch.hpp"
+#include "core/batch_kernels.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+using dso::SimdLevel;
+using dso::core::kernels::KernelTable;
+
+constexpr const int NUM_LEVELS = 3;
+
+/* kernels per level, null if not compiled in */
+const KernelTable *const TABLES[NUM_LEVELS] = {
+    &dso::core::kernels::baseline::table,
+#ifdef DSO_GEODESY_X86_KERNELS
+    &dso::core::kernels::avx2::table, &dso::core::kernels::avx512::table
+#else
+    nullptr, nullptr
+#endif
+};
+
+constexpr const char *NAMES[NUM_LEVELS] = {"baseline", "avx2", "avx512"};
+
+/* Is level l supported by the CPU (and the OS, i.e. are the wide registers
+ * saved on context switches)? Both are checked by the compiler's CPUID
+ * support (libgcc). */
+bool cpu_supports(SimdLevel l) noexcept {
+#ifdef DSO_GEODESY_X86_KERNELS
+  __builtin_cpu_init();
+  switch (l) {
+  case SimdLevel::avx2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case SimdLevel::avx512:
+    return __builtin_cpu_supports("avx512f") &&
+           __builtin_cpu_supports("avx512dq") &&
+           __builtin_cpu_supports("avx512vl") &&
+           __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  default:
+    break;
+  }
+#endif
+  return l == SimdLevel::baseline;
+}
+
+/* Level in use; -1 until selected */
+std::atomic<int> current{-1};
+
+/* The level requested via DSO_GEODESY_SIMD, if any and available, else the
+ * best one available */
+int initial_level() noexcept {
+  const char *env = std::getenv("DSO_GEODESY_SIMD");
+  if (env) {
+    for (int i = 0; i < NUM_LEVELS; i++) {
+      if (!std::strcmp(env, NAMES[i]) &&
+          dso::simd_level_available(static_cast<SimdLevel>(i)))
+        return i;
+    }
+    if (!std::strcmp(env, "sse2"))
+      return static_cast<int>(SimdLevel::baseline);
+  }
+  return static_cast<int>(dso::max_simd_level());
+}
+
+/* Select the level once, unless set already */
+int select_level() noexcept {
+  int expected = -1;
+  const int l = initial_level();
+  return current.compare_exchange_strong(expected, l,
+                                         std::memory_order_relaxed)
+             ? l
+             : expected;
+}
+
+/* select when the library is loaded */
+[[maybe_unused]] const int selected_at_load = select_level();
+} /* unnamed namespace */
+
+const char *dso::simd_level_name(SimdLevel l) noexcept {
+  return NAMES[static_cast<int>(l)];
+}
+
+bool dso::simd_level_available(SimdLevel l) noexcept {
+  return TABLES[static_cast<int>(l)] && cpu_supports(l);
+}
+
+dso::SimdLevel dso::max_simd_level() noexcept {
+  for (int i = NUM_LEVELS - 1; i > 0; i--)
+    if (simd_level_available(static_cast<SimdLevel>(i)))
+      return static_cast<SimdLevel>(i);
+  return SimdLevel::baseline;
+}
+
+dso::SimdLevel dso::simd_level() noexcept {
+  const int l = current.load(std::memory_order_relaxed);
+  return static_cast<SimdLevel>(l < 0 ? select_level() : l);
+}
+
+std::errc dso::set_simd_level(SimdLevel l) noexcept {
+  if (!simd_level_available(l))
+    return std::errc::not_supported;
+  current.store(static_cast<int>(l), std::memory_order_relaxed);
+  return std::errc{};
+}
+
+const dso::core::kernels::KernelTable &
+dso::core::kernels::active() noexcept {
+  const int l = current.load(std::memory_order_relaxed);
+  return *TABLES[l < 0 ? select_level() : l];
+}
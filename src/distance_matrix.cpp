@@ -0,0 +1,241 @@
+#include "distance_matrix.hpp"
+#include "core/vmath.hpp"
+#include <algorithm>
+#include <cmath>
+
+/* The (read-only) data of a network, as seen by the tile kernels */
+struct dso::detail::NetworkView {
+  const double *x, *y, *z;
+  const double *ux, *uy, *uz;
+  const double *lat, *lon;
+  const dso::core::GeodesicConstants *g;
+  double R;
+  std::size_t n;
+};
+
+namespace {
+constexpr const std::size_t TILE = dso::StationNetwork::TILE;
+using Stations = dso::detail::NetworkView;
+
+/* Distances from station i to stations [jb, je), stored in d */
+void chord_row(const Stations &s, std::size_t i, std::size_t jb,
+               std::size_t je, double *d) noexcept {
+  const double xi = s.x[i], yi = s.y[i], zi = s.z[i];
+  const std::size_t n = je - jb;
+  const double *x = s.x + jb, *y = s.y + jb, *z = s.z + jb;
+#pragma omp simd
+  for (std::size_t j = 0; j < n; j++) {
+    const double dx = x[j] - xi;
+    const double dy = y[j] - yi;
+    const double dz = z[j] - zi;
+    d[j] = std::sqrt(dx * dx + dy * dy + dz * dz);
+  }
+}
+
+/* The angle between the unit vectors is computed as atan2(|u×v|, u·v),
+ * which (unlike acos(u·v)) is accurate for any separation; atan2 has to be
+ * inlined for the loop to be vectorized */
+[[gnu::flatten]] void great_circle_row(const Stations &s, std::size_t i,
+                                       std::size_t jb, std::size_t je,
+                                       double *d) noexcept {
+  const double xi = s.ux[i], yi = s.uy[i], zi = s.uz[i];
+  const std::size_t n = je - jb;
+  const double *x = s.ux + jb, *y = s.uy + jb, *z = s.uz + jb;
+  const double R = s.R;
+#pragma omp simd
+  for (std::size_t j = 0; j < n; j++) {
+    const double cx = yi * z[j] - zi * y[j];
+    const double cy = zi * x[j] - xi * z[j];
+    const double cz = xi * y[j] - yi * x[j];
+    const double dot = xi * x[j] + yi * y[j] + zi * z[j];
+    const double c = std::sqrt(cx * cx + cy * cy + cz * cz);
+    d[j] = R * dso::core::vmath::atan2(c, dot);
+  }
+}
+
+void geodesic_row(const Stations &s, std::size_t i, std::size_t jb,
+                  std::size_t je, double *d) noexcept {
+  double azi1, azi2;
+  for (std::size_t j = jb; j < je; j++)
+    dso::core::geodesic_inverse(*s.g, s.lat[i], s.lon[i], s.lat[j], s.lon[j],
+                                d[j - jb], azi1, azi2);
+}
+
+/* Compute the tile of rows [i0, i0 + TILE) and columns [j0, j0 + TILE),
+ * j0 >= i0, i.e. the pairs (i, j) with i < j in the tile */
+template <typename T>
+void tile(const Stations &s, dso::distance_metric m, dso::matrix_storage st,
+          std::size_t i0, std::size_t j0, T *out) noexcept {
+  const std::size_t n = s.n;
+  const std::size_t i1 = std::min(i0 + TILE, n);
+  const std::size_t j1 = std::min(j0 + TILE, n);
+  double d[TILE];
+  for (std::size_t i = i0; i < i1; i++) {
+    const std::size_t jb = std::max(j0, i + 1);
+    if (jb >= j1)
+      continue;
+    switch (m) {
+    case dso::distance_metric::chord:
+      chord_row(s, i, jb, j1, d);
+      break;
+    case dso::distance_metric::great_circle:
+      great_circle_row(s, i, jb, j1, d);
+      break;
+    case dso::distance_metric::geodesic:
+      geodesic_row(s, i, jb, j1, d);
+      break;
+    }
+    const std::size_t k = j1 - jb;
+    if (st == dso::matrix_storage::full) {
+      T *row = out + i * n + jb;
+#pragma omp simd
+      for (std::size_t j = 0; j < k; j++)
+        row[j] = static_cast<T>(d[j]);
+      /* the mirrored elements; within a tile, these are TILE columns of
+       * TILE consecutive elements, hence stay in cache */
+      T *col = out + jb * n + i;
+      for (std::size_t j = 0; j < k; j++)
+        col[j * n] = static_cast<T>(d[j]);
+    } else {
+      T *row = out + dso::upper_index(n, i, jb);
+#pragma omp simd
+      for (std::size_t j = 0; j < k; j++)
+        row[j] = static_cast<T>(d[j]);
+    }
+  }
+  if (st == dso::matrix_storage::full && i0 == j0) {
+    for (std::size_t i = i0; i < i1; i++)
+      out[i * n + i] = T(0);
+  }
+}
+
+/* All tiles in the tile-row starting at row i0 */
+template <typename T>
+void tile_row(const Stations &s, dso::distance_metric m,
+              dso::matrix_storage st, std::size_t i0, T *out) noexcept {
+  for (std::size_t j0 = i0; j0 < s.n; j0 += TILE)
+    tile(s, m, st, i0, j0, out);
+}
+
+template <typename T>
+void distances(const Stations &s, dso::ThreadPool *pool,
+               dso::distance_metric m, dso::matrix_storage st,
+               T *out) noexcept {
+  const std::size_t rows = (s.n + TILE - 1) / TILE;
+  if (!pool) {
+    for (std::size_t r = 0; r < rows; r++)
+      tile_row(s, m, st, r * TILE, out);
+  } else {
+    /* tile-rows differ in size; the pool balances the load */
+    pool->parallel_for(rows, 1, [&](std::size_t b, std::size_t e) noexcept {
+      for (std::size_t r = b; r < e; r++)
+        tile_row(s, m, st, r * TILE, out);
+    });
+  }
+}
+} /* unnamed namespace */
+
+dso::StationNetwork::StationNetwork(const Ellipsoid &e, const double *x,
+                                    const double *y, const double *z,
+                                    std::size_t n)
+    : __x(x, x + n), __y(y, y + n), __z(z, z + n), __ux(n), __uy(n), __uz(n),
+      __lat(n), __lon(n), __g(e.semi_major(), e.flattening()) {
+  std::vector<double> hgt(n);
+  e.cartesian2geodetic(x, y, z, __lat.data(), __lon.data(), hgt.data(), n);
+  prepare(e);
+}
+
+dso::StationNetwork::StationNetwork(const Ellipsoid &e,
+                                    const std::vector<CartesianCrd> &sta)
+    : __x(sta.size()), __y(sta.size()), __z(sta.size()), __ux(sta.size()),
+      __uy(sta.size()), __uz(sta.size()), __lat(sta.size()),
+      __lon(sta.size()), __g(e.semi_major(), e.flattening()) {
+  const std::size_t n = sta.size();
+  for (std::size_t i = 0; i < n; i++) {
+    __x[i] = sta[i].x();
+    __y[i] = sta[i].y();
+    __z[i] = sta[i].z();
+  }
+  std::vector<double> hgt(n);
+  e.cartesian2geodetic(__x.data(), __y.data(), __z.data(), __lat.data(),
+                       __lon.data(), hgt.data(), n);
+  prepare(e);
+}
+
+dso::StationNetwork::StationNetwork(const Ellipsoid &e,
+                                    const std::vector<GeodeticCrd> &sta)
+    : __x(sta.size()), __y(sta.size()), __z(sta.size()), __ux(sta.size()),
+      __uy(sta.size()), __uz(sta.size()), __lat(sta.size()),
+      __lon(sta.size()), __g(e.semi_major(), e.flattening()) {
+  const std::size_t n = sta.size();
+  std::vector<double> hgt(n);
+  for (std::size_t i = 0; i < n; i++) {
+    __lat[i] = sta[i].lat();
+    __lon[i] = sta[i].lon();
+    hgt[i] = sta[i].hgt();
+  }
+  e.geodetic2cartesian(__lat.data(), __lon.data(), hgt.data(), __x.data(),
+                       __y.data(), __z.data(), n);
+  prepare(e);
+}
+
+void dso::StationNetwork::prepare(const Ellipsoid &e) {
+  __R = (2e0 * e.semi_major() + e.semi_minor()) / 3e0;
+  const std::size_t n = __x.size();
+  for (std::size_t i = 0; i < n; i++) {
+    const double r =
+        std::sqrt(__x[i] * __x[i] + __y[i] * __y[i] + __z[i] * __z[i]);
+    /* a station at the geocenter has no direction; use a null vector */
+    const double ir = (r > 0e0) ? 1e0 / r : 0e0;
+    __ux[i] = __x[i] * ir;
+    __uy[i] = __y[i] * ir;
+    __uz[i] = __z[i] * ir;
+  }
+}
+
+dso::detail::NetworkView dso::StationNetwork::view() const noexcept {
+  return {__x.data(),  __y.data(),  __z.data(),   __ux.data(),
+          __uy.data(), __uz.data(), __lat.data(), __lon.data(),
+          &__g,        __R,         size()};
+}
+
+double dso::StationNetwork::distance(std::size_t i, std::size_t j,
+                                     distance_metric m) const noexcept {
+  const Stations s = view();
+  double d;
+  switch (m) {
+  case distance_metric::chord:
+    chord_row(s, i, j, j + 1, &d);
+    break;
+  case distance_metric::great_circle:
+    great_circle_row(s, i, j, j + 1, &d);
+    break;
+  case distance_metric::geodesic:
+  default:
+    geodesic_row(s, i, j, j + 1, &d);
+    break;
+  }
+  return d;
+}
+
+void dso::StationNetwork::distances(distance_metric m, matrix_storage s,
+                                    double *out) const noexcept {
+  ::distances(view(), nullptr, m, s, out);
+}
+
+void dso::StationNetwork::distances(distance_metric m, matrix_storage s,
+                                    float *out) const noexcept {
+  ::distances(view(), nullptr, m, s, out);
+}
+
+void dso::StationNetwork::distances(ThreadPool &pool, distance_metric m,
+                                    matrix_storage s,
+                                    double *out) const noexcept {
+  ::distances(view(), &pool, m, s, out);
+}
+
+void dso::StationNetwork::distances(ThreadPool &pool, distance_metric m,
+                                    matrix_storage s,
+                                    float *out) const noexcept {
+  ::distances(view(), &pool, m, s, out);
+}
@@ -0,0 +1,753 @@
+/* Solvers of the geodesic (inverse and direct) problems on the ellipsoid,
+ * see core/geodesic_core.hpp.
+ *
+ * This file is derived from geodesic.c, of the C library of GeographicLib,
+ * version 1.52, which is distributed under the following license:
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2012-2021, Charles Karney <charles@karney.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit
+ * persons to whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+ * NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "core/geodesic_core.hpp"
+#include "core/geoconst.hpp"
+#include "core/vmath.hpp"
+#include <algorithm>
+
+namespace {
+using dso::core::GeodesicConstants;
+using dso::core::detail::polyval;
+using dso::core::detail::sin_series;
+
+/* Order of the series expansions; all series are truncated at ORDER */
+constexpr const int ORDER = GeodesicConstants::ORDER;
+/* Size of scratch arrays holding series coefficients (index 0 is unused) */
+constexpr const int NC = ORDER + 1;
+/* Max number of Newton iterations, before switching to bisection */
+constexpr const int MAXIT1 = 20;
+/* Max number of iterations (Newton and bisection) */
+constexpr const int MAXIT2 = MAXIT1 + std::numeric_limits<double>::digits + 10;
+/* sqrt of the smallest normal double */
+constexpr const double TINY = 0x1p-511;
+constexpr const double TOL0 = std::numeric_limits<double>::epsilon();
+constexpr const double TOL1 = 200e0 * TOL0;
+/* sqrt(TOL0) */
+constexpr const double TOL2 = 0x1p-26;
+constexpr const double TOLB = TOL0 * TOL2;
+constexpr const double XTHRESH = 1000e0 * TOL2;
+
+inline double sq(double x) noexcept { return x * x; }
+
+/* normalize (s, c) so that s^2 + c^2 = 1 */
+inline void norm2(double &s, double &c) noexcept {
+  const double r = std::hypot(s, c);
+  s /= r;
+  c /= r;
+}
+
+/* Round tiny angles to 0, so that the smallest gap in angles is 2^-57 [rad];
+ * this prevents underflow and keeps points close to the equator on it. */
+inline double ang_round(double x) noexcept {
+  constexpr const double z = 1e0 / 16e0;
+  const double y = std::abs(x);
+  const double w = (y < z) ? z - (z - y) : y;
+  return std::copysign(w, x);
+}
+
+/* The scale factor A1 - 1 (Karney, 2013, Eq. 17) */
+inline double A1m1f(double eps) noexcept {
+  constexpr const double coeff[] = {1, 4, 64, 0, 256};
+  const double t = polyval(ORDER / 2, coeff, sq(eps)) / coeff[ORDER / 2 + 1];
+  return (t + eps) / (1e0 - eps);
+}
+
+/* Fill c[l] with the coefficients of a series of the form
+ * sum(c[l] * eps^l), l = 1, ..., ORDER, the coefficients of each term being
+ * polynomials in eps^2 given in coeff */
+inline void series_coeffs(const double *coeff, double eps, double *c) noexcept {
+  const double eps2 = sq(eps);
+  double d = eps;
+  int o = 0;
+#pragma GCC unroll 8
+  for (int l = 1; l <= ORDER; ++l) {
+    const int m = (ORDER - l) / 2;
+    c[l] = d * polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+    o += m + 2;
+    d *= eps;
+  }
+}
+
+/* The coefficients C1[l] (Karney, 2013, Eq. 18) */
+inline void C1f(double eps, double *c) noexcept {
+  constexpr const double coeff[] = {-1, 6,   -16, 32, -9, 64, -128, 2048,
+                                    9,  -16, 768, 3,  -5, 512, -7,  1280,
+                                    -7, 2048};
+  series_coeffs(coeff, eps, c);
+}
+
+/* The coefficients C1'[l] (Karney, 2013, Eq. 21), of the reverted series */
+inline void C1pf(double eps, double *c) noexcept {
+  constexpr const double coeff[] = {205,   -432, 768,  1536, 4005,  -4736,
+                                    3840,  12288, -225, 116,  384,   -7173,
+                                    2695,  7680, 3467, 7680, 38081, 61440};
+  series_coeffs(coeff, eps, c);
+}
+
+/* The scale factor A2 - 1 (Karney, 2013, Eq. 42) */
+inline double A2m1f(double eps) noexcept {
+  constexpr const double coeff[] = {-11, -28, -192, 0, 256};
+  const double t = polyval(ORDER / 2, coeff, sq(eps)) / coeff[ORDER / 2 + 1];
+  return (t - eps) / (1e0 + eps);
+}
+
+/* The coefficients C2[l] (Karney, 2013, Eq. 43) */
+inline void C2f(double eps, double *c) noexcept {
+  constexpr const double coeff[] = {1,  2,  16,  32, 35, 64, 384, 2048, 15,
+                                    80, 768, 7, 35, 512, 63, 1280, 77, 2048};
+  series_coeffs(coeff, eps, c);
+}
+
+/* The scale factor A3 (Karney, 2013, Eq. 24) */
+inline double A3f(const GeodesicConstants &g, double eps) noexcept {
+  return polyval(ORDER - 1, g.A3x, eps);
+}
+
+/* The coefficients C3[l], l = 1, ..., ORDER-1 (Karney, 2013, Eq. 25) */
+inline void C3f(const GeodesicConstants &g, double eps, double *c) noexcept {
+  double mult = 1e0;
+  int o = 0;
+#pragma GCC unroll 8
+  for (int l = 1; l < ORDER; ++l) {
+    const int m = ORDER - l - 1;
+    mult *= eps;
+    c[l] = mult * polyval(m, g.C3x + o, eps);
+    o += m + 1;
+  }
+}
+
+/* The parameter ε, given k^2 (Karney, 2013, Eq. 16) */
+inline double epsilon_of(double k2) noexcept {
+  return k2 / (2e0 * (1e0 + std::sqrt(1e0 + k2)) + k2);
+}
+
+/* Distance (s12b) and reduced length (m12b) over b, and the coefficient of
+ * the secular term of the reduced length (m0); Karney, 2013, Eqs. 38-40 */
+void lengths(double eps, double sig12, double ssig1, double csig1, double dn1,
+             double ssig2, double csig2, double dn2, double *s12b,
+             double *m12b, double *m0) noexcept {
+  double Ca[NC], Cb[NC];
+  const double A1 = A1m1f(eps);
+  C1f(eps, Ca);
+  const double A2 = A2m1f(eps);
+  C2f(eps, Cb);
+  const double m0x = A1 - A2;
+  const double A1p = 1e0 + A1;
+  const double A2p = 1e0 + A2;
+  const double B1 =
+      sin_series(ssig2, csig2, Ca, ORDER) - sin_series(ssig1, csig1, Ca, ORDER);
+  const double B2 =
+      sin_series(ssig2, csig2, Cb, ORDER) - sin_series(ssig1, csig1, Cb, ORDER);
+  const double J12 = m0x * sig12 + (A1p * B1 - A2p * B2);
+  if (s12b)
+    *s12b = A1p * (sig12 + B1);
+  if (m12b)
+    /* parenthesized for accurate cancellation for coincident points */
+    *m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2) -
+            csig1 * csig2 * J12;
+  if (m0)
+    *m0 = m0x;
+}
+
+/* Solve k^4 + 2k^3 - (x^2 + y^2 - 1)k^2 - 2y^2 k - y^2 = 0 for the positive
+ * root k (Karney, 2013, Eq. 55) */
+double astroid(double x, double y) noexcept {
+  const double p = sq(x);
+  const double q = sq(y);
+  const double r = (p + q - 1e0) / 6e0;
+  if (q == 0e0 && r <= 0e0)
+    return 0e0;
+  const double S = p * q / 4e0;
+  const double r2 = sq(r);
+  const double r3 = r * r2;
+  /* discriminant of the quadratic equation for T3 */
+  const double disc = S * (S + 2e0 * r3);
+  double u = r;
+  if (disc >= 0e0) {
+    double T3 = S + r3;
+    /* pick the sign of the sqrt that maximizes |T3| */
+    T3 += (T3 < 0e0) ? -std::sqrt(disc) : std::sqrt(disc);
+    const double T = std::cbrt(T3);
+    u += T + ((T != 0e0) ? r2 / T : 0e0);
+  } else {
+    const double ang = std::atan2(std::sqrt(-disc), -(S + r3));
+    u += 2e0 * r * std::cos(ang / 3e0);
+  }
+  const double v = std::sqrt(sq(u) + q);
+  const double uv = (u < 0e0) ? q / (v - u) : u + v;
+  const double w = (uv - q) / (2e0 * v);
+  return uv / (std::sqrt(uv + sq(w)) + w);
+}
+
+/* Starting point (salp1, calp1) for Newton's method; if the line is short
+ * enough that no iteration is needed, (salp2, calp2) are set as well and the
+ * (spherical) arc sig12 is returned, else -1 is returned. For short lines,
+ * dnm is set (Karney, 2013, Sec. 5). */
+double inverse_start(const GeodesicConstants &g, double sbet1, double cbet1,
+                     double dn1, double sbet2, double cbet2, double dn2,
+                     double lam12, double slam12, double clam12,
+                     double &salp1, double &calp1, double &salp2,
+                     double &calp2, double &dnm) noexcept {
+  double sig12 = -1e0;
+  /* bet12 = bet2 - bet1 in [0, pi); bet12a = bet2 + bet1 in (-pi, 0] */
+  const double sbet12 = sbet2 * cbet1 - cbet2 * sbet1;
+  const double cbet12 = cbet2 * cbet1 + sbet2 * sbet1;
+  const double sbet12a = sbet2 * cbet1 + cbet2 * sbet1;
+  const bool shortline =
+      cbet12 >= 0e0 && sbet12 < 0.5e0 && cbet2 * lam12 < 0.5e0;
+  double somg12, comg12;
+  if (shortline) {
+    double sbetm2 = sq(sbet1 + sbet2);
+    sbetm2 /= sbetm2 + sq(cbet1 + cbet2);
+    dnm = std::sqrt(1e0 + g.ep2 * sbetm2);
+    const double omg12 = lam12 / (g.f1 * dnm);
+    somg12 = std::sin(omg12);
+    comg12 = std::cos(omg12);
+  } else {
+    somg12 = slam12;
+    comg12 = clam12;
+  }
+
+  salp1 = cbet2 * somg12;
+  calp1 = (comg12 >= 0e0)
+              ? sbet12 + cbet2 * sbet1 * sq(somg12) / (1e0 + comg12)
+              : sbet12a - cbet2 * sbet1 * sq(somg12) / (1e0 - comg12);
+
+  const double ssig12 = std::hypot(salp1, calp1);
+  const double csig12 = sbet1 * sbet2 + cbet1 * cbet2 * comg12;
+
+  if (shortline && ssig12 < g.etol2) {
+    /* really short lines */
+    salp2 = cbet1 * somg12;
+    calp2 = sbet12 -
+            cbet1 * sbet2 *
+                ((comg12 >= 0e0) ? sq(somg12) / (1e0 + comg12) : 1e0 - comg12);
+    norm2(salp2, calp2);
+    sig12 = std::atan2(ssig12, csig12);
+  } else if (std::abs(g.n) > 0.1e0 || csig12 >= 0e0 ||
+             ssig12 >= 6e0 * std::abs(g.n) * dso::DPI * sq(cbet1)) {
+    /* zeroth order spherical approximation is OK */
+    ;
+  } else {
+    /* nearly antipodal points; scale lam12 and bet2 to the (x, y) system
+     * where the antipodal point is at the origin */
+    double x, y, lamscale, betscale;
+    const double lam12x = std::atan2(-slam12, -clam12); /* lam12 - pi */
+    if (g.f >= 0e0) {
+      /* x = dlong, y = dlat */
+      const double eps = epsilon_of(sq(sbet1) * g.ep2);
+      lamscale = g.f * cbet1 * A3f(g, eps) * dso::DPI;
+      betscale = lamscale * cbet1;
+      x = lam12x / lamscale;
+      y = sbet12a / betscale;
+    } else {
+      /* x = dlat, y = dlong */
+      const double cbet12a = cbet2 * cbet1 - sbet2 * sbet1;
+      const double bet12a = std::atan2(sbet12a, cbet12a);
+      double m12b, m0;
+      lengths(g.n, dso::DPI + bet12a, sbet1, -cbet1, dn1, sbet2, cbet2, dn2,
+              nullptr, &m12b, &m0);
+      x = -1e0 + m12b / (cbet1 * cbet2 * m0 * dso::DPI);
+      betscale =
+          (x < -0.01e0) ? sbet12a / x : -g.f * sq(cbet1) * dso::DPI;
+      lamscale = betscale / cbet1;
+      y = lam12x / lamscale;
+    }
+
+    if (y > -TOL1 && x > -1e0 - XTHRESH) {
+      /* strip near cut */
+      if (g.f >= 0e0) {
+        salp1 = std::min(1e0, -x);
+        calp1 = -std::sqrt(1e0 - sq(salp1));
+      } else {
+        calp1 = std::max((x > -TOL1) ? 0e0 : -1e0, x);
+        salp1 = std::sqrt(1e0 - sq(calp1));
+      }
+    } else {
+      /* estimate omg12 by solving the astroid problem, and then alp1 via
+       * the spherical formula */
+      const double k = astroid(x, y);
+      const double omg12a =
+          lamscale * ((g.f >= 0e0) ? -x * k / (1e0 + k) : -y * (1e0 + k) / k);
+      somg12 = std::sin(omg12a);
+      comg12 = -std::cos(omg12a);
+      salp1 = cbet2 * somg12;
+      calp1 = sbet12a - cbet2 * sbet1 * sq(somg12) / (1e0 - comg12);
+    }
+  }
+
+  /* sanity check on the starting guess (lets NaNs through) */
+  if (!(salp1 <= 0e0)) {
+    norm2(salp1, calp1);
+  } else {
+    salp1 = 1e0;
+    calp1 = 0e0;
+  }
+  return sig12;
+}
+
+/* Longitude difference lam12 of the geodesic leaving the first point with
+ * azimuth alp1, reduced by the target value lam120 (Karney, 2013, Eq. 44);
+ * if diffp is set, its derivative w.r.t. alp1 is computed as well (Eq. 46).
+ */
+double lambda12(const GeodesicConstants &g, double sbet1, double cbet1,
+                double dn1, double sbet2, double cbet2, double dn2,
+                double salp1, double calp1, double slam120, double clam120,
+                double &salp2, double &calp2, double &sig12, double &ssig1,
+                double &csig1, double &ssig2, double &csig2, double &eps,
+                bool diffp, double &dlam12) noexcept {
+  double Ca[NC];
+
+  if (sbet1 == 0e0 && calp1 == 0e0)
+    /* break the degeneracy of the equatorial line */
+    calp1 = -TINY;
+
+  /* sin(alp1) * cos(bet1) = sin(alp0) */
+  const double salp0 = salp1 * cbet1;
+  const double calp0 = std::hypot(calp1, salp1 * sbet1);
+
+  /* tan(bet1) = tan(sig1) * cos(alp1)
+   * tan(omg1) = sin(alp0) * tan(sig1) */
+  ssig1 = sbet1;
+  const double somg1 = salp0 * sbet1;
+  csig1 = calp1 * cbet1;
+  const double comg1 = csig1;
+  norm2(ssig1, csig1);
+
+  /* enforce symmetries in the case |bet2| = -bet1 */
+  salp2 = (cbet2 != cbet1) ? salp0 / cbet2 : salp1;
+  if (cbet2 != cbet1 || std::abs(sbet2) != -sbet1) {
+    const double d = (cbet1 < -sbet1) ? (cbet2 - cbet1) * (cbet1 + cbet2)
+                                      : (sbet1 - sbet2) * (sbet1 + sbet2);
+    calp2 = std::sqrt(sq(calp1 * cbet1) + d) / cbet2;
+  } else {
+    calp2 = std::abs(calp1);
+  }
+  /* tan(bet2) = tan(sig2) * cos(alp2)
+   * tan(omg2) = sin(alp0) * tan(sig2) */
+  ssig2 = sbet2;
+  const double somg2 = salp0 * sbet2;
+  csig2 = calp2 * cbet2;
+  const double comg2 = csig2;
+  norm2(ssig2, csig2);
+
+  /* sig12 = sig2 - sig1, limited to [0, pi] */
+  sig12 = std::atan2(std::max(0e0, csig1 * ssig2 - ssig1 * csig2) + 0e0,
+                     csig1 * csig2 + ssig1 * ssig2);
+
+  /* omg12 = omg2 - omg1, limited to [0, pi] */
+  const double somg12 = std::max(0e0, comg1 * somg2 - somg1 * comg2) + 0e0;
+  const double comg12 = comg1 * comg2 + somg1 * somg2;
+  /* eta = omg12 - lam120 */
+  const double eta = std::atan2(somg12 * clam120 - comg12 * slam120,
+                                comg12 * clam120 + somg12 * slam120);
+  eps = epsilon_of(sq(calp0) * g.ep2);
+  C3f(g, eps, Ca);
+  const double B312 = sin_series(ssig2, csig2, Ca, ORDER - 1) -
+                      sin_series(ssig1, csig1, Ca, ORDER - 1);
+  const double domg12 = -g.f * A3f(g, eps) * salp0 * (sig12 + B312);
+  const double lam12 = eta + domg12;
+
+  if (diffp) {
+    if (calp2 == 0e0) {
+      dlam12 = -2e0 * g.f1 * dn1 / sbet1;
+    } else {
+      lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, nullptr,
+              &dlam12, nullptr);
+      dlam12 *= g.f1 / (calp2 * cbet2);
+    }
+  }
+
+  return lam12;
+}
+
+/* Solve the inverse problem; see dso::core::geodesic_inverse */
+inline void inverse(const GeodesicConstants &g, double lat1, double lon1,
+                    double lat2, double lon2, double &s12, double &azi1,
+                    double &azi2) noexcept {
+  /* longitude difference, in [-pi, pi] */
+  double lon12 = std::remainder(lon2 - lon1, 2e0 * dso::DPI);
+  /* make the longitude difference positive */
+  double lonsign = std::signbit(lon12) ? -1e0 : 1e0;
+  lon12 = ang_round(lon12 * lonsign);
+  const double lam12 = lon12;
+  /* sin(pi) is not exactly 0; handle antimeridian lines exactly */
+  const double slam12 = (lon12 == dso::DPI) ? 0e0 : std::sin(lam12);
+  const double clam12 = std::cos(lam12);
+  /* the supplementary longitude difference */
+  const double lon12s = dso::DPI - lon12;
+
+  /* if really close to the equator, treat as on the equator */
+  lat1 = ang_round(lat1);
+  lat2 = ang_round(lat2);
+  /* swap points so that the point with the higher (abs) latitude is point 1 */
+  const double swapp =
+      (std::abs(lat1) < std::abs(lat2) || lat2 != lat2) ? -1e0 : 1e0;
+  if (swapp < 0e0) {
+    lonsign *= -1e0;
+    std::swap(lat1, lat2);
+  }
+  /* make lat1 <= -0 */
+  const double latsign = std::signbit(lat1) ? 1e0 : -1e0;
+  lat1 *= latsign;
+  lat2 *= latsign;
+  /* Now we have:
+   *     0 <= lon12 <= pi
+   *     -pi/2 <= lat1 <= -0
+   *     lat1 <= lat2 <= -lat1
+   * lonsign, swapp and latsign register the transformation to this
+   * canonical form.
+   */
+
+  double sbet1 = g.f1 * std::sin(lat1), cbet1 = std::cos(lat1);
+  norm2(sbet1, cbet1);
+  /* ensure cbet1 = +epsilon at the poles */
+  cbet1 = std::max(TINY, cbet1);
+
+  double sbet2 = g.f1 * std::sin(lat2), cbet2 = std::cos(lat2);
+  norm2(sbet2, cbet2);
+  cbet2 = std::max(TINY, cbet2);
+
+  /* if cbet1 < -sbet1, then cbet2 - cbet1 is a sensitive measure of
+   * |bet1| - |bet2|, else |sbet2| + sbet1 is; if these vanish, force
+   * bet2 = +/- bet1 exactly */
+  if (cbet1 < -sbet1) {
+    if (cbet2 == cbet1)
+      sbet2 = std::copysign(sbet1, sbet2);
+  } else {
+    if (std::abs(sbet2) == -sbet1)
+      cbet2 = cbet1;
+  }
+
+  const double dn1 = std::sqrt(1e0 + g.ep2 * sq(sbet1));
+  const double dn2 = std::sqrt(1e0 + g.ep2 * sq(sbet2));
+
+  double s12x = 0e0, m12x = 0e0, sig12 = 0e0;
+  double salp1 = 0e0, calp1 = 0e0, salp2 = 0e0, calp2 = 0e0;
+  bool meridian = (lat1 == -dso::DPI / 2e0) || slam12 == 0e0;
+
+  if (meridian) {
+    /* end points are on a single full meridian, so the geodesic might lie
+     * on a meridian; head to the target longitude */
+    calp1 = clam12;
+    salp1 = slam12;
+    /* at the target we are heading north */
+    calp2 = 1e0;
+    salp2 = 0e0;
+
+    /* tan(bet) = tan(sig) * cos(alp) */
+    const double ssig1 = sbet1, csig1 = calp1 * cbet1;
+    const double ssig2 = sbet2, csig2 = calp2 * cbet2;
+
+    /* sig12 = sig2 - sig1 */
+    sig12 = std::atan2(std::max(0e0, csig1 * ssig2 - ssig1 * csig2) + 0e0,
+                       csig1 * csig2 + ssig1 * ssig2);
+    lengths(g.n, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, &s12x, &m12x,
+            nullptr);
+    /* if m12 < 0, i.e. the line is longer than the conjugate distance, the
+     * meridian is not the shortest path */
+    if (sig12 < 1e0 || m12x >= 0e0) {
+      if (sig12 < 3e0 * TINY ||
+          /* prevent negative s12 or m12 for short lines */
+          (sig12 < TOL0 && (s12x < 0e0 || m12x < 0e0)))
+        sig12 = m12x = s12x = 0e0;
+      s12x *= g.b;
+    } else {
+      meridian = false;
+    }
+  }
+
+  if (!meridian && sbet1 == 0e0 && /* and sbet2 == 0 */
+      (g.f <= 0e0 || lon12s >= g.f * dso::DPI)) {
+    /* geodesic runs along the equator */
+    calp1 = calp2 = 0e0;
+    salp1 = salp2 = 1e0;
+    s12x = g.a * lam12;
+  } else if (!meridian) {
+    /* figure out a starting point for Newton's method */
+    double dnm = 0e0;
+    sig12 = inverse_start(g, sbet1, cbet1, dn1, sbet2, cbet2, dn2, lam12,
+                          slam12, clam12, salp1, calp1, salp2, calp2, dnm);
+
+    if (sig12 >= 0e0) {
+      /* short lines (inverse_start sets salp2, calp2 and dnm) */
+      s12x = sig12 * g.b * dnm;
+    } else {
+      /* Newton's method on f(alp1) = lambda12(alp1) - lam12 = 0; a range
+       * (alp1a, alp1b) that brackets the root is maintained and shrunk with
+       * each evaluation of f. Whenever Newton's step is not usable, the
+       * midpoint of the range is taken. */
+      double ssig1 = 0e0, csig1 = 0e0, ssig2 = 0e0, csig2 = 0e0, eps = 0e0;
+      double salp1a = TINY, calp1a = 1e0, salp1b = TINY, calp1b = -1e0;
+      bool tripn = false, tripb = false;
+      for (int numit = 0;; ++numit) {
+        double dv = 0e0;
+        const double v =
+            lambda12(g, sbet1, cbet1, dn1, sbet2, cbet2, dn2, salp1, calp1,
+                     slam12, clam12, salp2, calp2, sig12, ssig1, csig1, ssig2,
+                     csig2, eps, numit < MAXIT1, dv);
+        if (tripb ||
+            /* reversed test to allow escape with NaNs */
+            !(std::abs(v) >= (tripn ? 8e0 : 1e0) * TOL0) ||
+            /* enough bisections to get an accurate result */
+            numit == MAXIT2)
+          break;
+        /* update bracketing values */
+        if (v > 0e0 && (numit > MAXIT1 || calp1 / salp1 > calp1b / salp1b)) {
+          salp1b = salp1;
+          calp1b = calp1;
+        } else if (v < 0e0 &&
+                   (numit > MAXIT1 || calp1 / salp1 < calp1a / salp1a)) {
+          salp1a = salp1;
+          calp1a = calp1;
+        }
+        if (numit < MAXIT1 && dv > 0e0) {
+          const double dalp1 = -v / dv;
+          if (std::abs(dalp1) < dso::DPI) {
+            const double sdalp1 = std::sin(dalp1), cdalp1 = std::cos(dalp1);
+            const double nsalp1 = salp1 * cdalp1 + calp1 * sdalp1;
+            if (nsalp1 > 0e0) {
+              calp1 = calp1 * cdalp1 - salp1 * sdalp1;
+              salp1 = nsalp1;
+              norm2(salp1, calp1);
+              /* convergence may not be quadratic if the slope vanishes,
+               * hence use a test based on epsilon */
+              tripn = std::abs(v) <= 16e0 * TOL0;
+              continue;
+            }
+          }
+        }
+        /* bisection */
+        salp1 = (salp1a + salp1b) / 2e0;
+        calp1 = (calp1a + calp1b) / 2e0;
+        norm2(salp1, calp1);
+        tripn = false;
+        tripb = (std::abs(salp1a - salp1) + (calp1a - calp1) < TOLB ||
+                 std::abs(salp1 - salp1b) + (calp1 - calp1b) < TOLB);
+      }
+      lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, &s12x,
+              nullptr, nullptr);
+      s12x *= g.b;
+    }
+  }
+
+  /* convert -0 to 0 */
+  s12 = 0e0 + s12x;
+
+  /* convert (calp, salp) to azimuths, undoing the canonical transformation */
+  if (swapp < 0e0) {
+    std::swap(salp1, salp2);
+    std::swap(calp1, calp2);
+  }
+  salp1 *= swapp * lonsign;
+  calp1 *= swapp * latsign;
+  salp2 *= swapp * lonsign;
+  calp2 *= swapp * latsign;
+
+  azi1 = std::atan2(salp1, calp1);
+  azi2 = std::atan2(salp2, calp2);
+}
+
+/* Solve the direct problem; see dso::core::geodesic_direct. The template
+ * parameter V selects the branch-free, vectorizable version (trigonometric
+ * functions via dso::core::vmath), which is used in batch loops. */
+template <bool V>
+inline void direct(const GeodesicConstants &g, double lat1, double lon1,
+                   double azi1, double s12, double &lat2, double &lon2,
+                   double &azi2) noexcept {
+  namespace vmath = dso::core::vmath;
+  double Ca[NC], C1a[NC], C1pa[NC];
+
+  double sbet1, cbet1, salp1, calp1;
+  if constexpr (V) {
+    vmath::sincos(ang_round(lat1), sbet1, cbet1);
+    vmath::sincos(ang_round(azi1), salp1, calp1);
+  } else {
+    sbet1 = std::sin(ang_round(lat1));
+    cbet1 = std::cos(ang_round(lat1));
+    salp1 = std::sin(ang_round(azi1));
+    calp1 = std::cos(ang_round(azi1));
+  }
+  sbet1 *= g.f1;
+  {
+    const double r = std::sqrt(sbet1 * sbet1 + cbet1 * cbet1);
+    sbet1 /= r;
+    /* ensure cbet1 = +epsilon at the poles */
+    cbet1 = std::max(TINY, cbet1 / r);
+  }
+
+  /* sin(alp1) * cos(bet1) = sin(alp0) */
+  const double salp0 = salp1 * cbet1;
+  const double calp0 = std::sqrt(sq(calp1) + sq(salp1 * sbet1));
+  /* tan(bet1) = tan(sig1) * cos(alp1); sig = 0 is the nearest northward
+   * crossing of the equator; tan(omg1) = sin(alp0) * tan(sig1) */
+  double ssig1 = sbet1;
+  const double somg1 = salp0 * sbet1;
+  double csig1 = (sbet1 != 0e0 || calp1 != 0e0) ? cbet1 * calp1 : 1e0;
+  const double comg1 = csig1;
+  {
+    const double r = std::sqrt(ssig1 * ssig1 + csig1 * csig1);
+    ssig1 /= r;
+    csig1 /= r;
+  }
+
+  const double k2 = sq(calp0) * g.ep2;
+  const double eps = epsilon_of(k2);
+
+  const double A1m1 = A1m1f(eps);
+  C1f(eps, C1a);
+  C1pf(eps, C1pa);
+  const double B11 = sin_series(ssig1, csig1, C1a, ORDER);
+  double sb11, cb11;
+  if constexpr (V) {
+    vmath::sincos(B11, sb11, cb11);
+  } else {
+    sb11 = std::sin(B11);
+    cb11 = std::cos(B11);
+  }
+  /* tau1 = sig1 + B11 */
+  const double stau1 = ssig1 * cb11 + csig1 * sb11;
+  const double ctau1 = csig1 * cb11 - ssig1 * sb11;
+
+  C3f(g, eps, Ca);
+  const double A3c = -g.f * salp0 * A3f(g, eps);
+  const double B31 = sin_series(ssig1, csig1, Ca, ORDER - 1);
+
+  /* tau12 from the distance, then sig12 via the reverted series */
+  const double tau12 = s12 / (g.b * (1e0 + A1m1));
+  double s, c;
+  if constexpr (V) {
+    vmath::sincos(tau12, s, c);
+  } else {
+    s = std::sin(tau12);
+    c = std::cos(tau12);
+  }
+  const double B12p = -sin_series(stau1 * c + ctau1 * s, ctau1 * c - stau1 * s,
+                                  C1pa, ORDER);
+  double sig12 = tau12 - (B12p - B11);
+  double ssig12, csig12;
+  if constexpr (V) {
+    vmath::sincos(sig12, ssig12, csig12);
+  } else {
+    ssig12 = std::sin(sig12);
+    csig12 = std::cos(sig12);
+  }
+  if (std::abs(g.f) > 0.01e0) {
+    /* the reverted series is inaccurate for |f| > 1/100, hence correct
+     * sig12 with one Newton iteration */
+    const double ssig2 = ssig1 * csig12 + csig1 * ssig12;
+    const double csig2 = csig1 * csig12 - ssig1 * ssig12;
+    const double B12 = sin_series(ssig2, csig2, C1a, ORDER);
+    const double serr = (1e0 + A1m1) * (sig12 + (B12 - B11)) - s12 / g.b;
+    sig12 = sig12 - serr / std::sqrt(1e0 + k2 * sq(ssig2));
+    if constexpr (V) {
+      vmath::sincos(sig12, ssig12, csig12);
+    } else {
+      ssig12 = std::sin(sig12);
+      csig12 = std::cos(sig12);
+    }
+  }
+
+  /* sig2 = sig1 + sig12 */
+  const double ssig2 = ssig1 * csig12 + csig1 * ssig12;
+  double csig2 = csig1 * csig12 - ssig1 * ssig12;
+  /* sin(bet2) = cos(alp0) * sin(sig2) */
+  const double sbet2 = calp0 * ssig2;
+  double cbet2 = std::sqrt(sq(salp0) + sq(calp0 * csig2));
+  /* i.e. salp0 = 0 and csig2 = 0; break the degeneracy */
+  csig2 = (cbet2 == 0e0) ? TINY : csig2;
+  cbet2 = (cbet2 == 0e0) ? TINY : cbet2;
+  /* tan(alp0) = cos(sig2) * tan(alp2) */
+  const double salp2 = salp0;
+  const double calp2 = calp0 * csig2;
+
+  /* tan(omg2) = sin(alp0) * tan(sig2) */
+  const double somg2 = salp0 * ssig2;
+  const double comg2 = csig2;
+  const double somg12 = somg2 * comg1 - comg2 * somg1;
+  const double comg12 = comg2 * comg1 + somg2 * somg1;
+  const double B32 = sin_series(ssig2, csig2, Ca, ORDER - 1);
+  if constexpr (V) {
+    const double omg12 = vmath::atan2(somg12, comg12);
+    const double lam12 = omg12 + A3c * (sig12 + (B32 - B31));
+    /* normalize to [-pi, pi]; rounding via the 1.5 * 2^52 trick is
+     * branch-free */
+    constexpr const double ROUND = 6755399441055744e0;
+    const double l = lon1 + lam12;
+    const double q = (l * (1e0 / (2e0 * dso::DPI)) + ROUND) - ROUND;
+    lon2 = l - q * (2e0 * dso::DPI);
+    lat2 = vmath::atan2(sbet2, g.f1 * cbet2);
+    azi2 = vmath::atan2(salp2, calp2);
+  } else {
+    const double omg12 = std::atan2(somg12, comg12);
+    const double lam12 = omg12 + A3c * (sig12 + (B32 - B31));
+    lon2 = std::remainder(lon1 + lam12, 2e0 * dso::DPI);
+    lat2 = std::atan2(sbet2, g.f1 * cbet2);
+    azi2 = std::atan2(salp2, calp2);
+  }
+}
+} /* unnamed namespace */
+
+void dso::core::geodesic_inverse(const GeodesicConstants &g, double lat1,
+                                 double lon1, double lat2, double lon2,
+                                 double &s12, double &azi1,
+                                 double &azi2) noexcept {
+  inverse(g, lat1, lon1, lat2, lon2, s12, azi1, azi2);
+}
+
+void dso::core::geodesic_direct(const GeodesicConstants &g, double lat1,
+                                double lon1, double azi1, double s12,
+                                double &lat2, double &lon2,
+                                double &azi2) noexcept {
+  direct<false>(g, lat1, lon1, azi1, s12, lat2, lon2, azi2);
+}
+
+void dso::core::geodesic_inverse(const GeodesicConstants &g,
+                                 const double *lat1, const double *lon1,
+                                 const double *lat2, const double *lon2,
+                                 double *s12, double *azi1, double *azi2,
+                                 std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; i++)
+    inverse(g, lat1[i], lon1[i], lat2[i], lon2[i], s12[i], azi1[i], azi2[i]);
+}
+
+/* the loop body is too large for the inliner's heuristics; it has to be
+ * inlined (including the vmath calls), and the series loops unrolled (hence
+ * the unroll pragmas here and in series.hpp), for the loop to be vectorized */
+[[gnu::flatten]] void
+dso::core::geodesic_direct(const GeodesicConstants &g, const double *lat1,
+                           const double *lon1, const double *azi1,
+                           const double *s12, double *lat2, double *lon2,
+                           double *azi2, std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++)
+    direct<true>(g, lat1[i], lon1[i], azi1[i], s12[i], lat2[i], lon2[i],
+                 azi2[i]);
+}
@@ -0,0 +1,16 @@
+#include "core/batch_kernels.hpp"
+#include "core/crd_transformations.hpp"
+
+void dso::core::geodetic2cartesian(const EllipsoidConstants &ell,
+                                   const double *lat, const double *lon,
+                                   const double *hgt, double *x, double *y,
+                                   double *z, std::size_t n) noexcept {
+  const instrument::detail::BatchTimer timer(
+      instrument::entry::geodetic2cartesian_batch, n);
+
+  /* the loop lives in src/batch_kernels.cpp */
+  kernels::active().geodetic2cartesian(ell, lat, lon, hgt, x, y, z, n);
+
+  /* Finished. */
+  return;
+}
@@ -0,0 +1,95 @@
+#include "helmert.hpp"
+#include "units.hpp"
+#include <algorithm>
+
+dso::HelmertParameters
+dso::HelmertParameters::from_iers(double tx_mm, double ty_mm, double tz_mm,
+                                  double d_ppb, double rx_mas, double ry_mas,
+                                  double rz_mas) noexcept {
+  HelmertParameters p;
+  p.tx = tx_mm * 1e-3;
+  p.ty = ty_mm * 1e-3;
+  p.tz = tz_mm * 1e-3;
+  p.d = d_ppb * 1e-9;
+  p.rx = sec2rad(rx_mas * 1e-3);
+  p.ry = sec2rad(ry_mas * 1e-3);
+  p.rz = sec2rad(rz_mas * 1e-3);
+  return p;
+}
+
+dso::HelmertTransform::HelmertTransform(const HelmertParameters &p) noexcept
+    : __T(p.tx, p.ty, p.tz) {
+  const double s = 1e0 + p.d;
+  __A << s, -p.rz, p.ry, p.rz, s, -p.rx, -p.ry, p.rx, s;
+}
+
+dso::HelmertTransform::HelmertTransform(const HelmertParameters &p,
+                                        const HelmertParameters &rates,
+                                        double t0, double t) noexcept
+    : HelmertTransform(HelmertParameters{
+          p.tx + rates.tx * (t - t0), p.ty + rates.ty * (t - t0),
+          p.tz + rates.tz * (t - t0), p.d + rates.d * (t - t0),
+          p.rx + rates.rx * (t - t0), p.ry + rates.ry * (t - t0),
+          p.rz + rates.rz * (t - t0)}) {}
+
+dso::HelmertTransform dso::HelmertTransform::inverse() const noexcept {
+  /* X = A^-1 (X' - T) */
+  const Eigen::Matrix<double, 3, 3> Ai = __A.inverse();
+  return HelmertTransform(Ai, CartesianCrd(-(Ai * __T.mv)));
+}
+
+void dso::HelmertTransform::apply(const double *x, const double *y,
+                                  const double *z, double *xt, double *yt,
+                                  double *zt, std::size_t n) const noexcept {
+  const double tx = __T.x(), ty = __T.y(), tz = __T.z();
+  const double a00 = __A(0, 0), a01 = __A(0, 1), a02 = __A(0, 2);
+  const double a10 = __A(1, 0), a11 = __A(1, 1), a12 = __A(1, 2);
+  const double a20 = __A(2, 0), a21 = __A(2, 1), a22 = __A(2, 2);
+
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    const double xi = x[i], yi = y[i], zi = z[i];
+    xt[i] = tx + (a00 * xi + a01 * yi + a02 * zi);
+    yt[i] = ty + (a10 * xi + a11 * yi + a12 * zi);
+    zt[i] = tz + (a20 * xi + a21 * yi + a22 * zi);
+  }
+}
+
+void dso::HelmertTransform::apply(const CartesianCrd *p, CartesianCrd *t,
+                                  std::size_t n) const noexcept {
+  for (std::size_t i = 0; i < n; i++) {
+    const double xi = p[i].x(), yi = p[i].y(), zi = p[i].z();
+    apply(xi, yi, zi, t[i].x(), t[i].y(), t[i].z());
+  }
+}
+
+void dso::HelmertTransform::apply(const Ellipsoid &e, const double *x,
+                                  const double *y, const double *z,
+                                  double *lat, double *lon, double *hgt,
+                                  std::size_t n) const noexcept {
+  /* transformed coordinates of a block; these stay in (L1) cache */
+  double bx[BLOCK], by[BLOCK], bz[BLOCK];
+  for (std::size_t b = 0; b < n; b += BLOCK) {
+    const std::size_t m = std::min(BLOCK, n - b);
+    apply(x + b, y + b, z + b, bx, by, bz, m);
+    e.cartesian2geodetic(bx, by, bz, lat + b, lon + b, hgt + b, m);
+  }
+}
+
+void dso::HelmertTransform::apply(const Ellipsoid &e, const CartesianCrd *p,
+                                  GeodeticCrd *g,
+                                  std::size_t n) const noexcept {
+  double bx[BLOCK], by[BLOCK], bz[BLOCK];
+  double blat[BLOCK], blon[BLOCK], bhgt[BLOCK];
+  for (std::size_t b = 0; b < n; b += BLOCK) {
+    const std::size_t m = std::min(BLOCK, n - b);
+    for (std::size_t i = 0; i < m; i++)
+      apply(p[b + i].x(), p[b + i].y(), p[b + i].z(), bx[i], by[i], bz[i]);
+    e.cartesian2geodetic(bx, by, bz, blat, blon, bhgt, m);
+    for (std::size_t i = 0; i < m; i++) {
+      g[b + i].lat() = blat[i];
+      g[b + i].lon() = blon[i];
+      g[b + i].hgt() = bhgt[i];
+    }
+  }
+}
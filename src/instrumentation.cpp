@@ -0,0 +1,143 @@
+#include "core/instrumentation.hpp"
+#ifdef DSO_GEODESY_INSTRUMENT
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace {
+constexpr const char *NAMES[] = {"geodetic2cartesian",
+                                 "cartesian2geodetic",
+                                 "cartesian2spherical",
+                                 "spherical2cartesian",
+                                 "geodetic2cartesian_batch",
+                                 "cartesian2geodetic_batch",
+                                 "geodetic2cartesian_covariance",
+                                 "cartesian2geodetic_covariance",
+                                 "cartesian2enu_covariance",
+                                 "enu2cartesian_covariance"};
+static_assert(sizeof(NAMES) / sizeof(NAMES[0]) ==
+                  dso::instrument::NUM_ENTRIES,
+              "A name is needed for every instrumented function");
+
+#ifdef DSO_GEODESY_INSTRUMENT
+using dso::instrument::NUM_ENTRIES;
+using dso::instrument::Snapshot;
+using dso::instrument::detail::ThreadCounters;
+
+/* Add the counters of a thread to a snapshot */
+void accumulate(const ThreadCounters &c, Snapshot &s) noexcept {
+  constexpr const auto relaxed = std::memory_order_relaxed;
+  for (std::size_t i = 0; i < NUM_ENTRIES; i++) {
+    s.entries[i].calls += c.calls[i].load(relaxed);
+    s.entries[i].points += c.points[i].load(relaxed);
+    s.entries[i].ticks += c.ticks[i].load(relaxed);
+  }
+  s.pole_hits += c.pole_hits.load(relaxed);
+}
+
+/* Counters of all live threads, and totals of the ones that have exited */
+struct Registry {
+  std::mutex m;
+  std::vector<ThreadCounters *> live;
+  Snapshot retired;
+  /* shared by threads recording during their exit, i.e. after their own
+   * counters are released (counts may be lost, but nothing breaks) */
+  ThreadCounters exiting{};
+};
+
+/* Set when the counters of the thread have been released */
+thread_local bool tls_exited = false;
+
+/* Never destroyed, since threads may exit after static destruction */
+Registry &registry() noexcept {
+  static Registry *r = new Registry;
+  return *r;
+}
+
+/* Owns the counters of a thread; on thread exit, they are added to the
+ * totals of the retired threads */
+struct ThreadRegistration {
+  std::unique_ptr<ThreadCounters> c{new ThreadCounters()};
+  ThreadRegistration() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.m);
+    r.live.push_back(c.get());
+  }
+  ~ThreadRegistration() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.m);
+    accumulate(*c, r.retired);
+    ++r.retired.threads;
+    r.live.erase(std::find(r.live.begin(), r.live.end(), c.get()));
+    dso::instrument::detail::tls_counters = &r.exiting;
+    tls_exited = true;
+  }
+};
+
+/* Ticks per second, measured once */
+double ticks_per_second() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  static const double tps = []() {
+    using clock = std::chrono::steady_clock;
+    const auto c0 = clock::now();
+    const std::uint64_t t0 = dso::instrument::detail::ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const std::uint64_t t1 = dso::instrument::detail::ticks();
+    const std::chrono::duration<double> dt = clock::now() - c0;
+    return static_cast<double>(t1 - t0) / dt.count();
+  }();
+  return tps;
+#else
+  return 1e9;
+#endif
+}
+#endif
+} /* unnamed namespace */
+
+const char *dso::instrument::name(entry e) noexcept {
+  return NAMES[static_cast<std::size_t>(e)];
+}
+
+#ifdef DSO_GEODESY_INSTRUMENT
+dso::instrument::detail::ThreadCounters *
+dso::instrument::detail::register_thread() {
+  if (tls_exited)
+    return &registry().exiting;
+  static thread_local ThreadRegistration reg;
+  tls_counters = reg.c.get();
+  return tls_counters;
+}
+#endif
+
+dso::instrument::Snapshot dso::instrument::snapshot() {
+  Snapshot s;
+#ifdef DSO_GEODESY_INSTRUMENT
+  s.ticks_per_second = ticks_per_second();
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+  for (std::size_t i = 0; i < NUM_ENTRIES; i++)
+    s.entries[i] = r.retired.entries[i];
+  s.pole_hits = r.retired.pole_hits;
+  s.threads = r.retired.threads + r.live.size();
+  for (const ThreadCounters *c : r.live)
+    accumulate(*c, s);
+  accumulate(r.exiting, s);
+#endif
+  return s;
+}
+
+dso::instrument::Snapshot
+dso::instrument::operator-(const Snapshot &a, const Snapshot &b) noexcept {
+  Snapshot s(a);
+  for (std::size_t i = 0; i < NUM_ENTRIES; i++) {
+    s.entries[i].calls -= b.entries[i].calls;
+    s.entries[i].points -= b.entries[i].points;
+    s.entries[i].ticks -= b.entries[i].ticks;
+  }
+  s.pole_hits -= b.pole_hits;
+  return s;
+}
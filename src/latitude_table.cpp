@@ -0,0 +1,113 @@
+#include "latitude_table.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+/* Value and derivative (w.r.t. latitude) of a quantity at latitude lat */
+void tabulated(const dso::Ellipsoid &e, dso::latitude_quantity q, double lat,
+               double &f, double &df) noexcept {
+  const double e2 = e.constants().e2;
+  const double sf = std::sin(lat), cf = std::cos(lat);
+  switch (q) {
+  case dso::latitude_quantity::N:
+    /* dN/dφ = N e² sinφ cosφ / W², with W² = 1 - e² sin²φ */
+    f = e.N(lat);
+    df = f * e2 * sf * cf / (1e0 - e2 * sf * sf);
+    break;
+  case dso::latitude_quantity::M:
+    /* dM/dφ = 3 M e² sinφ cosφ / W² */
+    f = e.M(lat);
+    df = 3e0 * f * e2 * sf * cf / (1e0 - e2 * sf * sf);
+    break;
+  case dso::latitude_quantity::geocentric:
+  case dso::latitude_quantity::reduced:
+  default: {
+    /* θ = atan(k tanφ), with dθ/dφ = k / (cos²φ + k² sin²φ) */
+    const bool gc = (q == dso::latitude_quantity::geocentric);
+    const double k = gc ? e.constants().ep2 : e.constants().ep;
+    f = gc ? e.geocentric_latitude(lat) : e.reduced_latitude(lat);
+    df = k / (cf * cf + k * k * sf * sf);
+    break;
+  }
+  }
+}
+
+/* Evaluate the piecewise cubic polynomial with coefficients c at lat */
+inline double interpolate(const double *c, double lat0, double ih,
+                          std::size_t n, double lat) noexcept {
+  const double t = (lat - lat0) * ih;
+  /* the segment; out of range, the first or last one */
+  const double tc = std::min(std::max(t, 0e0), static_cast<double>(n - 1));
+  const std::size_t i = static_cast<std::size_t>(tc);
+  const double u = t - static_cast<double>(i);
+  const double *ci = c + 4 * i;
+  return ci[0] + u * (ci[1] + u * (ci[2] + u * ci[3]));
+}
+} /* unnamed namespace */
+
+dso::LatitudeTable::LatitudeTable(const Ellipsoid &e, double step,
+                                  double lat_min, double lat_max)
+    : __lat0(lat_min) {
+  if (!(step > 0e0) || !std::isfinite(step) || !std::isfinite(lat_min) ||
+      !std::isfinite(lat_max) || !(lat_max > lat_min))
+    throw std::invalid_argument(
+        "LatitudeTable: step must be positive and lat_min < lat_max");
+  /* number of segments; must be representable (a huge table fails to
+   * allocate) */
+  const double segments = std::ceil((lat_max - lat_min) / step);
+  if (!(segments < 1e18))
+    throw std::invalid_argument("LatitudeTable: step too small");
+  __n = std::max<std::size_t>(1, static_cast<std::size_t>(segments));
+  __h = (lat_max - lat_min) / __n;
+  __ih = 1e0 / __h;
+
+  for (int k = 0; k < NQ; k++) {
+    const auto q = static_cast<latitude_quantity>(k);
+    std::vector<double> &c = __c[k];
+    c.resize(4 * __n);
+
+    /* Hermite segments, from the values and (scaled) derivatives at the
+     * nodes */
+    double f0, d0;
+    tabulated(e, q, __lat0, f0, d0);
+    d0 *= __h;
+    for (std::size_t i = 0; i < __n; i++) {
+      double f1, d1;
+      tabulated(e, q, __lat0 + (i + 1) * __h, f1, d1);
+      d1 *= __h;
+      c[4 * i] = f0;
+      c[4 * i + 1] = d0;
+      c[4 * i + 2] = 3e0 * (f1 - f0) - 2e0 * d0 - d1;
+      c[4 * i + 3] = 2e0 * (f0 - f1) + d0 + d1;
+      f0 = f1;
+      d0 = d1;
+    }
+
+    /* maximum error, w.r.t. the direct computation */
+    __err[k] = 0e0;
+    for (std::size_t i = 0; i < __n; i++) {
+      for (double u : {.25e0, .5e0, .75e0}) {
+        const double lat = __lat0 + (i + u) * __h;
+        double f, df;
+        tabulated(e, q, lat, f, df);
+        __err[k] = std::max(__err[k], std::abs(value(q, lat) - f));
+      }
+    }
+  }
+}
+
+double dso::LatitudeTable::value(latitude_quantity q,
+                                 double lat) const noexcept {
+  return interpolate(__c[static_cast<int>(q)].data(), __lat0, __ih, __n, lat);
+}
+
+void dso::LatitudeTable::value(latitude_quantity q, const double *lat,
+                               double *out, std::size_t n) const noexcept {
+  const double *c = __c[static_cast<int>(q)].data();
+  const double lat0 = __lat0, ih = __ih;
+  const std::size_t ns = __n;
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++)
+    out[i] = interpolate(c, lat0, ih, ns, lat[i]);
+}
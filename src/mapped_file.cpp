@@ -0,0 +1,50 @@
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void dso::MappedFile::close() noexcept {
+  if (__data)
+    munmap(__data, __size);
+  if (__fd >= 0)
+    ::close(__fd);
+  __data = nullptr;
+  __size = 0;
+  __fd = -1;
+}
+
+std::errc dso::MappedFile::open(const char *fn) noexcept {
+  close();
+  __fd = ::open(fn, O_RDONLY);
+  if (__fd < 0)
+    return static_cast<std::errc>(errno);
+  struct stat st;
+  if (fstat(__fd, &st)) {
+    const std::errc ec = static_cast<std::errc>(errno);
+    close();
+    return ec;
+  }
+  /* nothing to map */
+  if (!st.st_size)
+    return std::errc{};
+  const std::size_t size = static_cast<std::size_t>(st.st_size);
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, __fd, 0);
+  if (data == MAP_FAILED) {
+    const std::errc ec = static_cast<std::errc>(errno);
+    close();
+    return ec;
+  }
+  __data = data;
+  __size = size;
+  madvise(__data, __size, MADV_SEQUENTIAL);
+  return std::errc{};
+}
+
+void dso::MappedFile::release(std::size_t bytes) noexcept {
+  const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  bytes -= bytes % page;
+  if (__data && bytes)
+    madvise(__data, bytes, MADV_DONTNEED);
+}
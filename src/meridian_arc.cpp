@@ -0,0 +1,27 @@
+#include "core/meridian_arc_core.hpp"
+#include "core/vmath.hpp"
+
+void dso::core::meridian_arc_length(const MeridianArcConstants &c,
+                                    const double *lat, double *s,
+                                    std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    double sf, cf;
+    vmath::sincos(lat[i], sf, cf);
+    s[i] = c.A * (lat[i] + detail::sin_series(sf, cf, c.alp,
+                                              MeridianArcConstants::ORDER));
+  }
+}
+
+void dso::core::meridian_arc_latitude(const MeridianArcConstants &c,
+                                      const double *s, double *lat,
+                                      std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    const double mu = s[i] / c.A;
+    double sm, cm;
+    vmath::sincos(mu, sm, cm);
+    lat[i] = mu + detail::sin_series(sm, cm, c.bet,
+                                     MeridianArcConstants::ORDER);
+  }
+}
@@ -0,0 +1,321 @@
+#include "spatial_index.hpp"
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+using dso::detail::KdNode;
+
+namespace {
+constexpr const std::size_t LEAF = dso::SpatialIndex::LEAF_SIZE;
+constexpr const std::uint64_t INDEX_MASK = (std::uint64_t(1) << 62) - 1;
+
+inline std::size_t index_of(const KdNode &p) noexcept {
+  return static_cast<std::size_t>(p.key & INDEX_MASK);
+}
+inline int axis_of(const KdNode &p) noexcept {
+  return static_cast<int>(p.key >> 62);
+}
+
+/* Split the range [b, e) at its middle m, along the axis of largest extent:
+ * on return, points in [b, m) (resp. (m, e)) are not after (resp. not
+ * before) the point at m, which holds the split axis */
+std::size_t split(KdNode *nodes, std::size_t b, std::size_t e) noexcept {
+  double lo[3], hi[3];
+  for (int j = 0; j < 3; j++)
+    lo[j] = hi[j] = nodes[b].c[j];
+  for (std::size_t i = b + 1; i < e; i++) {
+    for (int j = 0; j < 3; j++) {
+      lo[j] = std::min(lo[j], nodes[i].c[j]);
+      hi[j] = std::max(hi[j], nodes[i].c[j]);
+    }
+  }
+  int axis = 0;
+  for (int j = 1; j < 3; j++)
+    axis = (hi[j] - lo[j] > hi[axis] - lo[axis]) ? j : axis;
+
+  const std::size_t m = b + (e - b) / 2;
+  std::nth_element(nodes + b, nodes + m, nodes + e,
+                   [axis](const KdNode &p1, const KdNode &p2) noexcept {
+                     return p1.c[axis] < p2.c[axis];
+                   });
+  nodes[m].key = (nodes[m].key & INDEX_MASK) |
+                 (static_cast<std::uint64_t>(axis) << 62);
+  return m;
+}
+
+/* Build the subtree spanning [b, e) */
+void build_range(KdNode *nodes, std::size_t b, std::size_t e) noexcept {
+  while (e - b > LEAF) {
+    const std::size_t m = split(nodes, b, e);
+    build_range(nodes, b, m);
+    b = m + 1;
+  }
+}
+
+inline double dist2(const KdNode &p, const double *q) noexcept {
+  const double dx = p.c[0] - q[0];
+  const double dy = p.c[1] - q[1];
+  const double dz = p.c[2] - q[2];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+/* State of a kNN query; d2 (squared distances) and idx are kept sorted by
+ * increasing distance, hence d2[k-1] is the current search radius */
+struct KnnQuery {
+  double q[3];
+  std::size_t k;
+  std::size_t *idx;
+  double *d2;
+
+  void insert(double d, std::size_t i) noexcept {
+    if (!(d < d2[k - 1]))
+      return;
+    std::size_t j = k - 1;
+    for (; j > 0 && d2[j - 1] > d; --j) {
+      d2[j] = d2[j - 1];
+      idx[j] = idx[j - 1];
+    }
+    d2[j] = d;
+    idx[j] = i;
+  }
+};
+
+void knn_search(const KdNode *nodes, std::size_t b, std::size_t e,
+                KnnQuery &s) noexcept {
+  if (e - b <= LEAF) {
+    double d[LEAF];
+    const std::size_t n = e - b;
+#pragma omp simd
+    for (std::size_t i = 0; i < n; i++)
+      d[i] = dist2(nodes[b + i], s.q);
+    for (std::size_t i = 0; i < n; i++)
+      s.insert(d[i], index_of(nodes[b + i]));
+    return;
+  }
+  const std::size_t m = b + (e - b) / 2;
+  const KdNode &p = nodes[m];
+  s.insert(dist2(p, s.q), index_of(p));
+  const double diff = s.q[axis_of(p)] - p.c[axis_of(p)];
+  /* nearer subtree first, the farther one only if it may hold closer
+   * points than the ones found so far */
+  if (diff < 0e0) {
+    knn_search(nodes, b, m, s);
+    if (diff * diff < s.d2[s.k - 1])
+      knn_search(nodes, m + 1, e, s);
+  } else {
+    knn_search(nodes, m + 1, e, s);
+    if (diff * diff < s.d2[s.k - 1])
+      knn_search(nodes, b, m, s);
+  }
+}
+
+void radius_search(const KdNode *nodes, std::size_t b, std::size_t e,
+                   const double *q, double r2, std::vector<std::size_t> &idx,
+                   std::vector<double> &dist) {
+  if (e - b <= LEAF) {
+    double d[LEAF];
+    const std::size_t n = e - b;
+#pragma omp simd
+    for (std::size_t i = 0; i < n; i++)
+      d[i] = dist2(nodes[b + i], q);
+    for (std::size_t i = 0; i < n; i++) {
+      if (d[i] <= r2) {
+        idx.push_back(index_of(nodes[b + i]));
+        dist.push_back(std::sqrt(d[i]));
+      }
+    }
+    return;
+  }
+  const std::size_t m = b + (e - b) / 2;
+  const KdNode &p = nodes[m];
+  const double d = dist2(p, q);
+  if (d <= r2) {
+    idx.push_back(index_of(p));
+    dist.push_back(std::sqrt(d));
+  }
+  const double diff = q[axis_of(p)] - p.c[axis_of(p)];
+  if (diff <= 0e0 || diff * diff <= r2)
+    radius_search(nodes, b, m, q, r2, idx, dist);
+  if (diff >= 0e0 || diff * diff <= r2)
+    radius_search(nodes, m + 1, e, q, r2, idx, dist);
+}
+
+/* number of queries per chunk, for parallel batch queries */
+constexpr const std::size_t QUERY_CHUNK = 256;
+} /* unnamed namespace */
+
+dso::SpatialIndex::SpatialIndex(const double *x, const double *y,
+                                const double *z, std::size_t n)
+    : __nodes(n), __pos(n) {
+  for (std::size_t i = 0; i < n; i++)
+    __nodes[i] = KdNode{{x[i], y[i], z[i]}, i};
+  build(nullptr);
+}
+
+dso::SpatialIndex::SpatialIndex(ThreadPool &pool, const double *x,
+                                const double *y, const double *z,
+                                std::size_t n)
+    : __nodes(n), __pos(n) {
+  for (std::size_t i = 0; i < n; i++)
+    __nodes[i] = KdNode{{x[i], y[i], z[i]}, i};
+  build(&pool);
+}
+
+dso::SpatialIndex::SpatialIndex(const std::vector<CartesianCrd> &pts)
+    : __nodes(pts.size()), __pos(pts.size()) {
+  for (std::size_t i = 0; i < pts.size(); i++)
+    __nodes[i] = KdNode{{pts[i].x(), pts[i].y(), pts[i].z()}, i};
+  build(nullptr);
+}
+
+dso::SpatialIndex::SpatialIndex(ThreadPool &pool,
+                                const std::vector<CartesianCrd> &pts)
+    : __nodes(pts.size()), __pos(pts.size()) {
+  for (std::size_t i = 0; i < pts.size(); i++)
+    __nodes[i] = KdNode{{pts[i].x(), pts[i].y(), pts[i].z()}, i};
+  build(&pool);
+}
+
+void dso::SpatialIndex::build(ThreadPool *pool) {
+  KdNode *nodes = __nodes.data();
+  const std::size_t n = __nodes.size();
+
+  if (!pool) {
+    build_range(nodes, 0, n);
+  } else {
+    /* split level by level (the ranges of each level in parallel), until
+     * there are enough subtrees to keep all threads busy; then build the
+     * subtrees in parallel. Splits do not depend on the order in which
+     * ranges are processed, hence the tree is the one built serially. */
+    std::vector<std::pair<std::size_t, std::size_t>> ranges{{0, n}}, next;
+    const std::size_t target = 8 * pool->num_threads();
+    while (ranges.size() < target) {
+      std::vector<std::size_t> mid(ranges.size());
+      pool->parallel_for(ranges.size(), 1,
+                         [&](std::size_t b, std::size_t e) noexcept {
+                           for (std::size_t i = b; i < e; i++)
+                             mid[i] = (ranges[i].second - ranges[i].first >
+                                       LEAF)
+                                          ? split(nodes, ranges[i].first,
+                                                  ranges[i].second)
+                                          : npos;
+                         });
+      next.clear();
+      for (std::size_t i = 0; i < ranges.size(); i++) {
+        if (mid[i] != npos) {
+          next.emplace_back(ranges[i].first, mid[i]);
+          next.emplace_back(mid[i] + 1, ranges[i].second);
+        }
+      }
+      if (next.empty())
+        break;
+      ranges.swap(next);
+    }
+    pool->parallel_for(ranges.size(), 1,
+                       [&](std::size_t b, std::size_t e) noexcept {
+                         for (std::size_t i = b; i < e; i++)
+                           build_range(nodes, ranges[i].first,
+                                       ranges[i].second);
+                       });
+  }
+
+  for (std::size_t i = 0; i < n; i++)
+    __pos[index_of(__nodes[i])] = i;
+}
+
+std::size_t dso::SpatialIndex::knn(double x, double y, double z,
+                                   std::size_t k, std::size_t *idx,
+                                   double *dist) const noexcept {
+  if (!k)
+    return 0;
+  std::fill(idx, idx + k, npos);
+  std::fill(dist, dist + k, std::numeric_limits<double>::infinity());
+  KnnQuery s{{x, y, z}, k, idx, dist};
+  if (!__nodes.empty())
+    knn_search(__nodes.data(), 0, __nodes.size(), s);
+  const std::size_t found = std::min(k, __nodes.size());
+  for (std::size_t i = 0; i < found; i++)
+    dist[i] = std::sqrt(dist[i]);
+  return found;
+}
+
+void dso::SpatialIndex::knn(const double *x, const double *y, const double *z,
+                            std::size_t nq, std::size_t k, std::size_t *idx,
+                            double *dist) const noexcept {
+  for (std::size_t i = 0; i < nq; i++)
+    knn(x[i], y[i], z[i], k, idx + i * k, dist + i * k);
+}
+
+void dso::SpatialIndex::knn(ThreadPool &pool, const double *x, const double *y,
+                            const double *z, std::size_t nq, std::size_t k,
+                            std::size_t *idx, double *dist) const noexcept {
+  pool.parallel_for(nq, QUERY_CHUNK,
+                    [&](std::size_t b, std::size_t e) noexcept {
+                      knn(x + b, y + b, z + b, e - b, k, idx + b * k,
+                          dist + b * k);
+                    });
+}
+
+void dso::SpatialIndex::radius(double x, double y, double z, double r,
+                               std::vector<std::size_t> &idx,
+                               std::vector<double> &dist) const {
+  const double q[3] = {x, y, z};
+  if (!__nodes.empty() && r >= 0e0)
+    radius_search(__nodes.data(), 0, __nodes.size(), q, r * r, idx, dist);
+}
+
+void dso::SpatialIndex::radius(const double *x, const double *y,
+                               const double *z, std::size_t nq, double r,
+                               std::vector<std::size_t> &offsets,
+                               std::vector<std::size_t> &idx,
+                               std::vector<double> &dist) const {
+  offsets.assign(1, 0);
+  offsets.reserve(nq + 1);
+  idx.clear();
+  dist.clear();
+  for (std::size_t i = 0; i < nq; i++) {
+    radius(x[i], y[i], z[i], r, idx, dist);
+    offsets.push_back(idx.size());
+  }
+}
+
+void dso::SpatialIndex::radius(ThreadPool &pool, const double *x,
+                               const double *y, const double *z,
+                               std::size_t nq, double r,
+                               std::vector<std::size_t> &offsets,
+                               std::vector<std::size_t> &idx,
+                               std::vector<double> &dist) const {
+  /* results of each chunk of queries, concatenated in order at the end;
+   * an exception (i.e. std::bad_alloc) is rethrown to the caller */
+  struct Chunk {
+    std::vector<std::size_t> offsets, idx;
+    std::vector<double> dist;
+    std::exception_ptr exc;
+  };
+  std::vector<Chunk> chunks((nq + QUERY_CHUNK - 1) / QUERY_CHUNK);
+  pool.parallel_for(nq, QUERY_CHUNK,
+                    [&](std::size_t b, std::size_t e) noexcept {
+                      Chunk &c = chunks[b / QUERY_CHUNK];
+                      try {
+                        radius(x + b, y + b, z + b, e - b, r, c.offsets,
+                               c.idx, c.dist);
+                      } catch (...) {
+                        c.exc = std::current_exception();
+                      }
+                    });
+  for (const Chunk &c : chunks)
+    if (c.exc)
+      std::rethrow_exception(c.exc);
+
+  offsets.assign(1, 0);
+  offsets.reserve(nq + 1);
+  idx.clear();
+  dist.clear();
+  for (const Chunk &c : chunks) {
+    const std::size_t base = idx.size();
+    for (std::size_t i = 1; i < c.offsets.size(); i++)
+      offsets.push_back(base + c.offsets[i]);
+    idx.insert(idx.end(), c.idx.begin(), c.idx.end());
+    dist.insert(dist.end(), c.dist.begin(), c.dist.end());
+  }
+}
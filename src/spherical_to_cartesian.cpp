@@ -3,6 +3,7 @@
 
 void dso::spherical2cartesian(double r, double glat, double lon, double &x,
                               double &y, double &z) noexcept {
+  instrument::detail::count(instrument::entry::spherical2cartesian, 1);
 
   const double sf = std::sin(glat);
   const double cf = std::cos(glat);
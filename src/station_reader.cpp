@@ -0,0 +1,403 @@
+#include "station_reader.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <exception>
+
+namespace {
+using dso::StationCoordinates;
+using dso::StationReadResult;
+
+/* buffers smaller than that are not split in chunks [bytes] */
+constexpr const std::size_t MIN_CHUNK_BYTES = 256 * 1024;
+/* number of chunks per thread, for load balancing */
+constexpr const std::size_t CHUNKS_PER_THREAD = 4;
+/* approximate size of the lines of a station in a SINEX file [bytes] */
+constexpr const std::size_t SINEX_STATION_BYTES = 3 * 81;
+
+inline bool is_blank(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char *end_of_line(const char *p, const char *last) noexcept {
+  const char *eol = static_cast<const char *>(std::memchr(p, '\n', last - p));
+  return eol ? eol : last;
+}
+
+inline const char *next_line(const char *eol, const char *last) noexcept {
+  return (eol == last) ? last : eol + 1;
+}
+
+/* [p, e), without leading and trailing blanks */
+inline std::string_view trim(const char *p, const char *e) noexcept {
+  while (p != e && is_blank(*p))
+    ++p;
+  while (e != p && is_blank(e[-1]))
+    --e;
+  return std::string_view(p, e - p);
+}
+
+/* A (whole) token as a floating point number; std::from_chars does not
+ * accept a leading '+' */
+inline std::errc to_double(std::string_view t, double &v) noexcept {
+  const char *p = t.data();
+  const char *e = p + t.size();
+  if (p != e && *p == '+')
+    ++p;
+  const auto r = std::from_chars(p, e, v);
+  if (r.ec != std::errc{})
+    return r.ec;
+  return (r.ptr == e) ? std::errc{} : std::errc::invalid_argument;
+}
+
+void push_back(StationCoordinates &sta, std::string_view site,
+               std::string_view soln, const double *v) {
+  sta.site.push_back(site);
+  sta.soln.push_back(soln);
+  sta.x.push_back(v[0]);
+  sta.y.push_back(v[1]);
+  sta.z.push_back(v[2]);
+  sta.sx.push_back(v[3]);
+  sta.sy.push_back(v[4]);
+  sta.sz.push_back(v[5]);
+}
+
+/* Fields of a SOLUTION/ESTIMATE line, i.e. [column, column + width) */
+struct SinexField {
+  std::size_t col, width;
+};
+constexpr const SinexField SNX_TYPE{7, 6};
+constexpr const SinexField SNX_CODE{14, 4};
+constexpr const SinexField SNX_PT{19, 2};
+constexpr const SinexField SNX_SOLN{22, 4};
+constexpr const SinexField SNX_VALUE{47, 21};
+constexpr const SinexField SNX_STDDEV{69, 11};
+
+/* A field of the line [p, eol), without blanks; empty if the line is too
+ * short */
+inline std::string_view field(const char *p, const char *eol,
+                              SinexField f) noexcept {
+  const std::size_t len = eol - p;
+  if (len <= f.col)
+    return std::string_view();
+  return trim(p + f.col, p + std::min(len, f.col + f.width));
+}
+
+/* Component (0, 1 or 2) of the parameter of the line [p, eol), if of type
+ * STAX, STAY or STAZ; -1 for any other type */
+inline int sinex_component(const char *p, const char *eol) noexcept {
+  const std::string_view type = field(p, eol, SNX_TYPE);
+  if (type.size() != 4 || type.compare(0, 3, "STA"))
+    return -1;
+  return (type[3] >= 'X' && type[3] <= 'Z') ? type[3] - 'X' : -1;
+}
+
+/* Does the line [p, eol) hold the X component of a station, i.e. does it
+ * start a station? */
+bool sinex_starts(const char *p, const char *eol) noexcept {
+  return p != eol && *p != '*' && sinex_component(p, eol) == 0;
+}
+
+/* Parse the lines [first, last) of a SOLUTION/ESTIMATE block; lines are
+ * parsed by column, as defined by the SINEX format. If the block goes on
+ * after last (at_end is false), last starts a station; hence an incomplete
+ * station at the end is an error at last, as for the whole block. */
+StationReadResult parse_sinex(const char *first, const char *last,
+                              StationCoordinates &sta, bool at_end = true) {
+  sta.reserve(sta.size() + (last - first) / SINEX_STATION_BYTES + 1);
+  std::size_t count = 0;
+  /* the station being read: key, start line and components read so far */
+  std::string_view code, pt, soln;
+  const char *start = nullptr;
+  int next = 0;
+  double v[6];
+
+  const char *line = first;
+  while (line != last) {
+    const char *eol = end_of_line(line, last);
+    const int c = (line == eol || *line == '*') ? -1
+                                                 : sinex_component(line, eol);
+    if (c < 0) {
+      line = next_line(eol, last);
+      continue;
+    }
+
+    /* components are expected in order X, Y, Z, for the same station */
+    const StationReadResult error{line, std::errc::invalid_argument, count};
+    if (c != next)
+      return error;
+    const std::string_view tcode = field(line, eol, SNX_CODE);
+    const std::string_view tpt = field(line, eol, SNX_PT);
+    const std::string_view tsoln = field(line, eol, SNX_SOLN);
+    if (c == 0) {
+      code = tcode;
+      pt = tpt;
+      soln = tsoln;
+      start = line;
+    } else if (tcode != code || tpt != pt || tsoln != soln) {
+      return error;
+    }
+    const std::string_view sdev = field(line, eol, SNX_STDDEV);
+    std::errc ec = to_double(field(line, eol, SNX_VALUE), v[c]);
+    v[3 + c] = 0e0;
+    if (ec == std::errc{} && !sdev.empty())
+      ec = to_double(sdev, v[3 + c]);
+    if (ec != std::errc{})
+      return {line, ec, count};
+
+    if (c == 2) {
+      push_back(sta, code, soln, v);
+      ++count;
+      next = 0;
+    } else {
+      next = c + 1;
+    }
+    line = next_line(eol, last);
+  }
+
+  /* last station incomplete */
+  if (next)
+    return {at_end ? start : last, std::errc::invalid_argument, count};
+  return {last, std::errc{}, count};
+}
+
+/* Parse the lines [first, last) of a CSV file, after the header */
+StationReadResult parse_csv(const char *first, const char *last,
+                            const dso::CsvColumns &cols,
+                            StationCoordinates &sta) {
+  const int want[] = {cols.site, cols.x, cols.y, cols.z,
+                      cols.sx,   cols.sy, cols.sz};
+  const int maxcol = *std::max_element(std::begin(want), std::end(want));
+  std::size_t count = 0;
+  double v[6];
+
+  const char *line = first;
+  while (line != last) {
+    const char *eol = end_of_line(line, last);
+    const std::string_view l = trim(line, eol);
+    if (l.empty() || l[0] == '#') {
+      line = next_line(eol, last);
+      continue;
+    }
+
+    /* split the (needed) fields */
+    std::string_view fld[7];
+    const char *p = line;
+    int j = 0;
+    for (; j <= maxcol; j++) {
+      const char *e =
+          static_cast<const char *>(std::memchr(p, cols.sep, eol - p));
+      const std::string_view f = trim(p, e ? e : eol);
+      for (int k = 0; k < 7; k++)
+        if (want[k] == j)
+          fld[k] = f;
+      if (!e) {
+        ++j;
+        break;
+      }
+      p = e + 1;
+    }
+    if (j <= maxcol)
+      return {line, std::errc::invalid_argument, count};
+
+    for (int k = 0; k < 6; k++) {
+      v[k] = 0e0;
+      if (k < 3 || want[k + 1] >= 0) {
+        const std::errc ec = to_double(fld[k + 1], v[k]);
+        if (ec != std::errc{})
+          return {line, ec, count};
+      }
+    }
+    push_back(sta, fld[0], std::string_view(), v);
+    ++count;
+    line = next_line(eol, last);
+  }
+  return {last, std::errc{}, count};
+}
+
+/* Split [first, last) in chunks, at line boundaries, for parsing in
+ * parallel; a chunk (but the first) only starts with a line for which
+ * starts(line, eol) holds. Returns the chunk boundaries. */
+template <typename S>
+std::vector<const char *> split_lines(const char *first, const char *last,
+                                      std::size_t max_chunks, S starts) {
+  const std::size_t bytes = last - first;
+  const std::size_t n =
+      std::max<std::size_t>(1, std::min(max_chunks, bytes / MIN_CHUNK_BYTES));
+  std::vector<const char *> b{first};
+  for (std::size_t i = 1; i < n; i++) {
+    const char *p = first + bytes / n * i;
+    if (p <= b.back())
+      continue;
+    p = next_line(end_of_line(p - 1, last), last);
+    while (p != last) {
+      const char *eol = end_of_line(p, last);
+      if (starts(p, eol))
+        break;
+      p = next_line(eol, last);
+    }
+    if (p != last && p > b.back())
+      b.push_back(p);
+  }
+  b.push_back(last);
+  return b;
+}
+
+/* Parse the chunks [b[i], b[i+1]) in parallel (via parse(first, last,
+ * sta)) and gather the results in order, up to the first error */
+template <typename P>
+StationReadResult parse_chunks(dso::ThreadPool &pool,
+                               const std::vector<const char *> &b,
+                               StationCoordinates &sta, P parse) {
+  const std::size_t n = b.size() - 1;
+  if (n == 1)
+    return parse(b[0], b[1], sta);
+
+  std::vector<StationCoordinates> part(n);
+  std::vector<StationReadResult> res(n);
+  std::vector<std::exception_ptr> exc(n);
+  pool.parallel_for(n, 1, [&](std::size_t cb, std::size_t ce) noexcept {
+    for (std::size_t i = cb; i < ce; i++) {
+      try {
+        res[i] = parse(b[i], b[i + 1], part[i]);
+      } catch (...) {
+        exc[i] = std::current_exception();
+      }
+    }
+  });
+  for (const auto &e : exc)
+    if (e)
+      std::rethrow_exception(e);
+
+  std::size_t total = sta.size();
+  for (const auto &p : part)
+    total += p.size();
+  sta.reserve(total);
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    sta.append(part[i]);
+    count += res[i].count;
+    if (res[i].ec != std::errc{})
+      return {res[i].ptr, res[i].ec, count};
+  }
+  return {b[n], std::errc{}, count};
+}
+
+/* Locate the lines of the SOLUTION/ESTIMATE block, i.e. [begin, end);
+ * end is null if the block is not terminated */
+bool sinex_block(const char *first, const char *last, const char *&begin,
+                 const char *&end) noexcept {
+  const std::string_view buf(first, last - first);
+  constexpr const std::string_view START = "\n+SOLUTION/ESTIMATE";
+  constexpr const std::string_view STOP = "\n-SOLUTION/ESTIMATE";
+  /* the start of the header line of the block; may be the first line */
+  std::size_t i = 0;
+  if (buf.compare(0, START.size() - 1, START.substr(1))) {
+    i = buf.find(START);
+    if (i == std::string_view::npos)
+      return false;
+    ++i;
+  }
+  begin = next_line(end_of_line(first + i, last), last);
+  const std::size_t j = buf.find(STOP, begin - first - 1);
+  end = (j == std::string_view::npos) ? nullptr : first + j + 1;
+  return true;
+}
+
+/* Skip comments and the header line of a CSV file, if any */
+const char *csv_body(const char *first, const char *last,
+                     const dso::CsvColumns &cols) noexcept {
+  if (!cols.header)
+    return first;
+  const char *line = first;
+  while (line != last) {
+    const char *eol = end_of_line(line, last);
+    const std::string_view l = trim(line, eol);
+    line = next_line(eol, last);
+    if (!l.empty() && l[0] != '#')
+      break;
+  }
+  return line;
+}
+
+template <typename P>
+StationReadResult read_sinex_impl(const char *first, const char *last,
+                                  P parse) {
+  const char *begin, *end;
+  if (!sinex_block(first, last, begin, end))
+    return {first, std::errc::invalid_argument, 0};
+  auto r = parse(begin, end ? end : last);
+  /* block not terminated; i.e. the file is truncated */
+  if (r.ec == std::errc{} && !end)
+    r.ec = std::errc::invalid_argument;
+  return r;
+}
+} /* unnamed namespace */
+
+void dso::StationCoordinates::clear() noexcept {
+  for (auto *v : {&site, &soln})
+    v->clear();
+  for (auto *v : {&x, &y, &z, &sx, &sy, &sz})
+    v->clear();
+}
+
+void dso::StationCoordinates::reserve(std::size_t n) {
+  for (auto *v : {&site, &soln})
+    v->reserve(n);
+  for (auto *v : {&x, &y, &z, &sx, &sy, &sz})
+    v->reserve(n);
+}
+
+void dso::StationCoordinates::append(const StationCoordinates &other) {
+  site.insert(site.end(), other.site.begin(), other.site.end());
+  soln.insert(soln.end(), other.soln.begin(), other.soln.end());
+  x.insert(x.end(), other.x.begin(), other.x.end());
+  y.insert(y.end(), other.y.begin(), other.y.end());
+  z.insert(z.end(), other.z.begin(), other.z.end());
+  sx.insert(sx.end(), other.sx.begin(), other.sx.end());
+  sy.insert(sy.end(), other.sy.begin(), other.sy.end());
+  sz.insert(sz.end(), other.sz.begin(), other.sz.end());
+}
+
+dso::StationReadResult dso::read_sinex(const char *first, const char *last,
+                                       StationCoordinates &sta) {
+  return read_sinex_impl(first, last, [&](const char *b, const char *e) {
+    return parse_sinex(b, e, sta);
+  });
+}
+
+dso::StationReadResult dso::read_sinex(ThreadPool &pool, const char *first,
+                                       const char *last,
+                                       StationCoordinates &sta) {
+  return read_sinex_impl(first, last, [&](const char *b, const char *e) {
+    return parse_chunks(
+        pool,
+        split_lines(b, e, CHUNKS_PER_THREAD * pool.num_threads(),
+                    sinex_starts),
+        sta, [e](const char *cb, const char *ce, StationCoordinates &s) {
+          return parse_sinex(cb, ce, s, ce == e);
+        });
+  });
+}
+
+dso::StationReadResult dso::read_station_csv(const char *first,
+                                             const char *last,
+                                             const CsvColumns &cols,
+                                             StationCoordinates &sta) {
+  return parse_csv(csv_body(first, last, cols), last, cols, sta);
+}
+
+dso::StationReadResult dso::read_station_csv(ThreadPool &pool,
+                                             const char *first,
+                                             const char *last,
+                                             const CsvColumns &cols,
+                                             StationCoordinates &sta) {
+  return parse_chunks(
+      pool,
+      split_lines(csv_body(first, last, cols), last,
+                  CHUNKS_PER_THREAD * pool.num_threads(),
+                  [](const char *, const char *) noexcept { return true; }),
+      sta, [&](const char *b, const char *e, StationCoordinates &s) {
+        return parse_csv(b, e, cols, s);
+      });
+}
@@ -0,0 +1,112 @@
+#include "thread_pool.hpp"
+
+dso::ThreadPool::ThreadPool(unsigned num_threads) {
+  if (!num_threads)
+    num_threads = std::thread::hardware_concurrency();
+  if (!num_threads)
+    num_threads = 1;
+
+  for (unsigned i = 0; i < num_threads; i++)
+    __queues.emplace_back(new Queue);
+
+  /* queue 0 belongs to the calling thread; spawn the workers */
+  for (unsigned i = 1; i < num_threads; i++)
+    __workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+dso::ThreadPool::~ThreadPool() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(__wake_m);
+    __stop = true;
+  }
+  __wake_cv.notify_all();
+  for (auto &t : __workers)
+    t.join();
+}
+
+void dso::ThreadPool::execute(const Task &task) noexcept {
+  Job *job = task.job;
+  job->fn(job->ctx, task.begin, task.end);
+  /* signal (under the lock, so that the job outlives the notification) */
+  std::lock_guard<std::mutex> lock(job->m);
+  if (--job->pending == 0)
+    job->cv.notify_all();
+}
+
+bool dso::ThreadPool::acquire(std::size_t own, Task &task) noexcept {
+  /* pop from the back of our own queue */
+  {
+    Queue &q = *__queues[own];
+    std::lock_guard<std::mutex> lock(q.m);
+    if (!q.tasks.empty()) {
+      task = q.tasks.back();
+      q.tasks.pop_back();
+      return true;
+    }
+  }
+  /* steal from the front of some other queue */
+  const std::size_t nq = __queues.size();
+  for (std::size_t k = 1; k < nq; k++) {
+    Queue &q = *__queues[(own + k) % nq];
+    std::lock_guard<std::mutex> lock(q.m);
+    if (!q.tasks.empty()) {
+      task = q.tasks.front();
+      q.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void dso::ThreadPool::run(Job &job, std::size_t n,
+                          std::size_t chunk) noexcept {
+  const std::size_t num_chunks = (n + chunk - 1) / chunk;
+  const std::size_t nq = __queues.size();
+  job.pending = num_chunks;
+
+  /* distribute contiguous blocks of chunks to the queues; chunks are pushed
+   * in reverse order, so that owners (popping from the back) process them
+   * in increasing order */
+  for (std::size_t k = 0; k < nq; k++) {
+    const std::size_t first = k * num_chunks / nq;
+    const std::size_t last = (k + 1) * num_chunks / nq;
+    Queue &q = *__queues[k];
+    std::lock_guard<std::mutex> lock(q.m);
+    for (std::size_t c = last; c-- > first;) {
+      const std::size_t b = c * chunk;
+      q.tasks.push_back(Task{&job, b, (n - b > chunk) ? b + chunk : n});
+    }
+  }
+
+  /* wake up workers */
+  {
+    std::lock_guard<std::mutex> lock(__wake_m);
+    ++__epoch;
+  }
+  __wake_cv.notify_all();
+
+  /* the calling thread takes part in the computation */
+  Task task;
+  while (acquire(0, task))
+    execute(task);
+
+  /* wait for chunks still being processed by workers */
+  std::unique_lock<std::mutex> lock(job.m);
+  job.cv.wait(lock, [&job]() { return job.pending == 0; });
+}
+
+void dso::ThreadPool::work(std::size_t id) noexcept {
+  std::size_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(__wake_m);
+      __wake_cv.wait(lock, [&]() { return __stop || __epoch != seen; });
+      if (__stop)
+        return;
+      seen = __epoch;
+    }
+    Task task;
+    while (acquire(id, task))
+      execute(task);
+  }
+}
@@ -0,0 +1,106 @@
+#include "topocentric_frame.hpp"
+#include "core/vmath.hpp"
+
+dso::TopocentricFrame::TopocentricFrame(const Ellipsoid &ell,
+                                        const GeodeticCrd &sta) noexcept
+    : __g0(sta) {
+  ell.geodetic2cartesian(sta.lat(), sta.lon(), sta.hgt(), __x0.x(), __x0.y(),
+                         __x0.z());
+  __R = geodetic2lvlh(sta.lat(), sta.lon());
+}
+
+dso::TopocentricFrame::TopocentricFrame(const Ellipsoid &ell,
+                                        const CartesianCrd &sta) noexcept
+    : __x0(sta) {
+  ell.cartesian2geodetic(sta.x(), sta.y(), sta.z(), __g0.lat(), __g0.lon(),
+                         __g0.hgt());
+  __R = geodetic2lvlh(__g0.lat(), __g0.lon());
+}
+
+void dso::TopocentricFrame::cartesian2enu(const double *x, const double *y,
+                                          const double *z, double *e,
+                                          double *n, double *u,
+                                          std::size_t num_pts) const noexcept {
+  const double x0 = __x0.x(), y0 = __x0.y(), z0 = __x0.z();
+  const double r00 = __R(0, 0), r10 = __R(1, 0), r20 = __R(2, 0);
+  const double r01 = __R(0, 1), r11 = __R(1, 1), r21 = __R(2, 1);
+  const double r02 = __R(0, 2), r12 = __R(1, 2), r22 = __R(2, 2);
+
+#pragma omp simd
+  for (std::size_t i = 0; i < num_pts; i++) {
+    const double dx = x[i] - x0;
+    const double dy = y[i] - y0;
+    const double dz = z[i] - z0;
+    e[i] = r00 * dx + r10 * dy + r20 * dz;
+    n[i] = r01 * dx + r11 * dy + r21 * dz;
+    u[i] = r02 * dx + r12 * dy + r22 * dz;
+  }
+}
+
+void dso::TopocentricFrame::enu2cartesian(const double *e, const double *n,
+                                          const double *u, double *x,
+                                          double *y, double *z,
+                                          std::size_t num_pts) const noexcept {
+  const double x0 = __x0.x(), y0 = __x0.y(), z0 = __x0.z();
+  const double r00 = __R(0, 0), r01 = __R(0, 1), r02 = __R(0, 2);
+  const double r10 = __R(1, 0), r11 = __R(1, 1), r12 = __R(1, 2);
+  const double r20 = __R(2, 0), r21 = __R(2, 1), r22 = __R(2, 2);
+
+#pragma omp simd
+  for (std::size_t i = 0; i < num_pts; i++) {
+    const double ei = e[i], ni = n[i], ui = u[i];
+    x[i] = x0 + (r00 * ei + r01 * ni + r02 * ui);
+    y[i] = y0 + (r10 * ei + r11 * ni + r12 * ui);
+    z[i] = z0 + (r20 * ei + r21 * ni + r22 * ui);
+  }
+}
+
+void dso::TopocentricFrame::cartesian2aer(const double *x, const double *y,
+                                          const double *z, double *az,
+                                          double *el, double *rng,
+                                          std::size_t num_pts) const noexcept {
+  const double x0 = __x0.x(), y0 = __x0.y(), z0 = __x0.z();
+  const double r00 = __R(0, 0), r10 = __R(1, 0), r20 = __R(2, 0);
+  const double r01 = __R(0, 1), r11 = __R(1, 1), r21 = __R(2, 1);
+  const double r02 = __R(0, 2), r12 = __R(1, 2), r22 = __R(2, 2);
+
+#pragma omp simd
+  for (std::size_t i = 0; i < num_pts; i++) {
+    const double dx = x[i] - x0;
+    const double dy = y[i] - y0;
+    const double dz = z[i] - z0;
+    const double e = r00 * dx + r10 * dy + r20 * dz;
+    const double n = r01 * dx + r11 * dy + r21 * dz;
+    const double u = r02 * dx + r12 * dy + r22 * dz;
+    const double a = core::vmath::atan2(e, n);
+    const double a1 = (a < 0e0) ? a + 2e0 * DPI : a;
+    /* a tiny negative angle rounds to 2π */
+    az[i] = (a1 >= 2e0 * DPI) ? a1 - 2e0 * DPI : a1;
+    el[i] = core::vmath::atan2(u, std::sqrt(e * e + n * n));
+    rng[i] = std::sqrt(e * e + n * n + u * u);
+  }
+}
+
+void dso::TopocentricFrame::aer2cartesian(const double *az, const double *el,
+                                          const double *rng, double *x,
+                                          double *y, double *z,
+                                          std::size_t num_pts) const noexcept {
+  const double x0 = __x0.x(), y0 = __x0.y(), z0 = __x0.z();
+  const double r00 = __R(0, 0), r01 = __R(0, 1), r02 = __R(0, 2);
+  const double r10 = __R(1, 0), r11 = __R(1, 1), r12 = __R(1, 2);
+  const double r20 = __R(2, 0), r21 = __R(2, 1), r22 = __R(2, 2);
+
+#pragma omp simd
+  for (std::size_t i = 0; i < num_pts; i++) {
+    double sa, ca, se, ce;
+    core::vmath::sincos(az[i], sa, ca);
+    core::vmath::sincos(el[i], se, ce);
+    const double hr = rng[i] * ce;
+    const double ei = hr * sa;
+    const double ni = hr * ca;
+    const double ui = rng[i] * se;
+    x[i] = x0 + (r00 * ei + r01 * ni + r02 * ui);
+    y[i] = y0 + (r10 * ei + r11 * ni + r12 * ui);
+    z[i] = z0 + (r20 * ei + r21 * ni + r22 * ui);
+  }
+}
@@ -0,0 +1,225 @@
+#include "core/transverse_mercator_core.hpp"
+#include "core/vmath.hpp"
+#include <limits>
+
+using dso::core::TransverseMercatorConstants;
+using dso::core::TransverseMercatorGrid;
+using dso::core::detail::sin_series;
+
+namespace {
+constexpr const int ORDER = TransverseMercatorConstants::ORDER;
+
+/* Normalize an angle to [-pi, pi]; rounding via the 1.5 * 2^52 trick is
+ * branch-free */
+template <bool V> inline double ang_normalize(double x) noexcept {
+  if constexpr (V) {
+    constexpr const double ROUND = 6755399441055744e0;
+    const double q = (x * (1e0 / (2e0 * dso::DPI)) + ROUND) - ROUND;
+    return x - q * (2e0 * dso::DPI);
+  } else {
+    return std::remainder(x, 2e0 * dso::DPI);
+  }
+}
+
+template <bool V> inline void sincos(double x, double &s, double &c) noexcept {
+  if constexpr (V) {
+    dso::core::vmath::sincos(x, s, c);
+  } else {
+    s = std::sin(x);
+    c = std::cos(x);
+  }
+}
+
+template <bool V> inline double atan2(double y, double x) noexcept {
+  if constexpr (V)
+    return dso::core::vmath::atan2(y, x);
+  else
+    return std::atan2(y, x);
+}
+
+template <bool V> inline double exp(double x) noexcept {
+  if constexpr (V)
+    return dso::core::vmath::exp(x);
+  else
+    return std::exp(x);
+}
+
+template <bool V> inline double log1p(double x) noexcept {
+  if constexpr (V)
+    return dso::core::vmath::log1p(x);
+  else
+    return std::log1p(x);
+}
+
+/* Geodetic to TM grid coordinates; see dso::core::geodetic2tm. The template
+ * parameter V selects the branch-free, vectorizable version (transcendental
+ * functions via dso::core::vmath), which is used in batch loops. */
+template <bool V>
+inline void forward(const TransverseMercatorConstants &c,
+                    const TransverseMercatorGrid &g, double lat, double lon,
+                    double &E, double &N) noexcept {
+  /* conformal latitude */
+  double sphi, cphi;
+  sincos<V>(lat, sphi, cphi);
+  const double chi = lat + sin_series(sphi, cphi, c.chi, ORDER);
+  double schi, cchi, sl, cl;
+  sincos<V>(chi, schi, cchi);
+  sincos<V>(ang_normalize<V>(lon - g.lon0), sl, cl);
+
+  /* spherical TM: tan(ξ') = tan(χ) / cos(λ), tanh(η') = cos(χ) sin(λ) */
+  const double q = cchi * sl;
+  const double ccl = cchi * cl;
+  const double xip = atan2<V>(schi, ccl);
+  const double etap = 0.5e0 * log1p<V>(2e0 * q / (1e0 - q));
+
+  /* sin/cos(2ξ') and sinh/cosh(2η'), expressed rationally in terms of q,
+   * since cos(ξ')^2 + sin(ξ')^2 = 1 / cosh(η')^2 = 1 - q^2 */
+  const double d = 1e0 / ((1e0 - q) * (1e0 + q));
+  const double s2 = 2e0 * schi * ccl * d;
+  const double c2 = (ccl - schi) * (ccl + schi) * d;
+  const double sh2 = 2e0 * q * d;
+  const double ch2 = (1e0 + q * q) * d;
+
+  /* ζ = ζ' + sum(α_k sin(2kζ')) */
+  double re, im;
+  sin_series(s2, c2, sh2, ch2, c.alp, ORDER, re, im);
+  const double kA = g.k0 * c.A;
+  E = g.fe + kA * (etap + im);
+  N = g.fn + kA * (xip + re);
+}
+
+/* TM grid to geodetic coordinates; see dso::core::tm2geodetic. For the
+ * template parameter V see forward. */
+template <bool V>
+inline void reverse(const TransverseMercatorConstants &c,
+                    const TransverseMercatorGrid &g, double E, double N,
+                    double &lat, double &lon) noexcept {
+  const double kA = g.k0 * c.A;
+  const double xi = (N - g.fn) / kA;
+  const double eta = (E - g.fe) / kA;
+
+  /* ζ' = ζ - sum(β_k sin(2kζ)) */
+  double s2, c2;
+  sincos<V>(2e0 * xi, s2, c2);
+  const double e2 = exp<V>(2e0 * eta);
+  const double sh2 = 0.5e0 * (e2 - 1e0 / e2);
+  const double ch2 = 0.5e0 * (e2 + 1e0 / e2);
+  double re, im;
+  sin_series(s2, c2, sh2, ch2, c.bet, ORDER, re, im);
+  const double xip = xi - re;
+  const double etap = eta - im;
+
+  /* inverse of the spherical TM */
+  double sxip, cxip;
+  sincos<V>(xip, sxip, cxip);
+  const double e1 = exp<V>(etap);
+  const double shp = 0.5e0 * (e1 - 1e0 / e1);
+  const double chp = 0.5e0 * (e1 + 1e0 / e1);
+  const double r = std::sqrt(shp * shp + cxip * cxip);
+  const double chi = atan2<V>(sxip, r);
+
+  /* geodetic from conformal latitude */
+  lat = chi + sin_series(sxip / chp, r / chp, c.phi, ORDER);
+  lon = ang_normalize<V>(g.lon0 + atan2<V>(shp, cxip));
+}
+
+/* Parameters of the UTM grid for a given zone and false northing */
+inline TransverseMercatorGrid utm_grid(int zone, double fn) noexcept {
+  return TransverseMercatorGrid{dso::core::utm_central_meridian(zone),
+                                dso::core::UTM_K0,
+                                dso::core::UTM_FALSE_EASTING, fn};
+}
+
+/* False northing of the UTM grid for a given hemisphere; selected
+ * arithmetically, since (GCC) does not vectorize selections on bool lanes */
+inline double utm_false_northing(bool north) noexcept {
+  return dso::core::UTM_FALSE_NORTHING_SOUTH * (1 - static_cast<int>(north));
+}
+} /* unnamed namespace */
+
+void dso::core::geodetic2tm(const TransverseMercatorConstants &c,
+                            const TransverseMercatorGrid &g, double lat,
+                            double lon, double &E, double &N) noexcept {
+  forward<false>(c, g, lat, lon, E, N);
+}
+
+void dso::core::tm2geodetic(const TransverseMercatorConstants &c,
+                            const TransverseMercatorGrid &g, double E,
+                            double N, double &lat, double &lon) noexcept {
+  reverse<false>(c, g, E, N, lat, lon);
+}
+
+void dso::core::geodetic2utm(const TransverseMercatorConstants &c,
+                             double lat, double lon, int &zone, bool &north,
+                             double &E, double &N) noexcept {
+  zone = utm_zone(lat, lon);
+  north = (lat >= 0e0);
+  forward<false>(c, utm_grid(zone, utm_false_northing(north)), lat, lon, E,
+                 N);
+}
+
+void dso::core::utm2geodetic(const TransverseMercatorConstants &c, int zone,
+                             bool north, double E, double N, double &lat,
+                             double &lon) noexcept {
+  if (!utm_valid_zone(zone)) {
+    lat = lon = std::numeric_limits<double>::quiet_NaN();
+    return;
+  }
+  reverse<false>(c, utm_grid(zone, utm_false_northing(north)), E, N, lat,
+                 lon);
+}
+
+/* as for the geodesic batch loops, the loop bodies have to be inlined in
+ * full (including the vmath calls) for the loops to be vectorized */
+[[gnu::flatten]] void
+dso::core::geodetic2tm(const TransverseMercatorConstants &c,
+                       const TransverseMercatorGrid &g, const double *lat,
+                       const double *lon, double *E, double *N,
+                       std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++)
+    forward<true>(c, g, lat[i], lon[i], E[i], N[i]);
+}
+
+[[gnu::flatten]] void
+dso::core::tm2geodetic(const TransverseMercatorConstants &c,
+                       const TransverseMercatorGrid &g, const double *E,
+                       const double *N, double *lat, double *lon,
+                       std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++)
+    reverse<true>(c, g, E[i], N[i], lat[i], lon[i]);
+}
+
+[[gnu::flatten]] void
+dso::core::geodetic2utm(const TransverseMercatorConstants &c,
+                        const double *lat, const double *lon, int *zone,
+                        bool *north, double *E, double *N,
+                        std::size_t n) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    const int z = utm_zone(lat[i], lon[i]);
+    const double fn = (lat[i] >= 0e0) ? 0e0 : UTM_FALSE_NORTHING_SOUTH;
+    forward<true>(c, utm_grid(z, fn), lat[i], lon[i], E[i], N[i]);
+    zone[i] = z;
+  }
+  /* stores of bool lanes do not vectorize; this loop is cheap */
+  for (std::size_t i = 0; i < n; i++)
+    north[i] = (lat[i] >= 0e0);
+}
+
+[[gnu::flatten]] void
+dso::core::utm2geodetic(const TransverseMercatorConstants &c, const int *zone,
+                        const bool *north, const double *E, const double *N,
+                        double *lat, double *lon, std::size_t n) noexcept {
+  constexpr const double NaN = std::numeric_limits<double>::quiet_NaN();
+#pragma omp simd
+  for (std::size_t i = 0; i < n; i++) {
+    double la, lo;
+    reverse<true>(c, utm_grid(zone[i], utm_false_northing(north[i])), E[i],
+                  N[i], la, lo);
+    const bool valid = utm_valid_zone(zone[i]);
+    lat[i] = valid ? la : NaN;
+    lon[i] = valid ? lo : NaN;
+  }
+}
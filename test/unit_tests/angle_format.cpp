@@ -0,0 +1,152 @@
+#include "angle_format.hpp"
+#include "units.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace dso;
+
+/* max difference of parsed angles, i.e. a few ulps [rad] */
+constexpr const double MAX_DIFF_RAD = 1e-15;
+
+namespace {
+bool parses(const char *str, angle_format f, double deg) {
+  double rad;
+  const auto r = parse_angle(str, str + std::strlen(str), f, rad);
+  return r.ec == std::errc{} &&
+         std::abs(rad - ((f == angle_format::radians) ? deg : deg2rad(deg))) <
+             MAX_DIFF_RAD;
+}
+
+std::errc error(const char *str, angle_format f) {
+  double rad;
+  const auto r = parse_angle(str, str + std::strlen(str), f, rad);
+  assert(r.ec == std::errc{} || r.ptr == str);
+  return r.ec;
+}
+
+std::string format(double rad, angle_format f, int precision,
+                   const char *hemi = nullptr) {
+  char buf[64];
+  const auto r = format_angle(buf, buf + sizeof(buf), rad, f, precision, hemi);
+  assert(r.ec == std::errc{});
+  return std::string(buf, r.ptr);
+}
+} /* unnamed namespace */
+
+int main() {
+  const double dms = hexd2decd(23, 45, 12.3456);
+
+  /* sexagesimal */
+  assert(parses("23 45 12.3456", angle_format::dms, dms));
+  assert(parses("  23:45:12.3456", angle_format::dms, dms));
+  assert(parses("+23 45 12.3456 N", angle_format::dms, dms));
+  assert(parses("-23 45 12.3456", angle_format::dms, -dms));
+  assert(parses("23 45 12.3456 S", angle_format::dms, -dms));
+  assert(parses("23\t45\t12.3456W", angle_format::dms, -dms));
+  assert(parses("-0 30 00", angle_format::dms, -0.5e0));
+  assert(parses("0 30 0 s", angle_format::dms, -0.5e0));
+  assert(error("23 60 00", angle_format::dms) ==
+         std::errc::result_out_of_range);
+  assert(error("23 45 60.0", angle_format::dms) ==
+         std::errc::result_out_of_range);
+  assert(error("23.5 45 12", angle_format::dms) == std::errc::invalid_argument);
+  assert(error("23 45", angle_format::dms) == std::errc::invalid_argument);
+  assert(error("-23 45 12 S", angle_format::dms) ==
+         std::errc::invalid_argument);
+  assert(error("23 45 12x", angle_format::dms) == std::errc::invalid_argument);
+
+  /* decimal degrees and radians */
+  assert(parses("23.5", angle_format::degrees, 23.5e0));
+  assert(parses("+23.5,", angle_format::degrees, 23.5e0));
+  assert(parses("-23.5", angle_format::degrees, -23.5e0));
+  assert(parses("23.5 E", angle_format::degrees, 23.5e0));
+  assert(parses(".5 W", angle_format::degrees, -.5e0));
+  assert(parses("-0.4145780", angle_format::radians, -0.4145780e0));
+  assert(error("0.41N", angle_format::radians) == std::errc::invalid_argument);
+  assert(error("--1", angle_format::degrees) == std::errc::invalid_argument);
+  assert(error("", angle_format::degrees) == std::errc::invalid_argument);
+  assert(error("abc", angle_format::degrees) == std::errc::invalid_argument);
+
+  /* formatting */
+  assert(format(deg2rad(dms), angle_format::dms, 4) == "23 45 12.3456");
+  assert(format(deg2rad(-dms), angle_format::dms, 2) == "-23 45 12.35");
+  assert(format(deg2rad(-dms), angle_format::dms, 0, "NS") == "23 45 12 S");
+  assert(format(deg2rad(hexd2decd(5, 3, 2.5)), angle_format::dms, 1, "EW") ==
+         "5 03 02.5 E");
+  /* rounding carries to minutes and degrees */
+  assert(format(deg2rad(hexd2decd(9, 59, 59.99996)), angle_format::dms, 4) ==
+         "10 00 00.0000");
+  assert(format(deg2rad(-1e-12), angle_format::dms, 3) == "0 00 00.000");
+  assert(format(deg2rad(-23.5), angle_format::degrees, 3) == "-23.500");
+  assert(format(deg2rad(23.5), angle_format::degrees, 1, "NS") == "23.5 N");
+  assert(format(-0.25, angle_format::radians, 2) == "-0.25");
+  {
+    char buf[8];
+    const auto r = format_angle(buf, buf + sizeof(buf), deg2rad(dms),
+                                angle_format::dms, 4);
+    assert(r.ec == std::errc::value_too_large);
+  }
+
+  /* round trip, in all formats */
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-DPI / 2e0, DPI / 2e0);
+  std::uniform_real_distribution<double> ulon(-DPI, DPI);
+  std::uniform_real_distribution<double> uhgt(-100e0, 5e3);
+  const std::size_t n = 1000;
+  std::vector<GeodeticCrd> crd(n), back(n);
+  for (auto &c : crd) {
+    c.lat() = ulat(gen);
+    c.lon() = ulon(gen);
+    c.hgt() = uhgt(gen);
+  }
+  std::vector<char> buf(100 * n);
+  for (angle_format f :
+       {angle_format::dms, angle_format::degrees, angle_format::radians}) {
+    const auto w = format_geodetic(buf.data(), buf.data() + buf.size(),
+                                   crd.data(), n, f, 9, 4);
+    assert(w.ec == std::errc{});
+    const auto r = parse_geodetic(buf.data(), w.ptr, f, back.data(), n);
+    assert(r.ec == std::errc{} && r.count == n && r.ptr == w.ptr);
+    /* 1e-9 arcsec, 1e-9 deg and 1e-9 rad */
+    const double tol = (f == angle_format::dms)       ? sec2rad(1e-9)
+                       : (f == angle_format::degrees) ? deg2rad(1e-9)
+                                                      : 1e-9;
+    for (std::size_t i = 0; i < n; i++) {
+      assert(std::abs(back[i].lat() - crd[i].lat()) < tol);
+      assert(std::abs(back[i].lon() - crd[i].lon()) < tol);
+      assert(std::abs(back[i].hgt() - crd[i].hgt()) <= .5e-4 + 1e-9);
+    }
+  }
+
+  /* records: comments, empty lines, commas, extra fields, errors */
+  {
+    const char *txt = "# station list\n"
+                      "38 02 45.12 N, 23 47 12.0 E, 123.4\n"
+                      "\n"
+                      "  38:02:45.12 S 23:47:12.0 W -5 NOA1 extra\r\n"
+                      "38 02 45.12 N 23 47 12.0 E\n"
+                      "38 02 45.12 N 23 47 12.0 E 1.0\n";
+    GeodeticCrd c[4];
+    const auto r =
+        parse_geodetic(txt, txt + std::strlen(txt), angle_format::dms, c, 4);
+    assert(r.count == 2 && r.ec == std::errc::invalid_argument);
+    assert(std::strncmp(r.ptr, "38 02 45.12 N 23 47 12.0 E\n", 27) == 0);
+    assert(std::abs(c[0].lat() - hexd2rad(38, 2, 45.12)) < MAX_DIFF_RAD);
+    assert(std::abs(c[0].lon() - hexd2rad(23, 47, 12.0)) < MAX_DIFF_RAD);
+    assert(c[0].hgt() == 123.4);
+    assert(c[1].lat() == -c[0].lat() && c[1].lon() == -c[0].lon());
+    assert(c[1].hgt() == -5e0);
+
+    /* at most n records */
+    const auto r1 =
+        parse_geodetic(txt, txt + std::strlen(txt), angle_format::dms, c, 1);
+    assert(r1.count == 1 && r1.ec == std::errc{});
+    assert(*r1.ptr == '\n');
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "units.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace dso;
+using detail::AngleUnit;
+
+namespace {
+/* bitwise identical (or both NaN) */
+bool same(double a, double b) noexcept {
+  if (std::isnan(a) || std::isnan(b))
+    return std::isnan(a) && std::isnan(b);
+  return a == b && std::signbit(a) == std::signbit(b);
+}
+
+/* Angles, in units U: random ones over all magnitudes, (close to) multiples
+ * of the half circle, and special values */
+template <AngleUnit U> std::vector<double> angles() {
+  constexpr const double C = detail::AngleUnitTraits<U>::full_circle();
+  std::vector<double> a;
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ue(-300e0, 11e0);
+  std::uniform_real_distribution<double> us(-1e0, 1e0);
+  for (int i = 0; i < 100000; i++)
+    a.push_back(us(gen) * std::pow(10e0, ue(gen)));
+  std::uniform_int_distribution<long> uk(-(1L << 26), 1L << 26);
+  for (int i = 0; i < 20000; i++) {
+    const long k = (i < 2000) ? (i - 1000) : uk(gen);
+    double x = static_cast<double>(k) * (C / 2e0);
+    double y = x;
+    for (int j = 0; j < 4; j++) {
+      a.push_back(x);
+      a.push_back(y);
+      x = std::nextafter(x, std::numeric_limits<double>::infinity());
+      y = std::nextafter(y, -std::numeric_limits<double>::infinity());
+    }
+  }
+  const double lim = angle_reduction_limit<U>();
+  for (double x : {0e0, -0e0, C, -C, C / 2e0, -C / 2e0, 1e-320, -1e-320,
+                   lim, -lim, std::nextafter(lim, 0e0), 1e300, -1e300,
+                   std::numeric_limits<double>::infinity(),
+                   -std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::quiet_NaN()})
+    a.push_back(x);
+  return a;
+}
+
+template <AngleUnit U> void check() {
+  const std::vector<double> a = angles<U>();
+  const std::size_t n = a.size();
+  std::vector<double> o1(n), o2(n);
+  norm_angle<U>(a.data(), o1.data(), n);
+  anpm<U>(a.data(), o2.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    assert(same(o1[i], norm_angle<U>(a[i])));
+    assert(same(o2[i], anpm<U>(a[i])));
+  }
+
+  /* in-place */
+  std::vector<double> b(a);
+  anp<U>(b.data(), b.data(), n);
+  for (std::size_t i = 0; i < n; i++)
+    assert(same(b[i], o1[i]));
+  b = a;
+  anpm<U>(b.data(), b.data(), n);
+  for (std::size_t i = 0; i < n; i++)
+    assert(same(b[i], o2[i]));
+}
+} /* unnamed namespace */
+
+int main() {
+  check<AngleUnit::Radians>();
+  check<AngleUnit::Degrees>();
+  check<AngleUnit::Seconds>();
+  check<AngleUnit::Hours>();
+  check<AngleUnit::SecondsOfHour>();
+  return 0;
+}
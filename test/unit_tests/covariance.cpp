@@ -0,0 +1,162 @@
+#include "transformations.hpp"
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* max relative difference of analytic vs numeric (central difference)
+ * Jacobian elements */
+constexpr const double MAX_DIFF_JACOBIAN = 1e-6;
+/* max relative difference of covariance elements */
+constexpr const double MAX_DIFF_COV = 1e-12;
+
+namespace {
+/* Unpack a covariance matrix */
+Eigen::Matrix<double, 3, 3> unpack(const double *c) noexcept {
+  Eigen::Matrix<double, 3, 3> S;
+  S << c[0], c[1], c[2], c[1], c[3], c[4], c[2], c[4], c[5];
+  return S;
+}
+
+/* Relative difference of packed covariance matrices, w.r.t. their largest
+ * element */
+double cov_diff(const double *a, const double *b) noexcept {
+  double d = 0e0, m = 0e0;
+  for (int k = 0; k < 6; k++) {
+    d = std::max(d, std::abs(a[k] - b[k]));
+    m = std::max(m, std::abs(b[k]));
+  }
+  return d / m;
+}
+} /* unnamed namespace */
+
+int main() {
+  const Ellipsoid ell(ellipsoid::grs80);
+  const auto &c = ellipsoid_constants<ellipsoid::grs80>;
+
+  const std::size_t n = 1000;
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-1.5e0, 1.5e0);
+  std::uniform_real_distribution<double> ulon(-DPI, DPI);
+  std::uniform_real_distribution<double> uhgt(-100e0, 20e3);
+  std::uniform_real_distribution<double> uc(-1e0, 1e0);
+  std::vector<double> lat(n), lon(n), hgt(n);
+  /* covariance matrices of (x,y,z), i.e. A A^T for random A (and hence
+   * positive (semi-)definite), of ~cm */
+  std::vector<double> cov(COV_SIZE * n);
+  for (std::size_t i = 0; i < n; i++) {
+    lat[i] = ulat(gen);
+    lon[i] = ulon(gen);
+    hgt[i] = uhgt(gen);
+    Eigen::Matrix<double, 3, 3> A;
+    for (int k = 0; k < 9; k++)
+      A(k / 3, k % 3) = 1e-2 * uc(gen);
+    const Eigen::Matrix<double, 3, 3> S = A * A.transpose();
+    double *ci = cov.data() + COV_SIZE * i;
+    ci[0] = S(0, 0);
+    ci[1] = S(0, 1);
+    ci[2] = S(0, 2);
+    ci[3] = S(1, 1);
+    ci[4] = S(1, 2);
+    ci[5] = S(2, 2);
+  }
+
+  for (std::size_t i = 0; i < n; i++) {
+    /* geodetic to cartesian Jacobian, vs central differences */
+    const Eigen::Matrix<double, 3, 3> J =
+        core::geodetic2cartesian_jacobian(c, lat[i], lon[i], hgt[i]);
+    const double dh[] = {1e-7, 1e-7, 1e-2};
+    for (int k = 0; k < 3; k++) {
+      double p[] = {lat[i], lon[i], hgt[i]};
+      double m[] = {lat[i], lon[i], hgt[i]};
+      p[k] += dh[k];
+      m[k] -= dh[k];
+      double xp, yp, zp, xm, ym, zm;
+      ell.geodetic2cartesian(p[0], p[1], p[2], xp, yp, zp);
+      ell.geodetic2cartesian(m[0], m[1], m[2], xm, ym, zm);
+      const Eigen::Matrix<double, 3, 1> d(xp - xm, yp - ym, zp - zm);
+      assert((J.col(k) - d / (2e0 * dh[k])).norm() <=
+             MAX_DIFF_JACOBIAN * J.col(k).norm());
+    }
+
+    /* the cartesian to geodetic Jacobian is its inverse (checked as J Ji,
+     * since the elements of Ji J mix [m] and [rad]) */
+    const Eigen::Matrix<double, 3, 3> Ji =
+        ell.cartesian2geodetic_jacobian(lat[i], lon[i], hgt[i]);
+    const Eigen::Matrix<double, 3, 3> I = J * Ji;
+    assert((I - Eigen::Matrix<double, 3, 3>::Identity()).norm() < 1e-12);
+
+    /* ENU Jacobian is orthonormal */
+    const Eigen::Matrix<double, 3, 3> R =
+        cartesian2enu_jacobian(lat[i], lon[i]);
+    assert((R * R.transpose() - Eigen::Matrix<double, 3, 3>::Identity())
+               .norm() < 1e-14);
+  }
+
+  /* spherical Jacobians are inverse of each other */
+  for (std::size_t i = 0; i < n; i++) {
+    const double r = 6378e3 + hgt[i];
+    const Eigen::Matrix<double, 3, 3> I =
+        spherical2cartesian_jacobian(r, lat[i], lon[i]) *
+        cartesian2spherical_jacobian(r, lat[i], lon[i]);
+    assert((I - Eigen::Matrix<double, 3, 3>::Identity()).norm() < 1e-12);
+  }
+
+  /* batch, vs J Σ J^T per point */
+  std::vector<double> geo(COV_SIZE * n), enu(COV_SIZE * n);
+  std::vector<double> xyz(COV_SIZE * n);
+  cartesian2geodetic_covariance<ellipsoid::grs80>(
+      lat.data(), lon.data(), hgt.data(), cov.data(), geo.data(), n);
+  cartesian2enu_covariance(lat.data(), lon.data(), cov.data(), enu.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    const double *ci = cov.data() + COV_SIZE * i;
+    double ref[COV_SIZE];
+    core::propagate_covariance(
+        core::cartesian2geodetic_jacobian(c, lat[i], lon[i], hgt[i]), ci, ref);
+    assert(cov_diff(geo.data() + COV_SIZE * i, ref) < MAX_DIFF_COV);
+    core::propagate_covariance(cartesian2enu_jacobian(lat[i], lon[i]), ci,
+                               ref);
+    assert(cov_diff(enu.data() + COV_SIZE * i, ref) < MAX_DIFF_COV);
+
+    /* propagate_covariance vs Eigen */
+    const Eigen::Matrix<double, 3, 3> J =
+        core::cartesian2geodetic_jacobian(c, lat[i], lon[i], hgt[i]);
+    const Eigen::Matrix<double, 3, 3> P = J * unpack(ci) * J.transpose();
+    core::propagate_covariance(J, ci, ref);
+    assert((unpack(ref) - P).norm() <= 1e-14 * P.norm());
+
+    /* the ENU trace is the cartesian one */
+    const double *e = enu.data() + COV_SIZE * i;
+    assert(std::abs((e[0] + e[3] + e[5]) - (ci[0] + ci[3] + ci[5])) <
+           1e-14 * (ci[0] + ci[3] + ci[5]));
+  }
+
+  /* round trips */
+  ell.geodetic2cartesian_covariance(lat.data(), lon.data(), hgt.data(),
+                                    geo.data(), xyz.data(), n);
+  for (std::size_t i = 0; i < n; i++)
+    assert(cov_diff(xyz.data() + COV_SIZE * i, cov.data() + COV_SIZE * i) <
+           1e-10);
+  enu2cartesian_covariance(lat.data(), lon.data(), enu.data(), xyz.data(), n);
+  for (std::size_t i = 0; i < n; i++)
+    assert(cov_diff(xyz.data() + COV_SIZE * i, cov.data() + COV_SIZE * i) <
+           1e-12);
+
+  /* in-place */
+  std::vector<double> tmp(cov);
+  cartesian2enu_covariance(lat.data(), lon.data(), tmp.data(), tmp.data(), n);
+  for (std::size_t i = 0; i < COV_SIZE * n; i++)
+    assert(tmp[i] == enu[i]);
+  tmp = cov;
+  geodetic2cartesian_covariance<ellipsoid::grs80>(
+      lat.data(), lon.data(), hgt.data(), tmp.data(), tmp.data(), n);
+  std::vector<double> ref(COV_SIZE * n);
+  ell.geodetic2cartesian_covariance(lat.data(), lon.data(), hgt.data(),
+                                    cov.data(), ref.data(), n);
+  for (std::size_t i = 0; i < COV_SIZE * n; i++)
+    assert(tmp[i] == ref[i]);
+
+  return 0;
+}
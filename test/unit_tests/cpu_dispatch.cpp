@@ -0,0 +1,112 @@
+#include "cpu_dispatch.hpp"
+#include "transformations.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+namespace {
+/* Outputs of all batch kernels, for a given set of inputs */
+struct Outputs {
+  std::vector<double> lat, lon, hgt, x, y, z, gcov, ccov, ecov, xcov;
+  bool operator==(const Outputs &o) const noexcept {
+    auto same = [](const std::vector<double> &a,
+                   const std::vector<double> &b) {
+      return a.size() == b.size() &&
+             !std::memcmp(a.data(), b.data(), a.size() * sizeof(double));
+    };
+    return same(lat, o.lat) && same(lon, o.lon) && same(hgt, o.hgt) &&
+           same(x, o.x) && same(y, o.y) && same(z, o.z) &&
+           same(gcov, o.gcov) && same(ccov, o.ccov) && same(ecov, o.ecov) &&
+           same(xcov, o.xcov);
+  }
+};
+
+Outputs run(const std::vector<double> &x, const std::vector<double> &y,
+            const std::vector<double> &z, const std::vector<double> &cov) {
+  const std::size_t n = x.size();
+  Outputs o;
+  for (auto *v : {&o.lat, &o.lon, &o.hgt, &o.x, &o.y, &o.z})
+    v->resize(n);
+  for (auto *v : {&o.gcov, &o.ccov, &o.ecov, &o.xcov})
+    v->resize(COV_SIZE * n);
+  cartesian2geodetic<ellipsoid::grs80>(x.data(), y.data(), z.data(),
+                                       o.lat.data(), o.lon.data(),
+                                       o.hgt.data(), n);
+  geodetic2cartesian<ellipsoid::grs80>(o.lat.data(), o.lon.data(),
+                                       o.hgt.data(), o.x.data(), o.y.data(),
+                                       o.z.data(), n);
+  const auto &c = ellipsoid_constants<ellipsoid::grs80>;
+  core::geodetic2cartesian_covariance(c, o.lat.data(), o.lon.data(),
+                                      o.hgt.data(), cov.data(),
+                                      o.gcov.data(), n);
+  core::cartesian2geodetic_covariance(c, o.lat.data(), o.lon.data(),
+                                      o.hgt.data(), cov.data(),
+                                      o.ccov.data(), n);
+  cartesian2enu_covariance(o.lat.data(), o.lon.data(), cov.data(),
+                           o.ecov.data(), n);
+  enu2cartesian_covariance(o.lat.data(), o.lon.data(), cov.data(),
+                           o.xcov.data(), n);
+  return o;
+}
+} /* unnamed namespace */
+
+int main() {
+  /* a level requested via the environment (if available) is used */
+  const char *env = std::getenv("DSO_GEODESY_SIMD");
+  if (env && !std::strcmp(env, "baseline"))
+    assert(simd_level() == SimdLevel::baseline);
+  if (!env)
+    assert(simd_level() == max_simd_level());
+
+  /* points around the globe, on the polar axis and deep inside the earth;
+   * odd size, so that loop remainders are exercised */
+  const std::size_t n = 1001;
+  std::mt19937_64 gen(7);
+  std::uniform_real_distribution<double> u(-7e6, 7e6);
+  std::uniform_real_distribution<double> s(1e-6, 1e-2);
+  std::vector<double> x(n), y(n), z(n), cov(COV_SIZE * n);
+  for (std::size_t i = 0; i < n; i++) {
+    x[i] = u(gen);
+    y[i] = u(gen);
+    z[i] = u(gen);
+    /* a valid (positive definite) covariance matrix */
+    const double a = s(gen), b = s(gen), d = s(gen);
+    double *c = cov.data() + COV_SIZE * i;
+    c[0] = a * a;
+    c[1] = a * b * 1e-1;
+    c[2] = -a * d * 2e-1;
+    c[3] = b * b;
+    c[4] = b * d * 3e-1;
+    c[5] = d * d;
+  }
+  x[0] = y[0] = 0e0;
+  x[1] = y[1] = 1e-9;
+  x[2] = y[2] = z[2] = 0e0;
+
+  assert(simd_level_available(SimdLevel::baseline));
+  assert(set_simd_level(SimdLevel::baseline) == std::errc{});
+  assert(simd_level() == SimdLevel::baseline);
+  const Outputs ref = run(x, y, z, cov);
+
+  /* every level available gives identical results; the ones that are not
+   * available cannot be selected */
+  for (SimdLevel l : {SimdLevel::avx2, SimdLevel::avx512}) {
+    assert(std::strlen(simd_level_name(l)) > 0);
+    if (simd_level_available(l)) {
+      assert(set_simd_level(l) == std::errc{});
+      assert(simd_level() == l);
+      assert(run(x, y, z, cov) == ref);
+    } else {
+      const SimdLevel prev = simd_level();
+      assert(set_simd_level(l) == std::errc::not_supported);
+      assert(simd_level() == prev);
+    }
+  }
+  assert(!std::strcmp(simd_level_name(SimdLevel::avx512), "avx512"));
+
+  return 0;
+}
@@ -0,0 +1,184 @@
+#include "transformations.hpp"
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* A record, with extra fields around the coordinates */
+struct Record {
+  int id;
+  double x, y, z;
+  float sigma;
+};
+
+int main() {
+  constexpr const ellipsoid E = ellipsoid::grs80;
+  const Ellipsoid ell(E);
+
+  /* 1000 points, i.e. more than a block (of non-SoA spans) */
+  const std::size_t n = 1000;
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-DPI / 2e0, DPI / 2e0);
+  std::uniform_real_distribution<double> ulon(-DPI, DPI);
+  std::uniform_real_distribution<double> uhgt(-100e0, 20e3);
+  std::vector<double> lat(n), lon(n), hgt(n);
+  for (std::size_t i = 0; i < n; i++) {
+    lat[i] = ulat(gen);
+    lon[i] = ulon(gen);
+    hgt[i] = uhgt(gen);
+  }
+
+  /* reference results, from the batch (SoA) transformation */
+  std::vector<double> x(n), y(n), z(n);
+  geodetic2cartesian<E>(lat.data(), lon.data(), hgt.data(), x.data(),
+                        y.data(), z.data(), n);
+
+  /* element access and traits */
+  {
+    CartesianCrdSpan s(x.data(), y.data(), z.data(), n);
+    assert(s.size() == n && s.is_soa());
+    assert(s[7].x() == x[7] && s[7].y() == y[7] && s[7].z() == z[7]);
+    s[7].y() += 1e0;
+    assert(y[7] == s[7].y());
+    s[7].y() -= 1e0;
+    static_assert(CoordinateTypeTraits<CartesianCrdSpan>::isSpan);
+    static_assert(!CoordinateTypeTraits<CartesianCrdSpan>::isConst);
+    static_assert(CoordinateTypeTraits<CartesianCrdConstSpan>::isConst);
+    static_assert(
+        CoordinateTypeTraits<CartesianCrdSpan::reference>::isCartesian);
+    static_assert(
+        std::is_same_v<crd_scalar_t<GeodeticCrdConstSpan::reference>, double>);
+
+    /* references can be passed to the scalar transformations */
+    const GeodeticCrd g = cartesian2geodetic<E>(s[7]);
+    assert(std::abs(g.lat() - lat[7]) < 1e-14);
+    assert(std::abs(g.hgt() - hgt[7]) < 1e-8);
+  }
+
+  /* SoA (i.e. the kernel runs directly on the spanned arrays) */
+  {
+    std::vector<double> ox(n), oy(n), oz(n);
+    geodetic2cartesian<E>(
+        GeodeticCrdConstSpan(lat.data(), lon.data(), hgt.data(), n),
+        CartesianCrdSpan(ox.data(), oy.data(), oz.data(), n));
+    for (std::size_t i = 0; i < n; i++)
+      assert(ox[i] == x[i] && oy[i] == y[i] && oz[i] == z[i]);
+  }
+
+  /* SoA, in place (i.e. overwriting the input arrays); both directions, so
+   * that every kernel reads components already overwritten, e.g. the
+   * (sign of) z after the height is written */
+  {
+    std::vector<double> a(x), b(y), c(z);
+    const CartesianCrdSpan cs(a.data(), b.data(), c.data(), n);
+    const GeodeticCrdSpan gs(a.data(), b.data(), c.data(), n);
+    assert(cs.overlaps(gs));
+    cartesian2geodetic<E>(CartesianCrdConstSpan(cs), gs);
+    for (std::size_t i = 0; i < n; i++) {
+      assert(std::abs(a[i] - lat[i]) < 1e-14);
+      assert(std::abs(b[i] - lon[i]) < 1e-14);
+      assert(std::abs(c[i] - hgt[i]) < 1e-8);
+    }
+    geodetic2cartesian(GeodeticCrdConstSpan(gs), cs, ell);
+    for (std::size_t i = 0; i < n; i++) {
+      assert(std::abs(a[i] - x[i]) < 1e-8);
+      assert(std::abs(b[i] - y[i]) < 1e-8);
+      assert(std::abs(c[i] - z[i]) < 1e-8);
+    }
+    /* columns shared in another order (e.g. height written over x) */
+    std::vector<double> d(n);
+    cartesian2geodetic(
+        CartesianCrdConstSpan(a.data(), b.data(), c.data(), n),
+        GeodeticCrdSpan(c.data(), d.data(), a.data(), n), ell);
+    for (std::size_t i = 0; i < n; i++) {
+      assert(std::abs(c[i] - lat[i]) < 1e-14);
+      assert(std::abs(d[i] - lon[i]) < 1e-14);
+      assert(std::abs(a[i] - hgt[i]) < 1e-8);
+    }
+    /* disjoint columns do not overlap */
+    assert(!CartesianCrdSpan(x.data(), y.data(), z.data(), n).overlaps(gs));
+  }
+
+  /* AoS, i.e. interleaved triplets */
+  {
+    std::vector<double> llh(3 * n), xyz(3 * n);
+    for (std::size_t i = 0; i < n; i++) {
+      llh[3 * i] = lat[i];
+      llh[3 * i + 1] = lon[i];
+      llh[3 * i + 2] = hgt[i];
+    }
+    const GeodeticCrdSpan g = GeodeticCrdSpan::aos(llh.data(), n);
+    const CartesianCrdSpan c = CartesianCrdSpan::aos(xyz.data(), n);
+    assert(!g.is_soa());
+    geodetic2cartesian<E>(g, c);
+    for (std::size_t i = 0; i < n; i++)
+      assert(xyz[3 * i] == x[i] && xyz[3 * i + 1] == y[i] &&
+             xyz[3 * i + 2] == z[i]);
+
+    /* back, in place (i.e. overwriting the cartesian coordinates) */
+    const GeodeticCrdSpan gx = GeodeticCrdSpan::aos(xyz.data(), n);
+    cartesian2geodetic(CartesianCrdConstSpan(c), gx, ell);
+    for (std::size_t i = 0; i < n; i++) {
+      assert(std::abs(gx[i].lat() - lat[i]) < 1e-14);
+      assert(std::abs(gx[i].hgt() - hgt[i]) < 1e-8);
+    }
+  }
+
+  /* records, with extra fields */
+  {
+    std::vector<Record> rec(n);
+    for (std::size_t i = 0; i < n; i++) {
+      rec[i].id = static_cast<int>(i);
+      rec[i].sigma = 1e0f;
+    }
+    const CartesianCrdSpan c =
+        CartesianCrdSpan::aos(&rec[0].x, n, sizeof(Record));
+    geodetic2cartesian(GeodeticCrdConstSpan(lat.data(), lon.data(),
+                                            hgt.data(), n),
+                       c, ell);
+    for (std::size_t i = 0; i < n; i++) {
+      assert(rec[i].x == x[i] && rec[i].y == y[i] && rec[i].z == z[i]);
+      assert(rec[i].id == static_cast<int>(i) && rec[i].sigma == 1e0f);
+    }
+    std::vector<double> olat(n), olon(n), ohgt(n);
+    cartesian2geodetic<E>(
+        c, GeodeticCrdSpan(olat.data(), olon.data(), ohgt.data(), n));
+    std::vector<double> rlat(n), rlon(n), rhgt(n);
+    cartesian2geodetic<E>(x.data(), y.data(), z.data(), rlat.data(),
+                          rlon.data(), rhgt.data(), n);
+    for (std::size_t i = 0; i < n; i++)
+      assert(olat[i] == rlat[i] && olon[i] == rlon[i] && ohgt[i] == rhgt[i]);
+  }
+
+  /* a strided column (every other element) and arrays of coordinate types */
+  {
+    std::vector<double> wide(2 * n);
+    for (std::size_t i = 0; i < n; i++)
+      wide[2 * i] = lat[i];
+    const GeodeticCrdConstSpan g(wide.data(), 2 * sizeof(double), lon.data(),
+                                 sizeof(double), hgt.data(), sizeof(double),
+                                 n);
+    std::vector<CartesianCrd> crd(n);
+    geodetic2cartesian<E>(g, CartesianCrdSpan::aos(crd.data(), n));
+    for (std::size_t i = 0; i < n; i++)
+      assert(crd[i].x() == x[i] && crd[i].y() == y[i] && crd[i].z() == z[i]);
+
+    /* spherical, via the scalar transformations */
+    std::vector<SphericalCrd> sph(n);
+    const CartesianCrdConstSpan cc = CartesianCrdConstSpan::aos(
+        static_cast<const CartesianCrd *>(crd.data()), n);
+    cartesian2spherical(cc, SphericalCrdSpan::aos(sph.data(), n));
+    std::vector<CartesianCrd> back(n);
+    spherical2cartesian(SphericalCrdConstSpan::aos(sph.data(), n),
+                        CartesianCrdSpan::aos(back.data(), n));
+    for (std::size_t i = 0; i < n; i++) {
+      const SphericalCrd si = cartesian2spherical(crd[i]);
+      assert(sph[i].mv == si.mv);
+      assert(back[i].mv == spherical2cartesian(si).mv);
+    }
+  }
+
+  return 0;
+}
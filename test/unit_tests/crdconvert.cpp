@@ -0,0 +1,96 @@
+/* Test of the crdconvert tool; the path of the executable is given as the
+ * (only) command line argument. */
+#include "transformations.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <vector>
+
+using namespace dso;
+
+namespace {
+void write_file(const char *fn, const std::vector<double> &v) {
+  std::FILE *fp = std::fopen(fn, "wb");
+  assert(fp);
+  [[maybe_unused]] const std::size_t w =
+      std::fwrite(v.data(), sizeof(double), v.size(), fp);
+  assert(w == v.size());
+  std::fclose(fp);
+}
+
+std::vector<double> read_file(const char *fn) {
+  std::vector<double> v;
+  std::FILE *fp = std::fopen(fn, "rb");
+  assert(fp);
+  double d;
+  while (std::fread(&d, sizeof(double), 1, fp) == 1)
+    v.push_back(d);
+  std::fclose(fp);
+  return v;
+}
+
+/* run the tool; returns its exit status */
+int run(const std::string &tool, const char *args) {
+  const std::string cmd = "\"" + tool + "\" " + args + " 2>/dev/null";
+  const int status = std::system(cmd.c_str());
+  return (status == -1) ? -1 : WEXITSTATUS(status);
+}
+} /* unnamed namespace */
+
+int main(int argc, char *argv[]) {
+  assert(argc == 2);
+  const std::string tool(argv[1]);
+
+  /* more points than a block of the tool, and not a multiple of it */
+  const std::size_t n = 5003;
+  std::vector<double> geo(3 * n), lat(n), lon(n), hgt(n), x(n), y(n), z(n);
+  for (std::size_t i = 0; i < n; i++) {
+    lat[i] = geo[3 * i] = -1.5e0 + 3e0 * i / n;
+    lon[i] = geo[3 * i + 1] = -3e0 + 6e0 * i / n;
+    hgt[i] = geo[3 * i + 2] = -1e2 + 1e1 * i;
+  }
+  geodetic2cartesian<ellipsoid::wgs84>(lat.data(), lon.data(), hgt.data(),
+                                       x.data(), y.data(), z.data(), n);
+  write_file("crdconvert_geo.bin", geo);
+
+  /* geodetic to cartesian, as the batch transformation */
+  int status = run(tool, "-f geodetic -t cartesian -e wgs84 "
+                         "crdconvert_geo.bin crdconvert_crt.bin");
+  assert(!status);
+  const std::vector<double> crt = read_file("crdconvert_crt.bin");
+  assert(crt.size() == 3 * n);
+  for (std::size_t i = 0; i < n; i++) {
+    assert(crt[3 * i] == x[i]);
+    assert(crt[3 * i + 1] == y[i]);
+    assert(crt[3 * i + 2] == z[i]);
+  }
+
+  /* and back */
+  status = run(tool, "-f cartesian -t geodetic -e wgs84 "
+                     "crdconvert_crt.bin crdconvert_back.bin");
+  assert(!status);
+  const std::vector<double> back = read_file("crdconvert_back.bin");
+  assert(back.size() == 3 * n);
+  for (std::size_t i = 0; i < 3 * n; i++)
+    assert(std::abs(back[i] - geo[i]) < ((i % 3 == 2) ? 1e-6 : 1e-12));
+
+  /* output is the input (even if named differently): refused, and the
+   * input is left intact */
+  status = run(tool, "-f cartesian -t geodetic crdconvert_crt.bin "
+                     "./crdconvert_crt.bin");
+  assert(status == 1);
+  assert(read_file("crdconvert_crt.bin") == crt);
+
+  /* bad options */
+  status = run(tool, "-f cartesian -t ecef crdconvert_crt.bin out.bin");
+  assert(status == 1);
+
+  std::remove("crdconvert_geo.bin");
+  std::remove("crdconvert_crt.bin");
+  std::remove("crdconvert_back.bin");
+  (void)status;
+  return 0;
+}
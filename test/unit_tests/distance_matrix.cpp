@@ -0,0 +1,120 @@
+#include "distance_matrix.hpp"
+#include "geodesic.hpp"
+#include "transformations.hpp"
+#include <cassert>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* relative, w.r.t. straightforward (pair by pair) computations */
+constexpr const double MAX_DIFF_REL = 1e-12;
+
+int main() {
+  constexpr const auto E = ellipsoid::grs80;
+  const Ellipsoid ell(E);
+
+  /* stations, randomly on (and slightly above) the ellipsoid; n is not a
+   * multiple of the tile size */
+  const std::size_t n = 203;
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-DPI / 2e0, DPI / 2e0);
+  std::uniform_real_distribution<double> ulon(-DPI, DPI);
+  std::uniform_real_distribution<double> uhgt(0e0, 3e3);
+  std::vector<GeodeticCrd> geo(n);
+  std::vector<CartesianCrd> car(n);
+  for (std::size_t i = 0; i < n; i++) {
+    geo[i].lat() = ulat(gen);
+    geo[i].lon() = ulon(gen);
+    geo[i].hgt() = uhgt(gen);
+    geodetic2cartesian<E>(geo[i].lat(), geo[i].lon(), geo[i].hgt(),
+                          car[i].x(), car[i].y(), car[i].z());
+  }
+  /* a pair of coincident and a pair of antipodal stations */
+  car[7] = car[3];
+  car[11] = CartesianCrd(-car[5].x(), -car[5].y(), -car[5].z());
+
+  const StationNetwork net(ell, car);
+  assert(net.size() == n);
+  assert(net.radius() == mean_earth_radius<E>());
+
+  ThreadPool pool(4);
+  for (auto m : {distance_metric::chord, distance_metric::great_circle,
+                 distance_metric::geodesic}) {
+    std::vector<double> full(matrix_size(n, matrix_storage::full));
+    std::vector<double> upper(matrix_size(n, matrix_storage::upper));
+    std::vector<float> fupper(upper.size());
+    net.distances(m, matrix_storage::full, full.data());
+    net.distances(m, matrix_storage::upper, upper.data());
+    net.distances(m, matrix_storage::upper, fupper.data());
+
+    for (std::size_t i = 0; i < n; i++) {
+      assert(full[i * n + i] == 0e0);
+      for (std::size_t j = i + 1; j < n; j++) {
+        /* reference values */
+        const double dx = car[i].x() - car[j].x();
+        const double dy = car[i].y() - car[j].y();
+        const double dz = car[i].z() - car[j].z();
+        const double c = std::sqrt(dx * dx + dy * dy + dz * dz);
+        double d = c;
+        if (m == distance_metric::great_circle) {
+          const double ri = car[i].mv.norm(), rj = car[j].mv.norm();
+          const double dot = car[i].mv.dot(car[j].mv) / (ri * rj);
+          const double crs = car[i].mv.cross(car[j].mv).norm() / (ri * rj);
+          d = net.radius() * std::atan2(crs, dot);
+        } else if (m == distance_metric::geodesic) {
+          double lat1, lon1, h1, lat2, lon2, h2, a1, a2;
+          cartesian2geodetic<E>(car[i].x(), car[i].y(), car[i].z(), lat1,
+                                lon1, h1);
+          cartesian2geodetic<E>(car[j].x(), car[j].y(), car[j].z(), lat2,
+                                lon2, h2);
+          geodesic_inverse<E>(lat1, lon1, lat2, lon2, d, a1, a2);
+        }
+        const double v = full[i * n + j];
+        assert(std::abs(v - d) <= MAX_DIFF_REL * d + 1e-9);
+        assert(full[j * n + i] == v);
+        assert(upper[upper_index(n, i, j)] == v);
+        assert(fupper[upper_index(n, i, j)] == static_cast<float>(v));
+        assert(net.distance(i, j, m) == v);
+        if (m == distance_metric::great_circle)
+          /* chord <= arc, up to the station radii vs the mean radius */
+          assert(c <= d * (1e0 + 2e-3));
+      }
+    }
+    assert(full[3 * n + 7] == 0e0);
+
+    /* parallel results are identical */
+    std::vector<double> pfull(full.size());
+    std::vector<float> pfupper(upper.size());
+    net.distances(pool, m, matrix_storage::full, pfull.data());
+    net.distances(pool, m, matrix_storage::upper, pfupper.data());
+    assert(pfull == full && pfupper == fupper);
+  }
+
+  /* antipodal stations, on the sphere */
+  assert(std::abs(net.distance(5, 11, distance_metric::great_circle) -
+                  DPI * net.radius()) < 1e-6);
+
+  /* construction from geodetic coordinates */
+  const StationNetwork gnet(ell, geo);
+  for (std::size_t i = 20; i < n; i++) {
+    for (std::size_t j = i + 1; j < n; j++) {
+      const double d = net.distance(i, j, distance_metric::chord);
+      assert(std::abs(gnet.distance(i, j, distance_metric::chord) - d) <
+             1e-6);
+      const double s = net.distance(i, j, distance_metric::geodesic);
+      assert(std::abs(gnet.distance(i, j, distance_metric::geodesic) - s) <
+             1e-6);
+    }
+  }
+
+  /* degenerate sizes */
+  const StationNetwork one(ell, std::vector<CartesianCrd>(1, car[0]));
+  double d0 = -1e0;
+  one.distances(distance_metric::chord, matrix_storage::full, &d0);
+  assert(d0 == 0e0);
+  assert(matrix_size(1, matrix_storage::upper) == 0);
+  assert(matrix_size(0, matrix_storage::upper) == 0);
+
+  return 0;
+}
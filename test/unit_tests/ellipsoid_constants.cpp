@@ -0,0 +1,66 @@
+#include "ellipsoid.hpp"
+#include "geodesic.hpp"
+#include "transverse_mercator.hpp"
+#include <cassert>
+#include <cmath>
+
+using namespace dso;
+
+/* all derived constants are available at compile time, on every compiler */
+constexpr const auto &wgs84 = ellipsoid_constants<ellipsoid::wgs84>;
+static_assert(wgs84.a == 6378137e0, "");
+static_assert(wgs84.aep > 6356752.3142 && wgs84.aep < 6356752.3143, "");
+static_assert(wgs84.c > 6399593.6257 && wgs84.c < 6399593.6258, "");
+static_assert(wgs84.le > 521854.0084 && wgs84.le < 521854.0085, "");
+static_assert(wgs84.second_ecc2 > 6.73949674e-3 &&
+                  wgs84.second_ecc2 < 6.73949675e-3,
+              "");
+static_assert(wgs84.n > 1.6792203e-3 && wgs84.n < 1.6792204e-3, "");
+static_assert(linear_eccentricity<ellipsoid::grs80>() > 0e0, "");
+static_assert(second_eccentricity_squared<ellipsoid::pz90>() > 0e0, "");
+static_assert(Ellipsoid(ellipsoid::pz90).linear_eccentricity() ==
+                  linear_eccentricity<ellipsoid::pz90>(),
+              "");
+static_assert(meridian_arc_constants<ellipsoid::grs80>.A > 0e0, "");
+static_assert(transverse_mercator_constants<ellipsoid::grs80>.A > 0e0, "");
+
+template <ellipsoid E> void check() noexcept {
+  constexpr const auto &c = ellipsoid_constants<E>;
+  const double a = ellipsoid_traits<E>::a;
+  const double f = ellipsoid_traits<E>::f;
+  const double e2 = f * (2e0 - f);
+  const double b = a * (1e0 - f);
+
+  /* identical to the ones computed at runtime (with std::sqrt) */
+  assert(c.e2 == e2);
+  assert(c.ep == std::sqrt(1e0 - e2));
+  assert(c.aep == a * std::sqrt(1e0 - e2));
+  assert(c.le == std::sqrt(a * a - b * b));
+  assert(c.n == f / (2e0 - f));
+  assert(c.c == a * a / b);
+  assert(c.second_ecc2 == e2 / (1e0 - e2));
+
+  /* identities */
+  assert(std::abs(c.aep - b) < 1e-8);
+  assert(std::abs(c.le * c.le - e2 * a * a) < 1e-12 * e2 * a * a);
+  assert(std::abs(c.second_ecc2 - (a * a - b * b) / (b * b)) < 1e-15);
+
+  /* the runtime ellipsoid holds the same constants */
+  const Ellipsoid ell(E);
+  assert(ell.constants().le == c.le &&
+         ell.constants().second_ecc2 == c.second_ecc2);
+  assert(ell.third_flattening() == third_flattening<E>());
+  assert(ell.polar_radius_of_curvature() == polar_radius_of_curvature<E>());
+  assert(ell.second_eccentricity_squared() ==
+         second_eccentricity_squared<E>());
+  /* likewise, if constructed from (a, f) */
+  const Ellipsoid user(a, f);
+  assert(user.constants().le == c.le && user.constants().c == c.c);
+}
+
+int main() {
+  check<ellipsoid::grs80>();
+  check<ellipsoid::wgs84>();
+  check<ellipsoid::pz90>();
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include "transformations.hpp"
+#include "units.hpp"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+using namespace dso;
+constexpr const double MAX_DIFF_LAT_RAD = sec2rad(1.5e-10);
+constexpr const double MAX_DIFF_HGT_MTRS = 5e-9;
+
+/* derived constants are computed at compile time */
+constexpr const Ellipsoid grs80(ellipsoid::grs80);
+static_assert(grs80.eccentricity_squared() ==
+              eccentricity_squared<ellipsoid::grs80>());
+static_assert(grs80.constants().aep > 6356752e0 &&
+              grs80.constants().aep < 6356753e0);
+
+int main() {
+
+  const Ellipsoid wgs84(ellipsoid::wgs84);
+  /* Bessel 1841, not part of the dso::ellipsoid enum */
+  const Ellipsoid bessel(6377397.155e0, 1e0 / 299.1528128e0);
+
+  std::vector<double> lats, lons, hgts;
+  for (double lat = -DPI / 2e0; lat < DPI / 2e0; lat += 1e-2) {
+    for (double lon = -DPI; lon < DPI; lon += 5e-2) {
+      for (double hgt = -100e0; hgt < 1e4; hgt += 1e3) {
+        lats.push_back(lat);
+        lons.push_back(lon);
+        hgts.push_back(hgt);
+      }
+    }
+  }
+  const std::size_t n = lats.size();
+
+  /* runtime ellipsoid gives the same results as the template functions */
+  std::vector<double> x(n), y(n), z(n), lat(n), lon(n), hgt(n);
+  wgs84.geodetic2cartesian(lats.data(), lons.data(), hgts.data(), x.data(),
+                           y.data(), z.data(), n);
+  wgs84.cartesian2geodetic(x.data(), y.data(), z.data(), lat.data(),
+                           lon.data(), hgt.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    double tx, ty, tz, tlat, tlon, thgt;
+    geodetic2cartesian<ellipsoid::wgs84>(lats[i], lons[i], hgts[i], tx, ty,
+                                         tz);
+    double rx, ry, rz;
+    wgs84.geodetic2cartesian(lats[i], lons[i], hgts[i], rx, ry, rz);
+    assert(tx == rx && ty == ry && tz == rz);
+    cartesian2geodetic<ellipsoid::wgs84>(x[i], y[i], z[i], tlat, tlon, thgt);
+    double rlat, rlon, rhgt;
+    wgs84.cartesian2geodetic(x[i], y[i], z[i], rlat, rlon, rhgt);
+    assert(tlat == rlat && tlon == rlon && thgt == rhgt);
+    /* batch results */
+    assert(std::abs(lat[i] - tlat) < MAX_DIFF_LAT_RAD);
+    assert(std::abs(hgt[i] - thgt) < MAX_DIFF_HGT_MTRS);
+  }
+
+  /* user-defined ellipsoid, round trip */
+  bessel.geodetic2cartesian(lats.data(), lons.data(), hgts.data(), x.data(),
+                            y.data(), z.data(), n);
+  bessel.cartesian2geodetic(x.data(), y.data(), z.data(), lat.data(),
+                            lon.data(), hgt.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    assert(std::abs(lat[i] - lats[i]) < MAX_DIFF_LAT_RAD);
+    assert(std::abs(hgt[i] - hgts[i]) < MAX_DIFF_HGT_MTRS);
+    const GeodeticCrd g = cartesian2geodetic(
+        CartesianCrd(x[i], y[i], z[i]), bessel);
+    assert(std::abs(g.lat() - lats[i]) < MAX_DIFF_LAT_RAD);
+  }
+
+  /* radii of curvature */
+  for (double phi = -DPI / 2e0; phi < DPI / 2e0; phi += 1e-3) {
+    assert(wgs84.N(phi) == N<ellipsoid::wgs84>(phi));
+    assert(std::abs(wgs84.M(phi) - M<ellipsoid::wgs84>(phi)) < 1e-8);
+  }
+
+  return 0;
+}
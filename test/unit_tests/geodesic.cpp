@@ -0,0 +1,145 @@
+#include "geodesic.hpp"
+#include <cassert>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* round trips (inverse then direct) should reproduce the end point */
+constexpr const double MAX_DIFF_MTRS = 1e-7;
+/* batch direct (vmath) vs single-point direct (libm) */
+constexpr const double MAX_DIFF_RAD = 1e-13;
+constexpr const double D2R = DPI / 180e0;
+
+/* the coefficients are computed at compile time */
+static_assert(geodesic_constants<ellipsoid::wgs84>.A3x[5] == 1e0);
+
+/* angle difference, in range [-π, π] */
+double dang(double a, double b) noexcept {
+  return std::remainder(a - b, 2e0 * DPI);
+}
+
+void check_known() {
+  double s12, azi1, azi2;
+  /* JFK to LHR (WGS84); see GeographicLib's documentation */
+  geodesic_inverse<ellipsoid::wgs84>(40.6e0 * D2R, -73.8e0 * D2R,
+                                     51.6e0 * D2R, -0.5e0 * D2R, s12, azi1,
+                                     azi2);
+  assert(std::abs(s12 - 5551759.400319e0) < 1e-5);
+  assert(std::abs(dang(azi1, 51.198882845579e0 * D2R)) < 1e-13);
+  assert(std::abs(dang(azi2, 107.821776735514e0 * D2R)) < 1e-13);
+
+  /* along the equator */
+  geodesic_inverse<ellipsoid::wgs84>(0e0, 0e0, 0e0, DPI / 2e0, s12, azi1,
+                                     azi2);
+  assert(std::abs(s12 - ellipsoid_traits<ellipsoid::wgs84>::a * DPI / 2e0) <
+         1e-6);
+  assert(std::abs(azi1 - DPI / 2e0) < 1e-15 &&
+         std::abs(azi2 - DPI / 2e0) < 1e-15);
+
+  /* pole to pole, along a meridian */
+  geodesic_inverse<ellipsoid::wgs84>(-DPI / 2e0, 0e0, DPI / 2e0, 0e0, s12,
+                                     azi1, azi2);
+  assert(std::abs(s12 - 20003931.4586e0) < 1e-4);
+
+  /* antipodal points on the equator; the geodesic runs over a pole */
+  geodesic_inverse<ellipsoid::wgs84>(0e0, 0e0, 0e0, DPI, s12, azi1, azi2);
+  assert(std::abs(s12 - 20003931.4586e0) < 1e-4);
+
+  /* coincident points */
+  geodesic_inverse<ellipsoid::wgs84>(0.3e0, 0.2e0, 0.3e0, 0.2e0, s12, azi1,
+                                     azi2);
+  assert(s12 == 0e0);
+
+  /* zero distance */
+  double lat2, lon2;
+  geodesic_direct<ellipsoid::wgs84>(0.3e0, 0.2e0, 1e0, 0e0, lat2, lon2, azi2);
+  assert(std::abs(lat2 - 0.3e0) < 1e-15 && std::abs(lon2 - 0.2e0) < 1e-15);
+  assert(std::abs(azi2 - 1e0) < 1e-15);
+}
+
+void check_round_trip() {
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> u(-1e0, 1e0);
+  const Geodesic geod(ellipsoid::grs80);
+  for (int i = 0; i < 20000; i++) {
+    const double lat1 = std::asin(u(gen));
+    const double lon1 = u(gen) * DPI;
+    double lat2 = std::asin(u(gen));
+    double lon2 = u(gen) * DPI;
+    if (i % 4 == 0) {
+      /* nearly antipodal points */
+      lat2 = -lat1 + u(gen) * 1e-3;
+      lon2 = lon1 + DPI + u(gen) * 1e-2;
+    }
+
+    double s12, azi1, azi2;
+    geodesic_inverse<ellipsoid::grs80>(lat1, lon1, lat2, lon2, s12, azi1,
+                                       azi2);
+    assert(s12 >= 0e0);
+
+    /* same results via the runtime ellipsoid */
+    double t12, b1, b2;
+    geod.inverse(lat1, lon1, lat2, lon2, t12, b1, b2);
+    assert(t12 == s12 && b1 == azi1 && b2 == azi2);
+
+    /* same distance in the reverse direction */
+    geod.inverse(lat2, lon2, lat1, lon1, t12, b1, b2);
+    assert(std::abs(t12 - s12) < MAX_DIFF_MTRS);
+
+    /* and back to the second point */
+    double lat, lon, azi;
+    geod.direct(lat1, lon1, azi1, s12, lat, lon, azi);
+    assert(std::abs(lat - lat2) * 6.4e6 < MAX_DIFF_MTRS);
+    assert(std::abs(dang(lon, lon2)) * std::cos(lat2) * 6.4e6 <
+           MAX_DIFF_MTRS);
+    if (std::cos(lat2) > 1e-3)
+      assert(std::abs(dang(azi, azi2)) < 1e-12);
+  }
+}
+
+void check_batch() {
+  std::mt19937_64 gen(2);
+  std::uniform_real_distribution<double> u(-1e0, 1e0);
+  const std::size_t n = 5003;
+  std::vector<double> lat1(n), lon1(n), lat2(n), lon2(n);
+  for (std::size_t i = 0; i < n; i++) {
+    lat1[i] = std::asin(u(gen));
+    lon1[i] = u(gen) * DPI;
+    lat2[i] = std::asin(u(gen));
+    lon2[i] = u(gen) * DPI;
+  }
+  /* points at the poles and on the equator */
+  lat1[0] = DPI / 2e0;
+  lat1[1] = -DPI / 2e0;
+  lat1[2] = lat2[2] = 0e0;
+
+  const Geodesic geod(Ellipsoid(6378136e0, 1e0 / 298.25784e0));
+  std::vector<double> s12(n), azi1(n), azi2(n);
+  geod.inverse(lat1.data(), lon1.data(), lat2.data(), lon2.data(), s12.data(),
+               azi1.data(), azi2.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    double s, a1, a2;
+    geod.inverse(lat1[i], lon1[i], lat2[i], lon2[i], s, a1, a2);
+    assert(s == s12[i] && a1 == azi1[i] && a2 == azi2[i]);
+  }
+
+  std::vector<double> lat(n), lon(n), azi(n);
+  geod.direct(lat1.data(), lon1.data(), azi1.data(), s12.data(), lat.data(),
+              lon.data(), azi.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    double b, l, a;
+    geod.direct(lat1[i], lon1[i], azi1[i], s12[i], b, l, a);
+    assert(std::abs(lat[i] - b) < MAX_DIFF_RAD);
+    assert(std::abs(dang(lon[i], l)) < MAX_DIFF_RAD);
+    assert(std::abs(dang(azi[i], a)) < MAX_DIFF_RAD);
+    assert(lon[i] >= -DPI && lon[i] <= DPI);
+  }
+}
+
+int main() {
+  check_known();
+  check_round_trip();
+  check_batch();
+  return 0;
+}
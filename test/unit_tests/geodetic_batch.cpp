@@ -0,0 +1,104 @@
+#include "transformations.hpp"
+#include "units.hpp"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+using namespace dso;
+constexpr const double MAX_DIFF_LAT_ASEC = 1.5e-10;
+constexpr const double MAX_DIFF_LON_ASEC = 5e-11;
+constexpr const double MAX_DIFF_HGT_MTRS = 5e-9;
+constexpr const double MAX_DIFF_CRT_MTRS = 5e-9;
+
+constexpr const double MAX_DIFF_LAT_RAD = sec2rad(MAX_DIFF_LAT_ASEC);
+constexpr const double MAX_DIFF_LON_RAD = sec2rad(MAX_DIFF_LON_ASEC);
+
+int main() {
+
+  /* input geodetic coordinates and respective cartesian */
+  std::vector<double> lats, lons, hgts, xs, ys, zs;
+
+  double hgt = -100e0;
+  while (hgt < 10000e0) {
+    double lon = -DPI;
+    while (lon < DPI) {
+      double lat = -DPI / 2e0;
+      while (lat < DPI / 2e0) {
+        double x, y, z;
+        geodetic2cartesian<ellipsoid::wgs84>(lat, lon, hgt, x, y, z);
+        lats.push_back(lat);
+        lons.push_back(lon);
+        hgts.push_back(hgt);
+        xs.push_back(x);
+        ys.push_back(y);
+        zs.push_back(z);
+        /* augment latitude */
+        lat += 1e-2;
+      }
+      /* augment lonitude */
+      lon += 1e-2;
+    }
+    /* augment height */
+    hgt += 997e0;
+  }
+
+  /* add points exactly on the polar axis (and the origin) */
+  const double pz[] = {6356752.314245e0, -6356752.314245e0, 6357000e0, 0e0};
+  for (double z : pz) {
+    lats.push_back(0e0);
+    lons.push_back(0e0);
+    hgts.push_back(0e0);
+    xs.push_back(0e0);
+    ys.push_back(0e0);
+    zs.push_back(z);
+  }
+
+  const std::size_t n = xs.size();
+
+  /* batch geodetic to cartesian; compare against scalar version */
+  std::vector<double> bx(n), by(n), bz(n);
+  geodetic2cartesian<ellipsoid::wgs84>(lats.data(), lons.data(), hgts.data(),
+                                       bx.data(), by.data(), bz.data(), n);
+  for (std::size_t i = 0; i < n - sizeof(pz) / sizeof(pz[0]); i++) {
+    assert(std::abs(bx[i] - xs[i]) < MAX_DIFF_CRT_MTRS);
+    assert(std::abs(by[i] - ys[i]) < MAX_DIFF_CRT_MTRS);
+    assert(std::abs(bz[i] - zs[i]) < MAX_DIFF_CRT_MTRS);
+  }
+
+  /* batch cartesian to geodetic */
+  std::vector<double> blat(n), blon(n), bhgt(n);
+  cartesian2geodetic<ellipsoid::wgs84>(xs.data(), ys.data(), zs.data(),
+                                       blat.data(), blon.data(), bhgt.data(),
+                                       n);
+
+  Eigen::Matrix<double, 3, 1> maxdiffs = Eigen::Matrix<double, 3, 1>::Zero();
+  for (std::size_t i = 0; i < n; i++) {
+    /* scalar cartesian to geodetic */
+    double slat, slon, shgt;
+    cartesian2geodetic<ellipsoid::wgs84>(xs[i], ys[i], zs[i], slat, slon,
+                                         shgt);
+    /* batch vs scalar */
+    maxdiffs(0) = std::max(maxdiffs(0), std::abs(bhgt[i] - shgt));
+    maxdiffs(1) = std::max(maxdiffs(1), std::abs(blat[i] - slat));
+    maxdiffs(2) = std::max(maxdiffs(2), std::abs(blon[i] - slon));
+    /* batch vs input (not for points on the polar axis) */
+    if (i < n - sizeof(pz) / sizeof(pz[0])) {
+      assert(std::abs(bhgt[i] - hgts[i]) < MAX_DIFF_HGT_MTRS);
+      assert(std::abs(blat[i] - lats[i]) < MAX_DIFF_LAT_RAD);
+      assert(std::abs(blon[i] - lons[i]) < MAX_DIFF_LON_RAD);
+    }
+  }
+
+#ifndef REPORT_TEST_DIFFS
+  assert(maxdiffs(0) < MAX_DIFF_HGT_MTRS);
+  assert(maxdiffs(1) < MAX_DIFF_LAT_RAD);
+  assert(maxdiffs(2) < MAX_DIFF_LON_RAD);
+#else
+  printf("Test : Cartesian -> Geodetic, batch vs scalar\n");
+  printf("Max height diff = %.2e[m]\n", maxdiffs(0));
+  printf("Max lat    diff = %.2e[sec]\n", rad2sec(maxdiffs(1)));
+  printf("Max lon    diff = %.2e[sec]\n", rad2sec(maxdiffs(2)));
+#endif
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "helmert.hpp"
+#include "transformations.hpp"
+#include "units.hpp"
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+constexpr const double MAX_DIFF_MTRS = 5e-9;
+
+int main() {
+  const Ellipsoid ell(ellipsoid::grs80);
+
+  /* points on (and above) the earth */
+  const std::size_t n = 1000;
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-DPI / 2e0, DPI / 2e0);
+  std::uniform_real_distribution<double> ulon(-DPI, DPI);
+  std::uniform_real_distribution<double> uhgt(-100e0, 20e3);
+  std::vector<double> x(n), y(n), z(n);
+  for (std::size_t i = 0; i < n; i++)
+    ell.geodetic2cartesian(ulat(gen), ulon(gen), uhgt(gen), x[i], y[i], z[i]);
+
+  /* parameters and rates of the order of the ones between ITRF
+   * realizations (exaggerated, so that all terms matter) */
+  const HelmertParameters p =
+      HelmertParameters::from_iers(1.6, 1.9, 2.4, -20, 50, -30, 10);
+  const HelmertParameters r =
+      HelmertParameters::from_iers(0, 0, -0.1, 0.3, 1, 2, -3);
+  assert(p.tx == 1.6e-3 && p.d == -20e-9);
+  assert(std::abs(p.rx - sec2rad(0.05)) < 1e-20);
+
+  /* 7 parameters, vs the formula of the IERS conventions */
+  const HelmertTransform h(p);
+  for (std::size_t i = 0; i < n; i++) {
+    double xt, yt, zt;
+    h.apply(x[i], y[i], z[i], xt, yt, zt);
+    const double xr = x[i] + p.tx + p.d * x[i] - p.rz * y[i] + p.ry * z[i];
+    const double yr = y[i] + p.ty + p.rz * x[i] + p.d * y[i] - p.rx * z[i];
+    const double zr = z[i] + p.tz - p.ry * x[i] + p.rx * y[i] + p.d * z[i];
+    assert(std::abs(xt - xr) < MAX_DIFF_MTRS);
+    assert(std::abs(yt - yr) < MAX_DIFF_MTRS);
+    assert(std::abs(zt - zr) < MAX_DIFF_MTRS);
+  }
+
+  /* 14 parameters: at the reference epoch, the 7-parameter transformation;
+   * at any other, the one with the propagated parameters */
+  const HelmertTransform h0(p, r, 2010e0, 2010e0);
+  assert(h0.matrix() == h.matrix());
+  assert(h0.translation().mv == h.translation().mv);
+  HelmertParameters pt = p;
+  const double dt = 2024.5e0 - 2010e0;
+  pt.tx += r.tx * dt;
+  pt.ty += r.ty * dt;
+  pt.tz += r.tz * dt;
+  pt.d += r.d * dt;
+  pt.rx += r.rx * dt;
+  pt.ry += r.ry * dt;
+  pt.rz += r.rz * dt;
+  const HelmertTransform ht(p, r, 2010e0, 2024.5e0);
+  const HelmertTransform hp(pt);
+  assert((ht.matrix() - hp.matrix()).cwiseAbs().maxCoeff() < 1e-20);
+  assert((ht.translation().mv - hp.translation().mv).norm() < 1e-15);
+
+  /* batch versions (structure-of-arrays, CartesianCrd, in-place) agree with
+   * the single-point one */
+  std::vector<double> xt(n), yt(n), zt(n);
+  ht.apply(x.data(), y.data(), z.data(), xt.data(), yt.data(), zt.data(), n);
+  std::vector<CartesianCrd> crd(n), crdt(n);
+  for (std::size_t i = 0; i < n; i++)
+    crd[i] = CartesianCrd(x[i], y[i], z[i]);
+  ht.apply(crd.data(), crdt.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    const CartesianCrd t = ht.apply(crd[i]);
+    assert(t.x() == xt[i] && t.y() == yt[i] && t.z() == zt[i]);
+    assert(crdt[i].mv == t.mv);
+  }
+  ht.apply(crd.data(), crd.data(), n);
+  for (std::size_t i = 0; i < n; i++)
+    assert(crd[i].mv == crdt[i].mv);
+
+  /* inverse */
+  const HelmertTransform hi = ht.inverse();
+  std::vector<double> xb(n), yb(n), zb(n);
+  hi.apply(xt.data(), yt.data(), zt.data(), xb.data(), yb.data(), zb.data(),
+           n);
+  for (std::size_t i = 0; i < n; i++) {
+    assert(std::abs(xb[i] - x[i]) < MAX_DIFF_MTRS);
+    assert(std::abs(yb[i] - y[i]) < MAX_DIFF_MTRS);
+    assert(std::abs(zb[i] - z[i]) < MAX_DIFF_MTRS);
+  }
+
+  /* fused transformation and conversion to geodetic coordinates, identical
+   * to the two steps (n is not a multiple of the block size) */
+  std::vector<double> lat(n), lon(n), hgt(n), flat(n), flon(n), fhgt(n);
+  ell.cartesian2geodetic(xt.data(), yt.data(), zt.data(), lat.data(),
+                         lon.data(), hgt.data(), n);
+  ht.apply(ell, x.data(), y.data(), z.data(), flat.data(), flon.data(),
+           fhgt.data(), n);
+  assert(flat == lat && flon == lon && fhgt == hgt);
+  std::vector<CartesianCrd> src(n);
+  std::vector<GeodeticCrd> geo(n);
+  for (std::size_t i = 0; i < n; i++)
+    src[i] = CartesianCrd(x[i], y[i], z[i]);
+  ht.apply(ell, src.data(), geo.data(), n);
+  for (std::size_t i = 0; i < n; i++)
+    assert(geo[i].lat() == lat[i] && geo[i].lon() == lon[i] &&
+           geo[i].hgt() == hgt[i]);
+
+  /* the identity */
+  const HelmertTransform id{HelmertParameters{}};
+  double a, b, c;
+  id.apply(x[0], y[0], z[0], a, b, c);
+  assert(a == x[0] && b == y[0] && c == z[0]);
+
+  return 0;
+}
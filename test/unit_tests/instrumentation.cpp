@@ -0,0 +1,93 @@
+#include "core/instrumentation.hpp"
+#include "transformations.hpp"
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace dso;
+using instrument::entry;
+
+int main() {
+  const std::size_t n = 1000;
+  std::vector<double> x(n), y(n), z(n), lat(n), lon(n), hgt(n);
+  for (std::size_t i = 0; i < n; i++) {
+    lat[i] = -1.5e0 + 3e0 * i / n;
+    lon[i] = -3e0 + 6e0 * i / n;
+    hgt[i] = 1e2 * i;
+  }
+
+  const instrument::Snapshot s0 = instrument::snapshot();
+
+  /* batch calls, one of them with points on the polar axis */
+  geodetic2cartesian<ellipsoid::grs80>(lat.data(), lon.data(), hgt.data(),
+                                       x.data(), y.data(), z.data(), n);
+  x[0] = y[0] = 0e0;
+  x[1] = y[1] = 1e-11;
+  cartesian2geodetic<ellipsoid::grs80>(x.data(), y.data(), z.data(),
+                                       lat.data(), lon.data(), hgt.data(), n);
+
+  /* scalar calls, via the ellipsoid-templated and the runtime versions */
+  const Ellipsoid wgs84(ellipsoid::wgs84);
+  double a, b, c;
+  float fx, fy, fz;
+  cartesian2geodetic<ellipsoid::grs80>(0e0, 0e0, 6.4e6, a, b, c);
+  wgs84.cartesian2geodetic(x[5], y[5], z[5], a, b, c);
+  wgs84.geodetic2cartesian(a, b, c, a, b, c);
+  cartesian2spherical(x[5], y[5], z[5], a, b, c);
+  spherical2cartesian<precision::full, float>(1e0f, .5f, .5f, fx, fy, fz);
+
+  /* covariance propagation, all four directions */
+  const auto &ell = ellipsoid_constants<ellipsoid::grs80>;
+  std::vector<double> cov(COV_SIZE * n, 1e-6), out(COV_SIZE * n);
+  core::geodetic2cartesian_covariance(ell, lat.data(), lon.data(),
+                                      hgt.data(), cov.data(), out.data(),
+                                      n);
+  core::cartesian2geodetic_covariance(ell, lat.data(), lon.data(),
+                                      hgt.data(), cov.data(), out.data(),
+                                      7);
+  cartesian2enu_covariance(lat.data(), lon.data(), cov.data(), out.data(), 5);
+  enu2cartesian_covariance(lat.data(), lon.data(), cov.data(), out.data(), 3);
+  enu2cartesian_covariance(lat.data(), lon.data(), cov.data(), out.data(), 2);
+
+  /* calls from other threads */
+  std::thread t([&]() {
+    geodetic2cartesian<ellipsoid::grs80>(lat.data(), lon.data(), hgt.data(),
+                                         x.data(), y.data(), z.data(), 10);
+  });
+  t.join();
+
+  const instrument::Snapshot s = instrument::snapshot() - s0;
+  if constexpr (instrument::enabled) {
+    assert(s[entry::geodetic2cartesian_batch].calls == 2);
+    assert(s[entry::geodetic2cartesian_batch].points == n + 10);
+    assert(s[entry::geodetic2cartesian_batch].ticks > 0);
+    assert(s[entry::cartesian2geodetic_batch].calls == 1);
+    assert(s[entry::cartesian2geodetic_batch].points == n);
+    assert(s[entry::cartesian2geodetic].calls == 2);
+    assert(s[entry::geodetic2cartesian].calls == 1);
+    assert(s[entry::cartesian2spherical].calls == 1);
+    assert(s[entry::spherical2cartesian].points == 1);
+    assert(s[entry::geodetic2cartesian].ticks == 0);
+    assert(s[entry::geodetic2cartesian_covariance].points == n);
+    assert(s[entry::cartesian2geodetic_covariance].points == 7);
+    assert(s[entry::cartesian2enu_covariance].calls == 1);
+    assert(s[entry::cartesian2enu_covariance].points == 5);
+    assert(s[entry::enu2cartesian_covariance].calls == 2);
+    assert(s[entry::enu2cartesian_covariance].points == 5);
+    assert(s.pole_hits == 3);
+    assert(s.threads >= 2);
+    assert(s.ticks_per_second > 0e0);
+  } else {
+    for (std::size_t i = 0; i < instrument::NUM_ENTRIES; i++)
+      assert(!s.entries[i].calls && !s.entries[i].points &&
+             !s.entries[i].ticks);
+    assert(!s.pole_hits && !s.threads);
+  }
+  assert(!std::strcmp(instrument::name(entry::cartesian2geodetic_covariance),
+                      "cartesian2geodetic_covariance"));
+  assert(!std::strcmp(instrument::name(entry::enu2cartesian_covariance),
+                      "enu2cartesian_covariance"));
+
+  return 0;
+}
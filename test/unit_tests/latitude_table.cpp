@@ -0,0 +1,125 @@
+#include "latitude_table.hpp"
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace dso;
+
+int main() {
+  const Ellipsoid e(ellipsoid::grs80);
+  const double deg = DPI / 180e0;
+  const latitude_quantity qs[] = {latitude_quantity::N, latitude_quantity::M,
+                                  latitude_quantity::geocentric,
+                                  latitude_quantity::reduced};
+
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-DPI / 2e0, DPI / 2e0);
+  std::vector<double> lat(10000);
+  for (auto &l : lat)
+    l = ulat(gen);
+  /* the poles, the equator and the grid nodes */
+  lat[0] = -DPI / 2e0;
+  lat[1] = DPI / 2e0;
+  lat[2] = 0e0;
+  lat[3] = 45e0 * deg;
+
+  /* the error is reduced (about) 16-fold when halving the step, down to
+   * rounding */
+  const LatitudeTable coarse(e, 1e0 * deg);
+  const LatitudeTable fine(e, .5e0 * deg);
+  const LatitudeTable dense(e, .1e0 * deg);
+  assert(coarse.size() == 180 && fine.size() == 360 && dense.size() == 1800);
+  for (auto q : qs) {
+    const double r = coarse.max_error(q) / fine.max_error(q);
+    assert(r > 12e0 && r < 20e0);
+  }
+  assert(dense.max_error(latitude_quantity::N) < 2e-8);
+  assert(dense.max_error(latitude_quantity::M) < 2e-8);
+  assert(dense.max_error(latitude_quantity::geocentric) < 5e-15);
+  assert(dense.max_error(latitude_quantity::reduced) < 5e-15);
+
+  for (const LatitudeTable *t : {&coarse, &fine, &dense}) {
+    std::vector<double> out(lat.size());
+    for (auto q : qs) {
+      t->value(q, lat.data(), out.data(), lat.size());
+      for (std::size_t i = 0; i < lat.size(); i++) {
+        double f;
+        switch (q) {
+        case latitude_quantity::N:
+          f = e.N(lat[i]);
+          assert(t->N(lat[i]) == out[i]);
+          break;
+        case latitude_quantity::M:
+          f = e.M(lat[i]);
+          assert(t->M(lat[i]) == out[i]);
+          break;
+        case latitude_quantity::geocentric:
+          f = e.geocentric_latitude(lat[i]);
+          assert(t->geocentric_latitude(lat[i]) == out[i]);
+          break;
+        case latitude_quantity::reduced:
+        default:
+          f = e.reduced_latitude(lat[i]);
+          assert(t->reduced_latitude(lat[i]) == out[i]);
+          break;
+        }
+        /* the maximum error is estimated on a few points per segment */
+        assert(std::abs(out[i] - f) <=
+               1.01e0 * t->max_error(q) + 4e-16 * std::abs(f));
+      }
+    }
+  }
+
+  /* batch accessors */
+  std::vector<double> a(lat.size()), b(lat.size());
+  dense.N(lat.data(), a.data(), lat.size());
+  dense.value(latitude_quantity::N, lat.data(), b.data(), lat.size());
+  assert(a == b);
+  dense.M(lat.data(), a.data(), lat.size());
+  dense.value(latitude_quantity::M, lat.data(), b.data(), lat.size());
+  assert(a == b);
+  dense.geocentric_latitude(lat.data(), a.data(), lat.size());
+  dense.value(latitude_quantity::geocentric, lat.data(), b.data(), lat.size());
+  assert(a == b);
+  dense.reduced_latitude(lat.data(), a.data(), lat.size());
+  dense.value(latitude_quantity::reduced, lat.data(), b.data(), lat.size());
+  assert(a == b);
+
+  /* a partial range; the step is adjusted to an integer number of segments
+   * and points just outside the range are extrapolated */
+  const LatitudeTable part(e, .3e0 * deg, 30e0 * deg, 61e0 * deg);
+  assert(part.size() == 104);
+  assert(part.step() <= .3e0 * deg);
+  assert(part.lat_min() == 30e0 * deg);
+  assert(std::abs(part.lat_max() - 61e0 * deg) < 1e-15);
+  for (double l : {30e0 * deg, 45.1e0 * deg, 61e0 * deg, 61.0001e0 * deg,
+                   29.9999e0 * deg}) {
+    assert(std::abs(part.N(l) - e.N(l)) < 1e-6);
+    assert(std::abs(part.geocentric_latitude(l) - e.geocentric_latitude(l)) <
+           1e-13);
+  }
+
+  /* invalid grids are rejected */
+  for (double step : {0e0, -1e0 * deg, std::nan(""), 1e-300}) {
+    bool thrown = false;
+    try {
+      LatitudeTable t(e, step);
+    } catch (const std::invalid_argument &) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+  {
+    bool thrown = false;
+    try {
+      LatitudeTable t(e, 1e0 * deg, 1e0, 0e0);
+    } catch (const std::invalid_argument &) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+
+  return 0;
+}
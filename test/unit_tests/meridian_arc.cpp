@@ -0,0 +1,78 @@
+#include "ellipsoid.hpp"
+#include <cassert>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* series vs numerical integration of the meridional radius of curvature */
+constexpr const double MAX_DIFF_MTRS = 1e-8;
+/* arc length to latitude and back */
+constexpr const double MAX_DIFF_RAD = 1e-15;
+
+/* the coefficients are computed at compile time */
+static_assert(meridian_arc_constants<ellipsoid::grs80>.A > 6367e3);
+
+/* meridian arc length via Simpson's rule on M(φ), in extended precision */
+long double arc_by_integration(double a, double f, double lat) {
+  const long double e2 = f * (2e0L - f);
+  auto M = [&](long double p) {
+    const long double s = std::sin(p);
+    const long double w = 1e0L - e2 * s * s;
+    return a * (1e0L - e2) / (w * std::sqrt(w));
+  };
+  const int n = 4000;
+  const long double h = lat / n;
+  long double sum = M(0e0L) + M(lat);
+  for (int i = 1; i < n; i++)
+    sum += ((i % 2) ? 4e0L : 2e0L) * M(i * h);
+  return sum * h / 3e0L;
+}
+
+int main() {
+  /* quarter meridian of WGS84 */
+  assert(std::abs(meridian_arc_length<ellipsoid::wgs84>(DPI / 2e0) -
+                  10001965.7293e0) < 1e-4);
+  assert(meridian_arc_length<ellipsoid::wgs84>(0e0) == 0e0);
+
+  constexpr const double a = ellipsoid_traits<ellipsoid::grs80>::a;
+  constexpr const double f = ellipsoid_traits<ellipsoid::grs80>::f;
+  for (double lat = -DPI / 2e0; lat <= DPI / 2e0; lat += 1e-2) {
+    const double s = meridian_arc_length<ellipsoid::grs80>(lat);
+    assert(std::abs(s - arc_by_integration(a, f, lat)) < MAX_DIFF_MTRS);
+    assert(std::abs(meridian_arc_latitude<ellipsoid::grs80>(s) - lat) <
+           MAX_DIFF_RAD);
+    assert(meridian_arc_constants<ellipsoid::grs80>.A *
+               rectifying_latitude<ellipsoid::grs80>(lat) ==
+           s);
+  }
+
+  /* runtime ellipsoid */
+  const Ellipsoid e(6378136e0, 1e0 / 298.25784e0);
+  const core::MeridianArcConstants c = e.meridian_arc_constants();
+  for (double lat = -DPI / 2e0; lat <= DPI / 2e0; lat += 1e-1) {
+    const double s = core::meridian_arc_length(c, lat);
+    assert(std::abs(s - arc_by_integration(e.semi_major(), e.flattening(),
+                                            lat)) < MAX_DIFF_MTRS);
+    /* small arcs agree with the infinitesimal formula */
+    const double ds = core::meridian_arc_length(c, lat + 1e-7) - s;
+    assert(std::abs(ds - e.M(lat + 5e-8) * 1e-7) < 1e-6);
+  }
+
+  /* batch versions */
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> u(-DPI / 2e0, DPI / 2e0);
+  const std::size_t n = 1003;
+  std::vector<double> lat(n), s(n), lat2(n);
+  for (auto &l : lat)
+    l = u(gen);
+  meridian_arc_length<ellipsoid::grs80>(lat.data(), s.data(), n);
+  meridian_arc_latitude<ellipsoid::grs80>(s.data(), lat2.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    assert(std::abs(s[i] - meridian_arc_length<ellipsoid::grs80>(lat[i])) <
+           MAX_DIFF_MTRS);
+    assert(std::abs(lat2[i] - lat[i]) < MAX_DIFF_RAD);
+  }
+
+  return 0;
+}
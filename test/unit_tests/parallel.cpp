@@ -0,0 +1,120 @@
+#include "parallel_transformations.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace dso;
+
+/* results of parallel transformations must be identical (bitwise) to the
+ * ones of the serial (batch) transformations */
+bool same(const std::vector<double> &a, const std::vector<double> &b) {
+  return a.size() == b.size() &&
+         !std::memcmp(a.data(), b.data(), a.size() * sizeof(double));
+}
+
+int main() {
+  /* number of points; not a multiple of any chunk size used */
+  const std::size_t n = 50017;
+
+  /* input geodetic coordinates */
+  std::vector<double> lats(n), lons(n), hgts(n);
+  for (std::size_t i = 0; i < n; i++) {
+    lats[i] = -DPI / 2e0 + DPI * ((i * 7919) % n) / n;
+    lons[i] = -DPI + 2e0 * DPI * ((i * 104729) % n) / n;
+    hgts[i] = -100e0 + 1e1 * (i % 1000);
+  }
+
+  /* serial (reference) results */
+  std::vector<double> xs(n), ys(n), zs(n);
+  geodetic2cartesian<ellipsoid::wgs84>(lats.data(), lons.data(), hgts.data(),
+                                       xs.data(), ys.data(), zs.data(), n);
+  std::vector<double> bs(n), ls(n), hs(n);
+  cartesian2geodetic<ellipsoid::wgs84>(xs.data(), ys.data(), zs.data(),
+                                       bs.data(), ls.data(), hs.data(), n);
+  std::vector<double> rs(n), gs(n), ps(n);
+  for (std::size_t i = 0; i < n; i++)
+    cartesian2spherical(xs[i], ys[i], zs[i], rs[i], gs[i], ps[i]);
+  std::vector<double> sx(n), sy(n), sz(n);
+  for (std::size_t i = 0; i < n; i++)
+    spherical2cartesian(rs[i], gs[i], ps[i], sx[i], sy[i], sz[i]);
+
+  const Ellipsoid grs80(ellipsoid::grs80);
+  std::vector<double> gx(n), gy(n), gz(n);
+  grs80.geodetic2cartesian(lats.data(), lons.data(), hgts.data(), gx.data(),
+                           gy.data(), gz.data(), n);
+  std::vector<double> gb(n), gl(n), gh(n);
+  grs80.cartesian2geodetic(gx.data(), gy.data(), gz.data(), gb.data(),
+                           gl.data(), gh.data(), n);
+
+  std::vector<double> a(n), b(n), c(n);
+  const unsigned threads[] = {1, 2, 3, 8};
+  const std::size_t chunks[] = {0, 1, 1000, parallel::DEFAULT_CHUNK_SIZE, n};
+  for (unsigned t : threads) {
+    /* the same pool is reused for all transformations */
+    ThreadPool pool(t);
+    assert(pool.num_threads() == t);
+    for (std::size_t chunk : chunks) {
+      parallel::geodetic2cartesian<ellipsoid::wgs84>(
+          pool, lats.data(), lons.data(), hgts.data(), a.data(), b.data(),
+          c.data(), n, chunk);
+      assert(same(a, xs) && same(b, ys) && same(c, zs));
+
+      parallel::cartesian2geodetic<ellipsoid::wgs84>(
+          pool, xs.data(), ys.data(), zs.data(), a.data(), b.data(), c.data(),
+          n, chunk);
+      assert(same(a, bs) && same(b, ls) && same(c, hs));
+
+      parallel::cartesian2spherical(pool, xs.data(), ys.data(), zs.data(),
+                                    a.data(), b.data(), c.data(), n, chunk);
+      assert(same(a, rs) && same(b, gs) && same(c, ps));
+
+      parallel::spherical2cartesian(pool, rs.data(), gs.data(), ps.data(),
+                                    a.data(), b.data(), c.data(), n, chunk);
+      assert(same(a, sx) && same(b, sy) && same(c, sz));
+
+      parallel::geodetic2cartesian(pool, grs80, lats.data(), lons.data(),
+                                   hgts.data(), a.data(), b.data(), c.data(),
+                                   n, chunk);
+      assert(same(a, gx) && same(b, gy) && same(c, gz));
+
+      parallel::cartesian2geodetic(pool, grs80, gx.data(), gy.data(),
+                                   gz.data(), a.data(), b.data(), c.data(), n,
+                                   chunk);
+      assert(same(a, gb) && same(b, gl) && same(c, gh));
+    }
+
+    /* empty input; output must not be touched */
+    a[0] = b[0] = c[0] = -1e0;
+    parallel::cartesian2geodetic<ellipsoid::wgs84>(pool, xs.data(), ys.data(),
+                                                   zs.data(), a.data(),
+                                                   b.data(), c.data(), 0);
+    assert(a[0] == -1e0 && b[0] == -1e0 && c[0] == -1e0);
+
+    /* every index is visited exactly once */
+    std::vector<int> visits(n, 0);
+    pool.parallel_for(n, 97, [&](std::size_t begin, std::size_t end) noexcept {
+      for (std::size_t i = begin; i < end; i++)
+        ++visits[i];
+    });
+    for (std::size_t i = 0; i < n; i++)
+      assert(visits[i] == 1);
+
+    /* the pool can be used by multiple threads at once */
+    std::vector<double> a2(n), b2(n), c2(n);
+    std::thread other([&]() {
+      parallel::geodetic2cartesian<ellipsoid::wgs84>(
+          pool, lats.data(), lons.data(), hgts.data(), a2.data(), b2.data(),
+          c2.data(), n, 512);
+    });
+    parallel::cartesian2geodetic<ellipsoid::wgs84>(pool, xs.data(), ys.data(),
+                                                   zs.data(), a.data(),
+                                                   b.data(), c.data(), n, 512);
+    other.join();
+    assert(same(a, bs) && same(b, ls) && same(c, hs));
+    assert(same(a2, xs) && same(b2, ys) && same(c2, zs));
+  }
+
+  return 0;
+}
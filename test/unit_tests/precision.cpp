@@ -0,0 +1,113 @@
+#include "transformations.hpp"
+#include <cassert>
+#include <cstdio>
+
+using namespace dso;
+
+/* check the elementary functions of a precision tier against libm, over
+ * dense grids */
+template <precision P> void check_kernels() {
+  constexpr const double MAX_ERR = precision_traits<P>::max_angle_error;
+
+  /* atan, over a wide range of arguments */
+  for (double x = -1e3; x <= 1e3; x += 1.3e-3) {
+    assert(std::abs(core::fastmath::atan<P>(x) - std::atan(x)) < MAX_ERR);
+    const double y = 1e0 / x;
+    assert(std::abs(core::fastmath::atan<P>(y) - std::atan(y)) < MAX_ERR);
+  }
+
+  /* atan2, for all quadrants (and the axes) */
+  for (double t = -DPI; t <= DPI; t += 1e-5) {
+    for (double r : {1e-3, 1e0, 6378137e0}) {
+      const double y = r * std::sin(t);
+      const double x = r * std::cos(t);
+      assert(std::abs(core::fastmath::atan2<P>(y, x) - std::atan2(y, x)) <
+             MAX_ERR);
+    }
+  }
+  for (double x : {-1e0, -0e0, 0e0, 1e0}) {
+    for (double y : {-1e0, -0e0, 0e0, 1e0}) {
+      assert(core::fastmath::atan2<P>(y, x) == std::atan2(y, x) ||
+             std::abs(core::fastmath::atan2<P>(y, x) - std::atan2(y, x)) <
+                 MAX_ERR);
+    }
+  }
+
+  /* asin */
+  for (double x = -1e0; x <= 1e0; x += 1e-6)
+    assert(std::abs(core::fastmath::asin<P>(x) - std::asin(x)) < MAX_ERR);
+  assert(std::abs(core::fastmath::asin<P>(1e0) - DPI / 2e0) < MAX_ERR);
+  assert(std::abs(core::fastmath::asin<P>(-1e0) + DPI / 2e0) < MAX_ERR);
+
+  /* sine and cosine */
+  for (double x = -4e0 * DPI; x <= 4e0 * DPI; x += 1e-5) {
+    double s, c;
+    core::fastmath::sincos<P>(x, s, c);
+    assert(std::abs(s - std::sin(x)) < MAX_ERR);
+    assert(std::abs(c - std::cos(x)) < MAX_ERR);
+  }
+}
+
+/* check the transformations of a precision tier against the full precision
+ * ones */
+template <precision P> void check_transformations() {
+  constexpr const double MAX_ERR = precision_traits<P>::max_angle_error;
+  const Ellipsoid grs80(ellipsoid::grs80);
+
+  for (double hgt = -100e0; hgt < 1e6; hgt += 99733e0) {
+    for (double lon = -DPI; lon < DPI; lon += 1e-2) {
+      for (double lat = -DPI / 2e0; lat < DPI / 2e0; lat += 1e-2) {
+        double x, y, z;
+        geodetic2cartesian<ellipsoid::grs80>(lat, lon, hgt, x, y, z);
+
+        /* cartesian to geodetic */
+        double b1, l1, h1, b2, l2, h2;
+        cartesian2geodetic<ellipsoid::grs80>(x, y, z, b1, l1, h1);
+        cartesian2geodetic<ellipsoid::grs80, P>(x, y, z, b2, l2, h2);
+        assert(std::abs(b1 - b2) < MAX_ERR);
+        assert(std::abs(l1 - l2) < MAX_ERR);
+        assert(h1 == h2);
+        grs80.cartesian2geodetic<P>(x, y, z, b2, l2, h2);
+        assert(std::abs(b1 - b2) < MAX_ERR);
+        assert(std::abs(l1 - l2) < MAX_ERR);
+        assert(h1 == h2);
+
+        /* cartesian to spherical */
+        double r1, g1, r2, g2;
+        cartesian2spherical(x, y, z, r1, g1, l1);
+        cartesian2spherical<P>(x, y, z, r2, g2, l2);
+        assert(r1 == r2);
+        assert(std::abs(g1 - g2) < MAX_ERR);
+        assert(std::abs(l1 - l2) < MAX_ERR);
+
+        /* spherical to cartesian; errors in [m], accumulate from two
+         * angles */
+        double x1, y1, z1, x2, y2, z2;
+        spherical2cartesian(r1, g1, l1, x1, y1, z1);
+        spherical2cartesian<P>(r1, g1, l1, x2, y2, z2);
+        assert(std::abs(x1 - x2) < 2e0 * MAX_ERR * r1);
+        assert(std::abs(y1 - y2) < 2e0 * MAX_ERR * r1);
+        assert(std::abs(z1 - z2) < 2e0 * MAX_ERR * r1);
+      }
+    }
+  }
+}
+
+int main() {
+  /* precision::full is (bitwise) the default transformation */
+  const double x = 4595212.468e0, y = 2039473.691e0, z = 3912617.891e0;
+  double b1, l1, h1, b2, l2, h2;
+  cartesian2geodetic<ellipsoid::grs80>(x, y, z, b1, l1, h1);
+  cartesian2geodetic<ellipsoid::grs80, precision::full>(x, y, z, b2, l2, h2);
+  assert(b1 == b2 && l1 == l2 && h1 == h2);
+  cartesian2spherical(x, y, z, b1, l1, h1);
+  cartesian2spherical<precision::full>(x, y, z, b2, l2, h2);
+  assert(b1 == b2 && l1 == l2 && h1 == h2);
+
+  check_kernels<precision::mm>();
+  check_kernels<precision::cm>();
+  check_transformations<precision::mm>();
+  check_transformations<precision::cm>();
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include "transformations.hpp"
+#include <cassert>
+#include <cstdio>
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define HAS_EXPERIMENTAL_SIMD
+#endif
+
+using namespace dso;
+
+/* float vs double; single precision holds ~7 significant digits, i.e.
+ * ~0.5 [m] at the Earth's radius; errors accumulate to a couple of [m] */
+constexpr const double MAX_DIFF_FLT_RAD = 5e-7;
+constexpr const double MAX_DIFF_FLT_MTRS = 3e0;
+
+/* check the float instantiations against the double ones */
+void check_float() {
+  const Ellipsoid grs80(ellipsoid::grs80);
+  for (double hgt = -100e0; hgt < 2e4; hgt += 997e0) {
+    for (double lon = -DPI; lon < DPI; lon += 3e-2) {
+      for (double lat = -DPI / 2e0; lat < DPI / 2e0; lat += 3e-2) {
+        double x, y, z;
+        geodetic2cartesian<ellipsoid::grs80>(lat, lon, hgt, x, y, z);
+        float xf, yf, zf;
+        geodetic2cartesian<ellipsoid::grs80>(
+            static_cast<float>(lat), static_cast<float>(lon),
+            static_cast<float>(hgt), xf, yf, zf);
+        assert(std::abs(x - xf) < MAX_DIFF_FLT_MTRS);
+        assert(std::abs(y - yf) < MAX_DIFF_FLT_MTRS);
+        assert(std::abs(z - zf) < MAX_DIFF_FLT_MTRS);
+
+        float bf, lf, hf;
+        cartesian2geodetic<ellipsoid::grs80>(
+            static_cast<float>(x), static_cast<float>(y),
+            static_cast<float>(z), bf, lf, hf);
+        assert(std::abs(lat - bf) < MAX_DIFF_FLT_RAD);
+        assert(std::abs(lon - lf) < MAX_DIFF_FLT_RAD);
+        assert(std::abs(hgt - hf) < MAX_DIFF_FLT_MTRS);
+        grs80.cartesian2geodetic(static_cast<float>(x), static_cast<float>(y),
+                                 static_cast<float>(z), bf, lf, hf);
+        assert(std::abs(lat - bf) < MAX_DIFF_FLT_RAD);
+        assert(std::abs(lon - lf) < MAX_DIFF_FLT_RAD);
+        assert(std::abs(hgt - hf) < MAX_DIFF_FLT_MTRS);
+
+        float r, g;
+        cartesian2spherical(static_cast<float>(x), static_cast<float>(y),
+                            static_cast<float>(z), r, g, lf);
+        spherical2cartesian(r, g, lf, xf, yf, zf);
+        assert(std::abs(x - xf) < MAX_DIFF_FLT_MTRS);
+        assert(std::abs(y - yf) < MAX_DIFF_FLT_MTRS);
+        assert(std::abs(z - zf) < MAX_DIFF_FLT_MTRS);
+      }
+    }
+  }
+
+  /* points on the polar axis */
+  float bf, lf, hf;
+  cartesian2geodetic<ellipsoid::grs80>(0e0f, 0e0f, -6356852.3141f, bf, lf, hf);
+  assert(bf == static_cast<float>(-DPI / 2e0) && lf == 0e0f);
+  assert(std::abs(hf - 100e0) < MAX_DIFF_FLT_MTRS);
+
+  /* radii of curvature */
+  for (double lat = -DPI / 2e0; lat < DPI / 2e0; lat += 1e-2) {
+    const float latf = static_cast<float>(lat);
+    assert(std::abs(N<ellipsoid::grs80>(latf) - N<ellipsoid::grs80>(lat)) <
+           MAX_DIFF_FLT_MTRS);
+    assert(std::abs(M<ellipsoid::grs80>(latf) - M<ellipsoid::grs80>(lat)) <
+           MAX_DIFF_FLT_MTRS);
+  }
+
+  /* single precision coordinate types */
+  GeodeticCrdf g;
+  g.lat() = 0.6632251157578452f;
+  g.lon() = 0.4136430278019753f;
+  g.hgt() = 145.123f;
+  const CartesianCrdf c = geodetic2cartesian<ellipsoid::grs80>(g);
+  const GeodeticCrdf g2 = cartesian2geodetic(c, grs80);
+  static_assert(std::is_same_v<crd_scalar_t<GeodeticCrdf>, float>);
+  assert(std::abs(g.lat() - g2.lat()) < MAX_DIFF_FLT_RAD);
+  assert(std::abs(g.lon() - g2.lon()) < MAX_DIFF_FLT_RAD);
+  assert(std::abs(g.hgt() - g2.hgt()) < MAX_DIFF_FLT_MTRS);
+  const SphericalCrdf s = cartesian2spherical(CartesianCrdConstViewf(c));
+  const CartesianCrdf c2 = spherical2cartesian(s);
+  assert((c.mv - c2.mv).norm() < MAX_DIFF_FLT_MTRS);
+}
+
+/* integer and mixed-type arguments are converted (to double, or to the
+ * type of the outputs), as for the plain double functions */
+void check_conversions() {
+  constexpr const ellipsoid E = ellipsoid::grs80;
+  constexpr const double a = ellipsoid_traits<E>::a;
+  static_assert(std::is_same_v<decltype(N<E>(0)), double>);
+  static_assert(std::is_same_v<decltype(M<E>(1)), double>);
+  static_assert(std::is_same_v<decltype(N<E>(0e0f)), float>);
+  assert(N<E>(0) == a && N<E>(1) == N<E>(1e0));
+  assert(M<E>(1) == M<E>(1e0) && std::abs(M<E>(1) - 6380753.76e0) < 1e-2);
+  assert(geocentric_latitude<E>(1) == geocentric_latitude<E>(1e0));
+  assert(std::abs(geocentric_latitude<E>(1) - 0.99694e0) < 1e-5);
+  assert(reduced_latitude<E>(1) == reduced_latitude<E>(1e0));
+
+  const Ellipsoid grs80(E);
+  double x, y, z, b, l, h;
+  geodetic2cartesian<E>(0, 0, 0, x, y, z);
+  assert(x == a && y == 0e0 && z == 0e0);
+  grs80.geodetic2cartesian(0, 0, 100, x, y, z);
+  assert(x == a + 100e0 && y == 0e0 && z == 0e0);
+  cartesian2geodetic<E>(6378237, 0, 0e0, b, l, h);
+  assert(b == 0e0 && l == 0e0 && std::abs(h - 100e0) < 1e-8);
+  grs80.cartesian2geodetic(6378237, 0, 0, b, l, h);
+  assert(b == 0e0 && l == 0e0 && std::abs(h - 100e0) < 1e-8);
+
+  /* double inputs, float outputs */
+  float xf, yf, zf;
+  geodetic2cartesian<E>(0.5e0, 0.5e0, 0e0, xf, yf, zf);
+  geodetic2cartesian<E>(0.5e0, 0.5e0, 0e0, x, y, z);
+  assert(std::abs(x - xf) < MAX_DIFF_FLT_MTRS);
+}
+
+#ifdef HAS_EXPERIMENTAL_SIMD
+/* check a SIMD pack instantiation, lane by lane, against the (scalar) double
+ * one */
+void check_simd() {
+  namespace stdx = std::experimental;
+  using V = stdx::native_simd<double>;
+  constexpr const std::size_t L = V::size();
+  constexpr const double MAX_DIFF_RAD = 1e-14;
+  constexpr const double MAX_DIFF_MTRS = 1e-8;
+
+  double lat[L], lon[L], hgt[L], x[L], y[L], z[L];
+  for (double h = -100e0; h < 1e6; h += 9973e0) {
+    for (double t = 0e0; t < 2e0 * DPI; t += 3e-2) {
+      for (std::size_t i = 0; i < L; i++) {
+        lat[i] = std::sin(t + i) * DPI / 2e0;
+        lon[i] = std::cos(3e0 * t + i) * DPI;
+        hgt[i] = h;
+      }
+      V vx, vy, vz;
+      geodetic2cartesian<ellipsoid::grs80>(
+          V(lat, stdx::element_aligned), V(lon, stdx::element_aligned),
+          V(hgt, stdx::element_aligned), vx, vy, vz);
+      for (std::size_t i = 0; i < L; i++) {
+        geodetic2cartesian<ellipsoid::grs80>(lat[i], lon[i], hgt[i], x[i],
+                                             y[i], z[i]);
+        assert(std::abs(vx[i] - x[i]) < MAX_DIFF_MTRS);
+        assert(std::abs(vy[i] - y[i]) < MAX_DIFF_MTRS);
+        assert(std::abs(vz[i] - z[i]) < MAX_DIFF_MTRS);
+      }
+      /* include a point on the polar axis */
+      x[0] = y[0] = 0e0;
+      V vb, vl, vh;
+      cartesian2geodetic<ellipsoid::grs80>(V(x, stdx::element_aligned),
+                                           V(y, stdx::element_aligned),
+                                           V(z, stdx::element_aligned), vb,
+                                           vl, vh);
+      for (std::size_t i = 0; i < L; i++) {
+        double b, l, hh;
+        cartesian2geodetic<ellipsoid::grs80>(x[i], y[i], z[i], b, l, hh);
+        assert(std::abs(vb[i] - b) < MAX_DIFF_RAD);
+        assert(std::abs(vl[i] - l) < MAX_DIFF_RAD);
+        assert(std::abs(vh[i] - hh) < MAX_DIFF_MTRS);
+      }
+    }
+  }
+}
+#endif
+
+int main() {
+  check_float();
+  check_conversions();
+#ifdef HAS_EXPERIMENTAL_SIMD
+  check_simd();
+#endif
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "spatial_index.hpp"
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* distance between the i-th point and the query point */
+double dist(const std::vector<double> &x, const std::vector<double> &y,
+            const std::vector<double> &z, std::size_t i, double qx, double qy,
+            double qz) {
+  return std::sqrt((x[i] - qx) * (x[i] - qx) + (y[i] - qy) * (y[i] - qy) +
+                   (z[i] - qz) * (z[i] - qz));
+}
+
+int main() {
+  constexpr const auto E = ellipsoid::grs80;
+
+  /* stations, randomly on (and slightly above) the ellipsoid */
+  const std::size_t n = 5003;
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-DPI / 2e0, DPI / 2e0);
+  std::uniform_real_distribution<double> ulon(-DPI, DPI);
+  std::uniform_real_distribution<double> uhgt(0e0, 3e3);
+  std::vector<double> x(n), y(n), z(n);
+  for (std::size_t i = 0; i < n; i++)
+    geodetic2cartesian<E>(std::asin(2e0 * ulat(gen) / DPI), ulon(gen),
+                          uhgt(gen), x[i], y[i], z[i]);
+
+  const SpatialIndex idx(x.data(), y.data(), z.data(), n);
+  assert(idx.size() == n);
+
+  /* query points; include the stations themselves */
+  const std::size_t nq = 1000;
+  std::vector<double> qx(nq), qy(nq), qz(nq);
+  for (std::size_t i = 0; i < nq; i++) {
+    if (i % 10) {
+      geodetic2cartesian<E>(ulat(gen), ulon(gen), 1e2 * uhgt(gen), qx[i],
+                            qy[i], qz[i]);
+    } else {
+      qx[i] = x[i];
+      qy[i] = y[i];
+      qz[i] = z[i];
+    }
+  }
+
+  /* kNN vs brute force */
+  const std::size_t k = 7;
+  std::vector<std::size_t> ki(nq * k);
+  std::vector<double> kd(nq * k);
+  idx.knn(qx.data(), qy.data(), qz.data(), nq, k, ki.data(), kd.data());
+  std::vector<std::pair<double, std::size_t>> bf(n);
+  for (std::size_t q = 0; q < nq; q++) {
+    for (std::size_t i = 0; i < n; i++)
+      bf[i] = {dist(x, y, z, i, qx[q], qy[q], qz[q]), i};
+    std::partial_sort(bf.begin(), bf.begin() + k, bf.end());
+    for (std::size_t j = 0; j < k; j++) {
+      assert(kd[q * k + j] == bf[j].first);
+      assert(dist(x, y, z, ki[q * k + j], qx[q], qy[q], qz[q]) ==
+             kd[q * k + j]);
+    }
+    double d;
+    assert(idx.nearest(qx[q], qy[q], qz[q], d) == ki[q * k]);
+    if (!(q % 10))
+      assert(ki[q * k] == q && d == 0e0);
+  }
+
+  /* radius queries vs brute force */
+  const double r = 300e3;
+  std::vector<std::size_t> offsets, ri;
+  std::vector<double> rd;
+  idx.radius(qx.data(), qy.data(), qz.data(), nq, r, offsets, ri, rd);
+  assert(offsets.size() == nq + 1 && offsets[nq] == ri.size());
+  for (std::size_t q = 0; q < nq; q++) {
+    std::vector<std::size_t> found(ri.begin() + offsets[q],
+                                   ri.begin() + offsets[q + 1]);
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < n; i++)
+      if (dist(x, y, z, i, qx[q], qy[q], qz[q]) <= r)
+        expected.push_back(i);
+    std::sort(found.begin(), found.end());
+    assert(found == expected);
+  }
+
+  /* parallel build and queries give identical results */
+  ThreadPool pool(4);
+  const SpatialIndex pidx(pool, x.data(), y.data(), z.data(), n);
+  std::vector<std::size_t> pki(nq * k);
+  std::vector<double> pkd(nq * k);
+  pidx.knn(pool, qx.data(), qy.data(), qz.data(), nq, k, pki.data(),
+           pkd.data());
+  assert(pki == ki && pkd == kd);
+  std::vector<std::size_t> poffsets, pri;
+  std::vector<double> prd;
+  pidx.radius(pool, qx.data(), qy.data(), qz.data(), nq, r, poffsets, pri,
+              prd);
+  assert(poffsets == offsets && pri == ri && prd == rd);
+
+  /* more neighbours requested than points */
+  const std::vector<CartesianCrd> few{CartesianCrd(1e0, 0e0, 0e0),
+                                      CartesianCrd(0e0, 2e0, 0e0)};
+  const SpatialIndex small(few);
+  std::size_t si[3];
+  double sd[3];
+  assert(small.knn(0e0, 0e0, 0e0, 3, si, sd) == 2);
+  assert(si[0] == 0 && si[1] == 1 && si[2] == SpatialIndex::npos);
+  assert(sd[0] == 1e0 && sd[1] == 2e0 && std::isinf(sd[2]));
+
+  /* geodesic radius vs brute force geodesic distances */
+  const double s = 500e3;
+  for (std::size_t q = 0; q < 50; q++) {
+    const double lat = ulat(gen), lon = ulon(gen);
+    std::vector<std::size_t> gi;
+    std::vector<double> gd;
+    idx.geodesic_radius<E>(lat, lon, s, gi, gd);
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < n; i++) {
+      double plat, plon, phgt, s12, a1, a2;
+      cartesian2geodetic<E>(x[i], y[i], z[i], plat, plon, phgt);
+      geodesic_inverse<E>(lat, lon, plat, plon, s12, a1, a2);
+      if (s12 <= s)
+        expected.push_back(i);
+    }
+    std::sort(gi.begin(), gi.end());
+    assert(gi == expected);
+  }
+
+  /* chord <-> arc on a sphere */
+  const double R = 6371e3;
+  for (double a = 0e0; a < 0.9e0 * DPI * R; a += 1e5)
+    assert(std::abs(chord2arc(arc2chord(a, R), R) - a) < 1e-6);
+
+  return 0;
+}
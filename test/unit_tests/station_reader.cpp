@@ -0,0 +1,301 @@
+#include "mapped_file.hpp"
+#include "station_reader.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <random>
+#include <string>
+
+using namespace dso;
+
+namespace {
+/* number of open file descriptors of the process */
+std::size_t open_fds() {
+  std::size_t n = 0;
+  DIR *d = opendir("/proc/self/fd");
+  assert(d);
+  while (readdir(d))
+    ++n;
+  closedir(d);
+  return n;
+}
+
+const char *SINEX_HEAD =
+    "%=SNX 2.01 IGS 21:001:00000 IGS 20:366:00000 20:366:86370 P 00009 2 S\n"
+    "*-------------------------------------------------------------------\n"
+    "+SITE/ID\n"
+    " ALGO  A 40104M002 P Algonquin Park          281 55 44.0  45 57 "
+    "20.9   200.9\n"
+    "-SITE/ID\n"
+    "+SOLUTION/ESTIMATE\n"
+    "*INDEX TYPE__ CODE PT SOLN _REF_EPOCH__ UNIT S __ESTIMATED VALUE____ "
+    "_STD_DEV___\n";
+const char *SINEX_TAIL = "-SOLUTION/ESTIMATE\n"
+                         "%ENDSNX\n";
+
+/* A SINEX file of n stations, with the expected results; if inner is
+ * set, a comment and a velocity line follow the STAX line of each station */
+std::string make_sinex(std::size_t n, StationCoordinates &sta,
+                       bool inner = false) {
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> u(-6.4e6, 6.4e6);
+  std::uniform_real_distribution<double> us(1e-4, 1e-2);
+  std::string s(SINEX_HEAD);
+  /* site codes; names of the expected results point here */
+  static std::vector<std::string> codes;
+  char line[128];
+  for (std::size_t i = codes.size(); i < 1000; i++) {
+    std::snprintf(line, sizeof(line), "S%03zu", i);
+    codes.push_back(line);
+  }
+  std::size_t idx = 1;
+  for (std::size_t i = 0; i < n; i++) {
+    const char *code = codes[i % 1000].c_str();
+    double v[6];
+    for (int c = 0; c < 3; c++) {
+      char val[32], sd[32];
+      std::snprintf(val, sizeof(val), "%21.14e", u(gen));
+      std::snprintf(sd, sizeof(sd), "%.5e", us(gen));
+      v[c] = std::strtod(val, nullptr);
+      v[3 + c] = std::strtod(sd, nullptr);
+      std::snprintf(line, sizeof(line),
+                    " %5zu STA%c   %4s  A %4zu 21:001:00000 m    2 %s %s\n",
+                    idx++, 'X' + c, code, i / 1000 + 1, val, sd);
+      s += line;
+      if (inner && !c) {
+        s += "* comment within a station\n";
+        std::snprintf(line, sizeof(line),
+                      " %5zu VELX   %4s  A %4zu 21:001:00000 m/y  2 "
+                      "-1.23456789012345e-02 1.00000e-04\n",
+                      idx++, code, i / 1000 + 1);
+        s += line;
+      }
+    }
+    /* velocities and comments are skipped */
+    if (!(i % 7)) {
+      std::snprintf(line, sizeof(line),
+                    " %5zu VELX   %4s  A %4zu 21:001:00000 m/y  2 "
+                    "-1.23456789012345e-02 1.00000e-04\n",
+                    idx++, code, i / 1000 + 1);
+      s += line;
+      s += "* comment\n";
+    }
+    sta.x.push_back(v[0]);
+    sta.y.push_back(v[1]);
+    sta.z.push_back(v[2]);
+    sta.sx.push_back(v[3]);
+    sta.sy.push_back(v[4]);
+    sta.sz.push_back(v[5]);
+    sta.site.push_back(codes[i % 1000]);
+  }
+  return s + SINEX_TAIL;
+}
+
+bool same(const StationCoordinates &a, const StationCoordinates &b) {
+  return a.site == b.site && a.x == b.x && a.y == b.y && a.z == b.z &&
+         a.sx == b.sx && a.sy == b.sy && a.sz == b.sz;
+}
+
+StationReadResult sinex(const std::string &s, StationCoordinates &sta) {
+  return read_sinex(s.data(), s.data() + s.size(), sta);
+}
+} /* unnamed namespace */
+
+int main() {
+  ThreadPool pool(4);
+
+  /* SINEX: serial and parallel */
+  {
+    StationCoordinates ref;
+    const std::string s = make_sinex(20000, ref);
+    StationCoordinates a, b;
+    auto r = sinex(s, a);
+    assert(r.ec == std::errc{} && r.count == 20000);
+    assert(same(a, ref));
+    assert(a.soln[0] == "1" && a.soln[19999] == "20");
+    r = read_sinex(pool, s.data(), s.data() + s.size(), b);
+    assert(r.ec == std::errc{} && r.count == 20000);
+    assert(same(b, ref) && b.soln == a.soln);
+    /* names point into the buffer */
+    assert(a.site[5].data() > s.data() &&
+           a.site[5].data() < s.data() + s.size());
+
+    /* an error late in the file; stations before it are kept */
+    std::string e(s);
+    const std::size_t pos = e.find("STAY   S500  A   15");
+    assert(pos != std::string::npos);
+    e[pos + 7] = 'X';
+    StationCoordinates c, d;
+    const auto r1 = sinex(e, c);
+    const auto r2 = read_sinex(pool, e.data(), e.data() + e.size(), d);
+    assert(r1.ec == std::errc::invalid_argument && r1.count == 14500);
+    assert(r2.ec == r1.ec && r2.count == r1.count && r2.ptr == r1.ptr);
+    assert(r1.ptr[-1] == '\n' && !std::strncmp(r1.ptr + 7, "STAY   X500", 11));
+    assert(c.size() == 14500 && d.size() == 14500);
+
+    /* non-STA lines within stations; the station count is not a multiple
+     * of anything related to the chunks */
+    {
+      StationCoordinates iref, ia, ib;
+      const std::string is = make_sinex(20003, iref, true);
+      const auto ra = sinex(is, ia);
+      const auto rb = read_sinex(pool, is.data(), is.data() + is.size(), ib);
+      assert(ra.ec == std::errc{} && ra.count == 20003 && same(ia, iref));
+      assert(rb.ec == std::errc{} && rb.count == 20003 && same(ib, iref));
+
+      /* an incomplete station (no STAZ line) just before each of the
+       * 1/16ths of the file, i.e. around the chunk boundaries; errors are
+       * reported as by the serial reader */
+      for (int k = 1; k < 16; k++) {
+        const std::size_t at = is.find(" STAX", is.size() / 16 * k);
+        const std::size_t z = is.rfind(" STAZ", at);
+        std::string bad(is);
+        const std::size_t bol = is.rfind('\n', z) + 1;
+        bad.erase(bol, is.find('\n', z) + 1 - bol);
+        StationCoordinates ea, eb;
+        const auto rs = sinex(bad, ea);
+        const auto rp =
+            read_sinex(pool, bad.data(), bad.data() + bad.size(), eb);
+        assert(rs.ec == std::errc::invalid_argument);
+        assert(rp.ec == rs.ec && rp.count == rs.count && rp.ptr == rs.ptr);
+        assert(same(ea, eb));
+      }
+    }
+
+    /* truncated file */
+    StationCoordinates t;
+    const std::size_t stop = s.find("-SOLUTION/ESTIMATE");
+    const auto r3 = read_sinex(s.data(), s.data() + stop, t);
+    assert(r3.ec == std::errc::invalid_argument && r3.count == 20000);
+  }
+
+  /* SINEX: malformed blocks */
+  {
+    StationCoordinates sta;
+    const std::string head(SINEX_HEAD);
+    const char *x = "     1 STAX   ALGO  A    1 21:001:00000 m    2 "
+                    "9.18129441417306e+05 3.61e-04\n";
+    const char *y = "     2 STAY   ALGO  A    1 21:001:00000 m    2 "
+                    "-4.34607094601549e+06 1.1e-03\n";
+    const char *z = "     3 STAZ   ALGO  A    1 21:001:00000 m    2 "
+                    "4.56197769612399e+06\n";
+    auto r = sinex(head + x + y + z + SINEX_TAIL, sta);
+    assert(r.ec == std::errc{} && r.count == 1 && sta.site[0] == "ALGO");
+    assert(sta.x[0] == 9.18129441417306e+05 && sta.sy[0] == 1.1e-03);
+    assert(sta.sz[0] == 0e0);
+    /* empty block */
+    assert(sinex(head + SINEX_TAIL, sta).count == 0);
+    /* no block */
+    r = sinex("%=SNX 2.01\n%ENDSNX\n", sta);
+    assert(r.ec == std::errc::invalid_argument && r.count == 0);
+    /* components out of order, or incomplete */
+    assert(sinex(head + x + z + y + SINEX_TAIL, sta).ec ==
+           std::errc::invalid_argument);
+    assert(sinex(head + x + y + SINEX_TAIL, sta).ec ==
+           std::errc::invalid_argument);
+    /* malformed number */
+    std::string bad(y);
+    bad[bad.find("-4.346") + 3] = 'x';
+    assert(sinex(head + x + bad + z + SINEX_TAIL, sta).ec ==
+           std::errc::invalid_argument);
+    assert(sta.size() == 1);
+  }
+
+  /* CSV */
+  {
+    const char *txt = "# exported stations\n"
+                      "name,x,y,z\n"
+                      "ALGO, 918129.4414,-4346070.9460 , 4561977.6961\n"
+                      "\n"
+                      "NOA1,4606851.0,1985738.5,3881629.7,extra\r\n";
+    StationCoordinates sta;
+    auto r = read_station_csv(txt, txt + std::strlen(txt), CsvColumns{}, sta);
+    assert(r.ec == std::errc{} && r.count == 2);
+    assert(sta.site[0] == "ALGO" && sta.site[1] == "NOA1");
+    assert(sta.y[0] == -4346070.9460 && sta.z[1] == 3881629.7);
+    assert(sta.sx[1] == 0e0 && sta.soln[1].empty());
+
+    /* another layout */
+    const char *txt2 = "1.0;2.0;3.0;ABCD;0.1;0.2;0.3\n"
+                       "4.0;5.0;6.0;EFGH;0.4;0.5\n";
+    CsvColumns cols;
+    cols.x = 0;
+    cols.y = 1;
+    cols.z = 2;
+    cols.site = 3;
+    cols.sx = 4;
+    cols.sy = 5;
+    cols.sz = 6;
+    cols.sep = ';';
+    cols.header = false;
+    sta.clear();
+    r = read_station_csv(txt2, txt2 + std::strlen(txt2), cols, sta);
+    assert(r.ec == std::errc::invalid_argument && r.count == 1);
+    assert(r.ptr == std::strchr(txt2, '\n') + 1);
+    assert(sta.site[0] == "ABCD" && sta.sz[0] == 0.3);
+
+    /* large file, serial and parallel */
+    StationCoordinates ref;
+    make_sinex(50000, ref);
+    std::string csv("site,x,y,z,sx,sy,sz\n");
+    char line[160];
+    for (std::size_t i = 0; i < ref.size(); i++) {
+      std::snprintf(line, sizeof(line), "%s,%.17g,%.17g,%.17g,%g,%g,%g\n",
+                    std::string(ref.site[i]).c_str(), ref.x[i], ref.y[i],
+                    ref.z[i], ref.sx[i], ref.sy[i], ref.sz[i]);
+      csv += line;
+    }
+    cols = CsvColumns{};
+    cols.sx = 4;
+    cols.sy = 5;
+    cols.sz = 6;
+    StationCoordinates a, b;
+    r = read_station_csv(csv.data(), csv.data() + csv.size(), cols, a);
+    assert(r.ec == std::errc{} && r.count == ref.size());
+    r = read_station_csv(pool, csv.data(), csv.data() + csv.size(), cols, b);
+    assert(r.ec == std::errc{} && r.count == ref.size());
+    assert(a.x == ref.x && a.y == ref.y && a.z == ref.z && a.site == ref.site);
+    assert(same(a, b));
+  }
+
+  /* from a (memory-mapped) file */
+  {
+    StationCoordinates ref;
+    const std::string s = make_sinex(100, ref);
+    const char *fn = "station_reader_test.snx";
+    std::FILE *fp = std::fopen(fn, "wb");
+    assert(fp);
+    std::fwrite(s.data(), 1, s.size(), fp);
+    std::fclose(fp);
+    {
+      MappedFile f;
+      const std::errc ec = f.open(fn);
+      assert(ec == std::errc{} && f.size() == s.size());
+      StationCoordinates sta;
+      const auto r = read_sinex(pool, f.begin(), f.end(), sta);
+      assert(r.ec == std::errc{} && r.ptr <= f.end() && same(sta, ref));
+    }
+    /* re-opening releases the previous mapping (no descriptors leak) */
+    {
+      const std::size_t fds = open_fds();
+      MappedFile f;
+      for (int i = 0; i < 10; i++) {
+        [[maybe_unused]] const std::errc ec = f.open(fn);
+        assert(ec == std::errc{} && f.size() == s.size());
+      }
+      assert(open_fds() == fds + 1);
+      f.close();
+      assert(open_fds() == fds && !f.data() && !f.size());
+    }
+    std::remove(fn);
+    MappedFile f;
+    const std::errc ec = f.open(fn);
+    assert(ec == std::errc::no_such_file_or_directory);
+    assert(!f.data() && !f.size());
+    (void)ec;
+  }
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include "topocentric_frame.hpp"
+#include "units.hpp"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+using namespace dso;
+constexpr const double MAX_DIFF_ENU_MTRS = 5e-8;
+constexpr const double MAX_DIFF_CRT_MTRS = 5e-8;
+constexpr const double MAX_DIFF_ANG_RAD = 5e-15;
+
+int main() {
+  const Ellipsoid wgs84(ellipsoid::wgs84);
+
+  /* a few stations */
+  const double stations[][3] = {{deg2rad(38.0), deg2rad(23.7), 100e0},
+                                {deg2rad(-33.9), deg2rad(151.2), 50e0},
+                                {deg2rad(78.2), deg2rad(-15.6), 500e0},
+                                {deg2rad(-89.9), deg2rad(179.9), 2800e0}};
+
+  /* target points, e.g. GNSS satellites */
+  std::vector<double> xs, ys, zs;
+  for (double lat = -DPI / 2e0; lat < DPI / 2e0; lat += 1e-1) {
+    for (double lon = -DPI; lon < DPI; lon += 1e-1) {
+      xs.push_back(26560e3 * std::cos(lat) * std::cos(lon));
+      ys.push_back(26560e3 * std::cos(lat) * std::sin(lon));
+      zs.push_back(26560e3 * std::sin(lat));
+    }
+  }
+  const std::size_t num_pts = xs.size();
+
+  std::vector<double> e(num_pts), n(num_pts), u(num_pts);
+  std::vector<double> az(num_pts), el(num_pts), rng(num_pts);
+  std::vector<double> x(num_pts), y(num_pts), z(num_pts);
+
+  for (const auto &s : stations) {
+    GeodeticCrd g;
+    g.lat() = s[0];
+    g.lon() = s[1];
+    g.hgt() = s[2];
+    const TopocentricFrame frame(wgs84, g);
+
+    /* constructing from cartesian coordinates results in the same frame */
+    const TopocentricFrame frame2(wgs84, frame.origin());
+    assert((frame2.origin().mv - frame.origin().mv).norm() < 1e-9);
+    assert((frame2.rotation() - frame.rotation()).cwiseAbs().maxCoeff() <
+           1e-15);
+    assert(frame.rotation() == geodetic2lvlh(g.lat(), g.lon()));
+
+    /* ECEF to ENU, against the (explicit) rotation */
+    frame.cartesian2enu(xs.data(), ys.data(), zs.data(), e.data(), n.data(),
+                        u.data(), num_pts);
+    const Eigen::Matrix<double, 3, 3> Rt =
+        geodetic2lvlh(g.lat(), g.lon()).transpose();
+    for (std::size_t i = 0; i < num_pts; i++) {
+      const detail::Vec3d dx =
+          detail::Vec3d(xs[i], ys[i], zs[i]) - frame.origin().mv;
+      const detail::Vec3d enu = Rt * dx;
+      assert(std::abs(enu(0) - e[i]) < MAX_DIFF_ENU_MTRS);
+      assert(std::abs(enu(1) - n[i]) < MAX_DIFF_ENU_MTRS);
+      assert(std::abs(enu(2) - u[i]) < MAX_DIFF_ENU_MTRS);
+      double es, ns, us;
+      frame.cartesian2enu(xs[i], ys[i], zs[i], es, ns, us);
+      assert(std::abs(es - e[i]) < MAX_DIFF_ENU_MTRS);
+      assert(std::abs(ns - n[i]) < MAX_DIFF_ENU_MTRS);
+      assert(std::abs(us - u[i]) < MAX_DIFF_ENU_MTRS);
+    }
+
+    /* ENU back to ECEF */
+    frame.enu2cartesian(e.data(), n.data(), u.data(), x.data(), y.data(),
+                        z.data(), num_pts);
+    for (std::size_t i = 0; i < num_pts; i++) {
+      assert(std::abs(xs[i] - x[i]) < MAX_DIFF_CRT_MTRS);
+      assert(std::abs(ys[i] - y[i]) < MAX_DIFF_CRT_MTRS);
+      assert(std::abs(zs[i] - z[i]) < MAX_DIFF_CRT_MTRS);
+    }
+
+    /* ECEF to azimuth/elevation/range, against the single-point version */
+    frame.cartesian2aer(xs.data(), ys.data(), zs.data(), az.data(), el.data(),
+                        rng.data(), num_pts);
+    for (std::size_t i = 0; i < num_pts; i++) {
+      double a, b, r;
+      frame.cartesian2aer(xs[i], ys[i], zs[i], a, b, r);
+      assert(az[i] >= 0e0 && az[i] < 2e0 * DPI);
+      assert(std::abs(a - az[i]) < MAX_DIFF_ANG_RAD);
+      assert(std::abs(b - el[i]) < MAX_DIFF_ANG_RAD);
+      assert(std::abs(r - rng[i]) < MAX_DIFF_ENU_MTRS);
+    }
+
+    /* azimuth/elevation/range back to ECEF */
+    frame.aer2cartesian(az.data(), el.data(), rng.data(), x.data(), y.data(),
+                        z.data(), num_pts);
+    for (std::size_t i = 0; i < num_pts; i++) {
+      assert(std::abs(xs[i] - x[i]) < MAX_DIFF_CRT_MTRS);
+      assert(std::abs(ys[i] - y[i]) < MAX_DIFF_CRT_MTRS);
+      assert(std::abs(zs[i] - z[i]) < MAX_DIFF_CRT_MTRS);
+      double xi, yi, zi;
+      frame.aer2cartesian(az[i], el[i], rng[i], xi, yi, zi);
+      assert(std::abs(xi - x[i]) < MAX_DIFF_CRT_MTRS);
+      assert(std::abs(yi - y[i]) < MAX_DIFF_CRT_MTRS);
+      assert(std::abs(zi - z[i]) < MAX_DIFF_CRT_MTRS);
+    }
+
+    /* a point straight up from the station is at elevation π/2 */
+    double xu, yu, zu, a, b, r;
+    frame.enu2cartesian(0e0, 0e0, 1e3, xu, yu, zu);
+    frame.cartesian2aer(xu, yu, zu, a, b, r);
+    assert(std::abs(b - DPI / 2e0) < 1e-9);
+    assert(std::abs(r - 1e3) < 1e-9);
+  }
+
+  /* azimuth of a point (just) west of north, i.e. e < 0 (tiny) and n > 0,
+   * is within [0, 2π); at (0, 0) the rotation is exact, so that e = Δy */
+  {
+    GeodeticCrd g;
+    g.lat() = g.lon() = g.hgt() = 0e0;
+    const TopocentricFrame frame(wgs84, g);
+    for (double ye : {-0e0, -1e-300, -1e-20}) {
+      const double xw = frame.origin().x();
+      const double yw = frame.origin().y() + ye;
+      const double zw = frame.origin().z() + 1e3;
+      double a, b, r;
+      frame.cartesian2aer(xw, yw, zw, a, b, r);
+      assert(a >= 0e0 && a < 2e0 * DPI);
+      frame.cartesian2aer(&xw, &yw, &zw, &a, &b, &r, 1);
+      assert(a >= 0e0 && a < 2e0 * DPI);
+    }
+  }
+
+  return 0;
+}
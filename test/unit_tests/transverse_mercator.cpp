@@ -0,0 +1,177 @@
+#include "parallel_transformations.hpp"
+#include "transverse_mercator.hpp"
+#include <cassert>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace dso;
+
+/* projection and back, [m] and [rad] */
+constexpr const double MAX_DIFF_MTRS = 1e-7;
+constexpr const double MAX_DIFF_RAD = 1e-14;
+/* conformality, relative, via numerical differentiation */
+constexpr const double MAX_DIFF_SCALE = 1e-8;
+
+/* the coefficients are computed at compile time */
+static_assert(transverse_mercator_constants<ellipsoid::wgs84>.alp[1] > 0e0);
+
+constexpr double deg(double d) noexcept { return d * DPI / 180e0; }
+
+int main() {
+  constexpr const auto E = ellipsoid::wgs84;
+  const core::TransverseMercatorGrid g{deg(9e0), 1e0, 0e0, 0e0};
+
+  /* on the central meridian, the northing is the meridian arc length */
+  for (double lat = -DPI / 2e0; lat <= DPI / 2e0; lat += 1e-2) {
+    double x, y;
+    geodetic2tm<E>(g, lat, g.lon0, x, y);
+    assert(std::abs(x) < MAX_DIFF_MTRS);
+    assert(std::abs(y - meridian_arc_length<E>(lat)) < MAX_DIFF_MTRS);
+  }
+
+  /* conformality (i.e. equal scale along the meridian and the parallel, no
+   * angular distortion) and round trip, up to 20 deg off the central
+   * meridian */
+  const Ellipsoid ell(E);
+  std::mt19937_64 gen(1);
+  std::uniform_real_distribution<double> ulat(-deg(85e0), deg(85e0));
+  std::uniform_real_distribution<double> ulon(-deg(20e0), deg(20e0));
+  for (int i = 0; i < 10000; i++) {
+    const double lat = ulat(gen), lon = g.lon0 + ulon(gen);
+    const double h = 1e-5;
+    double x1, y1, x2, y2, x3, y3, x4, y4;
+    geodetic2tm<E>(g, lat + h, lon, x1, y1);
+    geodetic2tm<E>(g, lat - h, lon, x2, y2);
+    geodetic2tm<E>(g, lat, lon + h, x3, y3);
+    geodetic2tm<E>(g, lat, lon - h, x4, y4);
+    const double m = ell.M(lat) * 2e0 * h;
+    const double p = ell.N(lat) * std::cos(lat) * 2e0 * h;
+    assert(std::abs((y1 - y2) / m - (x3 - x4) / p) < MAX_DIFF_SCALE);
+    assert(std::abs((x1 - x2) / m + (y3 - y4) / p) < MAX_DIFF_SCALE);
+
+    double x, y, lat2, lon2;
+    geodetic2tm<E>(g, lat, lon, x, y);
+    tm2geodetic<E>(g, x, y, lat2, lon2);
+    assert(std::abs(lat2 - lat) < MAX_DIFF_RAD);
+    assert(std::abs(lon2 - lon) < MAX_DIFF_RAD);
+  }
+
+  /* UTM zones */
+  int zone;
+  bool north;
+  double x, y;
+  geodetic2utm<E>(deg(40e0), deg(-3.7e0), zone, north, x, y);
+  assert(zone == 30 && north && x < 500e3);
+  geodetic2utm<E>(deg(-33.9e0), deg(151.2e0), zone, north, x, y);
+  assert(zone == 56 && !north && y > 6000e3 && y < 10000e3);
+  /* Norway and Svalbard */
+  assert(core::utm_zone(deg(60e0), deg(5e0)) == 32);
+  assert(core::utm_zone(deg(50e0), deg(5e0)) == 31);
+  assert(core::utm_zone(deg(78e0), deg(8e0)) == 31);
+  assert(core::utm_zone(deg(78e0), deg(15e0)) == 33);
+  assert(core::utm_zone(deg(78e0), deg(25e0)) == 35);
+  assert(core::utm_zone(deg(78e0), deg(40e0)) == 37);
+  for (double lon = -179.5e0; lon < 180e0; lon += 1e0)
+    assert(core::utm_zone(0e0, deg(lon)) ==
+           static_cast<int>(std::floor((lon + 180e0) / 6e0)) + 1);
+  assert(core::utm_zone(0e0, deg(3e0) + 2e0 * DPI) == 31);
+  /* the antimeridian belongs to zone 1, from either side */
+  assert(core::utm_zone(0e0, DPI) == 1 && core::utm_zone(0e0, -DPI) == 1);
+  assert(core::utm_zone(0e0, 3e0 * DPI) == 1);
+  {
+    double xw, yw;
+    geodetic2utm<E>(deg(-20e0), DPI, zone, north, x, y);
+    assert(zone == 1 && x < 500e3);
+    geodetic2utm<E>(deg(-20e0), -DPI, zone, north, xw, yw);
+    assert(zone == 1 && std::abs(x - xw) < MAX_DIFF_MTRS &&
+           std::abs(y - yw) < MAX_DIFF_MTRS);
+    const double latb[] = {deg(-20e0), deg(-20e0)}, lonb[] = {DPI, -DPI};
+    double eb[2], nb[2];
+    int zb[2];
+    bool hb[2];
+    geodetic2utm<E>(latb, lonb, zb, hb, eb, nb, 2);
+    assert(zb[0] == 1 && zb[1] == 1);
+    assert(std::abs(eb[0] - x) < MAX_DIFF_MTRS &&
+           std::abs(eb[1] - x) < MAX_DIFF_MTRS);
+  }
+  /* invalid zones yield NaN */
+  {
+    double la, lo;
+    utm2geodetic<E>(0, true, 500e3, 1000e3, la, lo);
+    assert(std::isnan(la) && std::isnan(lo));
+    utm2geodetic<E>(99, false, 500e3, 1000e3, la, lo);
+    assert(std::isnan(la) && std::isnan(lo));
+    const int zb[] = {0, 60, 61};
+    const bool hb[] = {true, true, true};
+    const double eb[] = {500e3, 500e3, 500e3}, nb[] = {1e6, 1e6, 1e6};
+    double lab[3], lob[3];
+    utm2geodetic<E>(zb, hb, eb, nb, lab, lob, 3);
+    assert(std::isnan(lab[0]) && std::isnan(lob[0]));
+    assert(std::abs(lob[1] - core::utm_central_meridian(60)) < MAX_DIFF_RAD);
+    assert(std::isnan(lab[2]) && std::isnan(lob[2]));
+  }
+  /* the central meridian of each zone maps to the false easting */
+  geodetic2utm<E>(deg(-10e0), deg(-177e0), zone, north, x, y);
+  assert(zone == 1 && std::abs(x - 500e3) < MAX_DIFF_MTRS);
+  assert(std::abs(y - (10000e3 + core::UTM_K0 *
+                                     meridian_arc_length<E>(deg(-10e0)))) <
+         MAX_DIFF_MTRS);
+
+  /* batch versions (and their parallel counterparts) */
+  const std::size_t n = 10007;
+  std::uniform_real_distribution<double> uglon(-DPI, DPI);
+  std::vector<double> lat(n), lon(n), xs(n), ys(n), lat2(n), lon2(n);
+  std::vector<int> zones(n);
+  bool *hemis = new bool[n];
+  for (std::size_t i = 0; i < n; i++) {
+    lat[i] = ulat(gen);
+    lon[i] = uglon(gen);
+  }
+  geodetic2utm<E>(lat.data(), lon.data(), zones.data(), hemis, xs.data(),
+                  ys.data(), n);
+  utm2geodetic<E>(zones.data(), hemis, xs.data(), ys.data(), lat2.data(),
+                  lon2.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    geodetic2utm<E>(lat[i], lon[i], zone, north, x, y);
+    assert(zone == zones[i] && north == hemis[i]);
+    assert(std::abs(x - xs[i]) < MAX_DIFF_MTRS);
+    assert(std::abs(y - ys[i]) < MAX_DIFF_MTRS);
+    assert(std::abs(lat2[i] - lat[i]) < MAX_DIFF_RAD);
+    assert(std::abs(std::remainder(lon2[i] - lon[i], 2e0 * DPI)) <
+           MAX_DIFF_RAD);
+  }
+
+  ThreadPool pool(4);
+  std::vector<double> pxs(n), pys(n), plat(n), plon(n);
+  std::vector<int> pzones(n);
+  bool *phemis = new bool[n];
+  parallel::geodetic2utm<E>(pool, lat.data(), lon.data(), pzones.data(),
+                            phemis, pxs.data(), pys.data(), n, 1000);
+  parallel::utm2geodetic<E>(pool, pzones.data(), phemis, pxs.data(),
+                            pys.data(), plat.data(), plon.data(), n, 1000);
+  assert(pzones == zones && !std::memcmp(phemis, hemis, n));
+  assert(pxs == xs && pys == ys && plat == lat2 && plon == lon2);
+  delete[] hemis;
+  delete[] phemis;
+
+  /* runtime ellipsoid, and a grid with a latitude of origin */
+  const TransverseMercator tm(Ellipsoid(6377563.396e0, 1e0 / 299.3249646e0),
+                              deg(-2e0), 0.9996012717e0, 400e3, -100e3,
+                              deg(49e0));
+  tm.forward(deg(49e0), deg(-2e0), x, y);
+  assert(std::abs(x - 400e3) < MAX_DIFF_MTRS);
+  assert(std::abs(y + 100e3) < MAX_DIFF_MTRS);
+  tm.forward(lat.data(), lon.data(), xs.data(), ys.data(), n);
+  parallel::tm2geodetic(pool, tm, xs.data(), ys.data(), plat.data(),
+                        plon.data(), n, 1000);
+  for (std::size_t i = 0; i < n; i++) {
+    /* up to 90 deg off the central meridian; stay well within */
+    if (std::abs(std::remainder(lon[i] - deg(-2e0), 2e0 * DPI)) < deg(30e0)) {
+      assert(std::abs(plat[i] - lat[i]) < MAX_DIFF_RAD);
+      assert(std::abs(plon[i] - lon[i]) < MAX_DIFF_RAD);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,261 @@
+/** @file
+ * crdconvert: convert (large) binary files of coordinates between coordinate
+ * types.
+ *
+ * Input and output files are flat binary files of packed (native-endian)
+ * doubles, three per point, i.e.
+ *   cartesian: x, y, z [m]
+ *   geodetic : lat, lon, hgt [rad, rad, m]
+ *   spherical: r, lat, lon [m, rad, rad] (geocentric latitude)
+ *
+ * The input file is memory-mapped and processed in blocks of points; each
+ * block is unpacked to (reused) arrays, transformed via the batch
+ * transformations of the library and written to the output. Hence, memory
+ * usage does not depend on the size of the input.
+ */
+
+#include "mapped_file.hpp"
+#include "transformations.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <strings.h>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+using namespace dso;
+
+namespace {
+
+/* number of points per block */
+constexpr const std::size_t BLOCK_SIZE = 4096;
+/* release pages of the input already processed, every that many blocks */
+constexpr const std::size_t RELEASE_EVERY = 256;
+
+enum class CrdType : char { cartesian, geodetic, spherical };
+
+struct Options {
+  CrdType from{CrdType::cartesian};
+  CrdType to{CrdType::geodetic};
+  ellipsoid ell{ellipsoid::grs80};
+  const char *input{nullptr};
+  const char *output{nullptr};
+};
+
+void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s -f FROM -t TO [-e ELLIPSOID] INPUT OUTPUT\n"
+          "Convert a binary file of coordinates (three doubles per point)\n"
+          "  FROM, TO  : one of cartesian, geodetic, spherical\n"
+          "  ELLIPSOID : one of grs80 (default), wgs84, pz90\n"
+          "  OUTPUT    : output file, or '-' for stdout\n"
+          "Component order (units) per coordinate type:\n"
+          "  cartesian : x, y, z (m)\n"
+          "  geodetic  : lat, lon, hgt (rad, rad, m)\n"
+          "  spherical : r, lat, lon (m, rad, rad)\n",
+          prog);
+}
+
+bool parse_crdtype(const char *str, CrdType &t) noexcept {
+  if (!strcasecmp(str, "cartesian"))
+    t = CrdType::cartesian;
+  else if (!strcasecmp(str, "geodetic"))
+    t = CrdType::geodetic;
+  else if (!strcasecmp(str, "spherical"))
+    t = CrdType::spherical;
+  else
+    return false;
+  return true;
+}
+
+bool parse_ellipsoid(const char *str, ellipsoid &e) noexcept {
+  if (!strcasecmp(str, ellipsoid_traits<ellipsoid::grs80>::n))
+    e = ellipsoid::grs80;
+  else if (!strcasecmp(str, ellipsoid_traits<ellipsoid::wgs84>::n))
+    e = ellipsoid::wgs84;
+  else if (!strcasecmp(str, ellipsoid_traits<ellipsoid::pz90>::n))
+    e = ellipsoid::pz90;
+  else
+    return false;
+  return true;
+}
+
+int parse_options(int argc, char *argv[], Options &opts) noexcept {
+  int positional = 0;
+  for (int i = 1; i < argc; i++) {
+    const bool has_value = i + 1 < argc;
+    if (!std::strcmp(argv[i], "-f") && has_value) {
+      if (!parse_crdtype(argv[++i], opts.from))
+        return 1;
+    } else if (!std::strcmp(argv[i], "-t") && has_value) {
+      if (!parse_crdtype(argv[++i], opts.to))
+        return 1;
+    } else if (!std::strcmp(argv[i], "-e") && has_value) {
+      if (!parse_ellipsoid(argv[++i], opts.ell))
+        return 1;
+    } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      return 1;
+    } else if (positional == 0) {
+      opts.input = argv[i];
+      ++positional;
+    } else if (positional == 1) {
+      opts.output = argv[i];
+      ++positional;
+    } else {
+      return 1;
+    }
+  }
+  return (positional == 2) ? 0 : 1;
+}
+
+/* Arrays (structure-of-arrays) holding one block of points */
+struct Block {
+  std::vector<double> a, b, c;
+  std::vector<double> x, y, z;
+  std::vector<double> packed;
+  Block()
+      : a(BLOCK_SIZE), b(BLOCK_SIZE), c(BLOCK_SIZE), x(BLOCK_SIZE),
+        y(BLOCK_SIZE), z(BLOCK_SIZE), packed(3 * BLOCK_SIZE) {}
+};
+
+/* transform n points of the block, from arrays (a, b, c) of type from to
+ * arrays (a, b, c) of type to; cartesian arrays (x, y, z) are used for
+ * intermediate results */
+template <ellipsoid E>
+void transform(CrdType from, CrdType to, Block &blk, std::size_t n) noexcept {
+  if (from == to)
+    return;
+
+  /* transform to cartesian ... */
+  double *x = blk.x.data();
+  double *y = blk.y.data();
+  double *z = blk.z.data();
+  if (from == CrdType::geodetic) {
+    geodetic2cartesian<E>(blk.a.data(), blk.b.data(), blk.c.data(), x, y, z,
+                          n);
+  } else if (from == CrdType::spherical) {
+    for (std::size_t i = 0; i < n; i++)
+      spherical2cartesian(blk.a[i], blk.b[i], blk.c[i], x[i], y[i], z[i]);
+  } else {
+    std::swap(blk.a, blk.x);
+    std::swap(blk.b, blk.y);
+    std::swap(blk.c, blk.z);
+    x = blk.x.data();
+    y = blk.y.data();
+    z = blk.z.data();
+  }
+
+  /* ... and from cartesian */
+  if (to == CrdType::geodetic) {
+    cartesian2geodetic<E>(x, y, z, blk.a.data(), blk.b.data(), blk.c.data(),
+                          n);
+  } else if (to == CrdType::spherical) {
+    for (std::size_t i = 0; i < n; i++)
+      cartesian2spherical(x[i], y[i], z[i], blk.a[i], blk.b[i], blk.c[i]);
+  } else {
+    std::swap(blk.a, blk.x);
+    std::swap(blk.b, blk.y);
+    std::swap(blk.c, blk.z);
+  }
+}
+
+/* convert all points of the input file, writing results to fout; returns 0
+ * on success */
+template <ellipsoid E>
+int convert(const Options &opts, MappedFile &fin, std::FILE *fout) {
+  const std::size_t num_pts = fin.size() / (3 * sizeof(double));
+  const double *in = reinterpret_cast<const double *>(fin.data());
+  Block blk;
+
+  for (std::size_t start = 0, k = 1; start < num_pts;
+       start += BLOCK_SIZE, k++) {
+    const std::size_t n =
+        (num_pts - start > BLOCK_SIZE) ? BLOCK_SIZE : num_pts - start;
+
+    /* unpack */
+    const double *p = in + 3 * start;
+    for (std::size_t i = 0; i < n; i++) {
+      blk.a[i] = p[3 * i];
+      blk.b[i] = p[3 * i + 1];
+      blk.c[i] = p[3 * i + 2];
+    }
+
+    transform<E>(opts.from, opts.to, blk, n);
+
+    /* pack and write */
+    double *q = blk.packed.data();
+    for (std::size_t i = 0; i < n; i++) {
+      q[3 * i] = blk.a[i];
+      q[3 * i + 1] = blk.b[i];
+      q[3 * i + 2] = blk.c[i];
+    }
+    if (std::fwrite(q, 3 * sizeof(double), n, fout) != n)
+      return 1;
+
+    if (!(k % RELEASE_EVERY))
+      fin.release((start + n) * 3 * sizeof(double));
+  }
+
+  return 0;
+}
+} /* unnamed namespace */
+
+int main(int argc, char *argv[]) {
+  Options opts;
+  if (parse_options(argc, argv, opts)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  MappedFile fin;
+  if (const std::errc ec = fin.open(opts.input); ec != std::errc{}) {
+    fprintf(stderr, "ERROR. Failed mapping input file %s (%s)\n", opts.input,
+            std::make_error_code(ec).message().c_str());
+    return 1;
+  }
+  if (fin.size() % (3 * sizeof(double))) {
+    fprintf(stderr,
+            "ERROR. Size of input file %s is not a multiple of %zu bytes\n",
+            opts.input, 3 * sizeof(double));
+    return 1;
+  }
+
+  const bool to_stdout = !std::strcmp(opts.output, "-");
+  /* opening the output truncates it; refuse to overwrite the input */
+  struct stat sin, sout;
+  if (!to_stdout && !stat(opts.input, &sin) && !stat(opts.output, &sout) &&
+      sin.st_dev == sout.st_dev && sin.st_ino == sout.st_ino) {
+    fprintf(stderr, "ERROR. Output file %s is the input file\n",
+            opts.output);
+    return 1;
+  }
+  std::FILE *fout = to_stdout ? stdout : std::fopen(opts.output, "wb");
+  if (!fout) {
+    fprintf(stderr, "ERROR. Failed opening output file %s (%s)\n",
+            opts.output, std::strerror(errno));
+    return 1;
+  }
+
+  int error = 0;
+  switch (opts.ell) {
+  case ellipsoid::grs80:
+    error = convert<ellipsoid::grs80>(opts, fin, fout);
+    break;
+  case ellipsoid::wgs84:
+    error = convert<ellipsoid::wgs84>(opts, fin, fout);
+    break;
+  case ellipsoid::pz90:
+    error = convert<ellipsoid::pz90>(opts, fin, fout);
+    break;
+  }
+
+  if (to_stdout ? std::fflush(fout) : std::fclose(fout))
+    error = 1;
+  if (error) {
+    fprintf(stderr, "ERROR. Failed writing output file %s\n", opts.output);
+    return 1;
+  }
+
+  return 0;
+}